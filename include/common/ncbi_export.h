@@ -1395,6 +1395,14 @@
 #  define NCBI_XREADER_CACHE_EXPORT NCBI_DLL_IMPORT
 #endif
 
+/* Export specifier for library xreader_lmdbcache
+ */
+#ifdef NCBI_XREADER_LMDBCACHE_EXPORTS
+#  define NCBI_XREADER_LMDBCACHE_EXPORT NCBI_DLL_EXPORT
+#else
+#  define NCBI_XREADER_LMDBCACHE_EXPORT NCBI_DLL_IMPORT
+#endif
+
 /* Export specifier for library xreader_pubseqos
  */
 #ifdef NCBI_XREADER_PUBSEQOS_EXPORTS
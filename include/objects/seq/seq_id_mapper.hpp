@@ -81,6 +81,19 @@ public:
     CSeq_id_Handle GetGiHandle(TGi gi);
     CSeq_id_Handle GetHandle(const CSeq_id& id, bool do_not_create = false);
 
+    /// Get seq-id handle for a string id, creating it if necessary.
+    /// Plain accessions like "NC_000001.11" are interned directly,
+    /// without constructing intermediate CSeq_id object.
+    CSeq_id_Handle GetHandle(const CTempString& str_id);
+
+    /// Get seq-id handles of many seq-ids at once, creating them if
+    /// necessary; handles[i] will be the handle of ids[i].
+    /// Seq-ids of the same type are processed together, so the shared
+    /// structures are locked once per type, not once per seq-id.
+    typedef vector<CConstRef<CSeq_id> > TSeq_ids;
+    typedef vector<CSeq_id_Handle>      TSeq_id_Handles;
+    void GetHandles(const TSeq_ids& ids, TSeq_id_Handles& handles);
+
     /// Get the list of matching handles, do not create new handles
     bool HaveMatchingHandles(const CSeq_id_Handle& id);
     void GetMatchingHandles(const CSeq_id_Handle& id,
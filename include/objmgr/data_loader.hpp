@@ -466,6 +466,25 @@ public:
     virtual unsigned GetDefaultBlobCacheSizeLimit() const;
     virtual bool GetTrackSplitSeq() const;
 
+    /// Statistics of the cache of unlocked TSEs kept by the data source.
+    /// Sizes are estimated in-memory sizes of the TSEs, including loaded
+    /// split chunks.
+    struct SBlobCacheStats {
+        Uint8  hits;          // unlocked TSEs re-used from the cache
+        Uint8  misses;        // TSEs that had to be loaded
+        Uint8  evicted;       // TSEs dropped from the cache
+        Uint8  evicted_bytes; // estimated size of the dropped TSEs
+        size_t cached;        // TSEs currently in the cache
+        size_t cached_bytes;  // estimated size of TSEs currently in the cache
+        size_t size_limit;    // limit on number of TSEs in the cache
+        size_t bytes_limit;   // limit on size of the cache, 0 - unlimited
+        SBlobCacheStats()
+            : hits(0), misses(0), evicted(0), evicted_bytes(0),
+              cached(0), cached_bytes(0), size_limit(0), bytes_limit(0) {}
+    };
+    /// Return current statistics of the blob cache of this data loader.
+    SBlobCacheStats GetBlobCacheStats(void) const;
+
 protected:
     /// Register the loader only if the name is not yet
     /// registered in the object manager
@@ -294,6 +294,10 @@ public:
     void SetDefaultPriority(TPriority priority);
 
     static unsigned GetDefaultBlobCacheSizeLimit();
+    static size_t GetDefaultBlobCacheBytesLimit();
+
+    typedef CDataLoader::SBlobCacheStats SBlobCacheStats;
+    SBlobCacheStats GetBlobCacheStats(void) const;
 
     // get locks
     enum FLockFlags {
@@ -360,8 +364,8 @@ private:
 
     // blob lookup map
     typedef map<TBlobId, TTSE_Ref>                  TBlob_Map;
-    // unlocked blobs cache
-    typedef list<TTSE_Ref>                          TBlob_Cache;
+    // unlocked blobs cache, ordered by eviction priority
+    typedef CTSE_Info::TTSE_Cache                   TBlob_Cache;
 
 #ifdef DEBUG_MAPS
     typedef debug::set<TTSE_Ref>                    TTSE_Set;
@@ -404,6 +408,11 @@ private:
                        CTSE_Info& tse, CRef<CTSE_Info::CLoadMutex> load_mutex);
     void x_ReleaseLastLoadLock(CTSE_LoadLock& lock);
     void x_ReleaseLastTSELock(CRef<CTSE_Info> info);
+    static void x_GetBlobCacheCost(const CTSE_Info& tse,
+                                   size_t& tse_bytes,
+                                   double& reload_seconds);
+    double x_GetBlobCachePriority(const CTSE_Info& tse,
+                                  double reload_seconds) const;
 
     // attach, detach, index & unindex methods
     // TSE
@@ -537,8 +546,13 @@ private:
 
     TBlob_Map             m_Blob_Map;       // TBlobId -> CTSE_Info
     mutable TBlob_Cache   m_Blob_Cache;     // unlocked blobs
-    mutable unsigned      m_Blob_Cache_Size;// list<>::size() is slow
+    mutable unsigned      m_Blob_Cache_Size;
     unsigned              m_Blob_Cache_Size_Limit;
+    mutable size_t        m_Blob_Cache_Bytes;// estimated size of cached blobs
+    size_t                m_Blob_Cache_Bytes_Limit;
+    // GDSF inflation value - priority of the last evicted blob
+    double                m_Blob_Cache_Clock;
+    mutable SBlobCacheStats m_Blob_Cache_Stats;
 
     // Prefetching thread and lock, used when initializing the thread
     CRef<CPrefetchThreadOld> m_PrefetchThread;
@@ -394,6 +394,10 @@ public:
 
     bool AddUsedTSE(const CTSE_ScopeUserLock& lock) const;
     void ReleaseUsedTSEs(void);
+
+    // weakly referenced objects attached to TSE (see CTSE_Handle)
+    CRef<CObjectEx> GetAttachedObject(const string& key) const;
+    CRef<CObjectEx> AttachObject(const string& key, CObjectEx& obj);
     
     typedef map<CConstRef<CObject>, CRef<CObject> >  TEditInfoMap;
     void SetEditTSE(const CTSE_Lock& new_tse_lock,
@@ -509,6 +513,10 @@ private: // members
     mutable CMutex              m_ScopeInfoMapMutex;
     TScopeInfoMap               m_ScopeInfoMap;
 
+    typedef map<string, CWeakRef<CObjectEx> > TAttachedObjects;
+    mutable CFastMutex          m_AttachedObjectsMutex;
+    TAttachedObjects            m_AttachedObjects;
+
 private: // to prevent copying
     CTSE_ScopeInfo(const CTSE_ScopeInfo&);
     CTSE_ScopeInfo& operator=(const CTSE_ScopeInfo&);
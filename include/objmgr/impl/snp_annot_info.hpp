@@ -40,6 +40,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
 #include <memory>
 
@@ -97,7 +98,7 @@ public:
 
 private:
     typedef vector<string> TStrings;
-    typedef map<string, size_t> TIndices;
+    typedef unordered_map<string, size_t> TIndices;
 
     TStrings m_Strings;
     unique_ptr<TIndices> m_Indices;
@@ -208,6 +209,8 @@ public:
     // filling SNP table from parser
     void x_AddSNP(const SSNP_Info& snp_info);
     void x_FinishParsing(void);
+    // rebuild position column after m_SNP_Set was filled directly
+    void x_UpdatePositions(void);
 
     SSNP_Info::TCommentIndex x_GetCommentIndex(const string& comment);
     const string& x_GetComment(SSNP_Info::TCommentIndex index) const;
@@ -236,6 +239,7 @@ public:
 
 protected:
     bool x_CheckId(const CSeq_id& id);
+    size_t x_LowerBound(TSeqPos position) const;
 
     void x_DoUpdate(TNeedUpdateFlags flags);
 
@@ -247,8 +251,12 @@ private:
     friend struct SSNP_Info;
     friend class CSeq_feat_Handle;
 
+    typedef vector<TSeqPos> TPositions;
+
     CRef<CSeq_id>               m_Seq_id;
     TSNP_Set                    m_SNP_Set;
+    // m_ToPosition of m_SNP_Set elements, 16 of them fit in a cache line
+    TPositions                  m_SNP_Positions;
     CIndexedStrings             m_Comments;
     CIndexedStrings             m_Alleles;
     CIndexedStrings             m_QualityCodesStr;
@@ -292,11 +300,32 @@ CSeq_annot_SNP_Info::end(void) const
 }
 
 
+inline
+size_t CSeq_annot_SNP_Info::x_LowerBound(TSeqPos position) const
+{
+    _ASSERT(m_SNP_Positions.size() == m_SNP_Set.size());
+    size_t n = m_SNP_Positions.size();
+    if ( !n ) {
+        return 0;
+    }
+    // branch-free binary search: the comparison only selects the next base,
+    // so it compiles to a conditional move instead of a mispredicted jump
+    const TSeqPos* first = &m_SNP_Positions.front();
+    const TSeqPos* base = first;
+    while ( n > 1 ) {
+        size_t half = n / 2;
+        base = base[half] < position ? base + half : base;
+        n -= half;
+    }
+    return (base - first) + (*base < position);
+}
+
+
 inline
 CSeq_annot_SNP_Info::const_iterator
 CSeq_annot_SNP_Info::FirstIn(const CRange<TSeqPos>& range) const
 {
-    return lower_bound(m_SNP_Set.begin(), m_SNP_Set.end(), range.GetFrom());
+    return m_SNP_Set.begin() + x_LowerBound(range.GetFrom());
 }
 
 
@@ -402,6 +431,7 @@ inline
 void CSeq_annot_SNP_Info::x_AddSNP(const SSNP_Info& snp_info)
 {
     m_SNP_Set.push_back(snp_info);
+    m_SNP_Positions.push_back(snp_info.m_ToPosition);
 }
 
 
@@ -513,6 +513,10 @@ private:
 
     void x_Initialize(void);
     void x_Reset(void); // can be called after incomplete loading
+    // memory estimation with known transfer size of loaded split chunks,
+    // never returns 0; takes the TSE annot lock, so it must not be called
+    // while holding data source locks
+    size_t x_GetEstimatedMemory(size_t loaded_chunks_bytes) const;
    
     void x_DSMapObject(CConstRef<TObject> obj, CDataSource& ds);
     void x_DSUnmapObject(CConstRef<TObject> obj, CDataSource& ds);
@@ -712,8 +716,13 @@ private:
     ELoadState              m_LoadState;
     mutable ECacheState     m_CacheState;
     
-    typedef list< CRef<CTSE_Info> > TTSE_Cache;
+    // unlocked TSEs cache ordered by eviction priority
+    typedef multimap<double, CRef<CTSE_Info> > TTSE_Cache;
     mutable TTSE_Cache::iterator   m_CachePosition;
+    // estimated size of TSE while it's in cache
+    mutable size_t                 m_CacheBytes;
+    // number of times the TSE was taken from cache
+    mutable Uint4                  m_CacheHits;
 
     // lock counter for garbage collector
     mutable CAtomicCounter_WithAutoInit m_LockCounter;
@@ -165,6 +165,8 @@ public:
 
     // update in-memory size
     void x_AddUsedMemory(size_t size);
+    // total transfer size and load time of already loaded chunks
+    pair<size_t, double> x_GetLoadedChunksCost(void) const;
 
     void x_SetBioseqUpdater(CRef<CBioseqUpdater> updater);
 
@@ -310,6 +310,73 @@ private:
 };
 
 
+/// Feature iteration over a batch of (seq-id, range, selector) queries.
+/// All Bioseqs of the batch are resolved with a single bulk request
+/// before any feature collection starts, so data loaders get one
+/// request for all blobs instead of one request per query.
+/// The queries are then executed by the prefetch manager threads with
+/// at most active_size of them in flight, and finished queries are
+/// returned in the order of their completion.
+/// Split chunks are not planned ahead across the batch: each query loads
+/// the chunks it needs when its features are collected.
+/// The destructor cancels the queries in flight and waits for them.
+class NCBI_XOBJMGR_EXPORT CPrefetchFeat_CIBatch : public CObject
+{
+public:
+    struct SQuery {
+        SQuery(const CSeq_id_Handle& seq_id,
+               const CRange<TSeqPos>& range,
+               ENa_strand strand,
+               const SAnnotSelector& selector)
+            : m_Seq_id(seq_id),
+              m_Range(range),
+              m_Strand(strand),
+              m_Selector(selector)
+            {
+            }
+
+        CSeq_id_Handle      m_Seq_id;
+        CRange<TSeqPos>     m_Range;
+        ENa_strand          m_Strand;
+        SAnnotSelector      m_Selector;
+    };
+    typedef vector<SQuery> TQueries;
+
+    CPrefetchFeat_CIBatch(CPrefetchManager& manager,
+                          const CScopeSource& scope,
+                          const TQueries& queries,
+                          size_t active_size = 10);
+    ~CPrefetchFeat_CIBatch(void);
+
+    /// Returns next finished query waiting for it if necessary.
+    /// Returns null when all queries were returned.
+    /// The index of the query in the batch is stored in *index.
+    /// The result is available via CStdPrefetch::GetFeat_CI(token).
+    CRef<CPrefetchRequest> GetNextToken(size_t* index = 0);
+
+    class CListener;
+
+protected:
+    void EnqueNextAction(void);
+
+private:
+    typedef map<CRef<CPrefetchRequest>, size_t> TActiveTokens;
+
+    CRef<CPrefetchManager>  m_Manager;
+    CScopeSource            m_Scope;
+    TQueries                m_Queries;
+    vector<CBioseq_Handle>  m_Bioseqs;
+    size_t                  m_NextQuery;
+    CRef<CListener>         m_Listener;
+    CMutex                  m_Mutex;
+    TActiveTokens           m_ActiveTokens;
+
+private:
+    CPrefetchFeat_CIBatch(const CPrefetchFeat_CIBatch&);
+    void operator=(const CPrefetchFeat_CIBatch&);
+};
+
+
 class NCBI_XOBJMGR_EXPORT CStdPrefetch
 {
 public:
@@ -163,6 +163,21 @@ public:
     /// Return true if this TSE handle is local to scope and can be edited.
     bool CanBeEdited(void) const;
 
+    /// Objects attached to this TSE in its scope, e.g. indexes built by
+    /// utility libraries that can be shared by all users of the TSE.
+    /// Only weak references are kept, so the attached objects don't lock
+    /// the TSE and are released when their last user releases them.
+    ///
+    /// @return
+    ///  Object attached with the key, or null if there's no such object.
+    CRef<CObjectEx> GetAttachedObject(const string& key) const;
+    /// Attach an object to this TSE with the key.
+    ///
+    /// @return
+    ///  The argument object, or the object attached with the same key
+    ///  before if it's still alive.
+    CRef<CObjectEx> AttachObject(const string& key, CObjectEx& obj) const;
+
     
     typedef vector<CSeq_feat_Handle> TSeq_feat_Handles;
 
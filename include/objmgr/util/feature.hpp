@@ -169,7 +169,9 @@ class CFeatTreeIndex;
 /// not change if parents were found already. However, features with no parent
 /// will be processed again in attempt to find parents from the newly added
 /// features.
-class NCBI_XOBJUTIL_EXPORT CFeatTree : public CObject
+/// A tree with all features of a TSE can be shared by all its users
+/// in the scope, see GetTSEFeatTree().
+class NCBI_XOBJUTIL_EXPORT CFeatTree : public CObjectEx
 {
 public:
     /// Construct empty tree.
@@ -194,6 +196,24 @@ public:
     /// Destructor.
     ~CFeatTree(void);
 
+    /// Return a tree with all features of the TSE.
+    /// The tree is built once and is shared by all callers in the same scope
+    /// while any of them keeps a reference to it, so consumers that work on
+    /// the same TSE (formatter, validator, etc.) don't rebuild the index.
+    /// Parents and genes of all features are assigned on creation, so
+    /// the shared tree can be queried from several threads.
+    /// The shared tree must not be modified: callers that need to add more
+    /// features (e.g. with AddGenesForFeat()) should work on a private copy
+    /// made by Clone().
+    /// Trees for editable TSEs are not shared, as the features may change.
+    static CRef<CFeatTree> GetTSEFeatTree(const CTSE_Handle& tse);
+
+    /// Return a copy of the tree with the same features and the same
+    /// already assigned parents and genes. Unlike the copy constructor,
+    /// it doesn't redo the assignment, so it's cheap to make a private
+    /// copy of a shared tree before adding more features to it.
+    CRef<CFeatTree> Clone(void) const;
+
     CFeatTree(const CFeatTree&);
     CFeatTree& operator=(const CFeatTree&);
 
@@ -386,6 +406,7 @@ protected:
     typedef vector<CFeatInfo*> TChildren;
 
     void x_Init(void);
+    void x_CopyAssigned(const CFeatTree& ft);
 
     CFeatInfo& x_GetInfo(const CSeq_feat_Handle& feat);
     CFeatInfo& x_GetInfo(const CMappedFeat& feat);
@@ -31,6 +31,7 @@
 */
 
 #include <corelib/ncbicntr.hpp>
+#include <corelib/ncbimtx.hpp>
 
 #include <objects/general/Object_id.hpp>
 #include <objects/seq/MolInfo.hpp>
@@ -253,6 +254,11 @@ public:
     CConstRef<CSeq_descr> GetTopDescr (void) const { return m_TopDescr; }
     CRef<feature::CFeatTree> GetFeatTree (void) const { return m_FeatTree; }
 
+    // The feature tree is shared by all Bioseq indexes, which can be explored
+    // by different threads (e.g., flatfile generation of a set); hold this
+    // mutex around any call that adds to or searches the tree
+    CFastMutex& GetFeatTreeMutex (void) const { return m_FeatTreeMutex; }
+
     const vector<CRef<CBioseqIndex>>& GetBioseqIndices(void);
 
     const vector<CRef<CSeqsetIndex>>& GetSeqsetIndices(void);
@@ -299,6 +305,7 @@ private:
     CConstRef<CSubmit_block> m_SbtBlk;
     CConstRef<CSeq_descr> m_TopDescr;
     CRef<feature::CFeatTree> m_FeatTree;
+    mutable CFastMutex m_FeatTreeMutex;
 
     CSeqEntryIndex::EPolicy m_Policy;
     CSeqEntryIndex::TFlags m_Flags;
@@ -58,17 +58,53 @@ class CCache_blob : public CCache_blob_Base
 public:
 
     enum {
-        kVersion = 1,
+        /// Version 1 blob: zlib compressed data, no blob header
         kMagicNum = 0x05D705DD,
+        /// Version 2 blob: data is preceded by a header selecting the codec
+        kMagicNumV2 = 0x05D705DE,
         kMD5Size = 16
     };
 
+    /// Compression of the blob data
+    enum ECodec {
+        eCodec_Zlib = 1,
+        eCodec_Zstd = 2
+    };
+
+    /// Size of zstd dictionaries built by TrainDictionary()
+    static const size_t kDefaultDictionarySize = 110 * 1024;
+
     // constructor
     CCache_blob(void);
     // destructor
     ~CCache_blob(void);
 
+    /// Load zstd dictionary from a file, so that blobs compressed with it
+    /// can be unpacked, and Pack() can use it.
+    /// @return
+    ///   id of the dictionary, it's stored in headers of the packed blobs
+    static Uint4 LoadDictionary(const string& file_name);
+
+    /// Build zstd dictionary from a sample of unpacked entries
+    /// (as returned by UnPack(vector<unsigned char>&)) and save it to a file.
+    static void TrainDictionary(const vector< vector<unsigned char> >& samples,
+                                const string& file_name,
+                                size_t dict_size = kDefaultDictionarySize);
+
+    /// Codec of the packed blob
+    /// @note
+    ///   Throws CASNCacheException if the blob header is truncated
+    ///   or selects an unknown codec.
+    ECodec GetCodec(void) const;
+
+    /// Pack the entry with zlib into a version 1 blob
     void Pack(const CSeq_entry& entry);
+    /// @param dict_id
+    ///   id of a zstd dictionary returned by LoadDictionary(), 0 for none
+    void Pack(const CSeq_entry& entry, ECodec codec, Uint4 dict_id = 0);
+    /// Pack an entry already serialized in ASN.1 binary format
+    void PackRaw(const vector<unsigned char>& raw_bytes,
+                 ECodec codec, Uint4 dict_id = 0);
     void UnPack(CSeq_entry& entry) const;
     void UnPack(vector<unsigned char>& raw_bytes) const;
 
@@ -77,6 +113,8 @@ private:
     CCache_blob(const CCache_blob& value);
     CCache_blob& operator=(const CCache_blob& value);
 
+    void x_Pack(const char* data, size_t size, ECodec codec, Uint4 dict_id);
+    void x_UnPackZstd(vector<unsigned char>& raw_bytes) const;
 };
 
 /////////////////// CCache_blob inline methods
@@ -123,6 +123,10 @@ public:
                        CAsnIndex::SIndexInfo &info);
     bool GetMultipleIndexEntries(const objects::CSeq_id_Handle & id,
                                  vector<CAsnIndex::SIndexInfo> &info);
+    /// Get the index entries of many ids in one pass over the index;
+    /// info[i] has empty seq_id if ids[i] is not found.
+    size_t GetIndexEntries(const vector<objects::CSeq_id_Handle>& ids,
+                           vector<CAsnIndex::SIndexInfo>& info);
 
 
     // AsnCacheStats
@@ -49,6 +49,9 @@ public:
         , eCantOpenChunkFile
         , eCantCopyChunkFile
         , eCantFindChunkFile
+        , eUnsupportedBlobFormat
+        , eCantOpenDictionary
+        , eBadSortedIndex
     };  
 
     virtual const char* GetErrCodeString() const
@@ -59,6 +62,9 @@ public:
             case eCantOpenChunkFile: return "Unable to open a cache chunk file.";
             case eCantCopyChunkFile: return "Unable to copy a cache chunk file.";
             case eCantFindChunkFile: return "Unable to find a cache chunk file.";
+            case eUnsupportedBlobFormat: return "Unable to (un)pack a cache blob.";
+            case eCantOpenDictionary: return "Unable to use a compression dictionary.";
+            case eBadSortedIndex: return "Invalid sorted cache index file.";
             default:     return CException::GetErrCodeString();
         }   
     }   
@@ -102,6 +102,13 @@ public:
     virtual bool GetMultipleIndexEntries(const objects::CSeq_id_Handle & id,
                                  vector<CAsnIndex::SIndexInfo> &info) = 0;
 
+    /// Get the index entries of many ids at once; info[i] is left empty
+    /// (with no seq_id) if ids[i] is not in the cache.
+    /// @return
+    ///   number of ids found
+    virtual size_t GetIndexEntries(const vector<objects::CSeq_id_Handle>& ids,
+                                   vector<CAsnIndex::SIndexInfo>& info) = 0;
+
 
 
     using TEnumSeqidCallback = std::function<void(string /*seq_id*/, uint32_t /*version*/,  uint64_t /*gi*/, uint32_t /*timestamp*/)>;
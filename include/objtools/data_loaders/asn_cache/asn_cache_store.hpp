@@ -32,6 +32,7 @@
 #include <corelib/ncbistd.hpp>
 
 #include <objtools/data_loaders/asn_cache/asn_cache_iface.hpp>
+#include <objtools/data_loaders/asn_cache/asn_sorted_index.hpp>
  
 BEGIN_NCBI_SCOPE
 
@@ -40,6 +41,8 @@ class CAsnCacheStore : public IAsnCacheStore
     std::string m_DbPath;
     std::unique_ptr<CAsnIndex> m_Index;
     std::unique_ptr<CAsnIndex> m_SeqIdIndex;
+    /// Used instead of m_Index for lookups if the cache has it
+    std::unique_ptr<CAsnSortedIndex> m_SortedIndex;
 
     CAsnIndex::TChunkId m_CurrChunkId;
     std::unique_ptr<CChunkFile> m_CurrChunk;
@@ -51,6 +54,17 @@ class CAsnCacheStore : public IAsnCacheStore
                                     vector<CAsnIndex::SIndexInfo>&  info,
                                     bool                    multiple);
 
+    static bool s_SelectIndexInfo(CAsnIndex::TVersion              version,
+                                  const CAsnIndex::SIndexInfo&     current_info,
+                                  vector<CAsnIndex::SIndexInfo>&  info,
+                                  bool                             multiple);
+
+    bool x_GetMainIndexEntries(const objects::CSeq_id_Handle&  idh,
+                               vector<CAsnIndex::SIndexInfo>&  info,
+                               bool                            multiple);
+    bool x_GetMainIndexEntry(const objects::CSeq_id_Handle&  idh,
+                             CAsnIndex::SIndexInfo&          info);
+
     CAsnIndex & x_GetIndexRef () const { return *m_Index; }
     bool x_GetBlob(const CAsnIndex::SIndexInfo &info, objects::CCache_blob& blob);
 
@@ -118,6 +132,8 @@ public:
                        CAsnIndex::SIndexInfo &info);
     bool GetMultipleIndexEntries(const objects::CSeq_id_Handle & id,
                                  vector<CAsnIndex::SIndexInfo> &info);
+    size_t GetIndexEntries(const vector<objects::CSeq_id_Handle>& ids,
+                           vector<CAsnIndex::SIndexInfo>& info);
 
 
     // IAsnCacheStats
@@ -192,6 +208,8 @@ public:
                        CAsnIndex::SIndexInfo &info);
     bool GetMultipleIndexEntries(const objects::CSeq_id_Handle & id,
                                  vector<CAsnIndex::SIndexInfo> &info);
+    size_t GetIndexEntries(const vector<objects::CSeq_id_Handle>& ids,
+                           vector<CAsnIndex::SIndexInfo>& info);
 
 
     // IAsnCacheStats
@@ -181,6 +181,21 @@ size_t  IndexABioseq( const objects::CBioseq&   bioseq,
                         CAsnIndex::TSize        size
                     );
 
+/// Same as above, but collect the index entries instead of inserting them
+size_t  IndexABioseq( const objects::CBioseq&           bioseq,
+                        vector<CAsnIndex::SIndexInfo> & entries,
+                        CAsnIndex::TTimestamp           timestamp,
+                        CAsnIndex::TChunkId             chunk_id,
+                        CAsnIndex::TOffset              offset,
+                        CAsnIndex::TSize                size
+                    );
+
+/// Insert collected index entries.  The entries are sorted in the order of
+/// the index keys first, which makes a large batch much faster to insert;
+/// for equal keys the entry added last wins, as with IndexABioseq().
+void    InsertIndexEntries( CAsnIndex &                     index,
+                            vector<CAsnIndex::SIndexInfo> & entries );
+
 void     BioseqIndexData( const objects::CBioseq&   bioseq,
                           CAsnIndex::TGi&           gi,
                           CAsnIndex::TSeqLength&    seq_length,
@@ -0,0 +1,113 @@
+#ifndef ___ASN_SORTED_INDEX__HPP
+#define ___ASN_SORTED_INDEX__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Immutable, memory-mapped alternative to the BDB main index of the cache
+ *
+ */
+
+#include <corelib/ncbistd.hpp>
+#include <corelib/ncbifile.hpp>
+#include <objtools/data_loaders/asn_cache/asn_index.hpp>
+
+
+BEGIN_NCBI_SCOPE
+
+/////////////////////////////////////////////////////////////////////////////
+///
+/// Read-only index holding the same entries as CAsnIndex, stored as an array
+/// of fixed-width records sorted by the hash of the seq-id.  The file is
+/// mapped into memory and searched in place, so opening it costs nothing
+/// and a lookup touches only a few cache lines.
+///
+/// File layout (native byte order, all parts 8-byte aligned):
+///   header | sorted seq-id hashes | records | seq-id strings
+///
+
+class CAsnSortedIndex
+{
+public:
+    typedef CAsnIndex::SIndexInfo SIndexInfo;
+
+    /// Probe for the batch lookup; version 0 matches all versions
+    struct SKey {
+        CAsnIndex::TSeqId   seq_id;
+        CAsnIndex::TVersion version;
+
+        SKey() : version(0) {}
+        SKey(const CAsnIndex::TSeqId& id, CAsnIndex::TVersion ver)
+            : seq_id(id), version(ver) {}
+    };
+
+    explicit CAsnSortedIndex(const string& file_name);
+
+    size_t GetSize() const { return m_Count; }
+
+    /// Append all entries for the seq-id having version not less than the
+    /// given one, in the order of the BDB index (version, gi, timestamp).
+    /// @return
+    ///   number of entries found
+    size_t Find(const CAsnIndex::TSeqId& seq_id,
+                CAsnIndex::TVersion version,
+                vector<SIndexInfo>& infos) const;
+
+    /// Look up many seq-ids at once.  The probes are visited in hash order
+    /// so that consecutive searches share the same pages of the index.
+    /// infos[i] receives the entries of keys[i].
+    void Find(const vector<SKey>& keys,
+              vector< vector<SIndexInfo> >& infos) const;
+
+    /// Write index file with all entries of a BDB index
+    static void Build(CAsnIndex& index, const string& file_name);
+
+    /// Hash of the normalized seq-id the records are sorted by
+    static Uint8 HashSeqId(const CAsnIndex::TSeqId& seq_id);
+
+private:
+    struct SHeader;
+    struct SRecord;
+
+    size_t x_LowerBound(Uint8 hash, size_t from) const;
+    size_t x_Collect(size_t pos, Uint8 hash,
+                     const CAsnIndex::TSeqId& seq_id,
+                     CAsnIndex::TVersion version,
+                     vector<SIndexInfo>& infos) const;
+
+    CMemoryFile    m_File;
+    size_t         m_Count;
+    const Uint8*   m_Hashes;
+    const SRecord* m_Records;
+    const char*    m_SeqIds;
+    size_t         m_SeqIdsSize;
+};
+
+
+END_NCBI_SCOPE
+
+
+#endif  // ___ASN_SORTED_INDEX__HPP
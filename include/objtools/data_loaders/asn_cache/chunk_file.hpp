@@ -60,10 +60,17 @@ public:
     { x_ReserveBufferSpace(); }
 
     void    OpenForWrite( const std::string & root_path  = "");
+    /// Append to the given chunk, whatever its size; used by writers that
+    /// share a cache and allocate chunk numbers among themselves
+    void    OpenForWrite( const std::string & root_path,
+                          unsigned int chunk );
     void    OpenForRead( const std::string & root_path  = "",
                          unsigned int chunk = 0);
     void    Write( const CCache_blob & cache_blob );
     void    RawWrite( const char * raw_blob, size_t raw_blob_size );
+    /// Write out the buffered data and sync the file to disk, so that
+    /// blobs written so far can be indexed
+    void    Flush();
     void    Read( CCache_blob & target, std::streampos offset, size_t blob_size );
     void    RawRead( std::streampos offset, char * raw_blob, size_t raw_blob_size );
     size_t  Append( const string & root_path,
@@ -71,6 +78,7 @@ public:
                     Uint8 input_offset = 0 );
     Int8    GetOffset() { return m_FileStream.tellp(); }
     unsigned int    GetChunkSerialNum() const { return m_ChunkSerialNum; }
+    bool    IsFull() const { return m_ChunkSize > m_kMaxChunkSize; }
 
     static std::string s_MakeChunkFileName( const std::string & root_path, unsigned int serial_num );
     static unsigned int    s_FindNextChunk( const std::string & root_path,
@@ -87,6 +95,7 @@ private:
     CSimpleBufferT<char>   m_Buffer;
 
     void    x_ReserveBufferSpace() { m_Buffer.reserve(128 * 1024); }
+    void    x_OpenStreamForWrite( const std::string & file_path );
 
     static const Int8  m_kMaxChunkSize = 4 * 1024 * 1024 * 1024LL;
 };
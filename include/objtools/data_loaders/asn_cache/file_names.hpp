@@ -50,6 +50,13 @@ namespace NASNCacheFileName
                                                                 : GetSeqIdIndex() );
     }
 
+    /// memory-mapped copy of the main index, see CAsnSortedIndex
+    inline string GetSortedIndex() { return string( "asn_cache.sidx" ); }
+    inline string GetSortedIndex( const string & root_dir )
+    {
+        return CDirEntry::ConcatPath( root_dir, GetSortedIndex() );
+    }
+
     inline string GetChunkPrefix() { return string( "chunk." ); }
     inline string GetSeqIdChunk() { return string( "seq_id_chunk" ); }
     inline string GetSeqIdChunk( const string & root_dir )
@@ -57,6 +64,13 @@ namespace NASNCacheFileName
         return CDirEntry::ConcatPath( root_dir, GetSeqIdChunk() );
     }
      
+    /// zstd dictionary used to compress cache blobs
+    inline string GetZstdDictionary() { return string( "zstd_dictionary" ); }
+    inline string GetZstdDictionary( const string & root_dir )
+    {
+        return CDirEntry::ConcatPath( root_dir, GetZstdDictionary() );
+    }
+
     inline string GetIntermediateFilePrefix() { return string( "intermediate." ); }
 
     inline string GetHeader() { return string( "header" ); }
@@ -0,0 +1,126 @@
+#ifndef ASN_CACHE_PARALLEL_CHUNK_WRITER_HPP__
+#define ASN_CACHE_PARALLEL_CHUNK_WRITER_HPP__
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ * Pack Seq-entries into cache blobs and append them to chunk files on a pool
+ * of worker threads.  Each worker writes its own chunk file; chunk numbers
+ * are handed out past the last chunk existing in the cache, so the workers
+ * never share a file and the chunk numbering stays contiguous.
+ */
+
+#include <corelib/ncbistd.hpp>
+#include <corelib/ncbitime.hpp>
+
+#include <objects/seqset/Seq_entry.hpp>
+#include <objtools/data_loaders/asn_cache/asn_index.hpp>
+#include <objtools/data_loaders/asn_cache/Cache_blob.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+BEGIN_NCBI_SCOPE
+
+class CParallelChunkWriter
+{
+public:
+    struct SBlobLocation {
+        CAsnIndex::TTimestamp timestamp;
+        CAsnIndex::TChunkId   chunk;
+        CAsnIndex::TOffset    offset;
+        CAsnIndex::TSize      size;
+    };
+
+    /// Called on a worker thread once the blob of the entry is written;
+    /// calls from different workers are not serialized
+    typedef function<void (const objects::CSeq_entry& entry,
+                           const SBlobLocation& location)> TCallback;
+
+    /// @param max_queued
+    ///   Write() blocks while that many entries wait for a worker;
+    ///   0 means twice the number of threads
+    CParallelChunkWriter(const string& root_path,
+                         unsigned thread_count,
+                         TCallback callback,
+                         size_t max_queued = 0);
+    /// Waits for the queued entries, but ignores errors
+    ~CParallelChunkWriter();
+
+    /// Compression of the blobs, zlib by default;
+    /// must be set before the first Write()
+    void SetCodec(objects::CCache_blob::ECodec codec, Uint4 dict_id = 0);
+
+    void Write(CConstRef<objects::CSeq_entry> entry,
+               CAsnIndex::TTimestamp timestamp);
+
+    /// Wait until all entries written so far are in the chunk files and
+    /// their callbacks have returned, and have every worker flush and sync
+    /// its chunk file, so the reported locations can be indexed.
+    /// Rethrows the first error of a worker; entries queued after the
+    /// error are dropped.
+    void Wait();
+
+    /// Log number of blobs, bytes and throughput so far
+    void ReportProgress(const char* what = "written") const;
+
+private:
+    struct SJob {
+        CConstRef<objects::CSeq_entry> entry;
+        CAsnIndex::TTimestamp          timestamp;
+    };
+
+    void x_Worker();
+    CAsnIndex::TChunkId x_AllocateChunk();
+
+    string              m_RootPath;
+    TCallback           m_Callback;
+    size_t              m_MaxQueued;
+    objects::CCache_blob::ECodec m_Codec;
+    Uint4               m_Dictionary;
+
+    mutable std::mutex  m_Mutex;
+    std::condition_variable m_JobAdded;
+    std::condition_variable m_JobDone;
+    std::deque<SJob>    m_Queue;
+    size_t              m_Active;
+    bool                m_Stop;
+    /// Wait() bumps the request; each worker flushes once per request
+    unsigned            m_FlushRequest;
+    size_t              m_Flushed;
+    std::exception_ptr  m_Error;
+
+    CAsnIndex::TChunkId m_NextChunk;
+    Uint8               m_BlobCount;
+    Uint8               m_ByteCount;
+    CStopWatch          m_Elapsed;
+
+    vector<std::thread> m_Threads;
+};
+
+END_NCBI_SCOPE
+#endif  // ASN_CACHE_PARALLEL_CHUNK_WRITER_HPP__
@@ -42,6 +42,20 @@ BEGIN_SCOPE(objects)
 
 class CSeq_id;
 
+/// Cache blob writer that stores the blob only when it's closed.
+/// CCacheWriter closes such writers after the whole blob is written,
+/// and aborts them if the blob stream fails.
+class NCBI_XREADER_CACHE_EXPORT ICacheBlobWriter : public IWriter
+{
+public:
+    virtual ~ICacheBlobWriter(void);
+
+    /// Store all written data as one blob
+    virtual void Close(void) = 0;
+    /// Discard all written data
+    virtual void Abort(void) = 0;
+};
+
 class NCBI_XREADER_CACHE_EXPORT CCacheWriter : public CWriter,
                                                public CCacheHolder,
                                                public SCacheInfo
@@ -59,6 +59,7 @@ protected:
 
     virtual void x_SendPacket(TConn conn, const CID2_Request_Packet& packet);
     virtual void x_ReceiveReply(TConn conn, CID2_Reply& reply);
+    virtual bool x_CanPipelinePackets(void) const;
 
     string x_ConnDescription(CConn_IOStream& stream) const;
     CConn_IOStream* x_GetCurrentConnection(TConn conn) const;
@@ -72,6 +72,7 @@ struct SId2LoadedSet;
 struct SId2PacketInfo;
 struct SId2PacketReplies;
 struct SId2ProcessingState;
+struct SId2Pipeline;
 
 class NCBI_XREADER_EXPORT CId2ReaderBase : public CReader
 {
@@ -163,7 +164,12 @@ protected:
     virtual void x_ReceiveReply(TConn conn, CID2_Reply& reply) = 0;
     void x_ReceiveReply(CObjectIStream& stream, TConn conn, CID2_Reply& reply);
 
+    // Called when all replies to the packets sent over the connection
+    // are received; with pipelining it's once after the last packet.
     virtual void x_EndOfPacket(TConn conn);
+    // Return true if the connection allows sending next packet
+    // before all replies to the previous packets are received.
+    virtual bool x_CanPipelinePackets(void) const;
 
     void x_SetResolve(CID2_Request_Get_Blob_Id& get_blob_id,
                       const CSeq_id& seq_id);
@@ -182,6 +188,12 @@ protected:
     void x_ProcessPacket(CReaderRequestResult& result,
                          CID2_Request_Packet& packet,
                          const SAnnotSelector* sel);
+    typedef vector< CRef<CID2_Request_Packet> > TPackets;
+    // Process several packets keeping up to ID2_MAX_PACKETS_IN_FLIGHT
+    // of them sent over the same connection without waiting for replies.
+    void x_ProcessPackets(CReaderRequestResult& result,
+                          TPackets& packets,
+                          const SAnnotSelector* sel);
 
     enum EErrorFlags {
         fError_warning              = 1 << 0,
@@ -272,6 +284,12 @@ protected:
                          SId2ProcessingState& state,
                          CID2_Request_Packet& packet);
     CRef<CID2_Reply> x_ReceiveFromConnection(TConn conn);
+    bool x_PrepareID2Packet(SId2ProcessingState& state,
+                            CID2_Request_Packet& packet);
+    void x_SendID2PacketToConn(TConn conn,
+                               CID2_Request_Packet& packet);
+    CRef<CID2_Reply> x_ReceiveID2ReplyFromConn(TConn conn);
+    CRef<CID2_Reply> x_ReceivePipelinedReply(SId2ProcessingState& state);
     CRef<CID2_Reply> x_ReceiveID2ReplyStage(SId2ProcessingState& state, size_t pos);
     CRef<CID2_Reply> x_ReceiveID2Reply(SId2ProcessingState& state);
     void x_AssignSerialNumbers(SId2PacketInfo& info,
@@ -0,0 +1,92 @@
+#ifndef READER_LMDBCACHE__HPP_INCLUDED
+#define READER_LMDBCACHE__HPP_INCLUDED
+
+/*  $Id$
+* ===========================================================================
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+* ===========================================================================
+*
+*  File Description: Data reader from cache shared by processes via LMDB
+*
+*/
+
+#include <objtools/data_loaders/genbank/cache/reader_cache.hpp>
+#include <objtools/data_loaders/genbank/cache/writer_cache.hpp>
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects)
+
+/// Parameters of the LMDB environment shared by cache reader and writer
+struct NCBI_XREADER_LMDBCACHE_EXPORT SLMDBCacheInfo
+{
+    string  m_Path;
+    Uint8   m_MapSize;
+    int     m_MaxReaders;
+    int     m_IdTimeout;
+    int     m_BlobTimeout;
+
+    void Init(const TPluginManagerParamTree* params,
+              const string& driver_name);
+
+    /// Create id and blob ICache instances over the shared environment
+    /// and register them in the cache manager.
+    void InitializeCache(CCacheHolder& holder,
+                         CReaderCacheManager& cache_manager) const;
+};
+
+
+/// Cache reader storing id and blob information in an LMDB environment
+/// which is memory mapped by all processes on the host.
+/// Any number of processes read the cache concurrently without locks,
+/// and only one writer transaction is active at a time.
+/// The record format is the same as in the ICache based reader.
+class NCBI_XREADER_LMDBCACHE_EXPORT CLMDBCacheReader : public CCacheReader
+{
+public:
+    CLMDBCacheReader(const TPluginManagerParamTree* params = 0,
+                     const string& driver_name = kEmptyStr);
+
+    virtual void InitializeCache(CReaderCacheManager& cache_manager,
+                                 const TPluginManagerParamTree* params);
+
+private:
+    SLMDBCacheInfo m_Info;
+};
+
+
+class NCBI_XREADER_LMDBCACHE_EXPORT CLMDBCacheWriter : public CCacheWriter
+{
+public:
+    CLMDBCacheWriter(const TPluginManagerParamTree* params = 0,
+                     const string& driver_name = kEmptyStr);
+
+    virtual void InitializeCache(CReaderCacheManager& cache_manager,
+                                 const TPluginManagerParamTree* params);
+
+private:
+    SLMDBCacheInfo m_Info;
+};
+
+
+END_SCOPE(objects)
+END_NCBI_SCOPE
+
+#endif // READER_LMDBCACHE__HPP_INCLUDED
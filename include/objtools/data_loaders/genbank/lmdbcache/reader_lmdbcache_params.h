@@ -0,0 +1,55 @@
+#ifndef GBLOADER_LMDBCACHE_PARAMS__HPP_INCLUDED
+#define GBLOADER_LMDBCACHE_PARAMS__HPP_INCLUDED
+
+/*  $Id$
+* ===========================================================================
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+* ===========================================================================
+*
+*  File Description: 
+*    GenBank shared LMDB cache configuration parameters
+*
+*/
+
+/* Name of shared LMDB cache reader driver */
+#define NCBI_GBLOADER_READER_LMDBCACHE_DRIVER_NAME "lmdbcache"
+
+/* Name of shared LMDB cache writer driver */
+#define NCBI_GBLOADER_WRITER_LMDBCACHE_DRIVER_NAME "lmdbcache"
+
+/* Directory of the LMDB environment shared by all processes */
+#define NCBI_GBLOADER_LMDBCACHE_PARAM_PATH "path"
+/* Maximal size of the memory map, e.g. "16GB" */
+#define NCBI_GBLOADER_LMDBCACHE_PARAM_MAP_SIZE "map_size"
+/* Maximal number of concurrent reader slots in all processes */
+#define NCBI_GBLOADER_LMDBCACHE_PARAM_MAX_READERS "max_readers"
+/* Expiration timeout of id cache entries in seconds */
+#define NCBI_GBLOADER_LMDBCACHE_PARAM_ID_TIMEOUT "id_timeout"
+/* Expiration timeout of blob cache entries in seconds */
+#define NCBI_GBLOADER_LMDBCACHE_PARAM_BLOB_TIMEOUT "blob_timeout"
+
+#define DEFAULT_LMDBCACHE_PATH ".genbank_lmdb_cache"
+#define DEFAULT_LMDBCACHE_MAP_SIZE "16GB"
+#define DEFAULT_LMDBCACHE_MAX_READERS 1024
+#define DEFAULT_LMDBCACHE_ID_TIMEOUT 172800
+#define DEFAULT_LMDBCACHE_BLOB_TIMEOUT 432000
+
+#endif
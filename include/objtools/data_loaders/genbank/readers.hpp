@@ -44,6 +44,8 @@ extern void NCBI_XREADER_PUBSEQOS2_EXPORT GenBankReaders_Register_Pubseq2(void);
 extern void NCBI_XREADER_CACHE_EXPORT    GenBankReaders_Register_Cache (void);
 extern void NCBI_XREADER_CACHE_EXPORT    GenBankWriters_Register_Cache (void);
 extern void NCBI_XREADER_GICACHE_EXPORT  GenBankReaders_Register_GICache(void);
+extern void NCBI_XREADER_LMDBCACHE_EXPORT GenBankReaders_Register_LMDBCache(void);
+extern void NCBI_XREADER_LMDBCACHE_EXPORT GenBankWriters_Register_LMDBCache(void);
 
 }
 
@@ -34,6 +34,7 @@
 */
 #include <corelib/ncbistd.hpp>
 #include <corelib/ncbiobj.hpp>
+#include <corelib/ncbimtx.hpp>
 #include <objects/general/User_object.hpp>
 #include <objects/seq/Bioseq.hpp>
 #include <objects/seq/Seq_inst.hpp>
@@ -475,7 +476,12 @@ public:
     bool GetSGS(void) const { return m_SmallGenomeSet; }
     void SetSGS(const bool sgs) { m_SmallGenomeSet = sgs; }
 
-    void AddSection(TSection& section) { m_Sections.push_back(section); }
+    // may be called concurrently by gatherers of independent Bioseqs
+    void AddSection(TSection& section)
+    {
+        CFastMutexGuard guard(m_SectionsMutex);
+        m_Sections.push_back(section);
+    }
 
     void Reset(void);
 
@@ -484,6 +490,7 @@ private:
     CFlatFileConfig             m_Cfg;
     CSeq_entry_Handle           m_Entry;
     TSections                   m_Sections;
+    CFastMutex                  m_SectionsMutex;
     CConstRef<CSubmit_block>    m_Submit;
     unique_ptr<SAnnotSelector>  m_Selector;
     CConstRef<CSeq_loc>         m_Loc;
@@ -670,6 +670,10 @@ public:
     int GetGapDepth(void) const { return m_GapDepth; }
     void SetGapDepth(const int gapDepth) { m_GapDepth = gapDepth; }
 
+    // -- Number of threads gathering the Bioseqs of one entry (0 or 1 = serial)
+    int GetBioseqThreads(void) const { return m_BioseqThreads; }
+    void SetBioseqThreads(const int threads) { m_BioseqThreads = threads; }
+
 
     void SetGenbankBlocks(const TGenbankBlocks& genbank_blocks)
     {
@@ -758,6 +762,7 @@ private:
     TCustom     m_Custom;
     int         m_FeatDepth;
     int         m_GapDepth;
+    int         m_BioseqThreads;
     string      m_SingleAccession;
     CRef<IHTMLFormatter> m_html_formatter;
 };
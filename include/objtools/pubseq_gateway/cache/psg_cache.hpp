@@ -83,6 +83,13 @@ class CPubseqGatewayCache
         const string& bioseq_info_file_name, const string& si2csi_file_name, const string& blob_prop_file_name);
     virtual ~CPubseqGatewayCache();
 
+    // Number of bioseq_info lookup results kept decoded in memory (LRU),
+    // 0 (default) disables it. Takes effect on the next Open()
+    void SetBioseqInfoLruSize(size_t size)
+    {
+        m_BioseqInfoLruSize = size;
+    }
+
     void Open(const set<int>& sat_ids);
 
     void ResetErrors();
@@ -98,6 +105,12 @@ class CPubseqGatewayCache
     TSi2CsiResponse FetchSi2Csi(CSi2CsiFetchRequest const& request);
     TSi2CsiResponse FetchSi2CsiLast(void);
 
+    // Batch lookups: one read transaction for the whole batch, keys are
+    // visited in sorted order. Responses go in the order of requests.
+    vector<TBioseqInfoResponse> FetchBioseqInfo(vector<TBioseqInfoRequest> const& requests);
+    vector<TBlobPropResponse> FetchBlobProp(vector<TBlobPropRequest> const& requests);
+    vector<TSi2CsiResponse> FetchSi2Csi(vector<TSi2CsiRequest> const& requests);
+
     static string PackBioseqInfoKey(const string& accession, int version);
     static string PackBioseqInfoKey(const string& accession, int version, int seq_id_type);
     static string PackBioseqInfoKey(const string& accession, int version, int seq_id_type, int64_t gi);
@@ -120,6 +133,7 @@ class CPubseqGatewayCache
     string m_BioseqInfoPath;
     string m_Si2CsiPath;
     string m_BlobPropPath;
+    size_t m_BioseqInfoLruSize;
     unique_ptr<CPubseqGatewayCacheBioseqInfo> m_BioseqInfoCache;
     unique_ptr<CPubseqGatewayCacheSi2Csi> m_Si2CsiCache;
     unique_ptr<CPubseqGatewayCacheBlobProp> m_BlobPropCache;
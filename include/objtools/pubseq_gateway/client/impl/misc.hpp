@@ -346,6 +346,12 @@ typedef NCBI_PARAM_TYPE(PSG, stats) TPSG_Stats;
 NCBI_PARAM_DECL(double, PSG, stats_period);
 typedef NCBI_PARAM_TYPE(PSG, stats_period) TPSG_StatsPeriod;
 
+NCBI_PARAM_DECL(bool, PSG, coalesce_requests);
+typedef NCBI_PARAM_TYPE(PSG, coalesce_requests) TPSG_CoalesceRequests;
+
+NCBI_PARAM_DECL(double, PSG, resolve_cache_ttl);
+typedef NCBI_PARAM_TYPE(PSG, resolve_cache_ttl) TPSG_ResolveCacheTtl;
+
 NCBI_PARAM_DECL(double, PSG, throttle_relaxation_period);
 using TPSG_ThrottlePeriod = NCBI_PARAM_TYPE(PSG, throttle_relaxation_period);
 
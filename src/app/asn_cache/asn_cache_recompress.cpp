@@ -0,0 +1,358 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Copy an ASN cache, re-packing all blobs of the main chunks with another
+ *   codec, optionally training a zstd dictionary on a sample of the entries.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbienv.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbifile.hpp>
+#include <corelib/ncbitime.hpp>
+
+#include <objtools/data_loaders/asn_cache/Cache_blob.hpp>
+#include <objtools/data_loaders/asn_cache/asn_index.hpp>
+#include <objtools/data_loaders/asn_cache/chunk_file.hpp>
+#include <objtools/data_loaders/asn_cache/file_names.hpp>
+#include <db/bdb/bdb_cursor.hpp>
+
+#include <random>
+
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  CAsnCacheRecompressApp::
+
+
+class CAsnCacheRecompressApp : public CNcbiApplication
+{
+private:
+    virtual void Init(void);
+    virtual int  Run(void);
+    virtual void Exit(void);
+
+    void x_ReadBlob(const CAsnIndex& index, CCache_blob& blob);
+    void x_TrainDictionary(const string& dict_path,
+                           size_t sample_count, size_t dict_size);
+
+    string     m_InputPath;
+    CAsnIndex  m_InputIndex;
+    CChunkFile m_InputChunk;
+    unsigned   m_InputChunkNum;
+
+public:
+    CAsnCacheRecompressApp()
+        : m_InputIndex(CAsnIndex::e_main)
+        , m_InputChunkNum(0)
+    {
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  Init test for all different types of arguments
+
+
+void CAsnCacheRecompressApp::Init(void)
+{
+    // Create command-line argument descriptions class
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+
+    // Specify USAGE context
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "Re-pack blobs of an ASN cache");
+
+    arg_desc->AddKey("i", "InputCache",
+                     "Source cache directory",
+                     CArgDescriptions::eInputFile);
+
+    arg_desc->AddKey("o", "OutputCache",
+                     "Destination cache directory; must not exist",
+                     CArgDescriptions::eOutputFile);
+
+    arg_desc->AddDefaultKey("codec", "Codec",
+                            "Compression of the re-packed blobs",
+                            CArgDescriptions::eString, "zstd");
+    arg_desc->SetConstraint("codec",
+                            &(*new CArgAllow_Strings, "zlib", "zstd"));
+
+    arg_desc->AddOptionalKey("dictionary", "Dictionary",
+                             "Existing zstd dictionary to compress with",
+                             CArgDescriptions::eInputFile);
+
+    arg_desc->AddOptionalKey("train", "SampleCount",
+                             "Train a zstd dictionary on a random sample of "
+                             "this many entries of the source cache",
+                             CArgDescriptions::eInteger);
+    arg_desc->SetConstraint("train", new CArgAllow_Integers(1, kMax_Int));
+    arg_desc->SetDependency("train",
+                            CArgDescriptions::eExcludes, "dictionary");
+
+    arg_desc->AddDefaultKey("dict-size", "DictionarySize",
+                            "Size of the trained dictionary",
+                            CArgDescriptions::eInteger,
+                            NStr::NumericToString(
+                                CCache_blob::kDefaultDictionarySize));
+    arg_desc->SetConstraint("dict-size",
+                            new CArgAllow_Integers(1024, kMax_Int));
+
+    // Setup arg.descriptions for this application
+    arg_desc->SetCurrentGroup("Default application arguments");
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+void CAsnCacheRecompressApp::x_ReadBlob(const CAsnIndex& index,
+                                        CCache_blob& blob)
+{
+    if (index.GetChunkId() != m_InputChunkNum) {
+        m_InputChunkNum = index.GetChunkId();
+        m_InputChunk.OpenForRead(m_InputPath, m_InputChunkNum);
+    }
+    m_InputChunk.Read(blob, index.GetOffset(), index.GetSize());
+}
+
+
+void CAsnCacheRecompressApp::x_TrainDictionary(const string& dict_path,
+                                               size_t sample_count,
+                                               size_t dict_size)
+{
+    /// Reservoir sample of the blob locations; several index entries
+    /// may share a blob, which slightly favors such blobs
+    typedef pair<CAsnIndex::TChunkId, CAsnIndex::TOffset> TBlobPos;
+    vector<TBlobPos> positions;
+    vector<CAsnIndex::TSize> sizes;
+    mt19937 rng;
+
+    size_t count = 0;
+    {{
+         CBDB_FileCursor cursor(m_InputIndex);
+         cursor.InitMultiFetch(1 * 1024 * 1024);
+         for ( ;  cursor.Fetch() == eBDB_Ok;  ++count) {
+             TBlobPos pos(m_InputIndex.GetChunkId(),
+                          m_InputIndex.GetOffset());
+             if (positions.size() < sample_count) {
+                 positions.push_back(pos);
+                 sizes.push_back(m_InputIndex.GetSize());
+             } else {
+                 size_t i = uniform_int_distribution<size_t>(0, count)(rng);
+                 if (i < sample_count) {
+                     positions[i] = pos;
+                     sizes[i] = m_InputIndex.GetSize();
+                 }
+             }
+         }
+     }}
+
+    /// Read the sample in file order
+    vector<size_t> order(positions.size());
+    for (size_t i = 0;  i < order.size();  ++i) {
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(),
+         [&positions](size_t a, size_t b)
+         { return positions[a] < positions[b]; });
+
+    vector< vector<unsigned char> > samples;
+    samples.reserve(order.size());
+    ITERATE (vector<size_t>, it, order) {
+        const TBlobPos& pos = positions[*it];
+        if (pos.first != m_InputChunkNum) {
+            m_InputChunkNum = pos.first;
+            m_InputChunk.OpenForRead(m_InputPath, m_InputChunkNum);
+        }
+        CCache_blob blob;
+        m_InputChunk.Read(blob, pos.second, sizes[*it]);
+        samples.push_back(vector<unsigned char>());
+        blob.UnPack(samples.back());
+    }
+
+    LOG_POST(Error << "training dictionary on " << samples.size()
+             << " of " << count << " entries");
+    CCache_blob::TrainDictionary(samples, dict_path, dict_size);
+}
+
+
+int CAsnCacheRecompressApp::Run(void)
+{
+    // Get arguments
+    const CArgs& args = GetArgs();
+
+    m_InputPath = args["i"].AsString();
+    string output_path = args["o"].AsString();
+    CCache_blob::ECodec codec = args["codec"].AsString() == "zlib"
+        ? CCache_blob::eCodec_Zlib : CCache_blob::eCodec_Zstd;
+
+    CDir output_dir(output_path);
+    if (output_dir.Exists()) {
+        NCBI_THROW(CException, eUnknown,
+                   "Output cache " + output_path + " already exists");
+    }
+    output_dir.CreatePath();
+
+    string input_dict = NASNCacheFileName::GetZstdDictionary(m_InputPath);
+    if (CFile(input_dict).Exists()) {
+        CCache_blob::LoadDictionary(input_dict);
+    }
+
+    m_InputIndex.Open(NASNCacheFileName::GetBDBIndex(m_InputPath,
+                                                     CAsnIndex::e_main),
+                      CBDB_RawFile::eReadOnly);
+
+    Uint4 dict_id = 0;
+    if (codec == CCache_blob::eCodec_Zstd) {
+        string output_dict = NASNCacheFileName::GetZstdDictionary(output_path);
+        if (args["train"]) {
+            x_TrainDictionary(output_dict,
+                              args["train"].AsInteger(),
+                              args["dict-size"].AsInteger());
+        } else if (args["dictionary"]) {
+            CFile(args["dictionary"].AsString()).Copy(output_dict);
+        }
+        if (CFile(output_dict).Exists()) {
+            dict_id = CCache_blob::LoadDictionary(output_dict);
+        }
+    }
+
+    /// The seq-id index and chunk do not hold packed blobs
+    CFile(NASNCacheFileName::GetBDBIndex(m_InputPath, CAsnIndex::e_seq_id))
+        .Copy(NASNCacheFileName::GetBDBIndex(output_path,
+                                             CAsnIndex::e_seq_id));
+    CFile(NASNCacheFileName::GetSeqIdChunk(m_InputPath))
+        .Copy(NASNCacheFileName::GetSeqIdChunk(output_path));
+
+    CAsnIndex output(CAsnIndex::e_main);
+    output.SetCacheSize(256 * 1024 * 1024);
+    output.Open(NASNCacheFileName::GetBDBIndex(output_path, CAsnIndex::e_main),
+                CBDB_RawFile::eReadWriteCreate);
+    CChunkFile output_chunk;
+
+    /// All Bioseqs of an entry share its blob; re-pack it once.  The index
+    /// is walked once per input chunk, so only the blobs of that chunk are
+    /// remembered at a time.
+    typedef pair<CAsnIndex::TChunkId, CAsnIndex::TOffset> TBlobPos;
+    typedef pair<TBlobPos, CAsnIndex::TSize> TNewBlob;
+    typedef map<CAsnIndex::TOffset, TNewBlob> TRepacked;
+
+    CStopWatch sw;
+    sw.Start();
+    size_t count = 0, blob_count = 0;
+    Uint8 input_size = 0, output_size = 0;
+    unsigned last_chunk = CChunkFile::s_FindLastChunk(m_InputPath);
+    for (unsigned chunk = 1;  chunk <= last_chunk;  ++chunk) {
+        if ( !CFile(CChunkFile::s_MakeChunkFileName(m_InputPath, chunk))
+             .Exists() ) {
+            continue;
+        }
+        TRepacked repacked;
+        CBDB_FileCursor cursor(m_InputIndex);
+        cursor.InitMultiFetch(1 * 1024 * 1024);
+        while (cursor.Fetch() == eBDB_Ok) {
+            if (m_InputIndex.GetChunkId() != chunk) {
+                continue;
+            }
+            TRepacked::iterator it =
+                repacked.find(m_InputIndex.GetOffset());
+            if (it == repacked.end()) {
+                CCache_blob blob;
+                x_ReadBlob(m_InputIndex, blob);
+                vector<unsigned char> raw;
+                blob.UnPack(raw);
+
+                CCache_blob new_blob;
+                new_blob.SetTimestamp(blob.GetTimestamp());
+                new_blob.PackRaw(raw, codec, dict_id);
+
+                output_chunk.OpenForWrite(output_path);
+                TBlobPos new_pos(output_chunk.GetChunkSerialNum(),
+                                 output_chunk.GetOffset());
+                output_chunk.Write(new_blob);
+                CAsnIndex::TSize new_size =
+                    CAsnIndex::TSize(output_chunk.GetOffset() -
+                                     new_pos.second);
+                it = repacked.insert(make_pair(m_InputIndex.GetOffset(),
+                                               TNewBlob(new_pos, new_size)))
+                    .first;
+
+                input_size += m_InputIndex.GetSize();
+                output_size += new_size;
+            }
+
+            output.SetSeqId     (m_InputIndex.GetSeqId());
+            output.SetVersion   (m_InputIndex.GetVersion());
+            output.SetGi        (m_InputIndex.GetGi());
+            output.SetTimestamp (m_InputIndex.GetTimestamp());
+            output.SetChunkId   (it->second.first.first);
+            output.SetOffset    (it->second.first.second);
+            output.SetSize      (it->second.second);
+            output.SetSeqLength (m_InputIndex.GetSeqLength());
+            output.SetTaxId     (m_InputIndex.GetTaxId());
+            if (output.Insert() != eBDB_Ok) {
+                NCBI_THROW(CException, eUnknown,
+                           "failed to add item to index");
+            }
+
+            if (++count % 10000 == 0) {
+                LOG_POST(Error << "  re-packed " << count << " items in "
+                         << sw.Elapsed() << " seconds");
+            }
+        }
+        blob_count += repacked.size();
+    }
+    LOG_POST(Error << "done, re-packed " << count << " items ("
+             << blob_count << " blobs) in " << sw.Elapsed()
+             << " seconds; " << input_size << " -> " << output_size
+             << " bytes");
+
+    return 0;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  Cleanup
+
+
+void CAsnCacheRecompressApp::Exit(void)
+{
+    SetDiagStream(0);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  MAIN
+
+
+int main(int argc, const char* argv[])
+{
+    // Execute main application function
+    return CAsnCacheRecompressApp().AppMain(argc, argv);
+}
@@ -36,6 +36,7 @@
 #include <corelib/ncbifile.hpp>
 
 #include <objtools/data_loaders/asn_cache/asn_index.hpp>
+#include <objtools/data_loaders/asn_cache/asn_sorted_index.hpp>
 #include <db/bdb/bdb_cursor.hpp>
 
 
@@ -83,6 +84,11 @@ void CCacheIndexCopyApp::Init(void)
                               "main",
                               "seq-id"));
 
+    arg_desc->AddFlag("sorted",
+                      "Write the main index as a sorted memory-mapped file, "
+                      "which the cache uses instead of the BDB index if it "
+                      "is named asn_cache.sidx and is in the cache directory");
+
     // Setup arg.descriptions for this application
     arg_desc->SetCurrentGroup("Default application arguments");
     SetupArgDescriptions(arg_desc.release());
@@ -109,6 +115,19 @@ int CCacheIndexCopyApp::Run(void)
     CAsnIndex input(index_type);
     input.Open(input_file, CBDB_RawFile::eReadOnly);
 
+    if (args["sorted"]) {
+        if (index_type != CAsnIndex::e_main) {
+            NCBI_THROW(CException, eUnknown,
+                       "Only the main index can be written as sorted");
+        }
+        CStopWatch sw(CStopWatch::eStart);
+        CAsnSortedIndex::Build(input, output_file);
+        CAsnSortedIndex output(output_file);
+        LOG_POST(Error << "done, wrote " << output.GetSize()
+                 << " items in " << sw.Elapsed() << " seconds");
+        return 0;
+    }
+
     CFile(output_file).Remove();
     CAsnIndex output(index_type);
     output.SetCacheSize(256 * 1024);
@@ -75,11 +75,14 @@
 #include <objtools/data_loaders/asn_cache/Cache_blob.hpp>
 #include <objtools/data_loaders/asn_cache/asn_index.hpp>
 #include <objtools/data_loaders/asn_cache/chunk_file.hpp>
+#include <objtools/data_loaders/asn_cache/parallel_chunk_writer.hpp>
 #include <objtools/data_loaders/asn_cache/seq_id_chunk_file.hpp>
 #include <objtools/data_loaders/asn_cache/asn_cache_util.hpp>
 
 #include <objtools/data_loaders/genbank/gbloader.hpp>
 
+#include <mutex>
+
 USING_NCBI_SCOPE;
 USING_SCOPE(objects);
 
@@ -150,6 +153,10 @@ public:
         , m_Genome (CBioSource::eGenome_unknown)
         , m_ExtractDelta(false)
         , m_MaxDeltaLevel(UINT_MAX)
+        , m_SeqIdsOstr(0)
+        , m_UnflushedCount(0)
+        , m_Codec(CCache_blob::eCodec_Zlib)
+        , m_Dictionary(0)
     {
     }
     
@@ -185,6 +192,14 @@ private:
                            CAsnIndex::TChunkId chunk_id,
                            CAsnIndex::TOffset offset,
                            CAsnIndex::TSize size);
+
+    // x_WriteEntry: pack the entry, append it to the main chunk and index
+    // it; with -threads it's done on the writer threads, and the index is
+    // updated in batches by x_FlushIndex()
+    void x_WriteEntry(const CSeq_entry& entry,
+                      CAsnIndex::TTimestamp timestamp);
+    void x_AddCachedIds(const CSeq_entry& entry);
+    void x_FlushIndex();
    
     bool x_StripSeqEntry(CScope& scope, CSeq_entry& entry, set<CSeq_id_Handle>& trimmed_bioseqs);
 
@@ -239,6 +254,21 @@ private: // data
     set<CSeq_id_Handle> m_CachedIds;
     set<CSeq_id_Handle> m_PreviousExecutionIds;
     set<string> m_PreviousExecutionRuns;
+
+    // compression of the blobs
+    CCache_blob::ECodec m_Codec;
+    Uint4 m_Dictionary;
+
+    // parallel mode
+    unique_ptr<CParallelChunkWriter> m_Writer;
+    std::mutex m_IndexMutex;
+    vector<CAsnIndex::SIndexInfo> m_PendingMainIndex;
+    vector<CAsnIndex::SIndexInfo> m_PendingSeqIdIndex;
+    // ids are reported only after their entries are indexed, so that
+    // -resume doesn't skip entries lost with an unflushed batch
+    CNcbiOstrstream m_PendingSeqIds;
+    CNcbiOstream* m_SeqIdsOstr;
+    size_t m_UnflushedCount;
 };
 
 template <typename T, typename Consumer>
@@ -390,6 +420,28 @@ void CPrimeCacheApplication::Init(void)
     arg_desc->SetDependency("delta-level",
                             CArgDescriptions::eRequires, "extract-delta");
 
+    arg_desc->AddOptionalKey("codec", "Codec",
+                             "Compression of the cached blobs; "
+                             "zlib by default, readable by all versions",
+                             CArgDescriptions::eString);
+    arg_desc->SetConstraint("codec",
+                            &(*new CArgAllow_Strings, "zlib", "zstd"));
+
+    arg_desc->AddOptionalKey("dictionary", "Dictionary",
+                             "zstd dictionary to compress the blobs with; "
+                             "it's copied into the cache",
+                             CArgDescriptions::eInputFile);
+    arg_desc->SetDependency("dictionary",
+                            CArgDescriptions::eRequires, "codec");
+
+    arg_desc->AddDefaultKey("threads", "Threads",
+                            "Number of threads packing and writing the "
+                            "entries; with more than one, each writes its "
+                            "own chunk files and the index is updated in "
+                            "batches",
+                            CArgDescriptions::eInteger, "1");
+    arg_desc->SetConstraint("threads", new CArgAllow_Integers(1, 256));
+
     arg_desc->AddFlag("resume", "Resume interrupted previous execution");
 
     arg_desc->AddFlag("non-exclusive",
@@ -416,6 +468,14 @@ void CPrimeCacheApplication::x_ExtractAndIndex(const CSeq_entry&      entry,
                  entry.GetSet().GetSeq_set()) {
             x_ExtractAndIndex(**iter, timestamp, chunk_id, offset, size);
         }
+    } else if (entry.IsSeq() && m_Writer) {
+        /// Called by a writer thread with m_IndexMutex locked
+        const objects::CBioseq& bioseq = entry.GetSeq();
+        IndexABioseq( bioseq, m_PendingMainIndex, timestamp, chunk_id, offset, size );
+        Int8 seq_id_offset = m_SeqIdChunk.GetOffset();
+        m_SeqIdChunk.Write( bioseq.GetId() );
+        IndexABioseq( bioseq, m_PendingSeqIdIndex, timestamp, 0,
+                      seq_id_offset, m_SeqIdChunk.GetOffset() - seq_id_offset );
     } else if (entry.IsSeq()) {
         const objects::CBioseq& bioseq = entry.GetSeq();
         IndexABioseq( bioseq, m_MainIndex, timestamp, chunk_id, offset, size );
@@ -429,6 +489,69 @@ void CPrimeCacheApplication::x_ExtractAndIndex(const CSeq_entry&      entry,
     }
 }
 
+void CPrimeCacheApplication::x_AddCachedIds(const CSeq_entry& entry)
+{
+    if (entry.IsSet()) {
+        ITERATE (CSeq_entry::TSet::TSeq_set, iter,
+                 entry.GetSet().GetSeq_set()) {
+            x_AddCachedIds(**iter);
+        }
+    } else if (entry.IsSeq()) {
+        ITERATE (CBioseq::TId, id_it, entry.GetSeq().GetId()) {
+            m_CachedIds.insert(CSeq_id_Handle::GetHandle(**id_it));
+        }
+    }
+}
+
+void CPrimeCacheApplication::x_WriteEntry(const CSeq_entry&      entry,
+                                          CAsnIndex::TTimestamp  timestamp)
+{
+    if (m_Writer) {
+        x_AddCachedIds(entry);
+        m_Writer->Write(CConstRef<CSeq_entry>(&entry), timestamp);
+        if (++m_UnflushedCount >= 1000000) {
+            x_FlushIndex();
+        }
+        return;
+    }
+
+    CCache_blob blob;
+    blob.SetTimestamp(timestamp);
+    blob.Pack(entry, m_Codec, m_Dictionary);
+
+    m_MainChunk.OpenForWrite(m_CachePath);
+    size_t offset = m_MainChunk.GetOffset();
+    m_MainChunk.Write(blob);
+    size_t size = m_MainChunk.GetOffset() - offset;
+    Uint4 chunk_id = m_MainChunk.GetChunkSerialNum();
+
+    x_ExtractAndIndex(entry, timestamp, chunk_id, offset, size);
+}
+
+void CPrimeCacheApplication::x_FlushIndex()
+{
+    if ( !m_Writer ) {
+        return;
+    }
+    m_Writer->Wait();
+    m_Writer->ReportProgress();
+
+    CStopWatch sw(CStopWatch::eStart);
+    size_t count = m_PendingMainIndex.size();
+    InsertIndexEntries(m_MainIndex, m_PendingMainIndex);
+    InsertIndexEntries(m_SeqIdIndex, m_PendingSeqIdIndex);
+    m_PendingMainIndex.clear();
+    m_PendingSeqIdIndex.clear();
+    LOG_POST(Error << "  indexed " << count << " ids in "
+             << sw.Elapsed() << " seconds");
+
+    *m_SeqIdsOstr << CNcbiOstrstreamToString(m_PendingSeqIds);
+    m_SeqIdsOstr->flush();
+    m_PendingSeqIds.str(kEmptyStr);
+    m_PendingSeqIds.clear();
+    m_UnflushedCount = 0;
+}
+
 void CPrimeCacheApplication::x_UpsertDescriptor(list<CRef<CSeqdesc> >& descs, CRef<CSeqdesc> new_desc)
 {
     bool updated = false;
@@ -588,18 +711,8 @@ void CPrimeCacheApplication::x_Process_Fasta(CNcbiIstream& istr,
         if (entry->IsSetDescr() && entry->GetDescr().Get().empty()) {
             entry->SetSeq().ResetDescr();
         }
-        CCache_blob blob;
-        blob.SetTimestamp(timestamp);
-        blob.Pack(*entry);
-
-        m_MainChunk.OpenForWrite(m_CachePath);
-        size_t offset = m_MainChunk.GetOffset();
-        m_MainChunk.Write(blob);
-        size_t size = m_MainChunk.GetOffset() - offset;
-        Uint4 chunk_id = m_MainChunk.GetChunkSerialNum();
-
         entry->Parentize();
-        x_ExtractAndIndex(*entry, timestamp, chunk_id, offset, size);
+        x_WriteEntry(*entry, timestamp);
 
         ostr_seqids << idh << endl;
 
@@ -663,18 +776,8 @@ void CPrimeCacheApplication::x_Process_SRA(CNcbiIstream& istr,
                            "trapped signal, exiting");
             }
 
-            CCache_blob blob;
-            blob.SetTimestamp(timestamp);
-            blob.Pack(*entry);
-
-            m_MainChunk.OpenForWrite(m_CachePath);
-            size_t offset = m_MainChunk.GetOffset();
-            m_MainChunk.Write(blob);
-            size_t size = m_MainChunk.GetOffset() - offset;
-            Uint4 chunk_id = m_MainChunk.GetChunkSerialNum();
-
             entry->Parentize();
-            x_ExtractAndIndex(*entry, timestamp, chunk_id, offset, size);
+            x_WriteEntry(*entry, timestamp);
             ostr_seqids << idh << endl;
 
             // extract canonical IDs
@@ -764,18 +867,8 @@ void CPrimeCacheApplication::x_CacheSeqEntry(CNcbiIstream& istr,
             }
         }
 
-        CCache_blob blob;
-        blob.SetTimestamp(timestamp);
-        blob.Pack(*entry);
-
-        m_MainChunk.OpenForWrite(m_CachePath);
-        size_t offset = m_MainChunk.GetOffset();
-        m_MainChunk.Write(blob);
-        size_t size = m_MainChunk.GetOffset() - offset;
-        Uint4 chunk_id = m_MainChunk.GetChunkSerialNum();
-
         entry->Parentize();
-        x_ExtractAndIndex(*entry, timestamp, chunk_id, offset, size);
+        x_WriteEntry(*entry, timestamp);
 
         // extract canonical IDs
         // note that we do this in a private scope and use no data loaders
@@ -848,17 +941,7 @@ void CPrimeCacheApplication::x_Process_Ids(const set<CSeq_id_Handle> &ids,
             }
         }
 
-        CCache_blob blob;
-        blob.SetTimestamp(timestamp);
-        blob.Pack(*entry);
-
-        m_MainChunk.OpenForWrite(m_CachePath);
-        size_t offset = m_MainChunk.GetOffset();
-        m_MainChunk.Write(blob);
-        size_t size = m_MainChunk.GetOffset() - offset;
-        Uint4 chunk_id = m_MainChunk.GetChunkSerialNum();
-
-        x_ExtractAndIndex(*entry, timestamp, chunk_id, offset, size);
+        x_WriteEntry(*entry, timestamp);
 
         // extract canonical IDs
         for (CBioseq_CI bioseq_it(seh);  bioseq_it;  ++bioseq_it) {
@@ -940,7 +1023,15 @@ CPrimeCacheApplication::CCacheBioseq::CCacheBioseq(CPrimeCacheApplication* p,
 void CPrimeCacheApplication::CCacheBioseq::operator () (CBioseq & bioseq)
 {
     CRef<CSeq_entry> entry(new CSeq_entry);
-    entry->SetSeq(bioseq);
+    if (parent_->m_Writer) {
+        /// bioseq doesn't outlive this call, but the writer threads may
+        /// still need it
+        CRef<CBioseq> copy(new CBioseq);
+        copy->Assign(bioseq);
+        entry->SetSeq(*copy);
+    } else {
+        entry->SetSeq(bioseq);
+    }
     CScope scope(*om_);
     CSeq_entry_Handle seh = scope.AddTopLevelSeqEntry(*entry);
     // Trim seq-entry of annotations and instances of Bioseq of specified classes.
@@ -952,18 +1043,8 @@ void CPrimeCacheApplication::CCacheBioseq::operator () (CBioseq & bioseq)
         }
     }
 
-    CCache_blob blob;
-    blob.SetTimestamp(timestamp_);
-    blob.Pack(*entry);
-
-    parent_->m_MainChunk.OpenForWrite(parent_->m_CachePath);
-    size_t offset = parent_->m_MainChunk.GetOffset();
-    parent_->m_MainChunk.Write(blob);
-    size_t size = parent_->m_MainChunk.GetOffset() - offset;
-    Uint4 chunk_id = parent_->m_MainChunk.GetChunkSerialNum();
-
     entry->Parentize();
-    parent_->x_ExtractAndIndex(*entry, timestamp_, chunk_id, offset, size);
+    parent_->x_WriteEntry(*entry, timestamp_);
 
     // extract canonical IDs
     // note that we do this in a private scope and use no data loaders
@@ -1086,6 +1167,33 @@ int CPrimeCacheApplication::Run(void)
          }
          m_SeqIdChunk.OpenForWrite(m_CachePath);
 
+         if (args["codec"]  &&  args["codec"].AsString() == "zstd") {
+             m_Codec = CCache_blob::eCodec_Zstd;
+         }
+
+         /// The cache holds a single dictionary; when resuming, keep
+         /// compressing with the one already there
+         string dict_path = NASNCacheFileName::GetZstdDictionary(m_CachePath);
+         if (args["dictionary"]) {
+             if (m_Codec != CCache_blob::eCodec_Zstd) {
+                 NCBI_THROW(CException, eUnknown,
+                            "-dictionary requires -codec zstd");
+             }
+             CFile dict_file(dict_path);
+             if (dict_file.Exists()  &&  !args["resume"]) {
+                 NCBI_THROW(CException, eUnknown,
+                            "Cache " + m_CachePath +
+                            " already has a compression dictionary");
+             }
+             if ( !dict_file.Exists() ) {
+                 CFile(args["dictionary"].AsString()).Copy(dict_path);
+             }
+         }
+         if (m_Codec == CCache_blob::eCodec_Zstd  &&
+             CFile(dict_path).Exists()) {
+             m_Dictionary = CCache_blob::LoadDictionary(dict_path);
+         }
+
          m_MainIndex.SetCacheSize(1 * 1024 * 1024 * 1024);
          m_MainIndex.Open(NASNCacheFileName::GetBDBIndex(m_CachePath, CAsnIndex::e_main), CBDB_RawFile::eReadWriteCreate);
          m_SeqIdIndex.SetCacheSize(1 * 1024 * 1024 * 1024);
@@ -1115,6 +1223,21 @@ int CPrimeCacheApplication::Run(void)
     m_id_type = args["seq-id-type"].AsString() == "canonical"
               ? sequence::eGetId_Canonical : sequence::eGetId_Best;
 
+    if (args["threads"].AsInteger() > 1) {
+        m_Writer.reset(new CParallelChunkWriter(
+            m_CachePath, args["threads"].AsInteger(),
+            [this](const CSeq_entry& entry,
+                   const CParallelChunkWriter::SBlobLocation& location)
+            {
+                std::lock_guard<std::mutex> guard(m_IndexMutex);
+                x_ExtractAndIndex(entry, location.timestamp, location.chunk,
+                                  location.offset, location.size);
+            }));
+        m_Writer->SetCodec(m_Codec, m_Dictionary);
+        m_SeqIdsOstr = &ostr;
+    }
+    CNcbiOstream& ostr_seqids = m_Writer ? m_PendingSeqIds : ostr;
+
     if (args["strip-annots-and-inst-mol"]) {
         list<string> mol_types;
         NStr::Split(args["strip-annots-and-inst-mol"].AsString(), string(","), mol_types, 0);
@@ -1163,18 +1286,18 @@ int CPrimeCacheApplication::Run(void)
                 x_Read_Ids(is, ids);
             }
             else if (ifmt == "fasta") {
-                x_Process_Fasta(is, ostr);
+                x_Process_Fasta(is, ostr_seqids);
             }
 #ifdef HAVE_NCBI_VDB
             else if (ifmt == "csra") {
-                x_Process_SRA(is, ostr);
+                x_Process_SRA(is, ostr_seqids);
             }
 #endif
             else if (ifmt == "asn-seq-entry") {
-                x_Process_SeqEntry(is, ostr, eSerial_AsnText, ids, count);
+                x_Process_SeqEntry(is, ostr_seqids, eSerial_AsnText, ids, count);
             }
             else if (ifmt == "asnb-seq-entry") {
-                x_Process_SeqEntry(is, ostr, eSerial_AsnBinary, ids, count);
+                x_Process_SeqEntry(is, ostr_seqids, eSerial_AsnBinary, ids, count);
             }
             else {
                 NCBI_THROW(CException, eUnknown,
@@ -1188,18 +1311,18 @@ int CPrimeCacheApplication::Run(void)
             x_Read_Ids(istr, ids);
         }
         else if (ifmt == "fasta") {
-            x_Process_Fasta(istr, ostr);
+            x_Process_Fasta(istr, ostr_seqids);
         }
 #ifdef HAVE_NCBI_VDB
             else if (ifmt == "csra") {
-                x_Process_SRA(istr, ostr);
+                x_Process_SRA(istr, ostr_seqids);
             }
 #endif        
         else if (ifmt == "asn-seq-entry") {
-            x_Process_SeqEntry(istr, ostr, eSerial_AsnText, ids, count);
+            x_Process_SeqEntry(istr, ostr_seqids, eSerial_AsnText, ids, count);
         }
         else if (ifmt == "asnb-seq-entry") {
-            x_Process_SeqEntry(istr, ostr, eSerial_AsnBinary, ids, count);
+            x_Process_SeqEntry(istr, ostr_seqids, eSerial_AsnBinary, ids, count);
         }
         else {
             NCBI_THROW(CException, eUnknown,
@@ -1208,7 +1331,12 @@ int CPrimeCacheApplication::Run(void)
     }
 
     if (!ids.empty()) {
-        x_Process_Ids(ids, ostr, ifmt == "ids" ? 0 : 1, count);
+        x_Process_Ids(ids, ostr_seqids, ifmt == "ids" ? 0 : 1, count);
+    }
+
+    if (m_Writer) {
+        x_FlushIndex();
+        m_Writer.reset();
     }
 
     GetDiagContext().GetRequestContext().SetRequestStatus(200);
@@ -131,6 +131,7 @@ static Uint8    s_PeriodicSyncTimeout = 0;
 static Uint8    s_FailedSyncRetryDelay = 0;
 static Uint8    s_NetworkErrorTimeout = 0;
 static Uint8    s_MaxBlobSizeSync = 0;
+static Uint8    s_SyncBandwidthLimit = 0;
 static bool     s_WarnBlobSizeSync = true;
 static bool     s_BlobUpdateHotline = true;
 static bool     s_SlotByRawkey = false;
@@ -223,6 +224,8 @@ CNCDistributionConf::Initialize(Uint2 control_port)
         s_MaxBlobSizeSync = NStr::StringToUInt8_DataSize(reg.GetString(
                            kNCReg_NCPoolSection, "max_blob_size_sync", "1 GB"));
         s_WarnBlobSizeSync  =  reg.GetBool( kNCReg_NCPoolSection, "warn_blob_size_sync", true);
+        s_SyncBandwidthLimit = NStr::StringToUInt8_DataSize(reg.GetString(
+                           kNCReg_NCPoolSection, "sync_bandwidth_limit", "0"));
         if (s_MaxBlobSizeSync == 0) {
             s_WarnBlobSizeSync = false;
         }
@@ -574,6 +577,9 @@ void CNCDistributionConf::WriteSetup(CSrvSocketTask& task)
                                                    .WriteText(NStr::UInt8ToString_DataSize( s_MaxBlobSizeSync)).WriteText(eos);
     task.WriteText(eol).WriteText("max_blob_size_sync").WriteText(is ).WriteNumber( s_MaxBlobSizeSync);
     task.WriteText(eol).WriteText("warn_blob_size_sync").WriteText(is ).WriteBool(s_WarnBlobSizeSync);
+    task.WriteText(eol).WriteText("sync_bandwidth_limit").WriteText(str).WriteText(iss)
+                                                   .WriteText(NStr::UInt8ToString_DataSize( s_SyncBandwidthLimit)).WriteText(eos);
+    task.WriteText(eol).WriteText("sync_bandwidth_limit").WriteText(is ).WriteNumber( s_SyncBandwidthLimit);
     task.WriteText(eol).WriteText("blob_update_hotline").WriteText(is ).WriteBool(s_BlobUpdateHotline);
     task.WriteText(eol).WriteText("slot_calculation_by_rawkey").WriteText(is ).WriteBool(s_SlotByRawkey);
 }
@@ -1083,6 +1089,11 @@ CNCDistributionConf::GetMaxBlobSizeSync(void)
 {
     return s_MaxBlobSizeSync;
 }
+Uint8
+CNCDistributionConf::GetSyncBandwidthLimit(void)
+{
+    return s_SyncBandwidthLimit;
+}
 bool
  CNCDistributionConf::GetWarnBlobSizeSync(void)
  {
@@ -131,6 +131,8 @@ public:
     static Uint8 GetFailedSyncRetryDelay(void);
     static Uint8 GetNetworkErrorTimeout(void);
     static Uint8 GetMaxBlobSizeSync(void);
+    // Bytes per second of blob data moved by periodic sync, 0 means unlimited
+    static Uint8 GetSyncBandwidthLimit(void);
     static bool  GetWarnBlobSizeSync(void);
     static bool  GetBlobUpdateHotline(void);
 
@@ -1340,6 +1340,9 @@ static CNCMessageHandler::SCommandDef s_CommandMap[] = {
           // Type of statistics period to show. See top of nc_stat.cpp for
           // list of all possible period types.
           { "type",    eNSPT_Str,  eNSPA_Optional, "life" },
+          // Output format: "text" or "prometheus" (text exposition format,
+          // meaningful for the "life" type).
+          { "fmt",     eNSPT_Str,  eNSPA_Optional, "text" },
           // Client IP for application sending the command.
           { "ip",      eNSPT_Str,  fNSPA_Optional },
           // Session ID for application sending the command.
@@ -2032,6 +2035,8 @@ CNCMessageHandler::x_AssignCmdParams(void)
             case 'f':
                 if (key == "flags") {
                     m_UserFlags = NStr::StringToUInt(val);
+                } else if (key == "fmt") {
+                    m_StatFormat = val;
                 } else if (key == "fcr_ago_ge") {
                     m_BlobFilter->cr_ago_ge = NStr::StringToUInt8(val);
                 } else if (key == "fcr_ago_lt") {
@@ -4197,6 +4202,10 @@ CNCMessageHandler::x_DoCmd_GetStat(void)
         x_ReportError("ERR:Unknown statistics type: " + m_StatType);
         GetDiagCtx()->SetRequestStatus(eStatus_BadCmd);
     }
+    else if (m_StatFormat == "prometheus") {
+        stat->PrintToSocketPrometheus(this);
+        x_ReportOK("OK:END\n");
+    }
     else {
         stat->PrintToSocket(this);
         x_ReportOK("OK:END\n");
@@ -377,6 +377,7 @@ private:
     CNCActiveClientHub*       m_ActiveHub;
     string                    m_LastPeerError;
     string                    m_StatType;
+    string                    m_StatFormat;
     Uint8                     m_AgeMax;
     Uint8                     m_AgeCur;
     SNCBlobFilter*            m_BlobFilter;
@@ -0,0 +1,144 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Compression of blob data chunks stored in the database.
+ */
+
+#include <ncbi_pch.hpp>
+
+#include <util/compress/zlib.hpp>
+#include <util/compress/zstd.hpp>
+
+#include "nc_blob_packing.hpp"
+
+
+BEGIN_NCBI_SCOPE
+
+
+static CCompression*
+s_CreatePacker(Uint1 packing)
+{
+    switch (packing) {
+    case eNCPackZlib:
+        return new CZipCompression(CCompression::eLevel_Lowest);
+#if defined(HAVE_LIBZSTD)
+    case eNCPackZstd:
+        return new CZstdCompression();
+#endif
+    default:
+        return NULL;
+    }
+}
+
+const char*
+CNCBlobPacker::GetName(Uint1 packing)
+{
+    switch (packing) {
+    case eNCPackNone:
+        return "none";
+    case eNCPackZlib:
+        return "zlib";
+    case eNCPackZstd:
+        return "zstd";
+    default:
+        return "unknown";
+    }
+}
+
+bool
+CNCBlobPacker::IsSupported(Uint1 packing)
+{
+#if defined(HAVE_LIBZSTD)
+    return packing <= eNCPackZstd;
+#else
+    return packing <= eNCPackZlib;
+#endif
+}
+
+bool
+CNCBlobPacker::Pack(Uint1 packing,
+                    const char* data,
+                    Uint4 data_size,
+                    AutoArray<char>& packed,
+                    Uint4& packed_size)
+{
+    unique_ptr<CCompression> packer(s_CreatePacker(packing));
+    if (!packer)
+        return false;
+    size_t buf_size = packer->EstimateCompressionBufferSize(data_size);
+    packed.reset(new char[buf_size]);
+    size_t out_size = 0;
+    // Reader tells packed chunks by their size, so packed data of the same
+    // size as original can't be stored.
+    if (!packer->CompressBuffer(data, data_size, packed.get(), buf_size,
+                                &out_size)
+        ||  out_size >= data_size
+        ||  out_size > data_size - data_size / 8)
+    {
+        return false;
+    }
+    packed_size = Uint4(out_size);
+    return true;
+}
+
+bool
+CNCBlobPacker::Restore(Uint1 packing,
+                       const char* src,
+                       Uint4 src_size,
+                       char* dst,
+                       Uint4 dst_size,
+                       bool& unpacked)
+{
+    unpacked = false;
+    if (src_size == dst_size) {
+        memcpy(dst, src, dst_size);
+        return true;
+    }
+    if (!IsValidDataSize(packing, src_size, dst_size))
+        return false;
+
+    unique_ptr<CCompression> packer(s_CreatePacker(packing));
+    if (!packer)
+        return false;
+    size_t out_size = 0;
+    if (!packer->DecompressBuffer(src, src_size, dst, dst_size, &out_size)
+        ||  out_size != dst_size)
+    {
+        return false;
+    }
+    unpacked = true;
+    return true;
+}
+
+bool
+CNCBlobPacker::IsValidDataSize(Uint1 packing, Uint4 data_size, Uint4 need_size)
+{
+    // Packed chunk is always smaller than original
+    return data_size == need_size
+           ||  (packing != eNCPackNone  &&  data_size < need_size);
+}
+
+END_NCBI_SCOPE
@@ -0,0 +1,86 @@
+#ifndef NETCACHE__NC_BLOB_PACKING__HPP
+#define NETCACHE__NC_BLOB_PACKING__HPP
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Compression of blob data chunks stored in the database.
+ */
+
+#include <corelib/ncbistd.hpp>
+
+
+BEGIN_NCBI_SCOPE
+
+
+/// Compression of blob data chunks in the database. Each chunk is stored
+/// packed only if that makes it smaller, so a chunk with data size equal to
+/// its full size is always stored as is.
+enum ENCBlobPacking {
+    eNCPackNone = 0,
+    eNCPackZlib = 1,
+    eNCPackZstd = 2
+};
+
+
+/// Packing and unpacking of blob data chunks. It has no state and doesn't
+/// depend on the storage, only on util/compress.
+class CNCBlobPacker
+{
+public:
+    /// Name of the method as used in the config and in statistics
+    static const char* GetName(Uint1 packing);
+    /// Check if blob data packed with given method can be read by this
+    /// server. Blobs with other methods are dropped at startup.
+    static bool IsSupported(Uint1 packing);
+
+    /// Compress chunk of blob data. Compressed data is kept only if it's
+    /// at least 1/8 and at least 1 byte smaller than the original,
+    /// otherwise false is returned and the chunk should be stored as is.
+    static bool Pack(Uint1 packing,
+                     const char* data,
+                     Uint4 data_size,
+                     AutoArray<char>& packed,
+                     Uint4& packed_size);
+    /// Restore chunk data as read from the database into the buffer which
+    /// should receive exactly dst_size bytes: data of full size is copied,
+    /// shorter data is unpacked. Returns false if data is corrupted.
+    /// unpacked is set to true if data was decompressed.
+    static bool Restore(Uint1 packing,
+                        const char* src,
+                        Uint4 src_size,
+                        char* dst,
+                        Uint4 dst_size,
+                        bool& unpacked);
+    /// Check size of chunk data record met while reading the database
+    /// against the size the chunk should have.
+    static bool IsValidDataSize(Uint1 packing,
+                                Uint4 data_size,
+                                Uint4 need_size);
+};
+
+END_NCBI_SCOPE
+
+#endif /* NETCACHE__NC_BLOB_PACKING__HPP */
@@ -31,6 +31,7 @@
 
 #include "nc_utils.hpp"
 #include "memory_man.hpp"
+#include "nc_blob_packing.hpp"
 
 
 namespace intr = boost::intrusive;
@@ -114,6 +115,7 @@ public:
     Uint4   chunk_size;
     Uint2   map_size;
     Uint1   map_depth;
+    Uint1   packing;
     bool    has_error;
 
     bool    is_cur_version;
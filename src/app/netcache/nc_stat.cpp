@@ -253,6 +253,7 @@ CNCStat::x_ClearStats(void)
     m_CntFailedFiles = 0;
     m_CmdLens.Initialize();
     m_CmdsByName.clear();
+    m_CmdHists.clear();
     m_LensByStatus.clear();
     m_ConnCmds.Initialize();
     for (int i = 0; i < 40; ++i) {
@@ -327,6 +328,9 @@ CNCStat::x_AddStats(CNCStat* src_stat)
     ITERATE(TCmdCountsMap, it, src_stat->m_CmdsByName) {
         m_CmdsByName[it->first] += it->second;
     }
+    ITERATE(TCmdHistsMap, it, src_stat->m_CmdHists) {
+        m_CmdHists[it->first].AddValues(it->second);
+    }
     ITERATE(TStatusCmdLens, it_stat, src_stat->m_LensByStatus) {
         const TCmdLensMap& src_lens = it_stat->second;
         TCmdLensMap& dst_lens = m_LensByStatus[it_stat->first];
@@ -479,6 +483,7 @@ CNCStat::CmdFinished(const char* cmd, Uint8 len_usec, int status)
     TCmdLensMap& cmd_lens = stat->m_LensByStatus[status];
     TSrvTimeTerm& time_term = g_SrvTimeTerm(cmd_lens, cmd);
     time_term.AddValue(len_usec);
+    stat->m_CmdHists[cmd].AddValue(len_usec);
     stat->m_StatLock.Unlock();
 }
 
@@ -1104,6 +1109,69 @@ CNCStat::PrintToSocket(CSrvSocketTask* sock)
     m_StatLock.Unlock();
 }
 
+static const double kPrometheusQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+static void
+s_PrintPrometheusCounter(CSrvPrintProxy& proxy, const char* name,
+                         const char* help, Uint8 value)
+{
+    proxy << "# HELP " << name << " " << help << endl;
+    proxy << "# TYPE " << name << " counter" << endl;
+    proxy << name << " " << value << endl;
+}
+
+// Prints the statistics in the Prometheus text exposition format. The
+// counters are monotonic only for the "life" statistics type, the
+// other types give the values accumulated within the period.
+void
+CNCStat::PrintToSocketPrometheus(CSrvSocketTask* sock)
+{
+    m_StatLock.Lock();
+    CSrvPrintProxy proxy(sock);
+
+    proxy << "# NetCache statistics type " << m_StatName << endl;
+    s_PrintPrometheusCounter(proxy, "netcache_commands_started_total",
+                             "Number of the started commands",
+                             m_StartedCmds);
+    s_PrintPrometheusCounter(proxy, "netcache_client_read_bytes_total",
+                             "Data read from the clients", m_ClDataRead);
+    s_PrintPrometheusCounter(proxy, "netcache_client_written_bytes_total",
+                             "Data written to the clients", m_ClDataWrite);
+    s_PrintPrometheusCounter(proxy, "netcache_peer_read_bytes_total",
+                             "Data read from the peers", m_PeerDataRead);
+    s_PrintPrometheusCounter(proxy, "netcache_peer_written_bytes_total",
+                             "Data written to the peers", m_PeerDataWrite);
+    s_PrintPrometheusCounter(proxy, "netcache_disk_read_bytes_total",
+                             "Data read from the disk", m_DiskDataRead);
+    s_PrintPrometheusCounter(proxy, "netcache_disk_written_bytes_total",
+                             "Data written to the disk", m_DiskDataWrite);
+    s_PrintPrometheusCounter(proxy, "netcache_client_blob_writes_total",
+                             "Number of the blobs written by the clients",
+                             m_ClWrBlobs);
+    s_PrintPrometheusCounter(proxy, "netcache_client_blob_reads_total",
+                             "Number of the blobs read by the clients",
+                             m_ClRdBlobs);
+
+    const char* name = "netcache_command_duration_seconds";
+    proxy << "# HELP " << name << " Time of the commands execution" << endl;
+    proxy << "# TYPE " << name << " summary" << endl;
+    ITERATE(TCmdHistsMap, it, m_CmdHists) {
+        const CSrvTimeHistogram& hist = it->second;
+        for (size_t i = 0; i < ArraySize(kPrometheusQuantiles); ++i) {
+            Uint8 value = hist.GetPercentile(kPrometheusQuantiles[i]);
+            proxy << name << "{cmd=\"" << it->first << "\",quantile=\""
+                  << kPrometheusQuantiles[i] << "\"} "
+                  << double(value) / kUSecsPerSecond << endl;
+        }
+        proxy << name << "_sum{cmd=\"" << it->first << "\"} "
+              << double(hist.GetSum()) / kUSecsPerSecond << endl;
+        proxy << name << "_count{cmd=\"" << it->first << "\"} "
+              << hist.GetCount() << endl;
+    }
+
+    m_StatLock.Unlock();
+}
+
 void
 CNCStat::DumpAllStats(void)
 {
@@ -80,6 +80,7 @@ public:
     static Uint4 GetCntRunningCmds(void);
     static void DumpAllStats(void);
     void PrintToSocket(CSrvSocketTask* sock);
+    void PrintToSocketPrometheus(CSrvSocketTask* sock);
     void PrintState(CSrvSocketTask& sock);
 
     static void AddSyncServer(Uint8 srv_id);
@@ -116,6 +117,8 @@ public:
 
     typedef map<const char*, TSrvTimeTerm, SConstCharCompare>   TCmdLensMap;
     typedef map<const char*, Uint8, SConstCharCompare>          TCmdCountsMap;
+    typedef map<const char*, CSrvTimeHistogram,
+                SConstCharCompare>                              TCmdHistsMap;
     typedef map<int, TCmdLensMap>                               TStatusCmdLens;
 
 private:
@@ -159,6 +162,7 @@ private:
     Uint8 m_CntFailedFiles;
     TSrvTimeTerm m_CmdLens;
     TCmdCountsMap m_CmdsByName;
+    TCmdHistsMap m_CmdHists;
     TStatusCmdLens m_LensByStatus;
     CSrvStatTerm<Uint8> m_ConnCmds;
     CSrvStatTerm<Uint4> m_CheckedRecs;
@@ -44,6 +44,7 @@
 #include "logging.hpp"
 #include "peer_control.hpp"
 
+#include <unordered_map>
 
 #ifdef NCBI_OS_LINUX
 # include <sys/types.h>
@@ -68,6 +69,7 @@ static const char* kNCStorage_MetaFileSuffix  = "";
 static const char* kNCStorage_DataFileSuffix  = "";
 static const char* kNCStorage_MapsFileSuffix  = "";
 static const char* kNCStorage_IndexFileSuffix = ".index";
+static const char* kNCStorage_KeysFileSuffix  = ".keys";
 static const char* kNCStorage_StartedFileName = "__ncbi_netcache_started__";
 
 static const char* kNCStorage_RegSection        = "storage";
@@ -91,6 +93,8 @@ static const char* kNCStorage_MinRecNoSaveParam = "min_rec_no_save_period";
 static const char* kNCStorage_FailedWriteSize   = "failed_write_blob_key_count";
 static const char* kNCStorage_MaxBlobSizeStore  = "max_blob_size_store";
 static const char* kNCStorage_WbMemRelease      = "task_priority_wb_memrelease";
+static const char* kNCStorage_SaveKeysParam     = "save_keys_on_shutdown";
+static const char* kNCStorage_PackingParam      = "blob_compression";
 
 
 // storage file type signatures
@@ -271,6 +275,7 @@ static TAllCacheBuckets s_AllCache;
 
 static EStopCause s_IsStopWrite = eNoStop;
 static bool s_CleanStart = false;
+static bool s_SaveKeys = true;
 static bool s_NeedSaveLogRecNo = false;
 static bool s_NeedSavePurgeData = false;
 static int s_WarnLimitOnPct = 0;
@@ -284,6 +289,13 @@ static Int8 s_StopWriteOnSize = 0;
 static Int8 s_StopWriteOffSize = 0;
 static Int8 s_DiskFreeLimit = 0;
 static Int8 s_DiskCritical = 0;
+static Uint1 s_BlobPacking = eNCPackNone;
+/// Statistics of chunks compression since server start
+volatile static Int8 s_PackedChunks = 0;
+volatile static Int8 s_PackedRawSize = 0;
+volatile static Int8 s_PackedSize = 0;
+volatile static Int8 s_NotPackedChunks = 0;
+volatile static Int8 s_UnpackedChunks = 0;
 static Uint8 s_MaxBlobSizeStore = 0;
 static CNewFileCreator* s_NewFileCreator = nullptr;
 static CDiskFlusher* s_DiskFlusher = nullptr;
@@ -589,6 +601,29 @@ s_ReadVariableParams(const CNcbiRegistry& reg)
     SetWBWriteTimeout( CNCServer::IsInitiallySynced() ? to2 : to1, to2);
     SetWBFailedWriteDelay(reg.GetInt(kNCStorage_RegSection, "write_back_failed_delay", 2));
     s_TaskPriorityWbMemRelease = reg.GetInt(kNCStorage_RegSection, kNCStorage_WbMemRelease, 10);
+    s_SaveKeys = reg.GetBool(kNCStorage_RegSection, kNCStorage_SaveKeysParam, true);
+
+    string packing = reg.GetString(kNCStorage_RegSection, kNCStorage_PackingParam, "none");
+    if (NStr::EqualNocase(packing, "zlib")) {
+        s_BlobPacking = eNCPackZlib;
+    }
+    else if (NStr::EqualNocase(packing, "zstd")) {
+#if defined(HAVE_LIBZSTD)
+        s_BlobPacking = eNCPackZstd;
+#else
+        SRV_LOG(Error, "Parameter " << kNCStorage_PackingParam
+                       << " is set to zstd, but server is built without zstd."
+                       << " Using zlib instead.");
+        s_BlobPacking = eNCPackZlib;
+#endif
+    }
+    else {
+        if (!NStr::EqualNocase(packing, "none")) {
+            SRV_LOG(Error, "Unknown value of " << kNCStorage_PackingParam
+                           << ": '" << packing << "'. Blobs will not be compressed.");
+        }
+        s_BlobPacking = eNCPackNone;
+    }
 
     int failed_write = reg.GetInt(kNCStorage_RegSection, kNCStorage_FailedWriteSize, 0);
     CNCBlobAccessor::SetFailedWriteCount((Uint4)failed_write);
@@ -639,6 +674,16 @@ s_GetIndexFileName(void)
     return CDirEntry::CreateAbsolutePath(file_name);
 }
 
+/// Make name of the file with snapshot of blobs metadata saved at shutdown
+static string
+s_GetKeysFileName(void)
+{
+    string file_name(s_Prefix);
+    file_name += kNCStorage_KeysFileSuffix;
+    file_name = CDirEntry::MakePath(s_Path, file_name, kNCStorage_DBFileExt);
+    return CDirEntry::CreateAbsolutePath(file_name);
+}
+
 /// Make name of file with meta-information in given database part
 static string
 s_GetFileName(Uint4 file_id, ENCDBFileType file_type)
@@ -813,6 +858,7 @@ s_CleanDatabase(void)
 
     s_DBFiles->clear();
     s_IndexDB->DeleteAllDBFiles();
+    CFile(s_GetKeysFileName()).Remove();
 }
 
 /// Check if database need re-initialization depending on different
@@ -1047,6 +1093,21 @@ s_CalcChunkRecSize(size_t data_size)
     return Uint4((char*)&data_rec.chunk_data[data_size] - (char*)&data_rec);
 }
 
+/// Compress chunk of blob data and account it in statistics
+static bool
+s_PackChunk(Uint1 packing, const char* data, Uint4 data_size,
+            AutoArray<char>& packed, Uint4& packed_size)
+{
+    if (!CNCBlobPacker::Pack(packing, data, data_size, packed, packed_size)) {
+        AtomicAdd(s_NotPackedChunks, 1);
+        return false;
+    }
+    AtomicAdd(s_PackedChunks, 1);
+    AtomicAdd(s_PackedRawSize, data_size);
+    AtomicAdd(s_PackedSize, packed_size);
+    return true;
+}
+
 static char*
 s_CalcRecordAddress(SNCDBFileInfo* file_info, SFileIndexRec* ind_rec)
 {
@@ -1284,6 +1345,235 @@ SNCDBFileInfo::~SNCDBFileInfo(void)
 #endif
 }
 
+/// Keys snapshot is written at clean shutdown and lets the next start skip
+/// reading every meta record and blob map from the database files.
+/// Layout (native byte order):
+///   header | blobs (SKeysBlob + key) | files (SKeysFile + SNCKeysRec[]) | signature
+/// Records of each file are listed in the order of the file's index chain,
+/// blob_idx of records not belonging to any blob is kKeysNoBlob.
+static const Uint8 kKeysSignature = NCBI_CONST_UINT8(0x4e434b4559535331);
+static const Uint4 kKeysVersion = 1;
+static const Uint4 kKeysNoBlob = Uint4(-1);
+
+struct SKeysHeader
+{
+    Uint8   signature;
+    Uint4   version;
+    Uint4   cnt_files;
+    Uint8   cnt_blobs;
+};
+
+struct SKeysBlob
+{
+    Uint8   size;
+    Uint8   create_time;
+    Uint8   create_server;
+    Uint4   file_id;
+    Uint4   rec_num;
+    Uint4   create_id;
+    Int4    dead_time;
+    Int4    expire;
+    Int4    ver_expire;
+    Uint4   chunk_size;
+    Uint2   map_size;
+    Uint2   key_size;
+};
+
+struct SKeysFile
+{
+    Uint4   file_id;
+    Uint4   file_size;
+    Uint4   file_type;
+    Uint4   last_rec_num;
+    Uint4   cnt_recs;
+    Uint4   reserved;
+};
+
+typedef unordered_map<const SNCCacheData*, Uint4> TKeysBlobIdxMap;
+
+/// Check that all records of the blob's map tree are alive and point to
+/// the blob; count them.
+static bool
+s_CheckKeysTree(SNCDataCoord coord, Uint1 map_depth,
+                const SNCCacheData* cache_data, Uint8& cnt_recs)
+{
+    TNCDBFilesMap::const_iterator it_file = s_DBFiles->find(coord.file_id);
+    if (it_file == s_DBFiles->end())
+        return false;
+    SNCDBFileInfo* file_info = it_file->second.GetNCPointerOrNull();
+    SFileIndexRec* ind_rec = s_GetIndexRecTry(file_info, coord.rec_num);
+    if (!ind_rec  ||  ind_rec->cache_data != cache_data)
+        return false;
+    ++cnt_recs;
+    if (map_depth == 0)
+        return ind_rec->rec_type == eFileRecChunkData;
+    if (ind_rec->rec_type != eFileRecChunkMap)
+        return false;
+
+    SFileChunkMapRec* map_rec = s_CalcMapAddress(file_info, ind_rec);
+    Uint2 cnt_downs = s_CalcCntMapDowns(ind_rec->rec_size);
+    for (Uint2 i = 0; i < cnt_downs; ++i) {
+        if (!s_CheckKeysTree(map_rec->down_coords[i], map_depth - 1,
+                             cache_data, cnt_recs))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool
+s_WriteKeysSnapshot(CNcbiOstream& out)
+{
+    int cur_time = CSrvTime::CurSecs();
+    SKeysHeader header;
+    memset(&header, 0, sizeof(header));
+    header.signature = kKeysSignature;
+    header.version = kKeysVersion;
+    header.cnt_files = Uint4(s_DBFiles->size());
+    out.write((const char*)&header, sizeof(header));
+
+    TKeysBlobIdxMap blob_idxs;
+    Uint8 cnt_owned = 0;
+    ITERATE(TBucketCacheMap, it_bucket, s_BucketsCache) {
+        SBucketCache* bucket_cache = it_bucket->second;
+        CMiniMutexGuard guard(bucket_cache->lock);
+        ITERATE(TKeyMap, it, bucket_cache->key_map) {
+#if __NC_CACHEDATA_INTR_SET
+            const SNCCacheData* cache_data = &(*it);
+#else
+            const SNCCacheData* cache_data = *it;
+#endif
+            SNCDataCoord coord = cache_data->coord;
+            if (coord.empty())
+                continue;
+            TNCDBFilesMap::const_iterator it_file = s_DBFiles->find(coord.file_id);
+            if (it_file == s_DBFiles->end())
+                return false;
+            SNCDBFileInfo* file_info = it_file->second.GetNCPointerOrNull();
+            SFileIndexRec* ind_rec = s_GetIndexRecTry(file_info, coord.rec_num);
+            if (!ind_rec  ||  ind_rec->cache_data != cache_data)
+                return false;
+            SFileMetaRec* meta_rec = s_CalcMetaAddress(file_info, ind_rec);
+            if (meta_rec->dead_time <= cur_time)
+                continue;
+
+            if (meta_rec->size != 0) {
+                Uint1 map_depth = s_CalcMapDepthImpl(meta_rec->size,
+                                                     meta_rec->chunk_size,
+                                                     meta_rec->map_size);
+                if (map_depth > kNCMaxBlobMapsDepth
+                    ||  !s_CheckKeysTree(ind_rec->chain_coord, map_depth,
+                                         cache_data, cnt_owned))
+                {
+                    return false;
+                }
+            }
+            ++cnt_owned;
+
+            char* key_data = meta_rec->key_data;
+            char* key_end = (char*)meta_rec + ind_rec->rec_size;
+            if (meta_rec->has_password)
+                key_data += 16;
+            SKeysBlob blob;
+            memset(&blob, 0, sizeof(blob));
+            blob.size = meta_rec->size;
+            blob.create_time = meta_rec->create_time;
+            blob.create_server = meta_rec->create_server;
+            blob.file_id = coord.file_id;
+            blob.rec_num = coord.rec_num;
+            blob.create_id = meta_rec->create_id;
+            blob.dead_time = meta_rec->dead_time;
+            blob.expire = meta_rec->expire;
+            blob.ver_expire = meta_rec->ver_expire;
+            blob.chunk_size = meta_rec->chunk_size;
+            blob.map_size = meta_rec->map_size;
+            blob.key_size = Uint2(key_end - key_data);
+            out.write((const char*)&blob, sizeof(blob));
+            out.write(key_data, blob.key_size);
+
+            Uint4 blob_idx = Uint4(blob_idxs.size());
+            blob_idxs[cache_data] = blob_idx;
+        }
+    }
+    header.cnt_blobs = blob_idxs.size();
+
+    vector<SNCKeysRec> recs;
+    ITERATE(TNCDBFilesMap, it_file, (*s_DBFiles)) {
+        SNCDBFileInfo* file_info = it_file->second.GetNCPointerOrNull();
+        recs.clear();
+        SFileIndexRec* ind_rec = file_info->index_head;
+        char* min_ptr = file_info->file_map + kSignatureSize;
+        Uint4 prev_rec_num = 0;
+        while (ind_rec->next_num != 0) {
+            Uint4 rec_num = ind_rec->next_num;
+            SFileIndexRec* next_ind = file_info->index_head - rec_num;
+            if (rec_num <= prev_rec_num  ||  (char*)next_ind < min_ptr)
+                return false;
+            SNCKeysRec rec;
+            rec.rec_num = rec_num;
+            rec.blob_idx = kKeysNoBlob;
+            TKeysBlobIdxMap::const_iterator it_idx
+                                    = blob_idxs.find(next_ind->cache_data);
+            if (it_idx != blob_idxs.end()) {
+                rec.blob_idx = it_idx->second;
+                --cnt_owned;
+            }
+            recs.push_back(rec);
+            ind_rec = next_ind;
+            prev_rec_num = rec_num;
+        }
+
+        SKeysFile file;
+        memset(&file, 0, sizeof(file));
+        file.file_id = file_info->file_id;
+        file.file_size = file_info->file_size;
+        file.file_type = Uint4(file_info->file_type);
+        file.last_rec_num = prev_rec_num;
+        file.cnt_recs = Uint4(recs.size());
+        out.write((const char*)&file, sizeof(file));
+        if (!recs.empty()) {
+            out.write((const char*)&recs[0], recs.size() * sizeof(recs[0]));
+        }
+    }
+    // Every record found in blobs' trees should be in index chains and
+    // nothing else should reference live blobs.
+    if (cnt_owned != 0)
+        return false;
+
+    out.write((const char*)&kKeysSignature, sizeof(kKeysSignature));
+    out.seekp(0);
+    out.write((const char*)&header, sizeof(header));
+    out.flush();
+    return bool(out);
+}
+
+/// Save snapshot of all live blobs so that next start could avoid full
+/// scan of the database. Called at shutdown when nothing changes storage.
+static void
+s_SaveKeysSnapshot(void)
+{
+    string file_name = s_GetKeysFileName();
+    string tmp_name = file_name + ".tmp";
+    bool success;
+    {{
+        CNcbiOfstream out(tmp_name.c_str(), ios::binary | ios::trunc);
+        success = s_WriteKeysSnapshot(out);
+    }}
+    if (!success) {
+        SRV_LOG(Warning, "Cannot save keys snapshot to " << tmp_name
+                         << ", next start will read all database files.");
+        CFile(tmp_name).Remove();
+        return;
+    }
+    if (!CFile(tmp_name).Rename(file_name, CFile::fRF_Overwrite)) {
+        SRV_LOG(Warning, "Cannot rename " << tmp_name << " to " << file_name);
+        CFile(tmp_name).Remove();
+        return;
+    }
+    INFO("Saved keys snapshot to " << file_name);
+}
+
 bool
 CNCBlobStorage::Initialize(bool do_reinit)
 {
@@ -1342,6 +1632,8 @@ CNCBlobStorage::Initialize(bool do_reinit)
 void
 CNCBlobStorage::Finalize(void)
 {
+    if (s_SaveKeys  &&  !s_AbandonDB  &&  CNCServer::IsCachingComplete())
+        s_SaveKeysSnapshot();
     s_IndexDB.reset();
 
     s_UnlockInstanceGuard();
@@ -1395,6 +1687,8 @@ void CNCBlobStorage::WriteSetup(CSrvSocketTask& task)
     task.WriteText(eol).WriteText("write_back_failed_delay"   ).WriteText(is ).WriteNumber( GetWBFailedWriteDelay());
     task.WriteText(eol).WriteText(kNCStorage_WbMemRelease).WriteText(is).WriteNumber(s_TaskPriorityWbMemRelease);
     task.WriteText(eol).WriteText(kNCStorage_FailedWriteSize  ).WriteText(is ).WriteNumber( CNCBlobAccessor::GetFailedWriteCount());
+    task.WriteText(eol).WriteText(kNCStorage_SaveKeysParam    ).WriteText(is ).WriteText( s_SaveKeys ? "true" : "false");
+    task.WriteText(eol).WriteText(kNCStorage_PackingParam     ).WriteText(iss).WriteText( CNCBlobPacker::GetName(s_BlobPacking)).WriteText(eos);
 }
 
 void CNCBlobStorage::WriteEnvInfo(CSrvSocketTask& task)
@@ -1449,6 +1743,16 @@ void CNCBlobStorage::WriteBlobStat(CSrvSocketTask& task)
     task.WriteText(eol).WriteText("TimeTable_count").WriteText( is).WriteNumber( timetable_count);
     task.WriteText(eol).WriteText("Purge_count").WriteText( is).WriteNumber( CNCBlobAccessor::GetPurgeCount());
 
+    Int8 packed_raw = s_PackedRawSize, packed_size = s_PackedSize;
+    task.WriteText(eol).WriteText("Compression").WriteText(iss).WriteText(CNCBlobPacker::GetName(s_BlobPacking)).WriteText(eos);
+    task.WriteText(eol).WriteText("PackedChunks").WriteText( is).WriteNumber( s_PackedChunks);
+    task.WriteText(eol).WriteText("NotPackedChunks").WriteText( is).WriteNumber( s_NotPackedChunks);
+    task.WriteText(eol).WriteText("UnpackedChunks").WriteText( is).WriteNumber( s_UnpackedChunks);
+    task.WriteText(eol).WriteText("PackedRawSize").WriteText(iss).WriteText(NStr::UInt8ToString_DataSize(packed_raw)).WriteText(eos);
+    task.WriteText(eol).WriteText("PackedSize").WriteText(iss).WriteText(NStr::UInt8ToString_DataSize(packed_size)).WriteText(eos);
+    task.WriteText(eol).WriteText("PackRatio").WriteText(iss)
+        .WriteText(NStr::DoubleToString(packed_size != 0 ? double(packed_raw) / packed_size : 1.0, 2)).WriteText(eos);
+
 #if __NC_CACHEDATA_ALL_MONITOR
     size_t ncaches_count = 0;
     ITERATE(TAllCacheBuckets, tt, s_AllCache) {
@@ -2075,6 +2379,7 @@ CNCAlerts::Register(CNCAlerts::eDebugReadBlobInfoFailed2, "ReadBlobInfo: ind_rec
     ver_data->create_id = meta_rec->create_id;
     ver_data->create_server = meta_rec->create_server;
     ver_data->data_coord = ind_rec->chain_coord;
+    ver_data->packing = meta_rec->packing;
 
     ver_data->map_depth = s_CalcMapDepth(ver_data->size,
                                          ver_data->chunk_size,
@@ -2289,6 +2594,7 @@ cout << "WriteBlobInfo:" << " coord = " << meta_ind->chain_coord.file_id
     meta_rec->ver_expire = ver_data->ver_expire;
     meta_rec->map_size = ver_data->map_size;
     meta_rec->chunk_size = ver_data->chunk_size;
+    meta_rec->packing = ver_data->packing;
     char* key_data = meta_rec->key_data;
     if (ver_data->password.empty()) {
         meta_rec->has_password = 0;
@@ -2613,6 +2919,15 @@ CNCAlerts::Register(CNCAlerts::eDebugWriteChunkData1,"chunk number");
             maps->maps[i]->map_idx = map_idx[i + 1];
     }
 
+    AutoArray<char> packed;
+    Uint4 packed_size = 0;
+    if (ver_data->packing != eNCPackNone
+        &&  s_PackChunk(ver_data->packing, buffer, buf_size, packed, packed_size))
+    {
+        buffer = packed.get();
+        buf_size = packed_size;
+    }
+
     SNCDataCoord data_coord;
     CSrvRef<SNCDBFileInfo> data_file;
     SFileIndexRec* data_ind;
@@ -2638,6 +2953,21 @@ CNCAlerts::Register(CNCAlerts::eDebugWriteChunkData2,"s_GetNextWriteCoord");
     return (char*)data_rec->chunk_data;
 }
 
+bool
+CNCBlobStorage::RestoreChunkData(Uint1 packing,
+                                 const char* src,
+                                 Uint4 src_size,
+                                 char* dst,
+                                 Uint4 dst_size)
+{
+    bool unpacked = false;
+    if (!CNCBlobPacker::Restore(packing, src, src_size, dst, dst_size, unpacked))
+        return false;
+    if (unpacked)
+        AtomicAdd(s_UnpackedChunks, 1);
+    return true;
+}
+
 void
 CNCBlobStorage::ChangeCacheDeadTime(SNCCacheData* cache_data)
 {
@@ -2713,6 +3043,12 @@ CNCBlobStorage::GetMaxBlobSizeStore(void)
     return s_MaxBlobSizeStore;
 }
 
+Uint1
+CNCBlobStorage::GetBlobPacking(void)
+{
+    return s_BlobPacking;
+}
+
 Int8
 CNCBlobStorage::GetDiskFree(void)
 {
@@ -2952,6 +3288,7 @@ CBlobCacher::x_CacheMapRecs(SNCDataCoord map_coord,
                             SNCDataCoord up_coord,
                             Uint2 up_index,
                             SNCCacheData* cache_data,
+                            Uint1 packing,
                             Uint8 cnt_chunks,
                             Uint8& chunk_num,
                             map<Uint4, Uint4>& sizes_map)
@@ -3013,7 +3350,7 @@ CBlobCacher::x_CacheMapRecs(SNCDataCoord map_coord,
             need_size = cache_data->chunk_size;
         else
             need_size = (cache_data->size - 1) % cache_data->chunk_size + 1;
-        if (data_size != need_size) {
+        if (!CNCBlobPacker::IsValidDataSize(packing, data_size, need_size)) {
             SRV_LOG(Critical, "Blob " << cache_data->key
                               << " with size " << cache_data->size
                               << " references data record with coord " << map_coord
@@ -3050,7 +3387,7 @@ CBlobCacher::x_CacheMapRecs(SNCDataCoord map_coord,
         Uint2 cnt_downs = s_CalcCntMapDowns(map_ind->rec_size);
         for (Uint2 i = 0; i < cnt_downs; ++i) {
             if (!x_CacheMapRecs(map_rec->down_coords[i], map_depth - 1,
-                                map_coord, i, cache_data, cnt_chunks,
+                                map_coord, i, cache_data, packing, cnt_chunks,
                                 chunk_num, sizes_map))
             {
                 for (Uint2 j = 0; j < i; ++j) {
@@ -3099,6 +3436,13 @@ CBlobCacher::x_CacheMetaRec(SNCDBFileInfo* file_info,
     }
     if (meta_rec->dead_time <= CSrvTime::CurSecs())
         return false;
+    if (!CNCBlobPacker::IsSupported(meta_rec->packing)) {
+        SRV_LOG(Critical, "Meta record in file " << file_info->file_name
+                          << " at offset " << ind_rec->offset
+                          << " has unsupported compression " << int(meta_rec->packing)
+                          << ". Deleting it.");
+        return false;
+    }
 
     char* key_data = meta_rec->key_data;
     char* key_end = (char*)meta_rec + ind_rec->rec_size;
@@ -3167,6 +3511,7 @@ CBlobCacher::x_CacheMetaRec(SNCDBFileInfo* file_info,
         typedef map<Uint4, Uint4> TSizesMap;
         TSizesMap sizes_map;
         if (!x_CacheMapRecs(ind_rec->chain_coord, map_depth, coord, 0, cache_data,
+                            meta_rec->packing,
                             cnt_chunks, chunk_num, sizes_map))
         {
             delete cache_data;
@@ -3194,6 +3539,15 @@ CBlobCacher::x_CacheMetaRec(SNCDBFileInfo* file_info,
     file_info->garb_size -= rec_size;
     AtomicSub(s_GarbageSize, rec_size);
 
+    x_AddCacheData(cache_data, ind_rec->chain_coord);
+    return true;
+}
+
+void
+CBlobCacher::x_AddCacheData(SNCCacheData* cache_data, SNCDataCoord chain_coord)
+{
+    const string& key = cache_data->key;
+    Uint2 time_bucket = cache_data->time_bucket;
     TBucketCacheMap::iterator it_bucket = s_BucketsCache.lower_bound(time_bucket);
     SBucketCache* bucket_cache;
     if (it_bucket == s_BucketsCache.end()  ||  it_bucket->first != time_bucket) {
@@ -3247,7 +3601,7 @@ CBlobCacher::x_CacheMetaRec(SNCDBFileInfo* file_info,
             CSrvRef<SNCDBFileInfo> old_file = s_GetDBFileNoLock(old_data->coord.file_id);
             SFileIndexRec* old_ind = s_GetIndexRec(old_file, old_data->coord.rec_num);
             SFileMetaRec* old_rec = s_CalcMetaAddress(old_file, old_ind);
-            if (old_rec->size != 0  &&  old_ind->chain_coord != ind_rec->chain_coord && !old_ind->chain_coord.empty()) {
+            if (old_rec->size != 0  &&  old_ind->chain_coord != chain_coord && !old_ind->chain_coord.empty()) {
                 Uint1 map_depth = s_CalcMapDepth(old_rec->size,
                                                  old_rec->chunk_size,
                                                  old_rec->map_size);
@@ -3267,8 +3621,6 @@ CBlobCacher::x_CacheMetaRec(SNCDBFileInfo* file_info,
     s_AllCache[time_bucket]->all_cache_set.insert(cache_data);
 #endif
     ++s_CurBlobsCnt;
-
-    return true;
 }
 
 CBlobCacher::State
@@ -3502,10 +3854,253 @@ CBlobCacher::x_StartCaching(void)
     CSrvDiagMsg().StartRequest().PrintParam("_type", "caching");
 
     s_DBFilesLock.Lock();
+    if (x_LoadKeysSnapshot()) {
+        m_FromKeys = true;
+        m_CurKeysFile = m_KeysFiles.begin();
+        return &CBlobCacher::x_ApplyKeysFile;
+    }
     m_CurFile = s_DBFiles->begin();
     return &CBlobCacher::x_PreCacheRecNums;
 }
 
+bool
+CBlobCacher::x_ReadKeysSnapshot(CNcbiIstream& in)
+{
+    SKeysHeader header;
+    if (!in.read((char*)&header, sizeof(header))
+        ||  header.signature != kKeysSignature
+        ||  header.version != kKeysVersion
+        ||  header.cnt_files != s_DBFiles->size())
+    {
+        return false;
+    }
+
+    int cur_time = CSrvTime::CurSecs();
+    vector<SNCDataCoord> meta_coords;
+    string key;
+    for (Uint8 i = 0; i < header.cnt_blobs; ++i) {
+        SKeysBlob blob;
+        if (!in.read((char*)&blob, sizeof(blob))  ||  blob.key_size == 0)
+            return false;
+        key.resize(blob.key_size);
+        if (!in.read(&key[0], blob.key_size))
+            return false;
+        SNCDataCoord coord;
+        coord.file_id = blob.file_id;
+        coord.rec_num = blob.rec_num;
+        meta_coords.push_back(coord);
+
+        // Records of blobs that expired while server was down will be
+        // deleted as belonging to nobody.
+        Uint2 slot = 0, time_bucket = 0;
+        if (blob.dead_time <= cur_time
+            ||  !CNCDistributionConf::GetSlotByKey(key, slot, time_bucket))
+        {
+            m_KeysBlobs.push_back(NULL);
+            continue;
+        }
+        SNCCacheData* cache_data = new SNCCacheData();
+        cache_data->key = key;
+        cache_data->coord = coord;
+        cache_data->time_bucket = time_bucket;
+        cache_data->size = blob.size;
+        cache_data->chunk_size = blob.chunk_size;
+        cache_data->map_size = blob.map_size;
+        cache_data->create_time = blob.create_time;
+        cache_data->create_server = blob.create_server;
+        cache_data->create_id = blob.create_id;
+        cache_data->dead_time = blob.dead_time;
+        cache_data->saved_dead_time = blob.dead_time;
+        cache_data->expire = blob.expire;
+        cache_data->ver_expire = blob.ver_expire;
+        m_KeysBlobs.push_back(cache_data);
+    }
+
+    vector<Uint4> cnt_metas(m_KeysBlobs.size(), 0);
+    for (Uint4 i = 0; i < header.cnt_files; ++i) {
+        SKeysFile file;
+        if (!in.read((char*)&file, sizeof(file)))
+            return false;
+        TNCDBFilesMap::const_iterator it_file = s_DBFiles->find(file.file_id);
+        if (it_file == s_DBFiles->end())
+            return false;
+        SNCDBFileInfo* file_info = it_file->second.GetNCPointerOrNull();
+        if (file_info->file_size != file.file_size
+            ||  Uint4(file_info->file_type) != file.file_type
+            ||  file.cnt_recs > file.file_size / sizeof(SFileIndexRec)
+            ||  m_KeysFiles.find(file.file_id) != m_KeysFiles.end())
+        {
+            return false;
+        }
+        SNCKeysFile& keys_file = m_KeysFiles[file.file_id];
+        keys_file.last_rec_num = file.last_rec_num;
+        keys_file.recs.resize(file.cnt_recs);
+        if (file.cnt_recs != 0
+            &&  !in.read((char*)&keys_file.recs[0],
+                         file.cnt_recs * sizeof(SNCKeysRec)))
+        {
+            return false;
+        }
+
+        // Snapshot is usable only if index chain in the file is exactly
+        // the same as it was at the time of saving.
+        SFileIndexRec* ind_rec = file_info->index_head;
+        char* min_ptr = file_info->file_map + kSignatureSize;
+        ITERATE(vector<SNCKeysRec>, it, keys_file.recs) {
+            SFileIndexRec* next_ind = file_info->index_head - it->rec_num;
+            if (ind_rec->next_num != it->rec_num
+                ||  (char*)next_ind < min_ptr  ||  next_ind >= ind_rec)
+            {
+                return false;
+            }
+            if (it->blob_idx != kKeysNoBlob) {
+                if (it->blob_idx >= m_KeysBlobs.size())
+                    return false;
+                if (next_ind->rec_type == eFileRecMeta) {
+                    if (meta_coords[it->blob_idx].file_id != file.file_id
+                        ||  meta_coords[it->blob_idx].rec_num != it->rec_num)
+                    {
+                        return false;
+                    }
+                    ++cnt_metas[it->blob_idx];
+                }
+            }
+            ind_rec = next_ind;
+        }
+        if (ind_rec->next_num != 0
+            ||  Uint4(file_info->index_head - ind_rec) != file.last_rec_num)
+        {
+            return false;
+        }
+    }
+
+    Uint8 signature = 0;
+    if (!in.read((char*)&signature, sizeof(signature))
+        ||  signature != kKeysSignature)
+    {
+        return false;
+    }
+    ITERATE(vector<Uint4>, it, cnt_metas) {
+        if (*it != 1)
+            return false;
+    }
+    return true;
+}
+
+bool
+CBlobCacher::x_LoadKeysSnapshot(void)
+{
+    string file_name = s_GetKeysFileName();
+    CFile file(file_name);
+    if (!file.Exists())
+        return false;
+
+    bool success;
+    {{
+        CNcbiIfstream in(file_name.c_str(), ios::binary);
+        success = x_ReadKeysSnapshot(in);
+    }}
+    // Snapshot describes the database only until the first write into it
+    file.Remove();
+    if (!success) {
+        SRV_LOG(Warning, "Keys snapshot " << file_name
+                         << " doesn't match database files, ignoring it.");
+        x_ClearKeysSnapshot();
+        return false;
+    }
+    INFO("Loading " << m_KeysBlobs.size()
+         << " blobs from keys snapshot " << file_name);
+    return true;
+}
+
+void
+CBlobCacher::x_ClearKeysSnapshot(void)
+{
+    ITERATE(vector<SNCCacheData*>, it, m_KeysBlobs) {
+        delete *it;
+    }
+    m_KeysBlobs.clear();
+    m_KeysFiles.clear();
+}
+
+CBlobCacher::State
+CBlobCacher::x_ApplyKeysFile(void)
+{
+    if (CTaskServer::IsInShutdown())
+        return &CBlobCacher::x_CancelCaching;
+    if (m_CurKeysFile == m_KeysFiles.end()) {
+        m_CurKeysBlob = 0;
+        return &CBlobCacher::x_AddKeysBlobs;
+    }
+
+    CSrvRef<SNCDBFileInfo> file_info = s_GetDBFileNoLock(m_CurKeysFile->first);
+    const SNCKeysFile& keys_file = m_CurKeysFile->second;
+
+    // Sizes are accounted the same way as in x_PreCacheRecNums and
+    // x_CacheMetaRec.
+    AtomicAdd(s_CurDBSize,  file_info->file_size);
+    Uint4 garb_size = file_info->file_size
+                      - (kSignatureSize + sizeof(SFileIndexRec));
+    file_info->garb_size += garb_size;
+    AtomicAdd(s_GarbageSize,garb_size);
+
+    ITERATE(vector<SNCKeysRec>, it, keys_file.recs) {
+        SFileIndexRec* ind_rec = file_info->index_head - it->rec_num;
+        SNCCacheData* cache_data = NULL;
+        if (it->blob_idx != kKeysNoBlob)
+            cache_data = m_KeysBlobs[it->blob_idx];
+        if (!cache_data) {
+            s_DeleteIndexRec(file_info, ind_rec);
+            continue;
+        }
+        ind_rec->cache_data = cache_data;
+        Uint4 rec_size = ind_rec->rec_size;
+        if (rec_size & 7)
+            rec_size += 8 - (rec_size & 7);
+        rec_size += sizeof(SFileIndexRec);
+        file_info->used_size += rec_size;
+        if (file_info->garb_size < rec_size) {
+            SRV_FATAL("Blob coords broken");
+        }
+        file_info->garb_size -= rec_size;
+        AtomicSub(s_GarbageSize, rec_size);
+    }
+    s_LockFileMem(file_info->index_head - keys_file.last_rec_num,
+                  (keys_file.last_rec_num + 1) * sizeof(SFileIndexRec));
+
+// to next file
+    ++m_CurKeysFile;
+    SetRunnable();
+    return NULL;
+}
+
+CBlobCacher::State
+CBlobCacher::x_AddKeysBlobs(void)
+{
+    if (CTaskServer::IsInShutdown())
+        return &CBlobCacher::x_CancelCaching;
+
+    for (Uint4 i = 0; i < 1000  &&  m_CurKeysBlob < m_KeysBlobs.size(); ++i) {
+        SNCCacheData* cache_data = m_KeysBlobs[m_CurKeysBlob];
+        if (cache_data) {
+            CSrvRef<SNCDBFileInfo> file_info
+                                = s_GetDBFileNoLock(cache_data->coord.file_id);
+            SFileIndexRec* ind_rec = s_GetIndexRec(file_info,
+                                                   cache_data->coord.rec_num);
+            x_AddCacheData(cache_data, ind_rec->chain_coord);
+            m_KeysBlobs[m_CurKeysBlob] = NULL;
+        }
+        ++m_CurKeysBlob;
+    }
+    if (m_CurKeysBlob < m_KeysBlobs.size()) {
+        SetRunnable();
+        return NULL;
+    }
+
+    x_ClearKeysSnapshot();
+    return &CBlobCacher::x_StartCreateFiles;
+}
+
 CBlobCacher::State
 CBlobCacher::x_CancelCaching(void)
 {
@@ -3540,6 +4135,8 @@ CBlobCacher::x_FinishCaching(void)
 CBlobCacher::State
 CBlobCacher::x_StartCacheBlobs(void)
 {
+    if (m_FromKeys)
+        return &CBlobCacher::x_FinishCaching;
     m_CurFile = s_DBFiles->begin();
     return &CBlobCacher::x_CacheNextFile;
 }
@@ -3613,6 +4210,7 @@ CBlobCacher::x_CleanOrphanRecs(void)
 }
 
 CBlobCacher::CBlobCacher(void)
+    : m_FromKeys(false)
 {
 #if __NC_TASKS_MONITOR
     m_TaskName = "CBlobCacher";
@@ -3621,7 +4219,9 @@ CBlobCacher::CBlobCacher(void)
 }
 
 CBlobCacher::~CBlobCacher(void)
-{}
+{
+    x_ClearKeysSnapshot();
+}
 
 
 void
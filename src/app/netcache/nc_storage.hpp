@@ -145,6 +145,8 @@ public:
     static void SavePurgeData(void);
 
     static Uint8 GetMaxBlobSizeStore(void);
+    /// Compression method (ENCBlobPacking) for newly written blobs
+    static Uint1 GetBlobPacking(void);
 public:
     // For internal use only
 
@@ -175,6 +177,13 @@ public:
                                 Uint8 chunk_num,
                                 char* buffer,
                                 Uint4 buf_size);
+    /// Copy or decompress chunk data read by ReadChunkData() into the
+    /// buffer which should receive exactly dst_size bytes.
+    static bool RestoreChunkData(Uint1 packing,
+                                 const char* src,
+                                 Uint4 src_size,
+                                 char* dst,
+                                 Uint4 dst_size);
 
     static void ReferenceCacheData(SNCCacheData* cache_data);
     static void ReleaseCacheData(SNCCacheData* cache_data);
@@ -1080,6 +1080,7 @@ SNCBlobVerData::SNCBlobVerData(CNCBlobVerManager* mgr)
         chunk_size(0),
         map_size(0),
         map_depth(0),
+        packing(eNCPackNone),
         has_error(false),
         is_cur_version(false),
         meta_has_changed(false),
@@ -1476,7 +1477,8 @@ CNCBlobAccessor::CNCBlobAccessor(void)
     : m_ChunkMaps(NULL),
       m_MetaInfoReady(false),
       m_WriteMemRequested(false),
-      m_Buffer(NULL)
+      m_Buffer(NULL),
+      m_Unpacked(NULL)
 {
 #if __NC_TASKS_MONITOR
     m_TaskName = "CNCBlobAccessor";
@@ -1490,6 +1492,7 @@ CNCBlobAccessor::~CNCBlobAccessor(void)
     if (m_ChunkMaps) {
         SRV_FATAL("blob accessor broken");
     }
+    delete [] m_Unpacked;
 
     //Uint8 cnt = AtomicSub(s_CntAccs, 1);
     //INFO("~CNCBlobAccessor, cnt=" << cnt);
@@ -1618,7 +1621,8 @@ CNCBlobAccessor::GetReadMemSize(void)
     }
     if (m_Buffer) {
         if (m_ChunkPos < m_ChunkSize) {
-            m_Buffer = m_CurData->chunks[m_CurChunk];
+            if (m_Buffer != m_Unpacked)
+                m_Buffer = m_CurData->chunks[m_CurChunk];
             return m_ChunkSize - m_ChunkPos;
         }
         ++m_CurChunk;
@@ -1629,6 +1633,9 @@ CNCBlobAccessor::GetReadMemSize(void)
     if (need_size > m_CurData->chunk_size)
         need_size = m_CurData->chunk_size;
 
+    if (m_CurData->packing != eNCPackNone)
+        return x_ReadPackedChunk(Uint4(need_size));
+
     m_Buffer = ACCESS_ONCE(m_CurData->chunks[m_CurChunk]);
     if (m_Buffer) {
         m_ChunkSize = Uint4(need_size);
@@ -1654,6 +1661,52 @@ CNCBlobAccessor::GetReadMemSize(void)
     return m_ChunkSize - m_ChunkPos;
 }
 
+Uint4
+CNCBlobAccessor::x_ReadPackedChunk(Uint4 need_size)
+{
+    // Chunks of packed blobs in the database can't be given to the reader
+    // as is, so every chunk is copied or unpacked into accessor's buffer.
+    if (!m_Unpacked)
+        m_Unpacked = new char[m_CurData->chunk_size];
+    m_Buffer = m_Unpacked;
+    m_ChunkSize = need_size;
+
+    // Chunk not written to the database yet is in write-back memory
+    // which is freed right after writing, thus it's copied under the lock.
+    m_CurData->wb_mem_lock.Lock();
+    char* wb_mem = NULL;
+    if (m_CurChunk >= m_CurData->cur_chunk_num) {
+        wb_mem = m_CurData->chunks[m_CurChunk];
+        if (wb_mem)
+            memcpy(m_Unpacked, wb_mem, need_size);
+    }
+    m_CurData->wb_mem_lock.Unlock();
+    if (wb_mem)
+        return m_ChunkSize - m_ChunkPos;
+
+    if (!m_ChunkMaps) {
+        m_ChunkMaps = new SNCChunkMaps(m_CurData->map_size);
+        s_AddCurrentMem(s_CalcChunkMapsSize(m_CurData->map_size));
+    }
+    char* data = NULL;
+    Uint4 data_size = 0;
+    if (!CNCBlobStorage::ReadChunkData(m_CurData, m_ChunkMaps, m_CurChunk,
+                                       data, data_size))
+    {
+        x_DelCorruptedVersion();
+        return 0;
+    }
+    CNCStat::DiskDataRead(data_size);
+    if (!CNCBlobStorage::RestoreChunkData(m_CurData->packing,
+                                          data, data_size,
+                                          m_Unpacked, need_size))
+    {
+        x_DelCorruptedVersion();
+        return 0;
+    }
+    return m_ChunkSize - m_ChunkPos;
+}
+
 void
 CNCBlobAccessor::MoveReadPos(Uint4 move_size)
 {
@@ -1672,6 +1725,7 @@ CNCBlobAccessor::x_CreateNewData(void)
     if (!m_NewData) {
         m_NewData = m_VerManager->CreateNewVersion();
         m_NewData->password = m_Password;
+        m_NewData->packing = CNCBlobStorage::GetBlobPacking();
     }
 }
 
@@ -227,6 +227,7 @@ private:
 
     void x_CreateNewData(void);
     void x_DelCorruptedVersion(void);
+    Uint4 x_ReadPackedChunk(Uint4 need_size);
 
 
     /// Type of access requested for the blob
@@ -248,6 +249,8 @@ private:
     Uint4       m_ChunkSize;
     Uint8       m_SizeRead;
     char*       m_Buffer;
+    /// Copy of current chunk for blobs stored with compression
+    char*       m_Unpacked;
     CSrvTask*   m_Owner;
 };
 
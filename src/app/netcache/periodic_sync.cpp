@@ -59,6 +59,17 @@ static CNCLogCleaner* s_LogCleaner;
 
 static FILE* s_LogFile = NULL;
 
+// Bandwidth budget shared by all periodic syncs (see sync_bandwidth_limit).
+// Tokens are bytes; a command is started while the budget is positive and its
+// blob size is charged up front, so a big blob leaves the budget in debt and
+// delays the next commands. The debt is limited to one second worth of data,
+// otherwise the peer could time the sync out while we wait.
+static CMiniMutex s_BWLock;
+static Int8     s_BWTokens = 0;
+static Uint8    s_BWLastTime = 0;
+static Uint8    s_BWBytes = 0;
+static Uint8    s_BWThrottled = 0;
+
 
 template <typename Type> void
 s_ShuffleList( vector<Type>& lst)
@@ -80,6 +91,83 @@ s_ShuffleSrvsLists(void)
 }
 
 
+static bool
+s_HasSyncBandwidth(void)
+{
+    Uint8 limit = CNCDistributionConf::GetSyncBandwidthLimit();
+    if (limit == 0)
+        return true;
+
+    CMiniMutexGuard guard(s_BWLock);
+    Uint8 now = CSrvTime::Current().AsUSec();
+    if (s_BWLastTime == 0) {
+        s_BWTokens = Int8(limit);
+    }
+    else if (now > s_BWLastTime) {
+        double refill = double(limit) * (now - s_BWLastTime) / kUSecsPerSecond;
+        if (refill >= double(limit) - double(s_BWTokens))
+            s_BWTokens = Int8(limit);
+        else
+            s_BWTokens += Int8(refill);
+    }
+    s_BWLastTime = now;
+    if (s_BWTokens > 0)
+        return true;
+    ++s_BWThrottled;
+    return false;
+}
+
+static void
+s_ConsumeSyncBandwidth(Uint8 size)
+{
+    if (size == 0)
+        return;
+    Uint8 limit = CNCDistributionConf::GetSyncBandwidthLimit();
+    CMiniMutexGuard guard(s_BWLock);
+    s_BWBytes += size;
+    if (limit != 0)
+        s_BWTokens = max(s_BWTokens - Int8(min(size, 2 * limit)), -Int8(limit));
+}
+
+// Amount of blob data the sync command will move between servers.
+// Writes refused by the peer (see x_DoEventSend() etc.) move nothing.
+static Uint8
+s_GetTaskDataSize(const SSyncTaskInfo& task_info, const CNCPeerControl* peer)
+{
+    const SNCSyncEvent* event = NULL;
+    switch (task_info.task_type) {
+    case eSynEventSend:
+        event = *task_info.send_evt;
+        if (event->blob_size > CNCDistributionConf::GetMaxBlobSizeSync()
+            ||  !peer->AcceptsBlobKey(event->key))
+        {
+            return 0;
+        }
+        break;
+    case eSynEventGet:
+        event = *task_info.get_evt;
+        break;
+    case eSynBlobSend:
+        if (!peer->AcceptsBlobKey(CNCBlobKeyLight(task_info.local_blob->first)))
+            return 0;
+        return task_info.local_blob->second->size;
+    case eSynBlobGet:
+        return task_info.remote_blob->second->size;
+    case eSynBlobUpdateOur:
+    case eSynBlobUpdatePeer:
+        if (task_info.local_blob->second->isSameData(*task_info.remote_blob->second))
+            return 0;
+        if (task_info.task_type == eSynBlobUpdateOur)
+            return task_info.remote_blob->second->size;
+        if (!peer->AcceptsBlobKey(CNCBlobKeyLight(task_info.remote_blob->first)))
+            return 0;
+        return task_info.local_blob->second->size;
+    default:
+        return 0;
+    }
+    return event->event_type == eSyncWrite? event->blob_size: 0;
+}
+
 static void
 s_FindServerSlot(Uint8 server_id,
                  Uint2 slot,
@@ -784,7 +872,7 @@ CNCActiveSyncControl::x_DoPeriodicSync(void)
     m_StartTime = CSrvTime::Current().AsUSec();
 
     m_ReadOK = m_ReadERR = 0;
-    m_WriteOK = m_WriteERR = 0;
+    m_WriteOK = m_WriteERR = m_WriteRefused = 0;
     m_ProlongOK = m_ProlongERR = 0;
     m_DelOK = m_DelERR = 0;
     m_NeedReply = false;
@@ -872,6 +960,7 @@ CNCActiveSyncControl::x_WaitForExecutingTasks(void)
         return NULL;
     }
     bool is_locked = false;
+    bool throttled = false;
     m_Lock.Lock(); is_locked = true;
     if (m_NextTask == eSynNoTask) {
         if (m_SyncHandlers.empty()) {
@@ -890,7 +979,17 @@ CNCActiveSyncControl::x_WaitForExecutingTasks(void)
             }
         }
     } else {
+        // Each event is a separate command with its own round trip, one
+        // command per background connection. Events are not batched nor
+        // pipelined, so catch-up time is still bound by the peer latency
+        // and max_peer_bg_connections.
         for (;m_NextTask > eSynNeedFinalize;) {
+            if (!s_HasSyncBandwidth()) {
+                // retry when the budget is refilled
+                if (!is_locked) {m_Lock.Lock(); is_locked = true;}
+                throttled = true;
+                break;
+            }
         	CNCActiveHandler* conn = m_SlotSrv->peer->GetBGConn(true);
             if (!conn) {
                 break;
@@ -900,11 +999,12 @@ CNCActiveSyncControl::x_WaitForExecutingTasks(void)
             SSyncTaskInfo task_info;
             GetNextTask(task_info);
             m_Lock.Unlock(); is_locked = false;
+            s_ConsumeSyncBandwidth(s_GetTaskDataSize(task_info, conn->GetPeer()));
             ExecuteSyncTask(task_info, conn);
         }
     }
     if (is_locked) {
-        if (m_SyncHandlers.empty()) {
+        if (m_SyncHandlers.empty()  &&  !throttled) {
             m_Result = eSynServerBusy;
             m_Hint = NC_SYNC_HINT;
             m_Lock.Unlock();
@@ -948,6 +1048,7 @@ CNCActiveSyncControl::x_FinishSync(void)
                  .PrintParam("r_err", m_ReadERR)
                  .PrintParam("w_ok", m_WriteOK)
                  .PrintParam("w_err", m_WriteERR)
+                 .PrintParam("w_refused", m_WriteRefused)
                  .PrintParam("p_ok", m_ProlongOK)
                  .PrintParam("p_err", m_ProlongERR)
                  .PrintParam("d_ok", m_DelOK)
@@ -1256,7 +1357,7 @@ CNCActiveSyncControl::x_DoEventSend(const SSyncTaskInfo& task_info,
     SNCSyncEvent* event = *task_info.send_evt;
     if (event->blob_size > CNCDistributionConf::GetMaxBlobSizeSync() ||
         !conn->GetPeer()->AcceptsBlobKey(event->key)) {
-        CmdFinished( eSynOK, eSynActionWrite, conn, NC_SYNC_HINT);
+        CmdFinished( eSynOK, eSynActionRefused, conn, NC_SYNC_HINT);
         conn->Release();
         return;
     }
@@ -1308,7 +1409,7 @@ CNCActiveSyncControl::x_DoBlobUpdatePeer(const SSyncTaskInfo& task_info,
 {
     CNCBlobKeyLight key(task_info.remote_blob->first);
     if (!conn->GetPeer()->AcceptsBlobKey(key)) {
-        CmdFinished( eSynOK, eSynActionWrite, conn, NC_SYNC_HINT);
+        CmdFinished( eSynOK, eSynActionRefused, conn, NC_SYNC_HINT);
         conn->Release();
         return;
     }
@@ -1326,7 +1427,7 @@ CNCActiveSyncControl::x_DoBlobSend(const SSyncTaskInfo& task_info,
 {
     CNCBlobKeyLight key(task_info.local_blob->first);
     if (!conn->GetPeer()->AcceptsBlobKey(key)) {
-        CmdFinished( eSynOK, eSynActionWrite, conn, NC_SYNC_HINT);
+        CmdFinished( eSynOK, eSynActionRefused, conn, NC_SYNC_HINT);
         conn->Release();
         return;
     }
@@ -1441,6 +1542,9 @@ CNCActiveSyncControl::CmdFinished(ESyncResult res, ESynActionType action, CNCAct
         case eSynActionRemove:
             ++m_DelOK;
             break;
+        case eSynActionRefused:
+            ++m_WriteRefused;
+            break;
         case eSynActionNone:
             break;
         }
@@ -1459,6 +1563,7 @@ CNCActiveSyncControl::CmdFinished(ESyncResult res, ESynActionType action, CNCAct
         case eSynActionRemove:
             ++m_DelERR;
             break;
+        case eSynActionRefused:
         case eSynActionNone:
             break;
         }
@@ -1488,10 +1593,11 @@ CNCActiveSyncControl::CmdFinished(ESyncResult res, ESynActionType action, CNCAct
 void CNCActiveSyncControl::PrintState(TNCBufferType& task, const CTempString& mask)
 {
     Uint2 slot = 0;
-    bool one_slot = false, is_audit = false;
+    bool one_slot = false, is_audit = false, all_slots = false;
     if (!mask.empty()) {
         is_audit = mask == "audit";
-        if (!is_audit) {
+        all_slots = mask == "lag";
+        if (!is_audit  &&  !all_slots) {
             try {
                 slot = NStr::StringToUInt(mask);
                 one_slot = true;
@@ -1503,6 +1609,21 @@ void CNCActiveSyncControl::PrintState(TNCBufferType& task, const CTempString& ma
     char buf[50];
     string is("\": "), iss("\": \""), eol(",\n\"");
 
+    Uint8 bw_bytes, bw_throttled;
+    Int8 bw_tokens;
+    {{
+        CMiniMutexGuard guard(s_BWLock);
+        bw_bytes = s_BWBytes;
+        bw_throttled = s_BWThrottled;
+        bw_tokens = s_BWTokens;
+    }}
+    task.WriteText(",\n\"SyncBandwidth\": {");
+    task.WriteText("\n\"").WriteText("limit"       ).WriteText(is ).WriteNumber( CNCDistributionConf::GetSyncBandwidthLimit());
+    task.WriteText(eol).WriteText("budget"        ).WriteText(is ).WriteNumber( bw_tokens);
+    task.WriteText(eol).WriteText("bytes"         ).WriteText(is ).WriteNumber( bw_bytes);
+    task.WriteText(eol).WriteText("throttled"     ).WriteText(is ).WriteNumber( bw_throttled);
+    task.WriteText("\n}");
+
     task.WriteText(",\n\"SyncControls\": [");
     ITERATE(TSyncControls, c, s_SyncControls) {
         if (c != s_SyncControls.begin()) {
@@ -1580,7 +1701,7 @@ void CNCActiveSyncControl::PrintState(TNCBufferType& task, const CTempString& ma
             if ((*sl)->slot != slot) {
                 continue;
             }
-        } else {
+        } else if (!all_slots) {
             if ((*sl)->cnt_sync_started == 0) {
                 continue;
             }
@@ -1596,6 +1717,7 @@ void CNCActiveSyncControl::PrintState(TNCBufferType& task, const CTempString& ma
         task.WriteText(eol).WriteText("clean_required"  ).WriteText(is ).WriteBool(   (*sl)->clean_required);
         task.WriteText(eol).WriteText("srvs"            ).WriteText(is );
         task.WriteText("\n[");
+        Uint8 cur_rec_no = CNCSyncLog::GetCurrentRecNo((*sl)->slot);
         ITERATE(TSlotSrvsList, srv, (*sl)->srvs) {
             if (srv != (*sl)->srvs.begin()) {
                 task.WriteText(",");
@@ -1617,6 +1739,16 @@ void CNCActiveSyncControl::PrintState(TNCBufferType& task, const CTempString& ma
             task.WriteText(eol).WriteText("last_active_time" ).WriteText(is ).WriteText( buf);
             CSrvTime((*srv)->last_success_time).Print(buf, CSrvTime::eFmtJson);
             task.WriteText(eol).WriteText("last_success_time").WriteText(is ).WriteText( buf);
+            // how far the peer is behind our log, and for how long
+            Uint8 local_rec_no = 0, remote_rec_no = 0;
+            CNCSyncLog::GetLastSyncedRecNo((*srv)->peer->GetSrvId(), (*sl)->slot,
+                                           &local_rec_no, &remote_rec_no);
+            Uint8 lag_secs = 0;
+            if ((*srv)->last_success_time != 0)
+                lag_secs = CSrvTime::CurSecs() - (*srv)->last_success_time;
+            task.WriteText(eol).WriteText("lag_records"      ).WriteText(is ).WriteNumber(
+                                cur_rec_no > local_rec_no? cur_rec_no - local_rec_no: 0);
+            task.WriteText(eol).WriteText("lag_secs"         ).WriteText(is ).WriteNumber( lag_secs);
             task.WriteText("\n}");
         }
         task.WriteText("]\n}");
@@ -129,7 +129,9 @@ enum ESynActionType {
     eSynActionRead,
     eSynActionWrite,
     eSynActionProlong,
-    eSynActionRemove
+    eSynActionRemove,
+    /// Write not sent because the peer doesn't accept the blob
+    eSynActionRefused
 };
 
 #define NC_SYNC_HINT  __LINE__
@@ -331,6 +333,7 @@ private:
     Uint8   m_ReadERR;
     Uint8   m_WriteOK;
     Uint8   m_WriteERR;
+    Uint8   m_WriteRefused;
     Uint8   m_ProlongOK;
     Uint8   m_ProlongERR;
     Uint8   m_DelOK;
@@ -52,6 +52,51 @@ s_SaveState(SSrvStateStat& state)
 }
 
 
+Uint8
+CSrvTimeHistogram::x_GetBucketMax(unsigned int bucket)
+{
+    if (bucket < kSubBuckets)
+        return bucket;
+
+    unsigned int shift = bucket / kSubBuckets - 1;
+    Uint8 sub_bucket = bucket % kSubBuckets;
+    return ((kSubBuckets + sub_bucket + 1) << shift) - 1;
+}
+
+void
+CSrvTimeHistogram::AddValues(const CSrvTimeHistogram& other)
+{
+    if (other.m_ValuesCount == 0)
+        return;
+
+    m_ValuesSum   += other.m_ValuesSum;
+    m_ValuesCount += other.m_ValuesCount;
+    m_ValuesMax    = max(other.m_ValuesMax, m_ValuesMax);
+    for (unsigned int i = 0; i < kCntBuckets; ++i)
+        m_Buckets[i] += other.m_Buckets[i];
+}
+
+Uint8
+CSrvTimeHistogram::GetPercentile(double part) const
+{
+    if (m_ValuesCount == 0)
+        return 0;
+
+    double exact_rank = part * double(m_ValuesCount);
+    Uint8 rank = Uint8(exact_rank);
+    if (rank == 0  ||  double(rank) < exact_rank)
+        ++rank;
+
+    Uint8 seen = 0;
+    for (unsigned int i = 0; i < kCntBuckets; ++i) {
+        seen += m_Buckets[i];
+        if (seen >= rank)
+            return min(x_GetBucketMax(i), m_ValuesMax);
+    }
+    return m_ValuesMax;
+}
+
+
 CSrvStat::CSrvStat(void)
     : m_MMStat(new SMMStat())
 {
@@ -182,6 +182,49 @@ g_SrvTimeTerm(Map& map, Key key)
 }
 
 
+/// Histogram of time values (in microseconds) in the spirit of HdrHistogram.
+/// Values are grouped by the power of 2 and each group is split into
+/// kSubBuckets buckets of equal width, so any percentile is known with
+/// the relative error of at most 1/kSubBuckets. Values above kMaxValue are
+/// counted in the last bucket. Unlike CSrvStatTerm the histogram allows
+/// to calculate percentiles of the aggregated per-thread values.
+class CSrvTimeHistogram
+{
+public:
+    enum {
+        kSubBucketBits = 3,
+        kSubBuckets    = 1 << kSubBucketBits,
+        kMaxValueBits  = 40,
+        kCntBuckets    = (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets
+    };
+
+    CSrvTimeHistogram(void);
+    void Initialize(void);
+
+    /// Add next value into the set.
+    void  AddValue  (Uint8 value);
+    /// Add all values from another set.
+    void  AddValues (const CSrvTimeHistogram& other);
+
+    /// Get number of values in the set.
+    Uint8 GetCount  (void) const;
+    /// Get sum of all values in the set.
+    Uint8 GetSum    (void) const;
+    /// Get the value which is not less than the given part (from 0 to 1) of
+    /// all values in the set.
+    Uint8 GetPercentile(double part) const;
+
+private:
+    static unsigned int x_GetBucket(Uint8 value);
+    static Uint8 x_GetBucketMax(unsigned int bucket);
+
+    Uint8  m_ValuesSum;
+    Uint8  m_ValuesCount;
+    Uint8  m_ValuesMax;
+    Uint8  m_Buckets[kCntBuckets];
+};
+
+
 struct SSrvStateStat
 {
     SSrvStateStat(void) : cnt_threads(0), cnt_sockets(0) {
@@ -587,6 +630,58 @@ CSrvStatTerm<T>::GetDoubleAvg(void) const
     return m_ValuesCount == 0? 0: double(m_ValuesSum) / m_ValuesCount;
 }
 
+
+inline
+CSrvTimeHistogram::CSrvTimeHistogram(void)
+{
+    Initialize();
+}
+
+inline void
+CSrvTimeHistogram::Initialize(void)
+{
+    m_ValuesSum   = 0;
+    m_ValuesCount = 0;
+    m_ValuesMax   = 0;
+    memset(m_Buckets, 0, sizeof(m_Buckets));
+}
+
+inline unsigned int
+CSrvTimeHistogram::x_GetBucket(Uint8 value)
+{
+    if (value < kSubBuckets)
+        return (unsigned int)value;
+
+    unsigned int log2 = g_GetLogBase2(value);
+    if (log2 >= kMaxValueBits)
+        return kCntBuckets - 1;
+
+    unsigned int shift = log2 - kSubBucketBits;
+    return (log2 - kSubBucketBits + 1) * kSubBuckets
+           + (unsigned int)(value >> shift) - kSubBuckets;
+}
+
+inline void
+CSrvTimeHistogram::AddValue(Uint8 value)
+{
+    m_ValuesSum += value;
+    ++m_ValuesCount;
+    m_ValuesMax = max(m_ValuesMax, value);
+    ++m_Buckets[x_GetBucket(value)];
+}
+
+inline Uint8
+CSrvTimeHistogram::GetCount(void) const
+{
+    return m_ValuesCount;
+}
+
+inline Uint8
+CSrvTimeHistogram::GetSum(void) const
+{
+    return m_ValuesSum;
+}
+
 END_NCBI_SCOPE
 
 #endif /* NETCACHE__SRV_STAT__HPP */
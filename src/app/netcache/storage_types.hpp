@@ -69,7 +69,7 @@ struct ATTR_PACKED SFileIndexRec
 struct ATTR_PACKED SFileMetaRec
 {
     Uint1   has_password;
-    Uint1   align_reserve;
+    Uint1   packing;        // ENCBlobPacking of data chunks
     Uint2   map_size;       // max number of down_coords in map record - see SFileChunkMapRec
     Uint4   chunk_size;
     Uint8   size;           // blob size
@@ -150,6 +150,20 @@ struct SNCTempBlobInfo
 typedef set<Uint4>              TRecNumsSet;
 typedef map<Uint4, TRecNumsSet> TFileRecsMap;
 
+/// Record of the database file as saved in keys snapshot
+struct SNCKeysRec
+{
+    Uint4   rec_num;
+    Uint4   blob_idx;
+};
+
+struct SNCKeysFile
+{
+    Uint4   last_rec_num;
+    vector<SNCKeysRec> recs;
+};
+typedef map<Uint4, SNCKeysFile> TKeysFilesMap;
+
 
 /*
     on startup:
@@ -158,7 +172,17 @@ typedef map<Uint4, TRecNumsSet> TFileRecsMap;
         checks DB consistency
 
     begin: x_StartCaching
-    -> x_StartCaching: get first DB file, goto  x_PreCacheRecNums
+    -> x_StartCaching
+        if keys snapshot saved at last shutdown matches DB files,
+        goto x_ApplyKeysFile
+        otherwise get first DB file, goto  x_PreCacheRecNums
+    -> x_ApplyKeysFile
+        for each DB file, attach records to blobs read from snapshot,
+        delete records not belonging to any blob
+        goto x_AddKeysBlobs
+    -> x_AddKeysBlobs
+        put blobs from snapshot into memory cache
+        goto x_StartCreateFiles
     -> x_PreCacheRecNums: 
         for each DB file, collect valid record numbers
         goto x_StartCreateFiles
@@ -172,7 +196,9 @@ typedef map<Uint4, TRecNumsSet> TFileRecsMap;
         if cannot delete any files, request shutdown, goto x_CancelCaching
         try to delete existing file (prefers data files)
         goto x_CreateInitialFile
-    -> x_StartCacheBlobs: get first file, goto  x_CacheNextFile
+    -> x_StartCacheBlobs
+        if blobs were taken from keys snapshot, goto x_FinishCaching
+        otherwise get first file, goto  x_CacheNextFile
     -> x_CacheNextFile
         if file type is eDBFileMeta, goto  x_CacheNextRecord
         after that, goto x_CleanOrphanRecs
@@ -194,6 +220,8 @@ public:
 
 private:
     State x_StartCaching(void);
+    State x_ApplyKeysFile(void);
+    State x_AddKeysBlobs(void);
     State x_PreCacheRecNums(void);
     State x_CancelCaching(void);
     State x_StartCreateFiles(void);
@@ -213,13 +241,23 @@ private:
                         SNCDataCoord up_coord,
                         Uint2 up_index,
                         SNCCacheData* cache_data,
+                        Uint1 packing,
                         Uint8 cnt_chunks,
                         Uint8& chunk_num,
                         map<Uint4, Uint4>& sizes_map);
     void x_DeleteIndexes(SNCDataCoord map_coord, Uint1 map_depth);
+    void x_AddCacheData(SNCCacheData* cache_data, SNCDataCoord chain_coord);
+    bool x_LoadKeysSnapshot(void);
+    bool x_ReadKeysSnapshot(CNcbiIstream& in);
+    void x_ClearKeysSnapshot(void);
 
 
     TFileRecsMap m_RecsMap;
+    TKeysFilesMap m_KeysFiles;
+    TKeysFilesMap::const_iterator m_CurKeysFile;
+    vector<SNCCacheData*> m_KeysBlobs;
+    size_t m_CurKeysBlob;
+    bool m_FromKeys;
     TRecNumsSet m_NewFileIds;
     TNCDBFilesMap::const_iterator m_CurFile;
     TRecNumsSet* m_CurRecsSet;
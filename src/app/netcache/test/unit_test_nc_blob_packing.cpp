@@ -0,0 +1,210 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Unit tests for compression of blob data chunks in NetCache storage.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+
+#include <util/random_gen.hpp>
+
+#include "../nc_blob_packing.hpp"
+
+// This header must be included before all Boost.Test headers if there are any
+#include <corelib/test_boost.hpp>
+
+#include <common/test_assert.h> // This header must go last
+
+
+USING_NCBI_SCOPE;
+
+
+/// Same as kNCMaxBlobChunkSize, which can't be taken from nc_db_info.hpp
+/// without the whole task server.
+static const Uint4 kChunkSize = 32740;
+
+
+static string s_CompressibleData(size_t size)
+{
+    string data;
+    data.reserve(size);
+    while (data.size() < size) {
+        data += "Lorem ipsum dolor sit amet, ";
+        data += NStr::SizetToString(data.size() % 1000);
+    }
+    data.resize(size);
+    return data;
+}
+
+static string s_RandomData(size_t size)
+{
+    CRandom rnd(12345);
+    string data(size, '\0');
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = char(rnd.GetRandIndex(256));
+    }
+    return data;
+}
+
+static vector<Uint1> s_SupportedMethods(void)
+{
+    vector<Uint1> methods;
+    methods.push_back(eNCPackZlib);
+    if (CNCBlobPacker::IsSupported(eNCPackZstd)) {
+        methods.push_back(eNCPackZstd);
+    }
+    return methods;
+}
+
+/// Emulate writing of one chunk and reading it back, as
+/// CNCBlobStorage::WriteChunkData() and CNCBlobAccessor do it.
+static void s_RoundTrip(Uint1 packing, const string& data, bool expect_packed)
+{
+    const Uint4 need_size = Uint4(data.size());
+    AutoArray<char> packed;
+    Uint4 packed_size = 0;
+    const char* stored = data.data();
+    Uint4 stored_size = need_size;
+    bool is_packed = CNCBlobPacker::Pack(packing, data.data(), need_size,
+                                         packed, packed_size);
+    BOOST_CHECK_EQUAL(is_packed, expect_packed);
+    if (is_packed) {
+        BOOST_CHECK(packed_size < need_size);
+        BOOST_CHECK(packed_size <= need_size - need_size / 8);
+        stored = packed.get();
+        stored_size = packed_size;
+    }
+
+    // Startup check of data record sizes
+    BOOST_CHECK(CNCBlobPacker::IsValidDataSize(packing, stored_size,
+                                               need_size));
+
+    AutoArray<char> out(new char[need_size + 1]);
+    bool unpacked = true;
+    BOOST_REQUIRE(CNCBlobPacker::Restore(packing, stored, stored_size,
+                                         out.get(), need_size, unpacked));
+    BOOST_CHECK_EQUAL(unpacked, is_packed);
+    BOOST_CHECK(memcmp(out.get(), data.data(), need_size) == 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestFullChunkRoundTrip)
+{
+    string data = s_CompressibleData(kChunkSize);
+    ITERATE(vector<Uint1>, it, s_SupportedMethods()) {
+        s_RoundTrip(*it, data, true);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TestShortLastChunk)
+{
+    ITERATE(vector<Uint1>, it, s_SupportedMethods()) {
+        // Too short to shrink - stored as is although it's shorter than
+        // chunk size, and must not be taken for a packed one.
+        for (Uint4 size = 1;  size <= 32;  ++size) {
+            s_RoundTrip(*it, s_RandomData(size), false);
+        }
+        // Compressible tail of a blob is packed as any other chunk
+        s_RoundTrip(*it, s_CompressibleData(1000), true);
+        // Incompressible tail is stored as is
+        s_RoundTrip(*it, s_RandomData(1000), false);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TestIncompressibleChunk)
+{
+    string data = s_RandomData(kChunkSize);
+    ITERATE(vector<Uint1>, it, s_SupportedMethods()) {
+        s_RoundTrip(*it, data, false);
+    }
+    // Blob written without compression
+    AutoArray<char> packed;
+    Uint4 packed_size = 0;
+    BOOST_CHECK(!CNCBlobPacker::Pack(eNCPackNone, data.data(), kChunkSize,
+                                     packed, packed_size));
+}
+
+BOOST_AUTO_TEST_CASE(TestCorruptedChunk)
+{
+    string data = s_CompressibleData(kChunkSize);
+    AutoArray<char> out(new char[kChunkSize]);
+    bool unpacked = false;
+
+    // Data record longer than the chunk
+    BOOST_CHECK(!CNCBlobPacker::IsValidDataSize(eNCPackZlib, kChunkSize + 1,
+                                                kChunkSize));
+    BOOST_CHECK(!CNCBlobPacker::Restore(eNCPackZlib, data.data(), kChunkSize,
+                                        out.get(), kChunkSize - 1, unpacked));
+    // Short data record in a blob without compression
+    BOOST_CHECK(!CNCBlobPacker::IsValidDataSize(eNCPackNone, 100, kChunkSize));
+    BOOST_CHECK(!CNCBlobPacker::Restore(eNCPackNone, data.data(), 100,
+                                        out.get(), kChunkSize, unpacked));
+
+    ITERATE(vector<Uint1>, it, s_SupportedMethods()) {
+        AutoArray<char> packed;
+        Uint4 packed_size = 0;
+        BOOST_REQUIRE(CNCBlobPacker::Pack(*it, data.data(), kChunkSize,
+                                          packed, packed_size));
+        // Truncated packed data
+        BOOST_CHECK(!CNCBlobPacker::Restore(*it, packed.get(), packed_size / 2,
+                                            out.get(), kChunkSize, unpacked));
+        // Packed data of another chunk size
+        BOOST_CHECK(!CNCBlobPacker::Restore(*it, packed.get(), packed_size,
+                                            out.get(), kChunkSize - 10,
+                                            unpacked));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TestUnknownPacking)
+{
+    // Meta records with these values are dropped by CBlobCacher at startup
+    BOOST_CHECK(CNCBlobPacker::IsSupported(eNCPackNone));
+    BOOST_CHECK(CNCBlobPacker::IsSupported(eNCPackZlib));
+#if defined(HAVE_LIBZSTD)
+    BOOST_CHECK(CNCBlobPacker::IsSupported(eNCPackZstd));
+#else
+    BOOST_CHECK(!CNCBlobPacker::IsSupported(eNCPackZstd));
+#endif
+    BOOST_CHECK(!CNCBlobPacker::IsSupported(3));
+    BOOST_CHECK(!CNCBlobPacker::IsSupported(255));
+    BOOST_CHECK_EQUAL(string(CNCBlobPacker::GetName(3)), "unknown");
+
+    // Nothing is packed or unpacked with unknown method, but chunks of full
+    // size can still be copied.
+    string data = s_CompressibleData(kChunkSize);
+    AutoArray<char> packed;
+    Uint4 packed_size = 0;
+    BOOST_CHECK(!CNCBlobPacker::Pack(3, data.data(), kChunkSize,
+                                     packed, packed_size));
+    AutoArray<char> out(new char[kChunkSize]);
+    bool unpacked = true;
+    BOOST_CHECK(CNCBlobPacker::Restore(3, data.data(), kChunkSize,
+                                       out.get(), kChunkSize, unpacked));
+    BOOST_CHECK(!unpacked);
+    BOOST_CHECK(!CNCBlobPacker::Restore(3, data.data(), 100,
+                                        out.get(), kChunkSize, unpacked));
+}
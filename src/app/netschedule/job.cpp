@@ -154,20 +154,20 @@ CJob::CJob() :
     m_Id(0),
     m_Passport(0),
     m_Status(CNetScheduleAPI::ePending),
+    m_ListenerNotifAddress(0),
     m_Timeout(),
     m_RunTimeout(),
     m_ReadTimeout(),
-    m_SubmNotifPort(0),
     m_SubmNotifTimeout(),
-    m_ListenerNotifAddress(0),
-    m_ListenerNotifPort(0),
     m_ListenerNotifAbsTime(),
+    m_LastTouch(),
     m_RunCount(0),
     m_ReadCount(0),
     m_AffinityId(0),
     m_Mask(0),
     m_GroupId(0),
-    m_LastTouch(),
+    m_SubmNotifPort(0),
+    m_ListenerNotifPort(0),
     m_NeedSubmProgressMsgNotif(false),
     m_NeedLsnrProgressMsgNotif(false),
     m_NeedStolenNotif(false)
@@ -178,21 +178,21 @@ CJob::CJob(const SNSCommandArguments &  request) :
     m_Id(0),
     m_Passport(0),
     m_Status(CNetScheduleAPI::ePending),
+    m_ListenerNotifAddress(0),
     m_Timeout(),
     m_RunTimeout(),
     m_ReadTimeout(),
-    m_SubmNotifPort(request.port),
     m_SubmNotifTimeout(request.timeout, 0),
-    m_ListenerNotifAddress(0),
-    m_ListenerNotifPort(0),
     m_ListenerNotifAbsTime(),
+    m_LastTouch(),
     m_RunCount(0),
     m_ReadCount(0),
-    m_ProgressMsg(""),
     m_AffinityId(0),
     m_Mask(request.job_mask),
     m_GroupId(0),
-    m_LastTouch(),
+    m_SubmNotifPort(request.port),
+    m_ListenerNotifPort(0),
+    m_ProgressMsg(""),
     m_Output(""),
     m_NeedSubmProgressMsgNotif(request.need_progress_msg),
     m_NeedLsnrProgressMsgNotif(false),
@@ -686,7 +686,7 @@ void CJob::x_AppendRemoteClientSID(string & dump) const
 {
     static string   prefix = "OK:remote_client_sid: ";
     dump.append(prefix)
-        .append(NStr::PrintableString(m_ClientSID))
+        .append(NStr::PrintableString(m_ClientSID.Get()))
         .append(kNewLine);
 }
 
@@ -694,7 +694,7 @@ void CJob::x_AppendRemoteClientIP(string & dump) const
 {
     static string   prefix = "OK:remote_client_ip: ";
     dump.append(prefix)
-        .append(NStr::PrintableString(m_ClientIP))
+        .append(NStr::PrintableString(m_ClientIP.Get()))
         .append(kNewLine);
 }
 
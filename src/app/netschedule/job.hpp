@@ -39,6 +39,7 @@
 #include "job_status.hpp"
 #include "ns_command_arguments.hpp"
 #include "ns_precise_time.hpp"
+#include "ns_interned_string.hpp"
 
 
 BEGIN_NCBI_SCOPE
@@ -117,9 +118,9 @@ public:
     int      GetRetCode() const
     { return m_RetCode; }
     const string& GetClientNode() const
-    { return m_ClientNode; }
+    { return m_ClientNode.Get(); }
     const string& GetClientSession() const
-    { return m_ClientSession; }
+    { return m_ClientSession.Get(); }
     const string& GetErrorMsg() const
     { return m_ErrorMsg; }
     const string GetQuotedErrorMsg() const
@@ -138,9 +139,13 @@ public:
     // The size of the client_node is normalized at the handshake stage
     void SetClientNode(const string &  client_node)
     { m_ClientNode = client_node; }
+    void SetClientNode(const CNSInternedString &  client_node)
+    { m_ClientNode = client_node; }
     // The size of the client_session is normalized at the handshake stage
     void SetClientSession(const string &  cliet_session)
     { m_ClientSession = cliet_session; }
+    void SetClientSession(const CNSInternedString &  cliet_session)
+    { m_ClientSession = cliet_session; }
     // The size of the error message is truncated (if needed) at the
     // command parameters processing stage
     void SetErrorMsg(const string &  msg)
@@ -156,8 +161,9 @@ private:
     CNSPreciseTime  m_Timestamp;        // event timestamp
     unsigned        m_NodeAddr;         // IP of a client (typically, worker node)
     int             m_RetCode;          // Return code
-    string          m_ClientNode;       // Client node id
-    string          m_ClientSession;    // Client session
+    // The nodes and sessions are shared between many events
+    CNSInternedString   m_ClientNode;       // Client node id
+    CNSInternedString   m_ClientSession;    // Client session
     string          m_ErrorMsg;         // Error message (exception::what())
 };
 
@@ -242,9 +248,9 @@ public:
     CNSPreciseTime GetLastTouch() const
     { return m_LastTouch; }
     const string&  GetClientIP() const
-    { return m_ClientIP; }
+    { return m_ClientIP.Get(); }
     const string&  GetClientSID() const
-    { return m_ClientSID; }
+    { return m_ClientSID.Get(); }
     const string&  GetNCBIPHID() const
     { return m_NCBIPHID; }
     bool  GetSubmNeedProgressMsgNotif() const
@@ -311,8 +317,12 @@ public:
 
     void SetClientIP(const string& client_ip)
     { m_ClientIP = client_ip; }
+    void SetClientIP(const CNSInternedString& client_ip)
+    { m_ClientIP = client_ip; }
     void SetClientSID(const string& client_sid)
     { m_ClientSID = client_sid; }
+    void SetClientSID(const CNSInternedString& client_sid)
+    { m_ClientSID = client_sid; }
     void SetNCBIPHID(const string& ncbi_phid)
     { m_NCBIPHID = ncbi_phid; }
     void SetNeedSubmProgressMsgNotif(bool  need)
@@ -407,30 +417,33 @@ private:
     void x_AppendNeedStolenNotif(string & dump) const;
 
 private:
+    // The fields are grouped by their size to avoid padding: the server
+    // keeps millions of jobs in memory
     unsigned            m_Id;
     unsigned int        m_Passport;
     TJobStatus          m_Status;
+    unsigned int        m_ListenerNotifAddress;
+
     CNSPreciseTime      m_Timeout;       // Individual timeout
     CNSPreciseTime      m_RunTimeout;    // Job run timeout
     CNSPreciseTime      m_ReadTimeout;   // Job read timeout
-
-    unsigned short      m_SubmNotifPort;    // Submit notification port
     CNSPreciseTime      m_SubmNotifTimeout; // Submit notification timeout
-
-    unsigned int        m_ListenerNotifAddress;
-    unsigned short      m_ListenerNotifPort;
     CNSPreciseTime      m_ListenerNotifAbsTime;
+    CNSPreciseTime      m_LastTouch;
 
     unsigned            m_RunCount;
     unsigned            m_ReadCount;
-    string              m_ProgressMsg;
     unsigned            m_AffinityId;
     unsigned            m_Mask;
     unsigned            m_GroupId;
-    CNSPreciseTime      m_LastTouch;
+    unsigned short      m_SubmNotifPort;    // Submit notification port
+    unsigned short      m_ListenerNotifPort;
+
+    string              m_ProgressMsg;
 
-    string              m_ClientIP;
-    string              m_ClientSID;
+    // The submitter addresses and sessions are shared between many jobs
+    CNSInternedString   m_ClientIP;
+    CNSInternedString   m_ClientSID;
     string              m_NCBIPHID;
 
     vector<CJobEvent>   m_Events;
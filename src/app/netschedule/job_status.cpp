@@ -43,7 +43,7 @@ BEGIN_NCBI_SCOPE
 
 
 CJobStatusTracker::CJobStatusTracker()
- : m_DoneCnt(0)
+ : m_DoneCnt(0), m_TrackChanges(false), m_ChangeCount(0)
 {
     // Note: one bit vector is not used - the corresponding job state became
     // obsolete and was deleted. The matrix though uses job statuses as indexes
@@ -213,6 +213,11 @@ void CJobStatusTracker::SetStatus(unsigned    job_id, TJobStatus  status)
                 bv.set_bit(job_id, true);
         }
     }
+
+    if (m_TrackChanges) {
+        m_ChangedJobs.set_bit(job_id, true);
+        ++m_ChangeCount;
+    }
 }
 
 
@@ -220,6 +225,10 @@ void CJobStatusTracker::AddPendingJob(unsigned int  job_id)
 {
     CWriteLockGuard         guard(m_Lock);
     m_StatusStor[(int) CNetScheduleAPI::ePending]->set_bit(job_id, true);
+    if (m_TrackChanges) {
+        m_ChangedJobs.set_bit(job_id, true);
+        ++m_ChangeCount;
+    }
 }
 
 
@@ -279,6 +288,46 @@ void CJobStatusTracker::AddPendingBatch(unsigned  job_id_from,
     CWriteLockGuard     guard(m_Lock);
     m_StatusStor[(int) CNetScheduleAPI::ePending]->set_range(job_id_from,
                                                              job_id_to);
+    if (m_TrackChanges) {
+        m_ChangedJobs.set_range(job_id_from, job_id_to);
+        ++m_ChangeCount;
+    }
+}
+
+
+void CJobStatusTracker::TrackChanges(bool  track)
+{
+    CWriteLockGuard     guard(m_Lock);
+    m_TrackChanges = track;
+    if (!track)
+        m_ChangedJobs.clear(true);
+}
+
+
+void CJobStatusTracker::MarkChanged(unsigned int  job_id)
+{
+    CWriteLockGuard     guard(m_Lock);
+    if (m_TrackChanges) {
+        m_ChangedJobs.set_bit(job_id, true);
+        ++m_ChangeCount;
+    }
+}
+
+
+// Hands over the collected jobs and starts collecting from scratch
+void CJobStatusTracker::GetChangedJobs(TNSBitVector &  jobs)
+{
+    jobs.clear();
+
+    CWriteLockGuard     guard(m_Lock);
+    jobs.swap(m_ChangedJobs);
+}
+
+
+Uint8 CJobStatusTracker::GetChangeCount(void) const
+{
+    CReadLockGuard      guard(m_Lock);
+    return m_ChangeCount;
 }
 
 
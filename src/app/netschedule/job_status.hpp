@@ -149,6 +149,16 @@ public:
     // Optimize bitvectors memory
     void OptimizeMem();
 
+    // Journal support. When tracking is switched on all the jobs which
+    // status has been touched are collected till the next call of
+    // GetChangedJobs(). MarkChanged() is for changes which do not touch the
+    // status. The change counter only grows; it tells if anything has
+    // been changed since it was read last time.
+    void TrackChanges(bool  track);
+    void MarkChanged(unsigned int  job_id);
+    void GetChangedJobs(TNSBitVector &  jobs);
+    Uint8 GetChangeCount(void) const;
+
 private:
     void x_IncDoneJobs(void);
 
@@ -162,6 +172,10 @@ private:
 
     // Done jobs counter
     unsigned                m_DoneCnt;
+
+    bool                    m_TrackChanges;
+    TNSBitVector            m_ChangedJobs;
+    Uint8                   m_ChangeCount;
 };
 
 
@@ -262,6 +262,7 @@ int CNetScheduleDApp::Run(void)
 
     qdb->RunExecutionWatcherThread(min_run_timeout);
     qdb->RunPurgeThread();
+    qdb->RunJournalThread();
     qdb->RunNotifThread();
     qdb->RunServiceThread();
 
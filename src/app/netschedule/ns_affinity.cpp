@@ -984,10 +984,9 @@ void CNSAffinityRegistry::RemoveDump(const string &  dump_dir_name,
 string CNSAffinityRegistry::x_GetDumpFileName(const string &  dump_dir_name,
                                               const string &  qname) const
 {
-    const string    fname("aff_dict_dump.");
     string          upper_queue_name = qname;
     NStr::ToUpper(upper_queue_name);
-    return dump_dir_name + fname + upper_queue_name;
+    return dump_dir_name + kAffDictFileName + "." + upper_queue_name;
 }
 
 
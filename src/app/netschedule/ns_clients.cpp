@@ -68,6 +68,8 @@ void CNSClientId::Update(unsigned int            peer_addr,
                          const TNSProtoParams &  params)
 {
     TNSProtoParams::const_iterator      found;
+    string                              client_node;
+    string                              client_session;
 
     m_Addr           = peer_addr;
     m_ProgName       = kEmptyStr;
@@ -83,11 +85,11 @@ void CNSClientId::Update(unsigned int            peer_addr,
 
     found = params.find("client_node");
     if (found != params.end())
-        m_ClientNode = NStr::ParseEscapes(found->second);
+        client_node = NStr::ParseEscapes(found->second);
 
     found = params.find("client_session");
     if (found != params.end())
-        m_ClientSession = NStr::ParseEscapes(found->second);
+        client_session = NStr::ParseEscapes(found->second);
 
     found = params.find("client_type");
     if (found != params.end())
@@ -95,18 +97,20 @@ void CNSClientId::Update(unsigned int            peer_addr,
 
     // It must be that either both client_node and client_session
     // parameters are provided or none of them
-    if (m_ClientNode.empty() && !m_ClientSession.empty())
+    if (client_node.empty() && !client_session.empty())
         NCBI_THROW(CNetScheduleException, eAuthenticationError,
                    "client_session is provided but client_node is not");
-    if (!m_ClientNode.empty() && m_ClientSession.empty())
+    if (!client_node.empty() && client_session.empty())
         NCBI_THROW(CNetScheduleException, eAuthenticationError,
                    "client_node is provided but client_session is not");
 
-    if (!m_ClientNode.empty())
-        m_ClientNode = x_NormalizeNodeOrSession(m_ClientNode,
+    // The normalized values are interned once here; the job events copy
+    // them
+    if (!client_node.empty())
+        m_ClientNode = x_NormalizeNodeOrSession(client_node,
                                                 "client_node");
-    if (!m_ClientSession.empty())
-        m_ClientSession = x_NormalizeNodeOrSession(m_ClientSession,
+    if (!client_session.empty())
+        m_ClientSession = x_NormalizeNodeOrSession(client_session,
                                                    "client_session");
 
     found = params.find("prog");
@@ -153,7 +157,7 @@ bool CNSClientId::IsComplete(void) const
 string CNSClientId::GetVirtualScope(void) const
 {
     if (IsComplete())
-        return kVirtualScopePrefix + m_ClientNode;
+        return kVirtualScopePrefix + m_ClientNode.Get();
     return "";
 }
 
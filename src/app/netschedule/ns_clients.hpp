@@ -38,6 +38,7 @@
 #include "ns_types.hpp"
 #include "ns_access.hpp"
 #include "ns_precise_time.hpp"
+#include "ns_interned_string.hpp"
 
 #include <string>
 
@@ -84,8 +85,13 @@ class CNSClientId
         unsigned int GetAddress(void) const
         { return m_Addr; }
         const string &  GetNode(void) const
-        { return m_ClientNode; }
+        { return m_ClientNode.Get(); }
         const string &  GetSession(void) const
+        { return m_ClientSession.Get(); }
+        // Interned at the handshake; the jobs copy them without a lookup
+        const CNSInternedString &  GetInternedNode(void) const
+        { return m_ClientNode; }
+        const CNSInternedString &  GetInternedSession(void) const
         { return m_ClientSession; }
         EClaimedClientType  GetType(void) const
         { return m_ClientType; }
@@ -142,9 +148,9 @@ class CNSClientId
                                               // and usually is an exe name
         string              m_ClientName;     // Client name - taken from the
                                               // app config file
-        string              m_ClientNode;     // Client node,
+        CNSInternedString   m_ClientNode;     // Client node,
                                               // e.g. service10:9300
-        string              m_ClientSession;  // Session of working
+        CNSInternedString   m_ClientSession;  // Session of working
                                               //  with netschedule.
         EClaimedClientType  m_ClientType;     // Client type, e.g. admin
         unsigned short      m_ControlPort;    // Client control port
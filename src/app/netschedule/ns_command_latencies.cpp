@@ -0,0 +1,249 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: NetSchedule command execution time histograms
+ *
+ */
+
+#include <ncbi_pch.hpp>
+
+#include "ns_command_latencies.hpp"
+
+
+BEGIN_NCBI_SCOPE
+
+
+static const double     kQuantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+static const char *     kLatencyMetric = "netschedule_command_duration_seconds";
+
+
+CNSTimeHistogram::CNSTimeHistogram(void) :
+    m_Count(0), m_Sum(0), m_Max(0)
+{
+    memset(m_Buckets, 0, sizeof(m_Buckets));
+}
+
+
+unsigned int CNSTimeHistogram::x_GetBucket(Uint8  value)
+{
+    if (value < kSubBuckets)
+        return static_cast<unsigned int>(value);
+
+    unsigned int    log2 = 0;
+    for (Uint8  v = value; v > 1; v >>= 1)
+        ++log2;
+    if (log2 >= kMaxValueBits)
+        return kBuckets - 1;
+
+    unsigned int    shift = log2 - kSubBucketBits;
+    return (log2 - kSubBucketBits + 1) * kSubBuckets +
+           static_cast<unsigned int>(value >> shift) - kSubBuckets;
+}
+
+
+Uint8 CNSTimeHistogram::x_GetBucketMax(unsigned int  bucket)
+{
+    if (bucket < kSubBuckets)
+        return bucket;
+
+    unsigned int    shift = bucket / kSubBuckets - 1;
+    Uint8           sub_bucket = bucket % kSubBuckets;
+    return ((kSubBuckets + sub_bucket + 1) << shift) - 1;
+}
+
+
+void CNSTimeHistogram::AddValue(Uint8  value)
+{
+    ++m_Count;
+    m_Sum += value;
+    if (value > m_Max)
+        m_Max = value;
+    ++m_Buckets[x_GetBucket(value)];
+}
+
+
+void CNSTimeHistogram::AddValues(const CNSTimeHistogram &  other)
+{
+    m_Count += other.m_Count;
+    m_Sum += other.m_Sum;
+    if (other.m_Max > m_Max)
+        m_Max = other.m_Max;
+    for (unsigned int  k = 0; k < kBuckets; ++k)
+        m_Buckets[k] += other.m_Buckets[k];
+}
+
+
+Uint8 CNSTimeHistogram::GetPercentile(double  part) const
+{
+    if (m_Count == 0)
+        return 0;
+
+    double      exact_rank = part * m_Count;
+    Uint8       rank = static_cast<Uint8>(exact_rank);
+    if (rank == 0 || rank < exact_rank)
+        ++rank;
+
+    Uint8       seen = 0;
+    for (unsigned int  k = 0; k < kBuckets; ++k) {
+        seen += m_Buckets[k];
+        if (seen >= rank)
+            return min(x_GetBucketMax(k), m_Max);
+    }
+    return m_Max;
+}
+
+
+
+thread_local CNSCommandLatencies::SThreadShard
+                                    CNSCommandLatencies::sm_ThreadShard;
+
+
+CNSCommandLatencies::SThreadShard::~SThreadShard(void)
+{
+    Release();
+}
+
+
+void CNSCommandLatencies::SThreadShard::Release(void)
+{
+    if (m_Shard != NULL) {
+        CFastMutexGuard     guard(m_Pool->m_Lock);
+        m_Pool->m_FreeShards.push_back(m_Shard);
+    }
+    m_Shard = NULL;
+    m_Pool.Reset();
+}
+
+
+CNSCommandLatencies::SShardPool::~SShardPool(void)
+{
+    // No thread refers to the pool at this point
+    for (vector<SShard *>::iterator  k = m_Shards.begin();
+            k != m_Shards.end(); ++k)
+        delete *k;
+}
+
+
+CNSCommandLatencies::CNSCommandLatencies(void) :
+    m_Pool(new SShardPool())
+{}
+
+
+CNSCommandLatencies::~CNSCommandLatencies(void)
+{
+    // The shards are deleted with the pool when the last thread which used
+    // them exits
+    if (sm_ThreadShard.m_Pool == m_Pool)
+        sm_ThreadShard.Release();
+}
+
+
+CNSCommandLatencies::SShard *  CNSCommandLatencies::x_GetThreadShard(void)
+{
+    if (sm_ThreadShard.m_Pool == m_Pool)
+        return sm_ThreadShard.m_Shard;
+
+    // The thread may still hold a shard of another instance
+    sm_ThreadShard.Release();
+
+    CFastMutexGuard     guard(m_Pool->m_Lock);
+    SShard *            shard;
+
+    if (m_Pool->m_FreeShards.empty()) {
+        shard = new SShard();
+        m_Pool->m_Shards.push_back(shard);
+    } else {
+        shard = m_Pool->m_FreeShards.back();
+        m_Pool->m_FreeShards.pop_back();
+    }
+
+    sm_ThreadShard.m_Pool = m_Pool;
+    sm_ThreadShard.m_Shard = shard;
+    return shard;
+}
+
+
+void CNSCommandLatencies::AddCommand(const char *  command,
+                                     const CNSPreciseTime &  duration)
+{
+    Uint8       usec = duration.Sec() * kUSecsPerSecond +
+                       duration.NSec() / kNSecsPerUSec;
+    SShard *    shard = x_GetThreadShard();
+
+    CFastMutexGuard     guard(shard->m_Lock);
+    shard->m_Histograms[command].AddValue(usec);
+}
+
+
+string CNSCommandLatencies::PrintPrometheus(void) const
+{
+    THistograms     histograms;
+    {{
+        CFastMutexGuard     guard(m_Pool->m_Lock);
+        for (vector<SShard *>::const_iterator  k = m_Pool->m_Shards.begin();
+                k != m_Pool->m_Shards.end(); ++k) {
+            CFastMutexGuard     shard_guard((*k)->m_Lock);
+            for (THistograms::const_iterator
+                    h = (*k)->m_Histograms.begin();
+                    h != (*k)->m_Histograms.end(); ++h)
+                histograms[h->first].AddValues(h->second);
+        }
+    }}
+
+    string      result;
+    result.append("# HELP ").append(kLatencyMetric)
+          .append(" Time of the commands execution\n")
+          .append("# TYPE ").append(kLatencyMetric)
+          .append(" summary\n");
+
+    for (THistograms::const_iterator  k = histograms.begin();
+            k != histograms.end(); ++k) {
+        string      cmd_label = string("cmd=\"") + k->first + "\"";
+
+        for (size_t  q = 0; q < sizeof(kQuantiles) / sizeof(double); ++q) {
+            double  value = k->second.GetPercentile(kQuantiles[q]);
+            result.append(kLatencyMetric)
+                  .append("{").append(cmd_label)
+                  .append(",quantile=\"")
+                  .append(NStr::DoubleToString(kQuantiles[q]))
+                  .append("\"} ")
+                  .append(NStr::DoubleToString(value / kUSecsPerSecond, 6))
+                  .append("\n");
+        }
+        double  sum = k->second.GetSum();
+        result.append(kLatencyMetric)
+              .append("_sum{").append(cmd_label).append("} ")
+              .append(NStr::DoubleToString(sum / kUSecsPerSecond, 6))
+              .append("\n")
+              .append(kLatencyMetric)
+              .append("_count{").append(cmd_label).append("} ")
+              .append(to_string(k->second.GetCount()))
+              .append("\n");
+    }
+    return result;
+}
+
+
+END_NCBI_SCOPE
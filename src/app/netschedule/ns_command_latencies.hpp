@@ -0,0 +1,185 @@
+#ifndef NETSCHEDULE_COMMAND_LATENCIES__HPP
+#define NETSCHEDULE_COMMAND_LATENCIES__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: NetSchedule command execution time histograms
+ *
+ */
+
+#include <corelib/ncbiobj.hpp>
+#include <corelib/ncbimtx.hpp>
+
+#include "ns_precise_time.hpp"
+
+#include <string.h>
+#include <map>
+#include <vector>
+
+
+BEGIN_NCBI_SCOPE
+
+
+// Histogram of time values in microseconds in the spirit of HdrHistogram.
+// The values are grouped by the power of 2 and each group is split into
+// kSubBuckets buckets of equal width, so any percentile is known with the
+// relative error of at most 1/kSubBuckets. The values above 2^kMaxValueBits
+// are counted in the last bucket.
+class CNSTimeHistogram
+{
+public:
+    enum {
+        kSubBucketBits = 3,
+        kSubBuckets    = 1 << kSubBucketBits,
+        kMaxValueBits  = 40,
+        kBuckets       = (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets
+    };
+
+    CNSTimeHistogram(void);
+
+    void AddValue(Uint8  value);
+    void AddValues(const CNSTimeHistogram &  other);
+
+    Uint8 GetCount(void) const { return m_Count; }
+    Uint8 GetSum(void) const   { return m_Sum; }
+
+    // Provides the value which is not less than the given part
+    // (from 0 to 1) of all the values
+    Uint8 GetPercentile(double  part) const;
+
+private:
+    static unsigned int x_GetBucket(Uint8  value);
+    static Uint8 x_GetBucketMax(unsigned int  bucket);
+
+private:
+    Uint8       m_Count;
+    Uint8       m_Sum;
+    Uint8       m_Max;
+    Uint8       m_Buckets[kBuckets];
+};
+
+
+// Execution time histograms of the commands.
+// Each thread updates its own shard which is protected by its own lock, so
+// the lock is never contended except when the histograms are collected.
+// The shards are merged only when the histograms are printed.
+// There is a single instance of the class owned by the server.
+class CNSCommandLatencies
+{
+public:
+    CNSCommandLatencies(void);
+    ~CNSCommandLatencies(void);
+
+    // The command name must be a static string
+    void AddCommand(const char *  command,
+                    const CNSPreciseTime &  duration);
+
+    // Prometheus text exposition format; the protocol prefix is added by
+    // the command handler
+    string PrintPrometheus(void) const;
+
+private:
+    struct SCStrLess
+    {
+        bool operator() (const char *  left, const char *  right) const
+        { return strcmp(left, right) < 0; }
+    };
+    typedef map<const char *, CNSTimeHistogram, SCStrLess>  THistograms;
+
+    struct SShard
+    {
+        CFastMutex      m_Lock;
+        THistograms     m_Histograms;
+    };
+
+    // The shards are owned by the pool which is shared with the threads
+    // that use them, so a thread which exits after the latencies instance
+    // is destroyed still returns its shard to a live pool
+    struct SShardPool : public CObject
+    {
+        ~SShardPool(void);
+
+        mutable CFastMutex  m_Lock;
+        vector<SShard *>    m_Shards;
+        vector<SShard *>    m_FreeShards;
+    };
+
+    // Returns the shard to the pool when the thread exits so that the next
+    // started thread reuses it; the collected values are preserved
+    struct SThreadShard
+    {
+        SThreadShard(void) : m_Shard(NULL) {}
+        ~SThreadShard(void);
+
+        void Release(void);
+
+        CRef<SShardPool>        m_Pool;
+        SShard *                m_Shard;
+    };
+
+    SShard *  x_GetThreadShard(void);
+
+private:
+    CRef<SShardPool>    m_Pool;
+
+    static thread_local SThreadShard    sm_ThreadShard;
+
+private:
+    CNSCommandLatencies(const CNSCommandLatencies &);
+    CNSCommandLatencies &  operator=(const CNSCommandLatencies &);
+};
+
+
+// Counts the command execution time when it goes out of scope so that the
+// commands finished with an exception are counted as well
+class CNSCommandTimer
+{
+public:
+    CNSCommandTimer(CNSCommandLatencies &  latencies) :
+        m_Latencies(latencies), m_Command(NULL),
+        m_Start(CNSPreciseTime::Current())
+    {}
+
+    ~CNSCommandTimer()
+    {
+        if (m_Command != NULL)
+            m_Latencies.AddCommand(m_Command,
+                                   CNSPreciseTime::Current() - m_Start);
+    }
+
+    void SetCommand(const char *  command)
+    { m_Command = command; }
+
+private:
+    CNSCommandLatencies &   m_Latencies;
+    const char *            m_Command;
+    CNSPreciseTime          m_Start;
+};
+
+
+END_NCBI_SCOPE
+
+#endif /* NETSCHEDULE_COMMAND_LATENCIES__HPP */
@@ -104,6 +104,41 @@ int SJobDumpHeader::Read(FILE *  f)
 }
 
 
+SJournalDumpHeader::SJournalDumpHeader() :
+    job_header(),
+    aff_fixed_size(sizeof(SAffinityDictDump)),
+    group_fixed_size(sizeof(SGroupDictDump))
+{}
+
+
+void SJournalDumpHeader::Write(FILE *  f)
+{
+    errno = 0;
+    if (fwrite(this, sizeof(SJournalDumpHeader), 1, f) != 1)
+        throw runtime_error(strerror(errno));
+}
+
+
+int SJournalDumpHeader::Read(FILE *  f)
+{
+    errno = 0;
+    size_t      bytes = fread(this, 1, sizeof(SJournalDumpHeader), f);
+    if (bytes != sizeof(SJournalDumpHeader)) {
+        if (bytes > 0)
+            throw runtime_error("Incomplete journal file header");
+        if (feof(f))
+            return 1;
+        if (errno != 0)
+            throw runtime_error(strerror(errno));
+        throw runtime_error("Unknown journal file header reading error");
+    }
+
+    if (job_header.common_header.magic != kDumpMagic)
+        throw runtime_error("Journal file header magic does not match");
+    return 0;
+}
+
+
 SOneStructDumpHeader::SOneStructDumpHeader() :
     common_header(),
     fixed_size(0)
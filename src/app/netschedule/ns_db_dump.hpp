@@ -106,6 +106,26 @@ struct SOneStructDumpHeader
 #pragma pack(pop)
 
 
+// The header appears once in each jobs journal file. It is followed by the
+// records each of which is framed as: Uint4 record type, Uint4 body size,
+// the body and Uint4 CRC32 of all the preceding record bytes. The body is
+// exactly as in the other dump files: a job (as in the jobs dump file), a
+// deleted job Uint4 id, an affinity or a group dictionary entry.
+#pragma pack(push, 1)
+struct SJournalDumpHeader
+{
+    SJobDumpHeader      job_header;
+    Uint4               aff_fixed_size;
+    Uint4               group_fixed_size;
+
+    SJournalDumpHeader();
+
+    void Write(FILE *  f);
+    int Read(FILE *  f);
+};
+#pragma pack(pop)
+
+
 // The structures mostly match the Berkeley DB tables structure
 // but use only fixed size POD fields
 
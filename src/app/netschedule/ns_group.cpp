@@ -659,10 +659,9 @@ void CNSGroupsRegistry::RemoveDump(const string &  dump_dir_name,
 string CNSGroupsRegistry::x_GetDumpFileName(const string &  dump_dir_name,
                                             const string &  qname) const
 {
-    const string    fname("group_dict_dump.");
     string          upper_queue_name = qname;
     NStr::ToUpper(upper_queue_name);
-    return dump_dir_name + fname + upper_queue_name;
+    return dump_dir_name + kGroupDictFileName + "." + upper_queue_name;
 }
 
 
@@ -56,6 +56,8 @@ const string    kEndOfResponse = "\n";
 const string    kOKCompleteResponse = "OK:" + kEndOfResponse;
 const string    kErrNoJobFoundResponse = "ERR:eJobNotFound:" + kEndOfResponse;
 const string    kOKResponsePrefix = "OK:";
+// Upper limit of the jobs given out by one GET2 with count
+const unsigned int  kMaxJobsPerGet = 100;
 
 
 
@@ -439,7 +441,8 @@ CNetScheduleHandler::SCommandMap CNetScheduleHandler::sm_CommandMap[] = {
           { "ip",                eNSPT_Str, eNSPA_Optional, ""  },
           { "sid",               eNSPT_Str, eNSPA_Optional, ""  },
           { "ncbi_phid",         eNSPT_Str, eNSPA_Optional, ""  },
-          { "prioritized_aff",   eNSPT_Int, eNSPA_Optional, "0" } } },
+          { "prioritized_aff",   eNSPT_Int, eNSPA_Optional, "0" },
+          { "count",             eNSPT_Int, eNSPA_Optional, "0" } } },
     { "PUT",           { &CNetScheduleHandler::x_ProcessPut,
                          eNS_Queue | eNS_Worker | eNS_Program },
         { { "job_key",           eNSPT_Id,  eNSPA_Required      },
@@ -621,7 +624,8 @@ CNetScheduleHandler::CNetScheduleHandler(CNetScheduleServer* server)
       m_BatchHeaderParser(sm_BatchHeaderMap),
       m_BatchEndParser(sm_BatchEndMap),
       m_ClientIdentificationPrinted(false),
-      m_RollbackAction(NULL)
+      m_RollbackAction(NULL),
+      m_JournalChangeCount(0)
 {}
 
 
@@ -919,6 +923,11 @@ CNetScheduleHandler::x_PrepareWriteBuffer(const string &  msg,
 
 EIO_Status CNetScheduleHandler::x_WriteMessage(const string &  msg)
 {
+    if (m_JournalQueue.NotNull()) {
+        m_JournalQueue->WaitJournalSync(m_JournalChangeCount);
+        m_JournalQueue.Reset();
+    }
+
     size_t  msg_size = msg.size();
     bool    has_eom = false;
 
@@ -1138,6 +1147,8 @@ void CNetScheduleHandler::x_ProcessMsgQueue(BUF buffer)
 // Workhorse method
 void CNetScheduleHandler::x_ProcessMsgRequest(BUF buffer)
 {
+    CNSCommandTimer     cmd_timer(m_Server->GetCommandLatencies());
+
     if (x_NeedCmdLogging()) {
         m_CmdContext.Reset(new CRequestContext());
         m_CmdContext->SetRequestStatus(eStatus_OK);
@@ -1179,6 +1190,7 @@ void CNetScheduleHandler::x_ProcessMsgRequest(BUF buffer)
 
     const SCommandExtra &   extra = cmd.command->extra;
 
+    cmd_timer.SetCommand(cmd.command->cmd);
     if (extra.processor == &CNetScheduleHandler::x_ProcessQuitSession) {
         x_ProcessQuitSession(0);
         return;
@@ -1268,6 +1280,9 @@ void CNetScheduleHandler::x_ProcessMsgRequest(BUF buffer)
     }
 
     // Execute the command
+    m_JournalQueue.Reset();
+    if (x_NeedJournalSync(extra.processor))
+        x_HoldReplyForJournal(queue_ptr);
     (this->*extra.processor)(queue_ptr);
 
     if (restore_client) {
@@ -1525,11 +1540,13 @@ void CNetScheduleHandler::x_ProcessMsgBatchSubmit(BUF buffer)
         // we have our batch now
         CStopWatch  sw(CStopWatch::eStart);
         x_ClearRollbackAction();
-        unsigned    job_id = GetQueue()->SubmitBatch(m_ClientId,
-                                                     m_BatchJobs,
-                                                     m_BatchGroup,
-                                                     x_NeedCmdLogging(),
-                                                     m_RollbackAction);
+        CRef<CQueue>    q = GetQueue();
+        x_HoldReplyForJournal(q.GetPointer());
+        unsigned    job_id = q->SubmitBatch(m_ClientId,
+                                            m_BatchJobs,
+                                            m_BatchGroup,
+                                            x_NeedCmdLogging(),
+                                            m_RollbackAction);
         double      db_elapsed = sw.Elapsed();
 
         if (x_NeedCmdLogging())
@@ -2196,7 +2213,14 @@ void CNetScheduleHandler::x_ProcessGetJob(CQueue* q)
     NStr::Split(m_CommandArguments.group,
                 "\t,", group_list);
 
+    // GET2 may ask for up to 'count' jobs in one response
+    unsigned int    max_extra_jobs = 0;
+    if (cmdv2 && m_CommandArguments.count > 1)
+        max_extra_jobs = min(m_CommandArguments.count,
+                             kMaxJobsPerGet) - 1;
+
     CJob            job;
+    vector<CJob>    extra_jobs;
     string          added_pref_aff;
     x_ClearRollbackAction();
     if (q->GetJobOrWait(m_ClientId,
@@ -2211,7 +2235,9 @@ void CNetScheduleHandler::x_ProcessGetJob(CQueue* q)
                         &group_list,
                         &job,
                         m_RollbackAction,
-                        added_pref_aff) == false) {
+                        added_pref_aff,
+                        max_extra_jobs,
+                        &extra_jobs) == false) {
         // Preferred affinities were reset for the client, so no job
         // and bad request
         x_SetCmdRequestStatus(eStatus_BadRequest);
@@ -2232,7 +2258,7 @@ void CNetScheduleHandler::x_ProcessGetJob(CQueue* q)
                         .Print("added_preferred_affinity", added_pref_aff);
             }
         }
-        x_PrintGetJobResponse(q, job, cmdv2);
+        x_PrintGetJobResponse(q, job, cmdv2, &extra_jobs);
         x_ClearRollbackAction();
     }
 
@@ -2864,7 +2890,7 @@ void CNetScheduleHandler::x_ProcessStatistics(CQueue* q)
         what != "JOBS" && what != "ALL" && what != "CLIENTS" &&
         what != "NOTIFICATIONS" && what != "AFFINITIES" &&
         what != "GROUPS" && what != "WNODE" && what != "SERVICES" &&
-        what != "ALERTS" && what != "SCOPES") {
+        what != "ALERTS" && what != "SCOPES" && what != "METRICS") {
         NCBI_THROW(CNetScheduleException, eInvalidParameter,
                    "Unsupported '" + what +
                    "' parameter for the STAT command.");
@@ -2914,6 +2940,22 @@ void CNetScheduleHandler::x_ProcessStatistics(CQueue* q)
         x_PrintCmdRequestStop();
         return;
     }
+    if (what == "METRICS") {
+        // Prometheus text format; the metrics are server wide. The printers
+        // produce the plain exposition text and each of its lines is sent
+        // with the protocol prefix
+        list<string>    lines;
+        string          output;
+
+        NStr::Split(m_Server->PrintMetrics(), "\n", lines,
+                    NStr::fSplit_Tokenize);
+        for (list<string>::const_iterator  k = lines.begin();
+                k != lines.end(); ++k)
+            output.append("OK:").append(*k).append(kEndOfResponse);
+        x_WriteMessage(output + "OK:END" + kEndOfResponse);
+        x_PrintCmdRequestStop();
+        return;
+    }
     if (what == "ALERTS") {
         string  output = m_Server->SerializeAlerts();
         if (!output.empty())
@@ -4310,9 +4352,10 @@ void CNetScheduleHandler::x_PrintCmdRequestStop(void)
 // The function forms a responce for various 'get job' commands and prints
 // extra to the log if required
 void
-CNetScheduleHandler::x_PrintGetJobResponse(const CQueue *  q,
-                                           const CJob &    job,
-                                           bool            cmdv2)
+CNetScheduleHandler::x_PrintGetJobResponse(const CQueue *         q,
+                                           const CJob &           job,
+                                           bool                   cmdv2,
+                                           const vector<CJob> *   extra_jobs)
 {
     if (!job.GetId()) {
         // No suitable job found
@@ -4329,43 +4372,29 @@ CNetScheduleHandler::x_PrintGetJobResponse(const CQueue *  q,
     }
 
     if (cmdv2) {
-        string      submitter_notif_info;
-        if (job.GetSubmNotifPort() != 0) {
-            string  host = CSocketAPI::ntoa(job.GetSubmAddr());
-            if (host == "127.0.0.1") {
-                unsigned int    my_addr = CSocketAPI::GetLocalHostAddress();
-                host = CSocketAPI::ntoa(my_addr);
-                if (host == "127.0.0.1") {
-                    ERR_POST(Warning <<
-                             "Could not detect the self host address "
-                             "to provide it to a worker node");
-                }
-            }
-            submitter_notif_info.append("&submitter_notif_host=")
-                                .append(NStr::URLEncode(host))
-                                .append("&submitter_notif_port=")
-                                .append(to_string(job.GetSubmNotifPort()));
-        }
         string      reply;
         reply.reserve(1024);
-        reply.append("OK:job_key=")
-             .append(job_key)
-             .append("&input=")
-             .append(NStr::URLEncode(job.GetInput()))
-             .append("&affinity=")
-             .append(NStr::URLEncode(q->GetAffinityTokenByID(job.GetAffinityId())))
-             .append("&client_ip=")
-             .append(NStr::URLEncode(job.GetClientIP()))
-             .append("&client_sid=")
-             .append(NStr::URLEncode(job.GetClientSID()))
-             .append("&ncbi_phid=")
-             .append(NStr::URLEncode(job.GetNCBIPHID()))
-             .append("&mask=")
-             .append(to_string(job.GetMask()))
-             .append("&auth_token=")
-             .append(job.GetAuthToken())
-             .append(submitter_notif_info)
-             .append(kEndOfResponse);
+        reply.append("OK:");
+        x_AppendGet2JobFields(q, job, job_key, reply);
+
+        // The extra jobs of GET2 with count > 1 follow in the same line;
+        // each of them starts with its own job_key
+        if (extra_jobs != NULL && !extra_jobs->empty()) {
+            string      extra_keys;
+            for (vector<CJob>::const_iterator  k = extra_jobs->begin();
+                    k != extra_jobs->end(); ++k) {
+                string  extra_key = q->MakeJobKey(k->GetId());
+                reply.append("&");
+                x_AppendGet2JobFields(q, *k, extra_key, reply);
+
+                if (!extra_keys.empty())
+                    extra_keys.append(",");
+                extra_keys.append(extra_key);
+            }
+            if (x_NeedCmdLogging())
+                GetDiagContext().Extra().Print("extra_job_keys", extra_keys);
+        }
+        reply.append(kEndOfResponse);
         x_WriteMessage(reply);
     } else {
         x_WriteMessage(
@@ -4382,6 +4411,49 @@ CNetScheduleHandler::x_PrintGetJobResponse(const CQueue *  q,
 }
 
 
+// Appends the GET2 response fields of a single job
+void
+CNetScheduleHandler::x_AppendGet2JobFields(const CQueue *  q,
+                                           const CJob &    job,
+                                           const string &  job_key,
+                                           string &        reply)
+{
+    reply.append("job_key=")
+         .append(job_key)
+         .append("&input=")
+         .append(NStr::URLEncode(job.GetInput()))
+         .append("&affinity=")
+         .append(NStr::URLEncode(q->GetAffinityTokenByID(job.GetAffinityId())))
+         .append("&client_ip=")
+         .append(NStr::URLEncode(job.GetClientIP()))
+         .append("&client_sid=")
+         .append(NStr::URLEncode(job.GetClientSID()))
+         .append("&ncbi_phid=")
+         .append(NStr::URLEncode(job.GetNCBIPHID()))
+         .append("&mask=")
+         .append(to_string(job.GetMask()))
+         .append("&auth_token=")
+         .append(job.GetAuthToken());
+
+    if (job.GetSubmNotifPort() != 0) {
+        string  host = CSocketAPI::ntoa(job.GetSubmAddr());
+        if (host == "127.0.0.1") {
+            unsigned int    my_addr = CSocketAPI::GetLocalHostAddress();
+            host = CSocketAPI::ntoa(my_addr);
+            if (host == "127.0.0.1") {
+                ERR_POST(Warning <<
+                         "Could not detect the self host address "
+                         "to provide it to a worker node");
+            }
+        }
+        reply.append("&submitter_notif_host=")
+             .append(NStr::URLEncode(host))
+             .append("&submitter_notif_port=")
+             .append(to_string(job.GetSubmNotifPort()));
+    }
+}
+
+
 bool CNetScheduleHandler::x_CanBeWithoutQueue(FProcessor  processor) const
 {
     return // STATUS/STATUS2
@@ -4433,6 +4505,56 @@ CNetScheduleHandler::x_NeedToGeneratePHIDAndSID(FProcessor  processor) const
 }
 
 
+// The commands which change jobs. Their replies are held till the changes
+// are synced to the queue journal if so configured.
+bool CNetScheduleHandler::x_NeedJournalSync(FProcessor  processor) const
+{
+    return // SUBMIT
+           processor == &CNetScheduleHandler::x_ProcessSubmit ||
+           // CANCEL
+           processor == &CNetScheduleHandler::x_ProcessCancel ||
+           // CANCELQ
+           processor == &CNetScheduleHandler::x_ProcessCancelQueue ||
+           // CLRN
+           processor == &CNetScheduleHandler::x_ProcessClearWorkerNode ||
+           // GET/GET2/WGET
+           processor == &CNetScheduleHandler::x_ProcessGetJob ||
+           // PUT/PUT2
+           processor == &CNetScheduleHandler::x_ProcessPut ||
+           // RETURN/RETURN2
+           processor == &CNetScheduleHandler::x_ProcessReturn ||
+           // RESCHEDULE
+           processor == &CNetScheduleHandler::x_ProcessReschedule ||
+           // REDO
+           processor == &CNetScheduleHandler::x_ProcessRedo ||
+           // FPUT/FPUT2
+           processor == &CNetScheduleHandler::x_ProcessPutFailure ||
+           // JXCG
+           processor == &CNetScheduleHandler::x_ProcessJobExchange ||
+           // READ/READ2
+           processor == &CNetScheduleHandler::x_ProcessReading ||
+           // CFRM
+           processor == &CNetScheduleHandler::x_ProcessConfirm ||
+           // FRED
+           processor == &CNetScheduleHandler::x_ProcessReadFailed ||
+           // RDRB
+           processor == &CNetScheduleHandler::x_ProcessReadRollback ||
+           // REREAD
+           processor == &CNetScheduleHandler::x_ProcessReread;
+}
+
+
+// The next reply waits till the changes made from now on are journaled
+void CNetScheduleHandler::x_HoldReplyForJournal(CQueue *  q)
+{
+    if (q == NULL || !m_Server->GetJournalSyncReplies())
+        return;
+
+    m_JournalQueue.Reset(q);
+    m_JournalChangeCount = q->GetJournalChangeCount();
+}
+
+
 bool
 CNetScheduleHandler::x_WorkerNodeCommand(void) const
 {
@@ -245,11 +245,18 @@ private:
     void x_PrintCmdRequestStart(CTempString  msg);
     void x_PrintCmdRequestStop(void);
 
-    void x_PrintGetJobResponse(const CQueue * q,
-                               const CJob &   job,
-                               bool           add_security_token);
+    void x_PrintGetJobResponse(const CQueue *        q,
+                               const CJob &          job,
+                               bool                  add_security_token,
+                               const vector<CJob> *  extra_jobs = NULL);
+    void x_AppendGet2JobFields(const CQueue *  q,
+                               const CJob &    job,
+                               const string &  job_key,
+                               string &        reply);
     bool x_CanBeWithoutQueue(FProcessor  processor) const;
     bool x_NeedToGeneratePHIDAndSID(FProcessor  processor) const;
+    bool x_NeedJournalSync(FProcessor  processor) const;
+    void x_HoldReplyForJournal(CQueue *  q);
     bool x_WorkerNodeCommand(void) const;
     void x_LogCommandWithJob(const CJob &  job) const;
     void x_LogCommandWithJob(const string &  client_ip,
@@ -292,8 +299,8 @@ private:
     string                          m_BatchGroup;
     unsigned                        m_BatchSubmPort;
     CNSPreciseTime                  m_BatchSubmTimeout;
-    string                          m_BatchClientIP;
-    string                          m_BatchClientSID;
+    CNSInternedString               m_BatchClientIP;
+    CNSInternedString               m_BatchClientSID;
     string                          m_BatchNCBIPHID;
     bool                            m_WithinBatchSubmit;
 
@@ -318,6 +325,11 @@ private:
     // Rollback support
     CNSRollbackInterface *          m_RollbackAction;
 
+    // Group commit support: the queue which journal the reply waits for and
+    // its change counter before the command
+    CRef<CQueue>                    m_JournalQueue;
+    Uint8                           m_JournalChangeCount;
+
     bool x_NeedCmdLogging(void) const;
     void x_SetRequestContext(void);
     string x_GetConnRef(void) const;
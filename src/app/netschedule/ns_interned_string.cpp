@@ -0,0 +1,132 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: NetSchedule shared copies of the repeated job strings
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbimtx.hpp>
+
+#include "ns_interned_string.hpp"
+
+#include <map>
+
+
+BEGIN_NCBI_SCOPE
+
+
+// The key refers to the string stored in the value
+typedef map< CTempString, CRef<CObject> >   TInternPool;
+
+// The pool is split into shards by the value hash so that the threads
+// interning different values do not contend for the same lock
+const size_t    kInternPoolShards = 16;
+
+struct SInternPoolShard
+{
+    CFastMutex      m_Lock;
+    TInternPool     m_Pool;
+};
+
+static SInternPoolShard *  s_GetShards(void)
+{
+    static SInternPoolShard *   shards =
+                                    new SInternPoolShard[kInternPoolShards];
+    return shards;
+}
+
+
+static SInternPoolShard &  s_GetShard(const string &  value)
+{
+    size_t      hash = 0;
+    for (string::const_iterator  k = value.begin(); k != value.end(); ++k)
+        hash = hash * 31 + (unsigned char)(*k);
+    return s_GetShards()[hash % kInternPoolShards];
+}
+
+
+void CNSInternedString::x_Intern(const string &  value)
+{
+    if (value.empty()) {
+        m_Value.Reset();
+        return;
+    }
+    if (m_Value.NotNull() && m_Value->m_Value == value)
+        return;
+
+    SInternPoolShard &      shard = s_GetShard(value);
+    CFastMutexGuard         guard(shard.m_Lock);
+    TInternPool &           pool = shard.m_Pool;
+    TInternPool::iterator   found = pool.find(value);
+
+    if (found != pool.end()) {
+        m_Value.Reset(static_cast<const SValue *>(found->second.GetPointer()));
+        return;
+    }
+
+    CRef<SValue>    new_value(new SValue(value));
+    pool[new_value->m_Value] = new_value;
+    m_Value = new_value;
+}
+
+
+// A value referred only by the pool cannot get a new reference other than
+// from the pool, so it is safe to remove it under the pool lock
+size_t CNSInternedString::Prune(void)
+{
+    size_t                  removed = 0;
+
+    for (size_t  index = 0; index < kInternPoolShards; ++index) {
+        SInternPoolShard &  shard = s_GetShards()[index];
+        CFastMutexGuard     guard(shard.m_Lock);
+        TInternPool &       pool = shard.m_Pool;
+
+        for (TInternPool::iterator  k = pool.begin(); k != pool.end(); ) {
+            if (k->second->ReferencedOnlyOnce()) {
+                pool.erase(k++);
+                ++removed;
+            } else
+                ++k;
+        }
+    }
+    return removed;
+}
+
+
+size_t CNSInternedString::GetPoolSize(void)
+{
+    size_t      pool_size = 0;
+
+    for (size_t  index = 0; index < kInternPoolShards; ++index) {
+        SInternPoolShard &  shard = s_GetShards()[index];
+        CFastMutexGuard     guard(shard.m_Lock);
+        pool_size += shard.m_Pool.size();
+    }
+    return pool_size;
+}
+
+
+END_NCBI_SCOPE
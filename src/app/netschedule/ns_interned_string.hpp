@@ -0,0 +1,96 @@
+#ifndef NETSCHEDULE_INTERNED_STRING__HPP
+#define NETSCHEDULE_INTERNED_STRING__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: NetSchedule shared copies of the repeated job strings
+ *
+ */
+
+#include <corelib/ncbiobj.hpp>
+
+#include <string>
+
+
+BEGIN_NCBI_SCOPE
+
+
+// The jobs and their events refer to a few distinct client nodes, sessions
+// and IP addresses. The class keeps a single reference counted copy of each
+// distinct value in a server wide pool, so a job holds a pointer instead of
+// a string.
+// The pool itself holds a reference to each value; the values which are not
+// referred by anything else are removed by Prune().
+// Assigning a string looks the value up in the pool; copying an interned
+// string only copies the reference, so the values which are assigned many
+// times (e.g. the client node and session) are interned once and copied.
+class CNSInternedString
+{
+public:
+    CNSInternedString(void)
+    {}
+    CNSInternedString(const string &  value)
+    { x_Intern(value); }
+    CNSInternedString &  operator=(const string &  value)
+    { x_Intern(value);
+      return *this; }
+
+    const string &  Get(void) const
+    { return m_Value.IsNull() ? kEmptyStr : m_Value->m_Value; }
+    operator const string & (void) const
+    { return Get(); }
+    size_t size(void) const
+    { return Get().size(); }
+    bool empty(void) const
+    { return m_Value.IsNull(); }
+    const char *  data(void) const
+    { return Get().data(); }
+    void clear(void)
+    { m_Value.Reset(); }
+
+    // Removes the values which are not referred by any job.
+    // Returns the number of the removed values.
+    static size_t Prune(void);
+    static size_t GetPoolSize(void);
+
+private:
+    struct SValue : public CObject
+    {
+        SValue(const string &  value) : m_Value(value)
+        {}
+        string      m_Value;
+    };
+
+    void x_Intern(const string &  value);
+
+private:
+    CConstRef<SValue>       m_Value;
+};
+
+
+END_NCBI_SCOPE
+
+#endif /* NETSCHEDULE_INTERNED_STRING__HPP */
@@ -0,0 +1,771 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   NetSchedule queue jobs journal
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbistd.hpp>
+#include <corelib/ncbifile.hpp>
+#include <util/checksum.hpp>
+
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+#include "ns_journal.hpp"
+#include "ns_db_dump.hpp"
+
+
+BEGIN_NCBI_SCOPE
+
+
+// The journal is written in large chunks; the records become durable at
+// the time of the periodic sync anyway
+const size_t    kJournalBufferSize = 1024 * 1024;
+const string    kTmpSuffix(".tmp");
+// Anything larger is a damaged record size rather than a real job
+const Uint4     kMaxJournalRecordSize = 64 * 1024 * 1024;
+
+
+static void s_SyncFile(FILE *  f)
+{
+    errno = 0;
+    if (fflush(f) != 0)
+        throw runtime_error(strerror(errno));
+
+    #ifdef NCBI_OS_LINUX
+    int     ret = fdatasync(fileno(f));
+    #else
+    int     ret = fsync(fileno(f));
+    #endif
+    if (ret != 0)
+        throw runtime_error(strerror(errno));
+}
+
+
+// Collects what the dump function writes into memory, so that the record
+// size and checksum are known before the record is written
+template <typename TDump>
+static string s_DumpToString(TDump  dump)
+{
+    char *      buf = NULL;
+    size_t      size = 0;
+    FILE *      f = open_memstream(&buf, &size);
+
+    if (f == NULL)
+        throw runtime_error("Cannot open a memory stream for a journal "
+                            "record: " + string(strerror(errno)));
+    try {
+        dump(f);
+    } catch (...) {
+        fclose(f);
+        free(buf);
+        throw;
+    }
+    fclose(f);
+
+    string      result(buf, size);
+    free(buf);
+    return result;
+}
+
+
+static Uint4 s_GetRecordChecksum(const Uint4 *   record_header,
+                                 const string &  body)
+{
+    CChecksum   crc32(CChecksum::eCRC32);
+    crc32.AddChars(reinterpret_cast<const char *>(record_header),
+                   2 * sizeof(Uint4));
+    crc32.AddChars(body.data(), body.size());
+    return crc32.GetChecksum();
+}
+
+
+CNSJobJournal::CNSJobJournal(const string &  journal_dname,
+                             const string &  qname) :
+    m_DirName(journal_dname),
+    m_QueueName(qname),
+    m_Segment(NULL),
+    m_SegmentNumber(0)
+{
+    NStr::ToUpper(m_QueueName);
+}
+
+
+CNSJobJournal::~CNSJobJournal()
+{
+    try {
+        x_CloseSegment();
+    } catch (const exception &  ex) {
+        ERR_POST("Error closing the journal of queue " << m_QueueName <<
+                 ": " << ex.what());
+    } catch (...) {
+        ERR_POST("Unknown error closing the journal of queue " <<
+                 m_QueueName);
+    }
+}
+
+
+size_t CNSJobJournal::Recover(void)
+{
+    vector<unsigned int>    segments = x_GetSegments();
+    if (segments.empty())
+        return 0;
+
+    size_t      records = x_Merge(segments);
+    x_RemoveSegments(segments);
+    return records;
+}
+
+
+void CNSJobJournal::Start(EStartFrom       from,
+                          const string &   dump_dname,
+                          bool             keep_dump)
+{
+    // The segments left by the previous instance are either merged already
+    // or describe the jobs the queue does not have
+    vector<unsigned int>    segments = x_GetSegments();
+    x_RemoveSegments(segments);
+
+    if (from != eFromSnapshot)
+        x_RemoveSnapshot();
+
+    if (from == eFromDump) {
+        // The dump files have exactly the snapshot format
+        const string    prefixes[] = { kJobsFileName,
+                                       kAffDictFileName,
+                                       kGroupDictFileName };
+        for (size_t  k = 0; k < sizeof(prefixes) / sizeof(prefixes[0]); ++k) {
+            CFile       dump_file(dump_dname + prefixes[k] + "." +
+                                  m_QueueName);
+            if (!dump_file.Exists())
+                continue;
+
+            string      snapshot_file_name = x_GetSnapshotFileName(prefixes[k]);
+            bool        ok;
+            if (keep_dump)
+                ok = dump_file.Copy(snapshot_file_name,
+                                    CFile::fCF_Overwrite);
+            else
+                ok = dump_file.Rename(snapshot_file_name,
+                                      CFile::fRF_Overwrite);
+            if (!ok)
+                throw runtime_error("Cannot move the dump file " +
+                                    dump_file.GetPath() + " to " +
+                                    snapshot_file_name);
+        }
+    }
+
+    m_SegmentNumber = 1;
+    if (!segments.empty())
+        m_SegmentNumber = segments.back() + 1;
+    x_OpenSegment(m_SegmentNumber);
+}
+
+
+void CNSJobJournal::Close(bool  remove_files)
+{
+    x_CloseSegment();
+    if (remove_files) {
+        x_RemoveSegments(x_GetSegments());
+        x_RemoveSnapshot();
+    }
+}
+
+
+void CNSJobJournal::AppendJob(const CJob &    job,
+                              const string &  aff_token,
+                              const string &  group_token)
+{
+    if (m_Segment == NULL)
+        throw runtime_error("The jobs journal is not open");
+
+    unsigned int    aff_id = job.GetAffinityId();
+    unsigned int    group_id = job.GetGroupId();
+
+    // No token means the dictionary entry has gone together with the job;
+    // the job deletion record is on its way then
+    if (aff_id != 0 && !aff_token.empty() &&
+        !m_WrittenAffinities.get_bit(aff_id)) {
+        SAffinityDictDump   aff_dump;
+
+        aff_dump.aff_id = aff_id;
+        aff_dump.token_size = min(aff_token.size(),
+                                  sizeof(aff_dump.token));
+        memcpy(aff_dump.token, aff_token.data(), aff_dump.token_size);
+
+        x_WriteRecord(m_Segment, eAffinityRecord,
+                      s_DumpToString([&](FILE *  f) { aff_dump.Write(f); }));
+        m_WrittenAffinities.set_bit(aff_id);
+    }
+
+    if (group_id != 0 && !group_token.empty() &&
+        !m_WrittenGroups.get_bit(group_id)) {
+        SGroupDictDump      group_dump;
+
+        group_dump.group_id = group_id;
+        group_dump.token_size = min(group_token.size(),
+                                    sizeof(group_dump.token));
+        memcpy(group_dump.token, group_token.data(), group_dump.token_size);
+
+        x_WriteRecord(m_Segment, eGroupRecord,
+                      s_DumpToString([&](FILE *  f) { group_dump.Write(f); }));
+        m_WrittenGroups.set_bit(group_id);
+    }
+
+    x_WriteRecord(m_Segment, eJobRecord,
+                  s_DumpToString([&](FILE *  f) { job.Dump(f); }));
+}
+
+
+void CNSJobJournal::AppendDeletedJob(unsigned int  job_id)
+{
+    if (m_Segment == NULL)
+        throw runtime_error("The jobs journal is not open");
+
+    Uint4       id = job_id;
+    x_WriteRecord(m_Segment, eDeletedJobRecord,
+                  string(reinterpret_cast<const char *>(&id), sizeof(id)));
+}
+
+
+void CNSJobJournal::Sync(void)
+{
+    if (m_Segment != NULL)
+        s_SyncFile(m_Segment);
+}
+
+
+Int8 CNSJobJournal::GetSegmentSize(void) const
+{
+    if (m_Segment == NULL)
+        return 0;
+    return ftello(m_Segment);
+}
+
+
+// Switches to a new segment and merges the previous ones into the snapshot.
+// The merge reads the files only so the queue is not locked.
+void CNSJobJournal::Compact(void)
+{
+    x_CloseSegment();
+    x_OpenSegment(m_SegmentNumber + 1);
+
+    vector<unsigned int>    segments = x_GetSegments();
+    segments.pop_back();    // The one just opened
+    if (segments.empty())
+        return;
+
+    x_Merge(segments);
+    x_RemoveSegments(segments);
+}
+
+
+bool CNSJobJournal::IsQueueFile(const string &  file_name,
+                                const string &  qname)
+{
+    string      upper_queue_name = qname;
+    NStr::ToUpper(upper_queue_name);
+
+    if (file_name == kJobsFileName + "." + upper_queue_name ||
+        file_name == kAffDictFileName + "." + upper_queue_name ||
+        file_name == kGroupDictFileName + "." + upper_queue_name)
+        return true;
+    return NStr::StartsWith(file_name,
+                            kJournalFileName + "." + upper_queue_name + ".");
+}
+
+
+string CNSJobJournal::x_GetSnapshotFileName(const string &  prefix) const
+{
+    return m_DirName + prefix + "." + m_QueueName;
+}
+
+
+string CNSJobJournal::x_GetSegmentFileName(unsigned int  segment) const
+{
+    return m_DirName + kJournalFileName + "." + m_QueueName + "." +
+           to_string(segment);
+}
+
+
+// Provides the existing segment numbers in ascending order
+vector<unsigned int> CNSJobJournal::x_GetSegments(void) const
+{
+    vector<unsigned int>    segments;
+    string                  prefix = kJournalFileName + "." +
+                                     m_QueueName + ".";
+    CDir                    journal_dir(m_DirName);
+
+    if (!journal_dir.Exists())
+        return segments;
+
+    CDir::TEntries      entries = journal_dir.GetEntries(
+                                    prefix + "*", CDir::fIgnoreRecursive);
+    for (CDir::TEntries::const_iterator  k = entries.begin();
+            k != entries.end(); ++k) {
+        string          name = (*k)->GetName();
+        unsigned int    segment = NStr::StringToUInt(
+                                        name.substr(prefix.size()),
+                                        NStr::fConvErr_NoThrow);
+        if (segment != 0)
+            segments.push_back(segment);
+    }
+    sort(segments.begin(), segments.end());
+    return segments;
+}
+
+
+void CNSJobJournal::x_OpenSegment(unsigned int  segment)
+{
+    string      file_name = x_GetSegmentFileName(segment);
+
+    m_Segment = fopen(file_name.c_str(), "wb");
+    if (m_Segment == NULL)
+        throw runtime_error("Cannot open file " + file_name +
+                            " to write the jobs journal");
+    setvbuf(m_Segment, NULL, _IOFBF, kJournalBufferSize);
+    m_SegmentNumber = segment;
+    m_WrittenAffinities.clear();
+    m_WrittenGroups.clear();
+
+    try {
+        SJournalDumpHeader      header;
+        header.Write(m_Segment);
+        s_SyncFile(m_Segment);
+    } catch (const exception &  ex) {
+        fclose(m_Segment);
+        m_Segment = NULL;
+        throw runtime_error("Writing error while starting the jobs "
+                            "journal: " + string(ex.what()));
+    }
+}
+
+
+void CNSJobJournal::x_CloseSegment(void)
+{
+    if (m_Segment == NULL)
+        return;
+
+    FILE *      segment = m_Segment;
+    m_Segment = NULL;
+    try {
+        s_SyncFile(segment);
+    } catch (...) {
+        fclose(segment);
+        throw;
+    }
+    fclose(segment);
+}
+
+
+void CNSJobJournal::x_RemoveSegments(const vector<unsigned int> &  segments)
+{
+    for (vector<unsigned int>::const_iterator  k = segments.begin();
+            k != segments.end(); ++k) {
+        string      file_name = x_GetSegmentFileName(*k);
+        if (access(file_name.c_str(), F_OK) != -1)
+            remove(file_name.c_str());
+    }
+}
+
+
+void CNSJobJournal::x_RemoveSnapshot(void)
+{
+    const string    prefixes[] = { kJobsFileName,
+                                   kAffDictFileName,
+                                   kGroupDictFileName };
+    for (size_t  k = 0; k < sizeof(prefixes) / sizeof(prefixes[0]); ++k) {
+        string      file_name = x_GetSnapshotFileName(prefixes[k]);
+        if (access(file_name.c_str(), F_OK) != -1)
+            remove(file_name.c_str());
+    }
+}
+
+
+// Produces a new snapshot out of the current one and the given segments.
+// The new files are written aside and then renamed: the dictionaries first
+// and the jobs last. The new dictionaries keep everything the old jobs
+// refer to, so a crash in between leaves a consistent set of files (the
+// segments are still there and will be merged again).
+size_t CNSJobJournal::x_Merge(const vector<unsigned int> &  segments)
+{
+    SMergeState         state;
+    size_t              records = 0;
+    AutoArray<char>     input_buf(new char[kNetScheduleMaxOverflowSize]);
+    AutoArray<char>     output_buf(new char[kNetScheduleMaxOverflowSize]);
+
+    string      jobs_file_name = x_GetSnapshotFileName(kJobsFileName);
+    string      aff_file_name = x_GetSnapshotFileName(kAffDictFileName);
+    string      group_file_name = x_GetSnapshotFileName(kGroupDictFileName);
+
+    x_ReadDictionary(aff_file_name, true, state.affinities);
+    x_ReadDictionary(group_file_name, false, state.groups);
+    for (vector<unsigned int>::const_iterator  k = segments.begin();
+            k != segments.end(); ++k)
+        records += x_ReadSegment(*k, state,
+                                 input_buf.get(), output_buf.get());
+
+    TNSBitVector        used_affinities;
+    TNSBitVector        used_groups;
+    string              tmp_jobs_file_name = jobs_file_name + kTmpSuffix;
+    FILE *              old_jobs_file = NULL;
+    FILE *              new_jobs_file = NULL;
+
+    try {
+        new_jobs_file = fopen(tmp_jobs_file_name.c_str(), "wb");
+        if (new_jobs_file == NULL)
+            throw runtime_error("Cannot open file " + tmp_jobs_file_name +
+                                " to write the journal snapshot");
+        setvbuf(new_jobs_file, NULL, _IOFBF, kJournalBufferSize);
+
+        SJobDumpHeader      new_header;
+        new_header.Write(new_jobs_file);
+
+        // The jobs which have not been changed since the old snapshot
+        if (CFile(jobs_file_name).Exists()) {
+            old_jobs_file = fopen(jobs_file_name.c_str(), "rb");
+            if (old_jobs_file == NULL)
+                throw runtime_error("Cannot open file " + jobs_file_name +
+                                    " to read the journal snapshot");
+
+            SJobDumpHeader      old_header;
+            if (old_header.Read(old_jobs_file) == 0) {
+                CJob        job;
+                while (job.LoadFromDump(old_jobs_file,
+                                        input_buf.get(), output_buf.get(),
+                                        old_header)) {
+                    unsigned int    job_id = job.GetId();
+
+                    if (job.GetAffinityId() != 0)
+                        used_affinities.set_bit(job.GetAffinityId());
+                    if (job.GetGroupId() != 0)
+                        used_groups.set_bit(job.GetGroupId());
+
+                    if (state.deleted.get_bit(job_id))
+                        continue;
+                    if (state.jobs.find(job_id) != state.jobs.end())
+                        continue;
+                    job.Dump(new_jobs_file);
+                }
+            }
+            fclose(old_jobs_file);
+            old_jobs_file = NULL;
+        }
+
+        // The jobs which have been changed
+        for (map<unsigned int, CJob>::iterator  k = state.jobs.begin();
+                k != state.jobs.end(); ++k) {
+            CJob &          job = k->second;
+            unsigned int    aff_id = job.GetAffinityId();
+            unsigned int    group_id = job.GetGroupId();
+
+            if (aff_id != 0 &&
+                state.affinities.find(aff_id) == state.affinities.end()) {
+                ERR_POST(Warning << "Journal of queue " << m_QueueName <<
+                         ": no affinity token for job " << k->first <<
+                         ". The affinity is reset.");
+                job.SetAffinityId(0);
+                aff_id = 0;
+            }
+            if (group_id != 0 &&
+                state.groups.find(group_id) == state.groups.end()) {
+                ERR_POST(Warning << "Journal of queue " << m_QueueName <<
+                         ": no group token for job " << k->first <<
+                         ". The group is reset.");
+                job.SetGroupId(0);
+                group_id = 0;
+            }
+
+            if (aff_id != 0)
+                used_affinities.set_bit(aff_id);
+            if (group_id != 0)
+                used_groups.set_bit(group_id);
+            job.Dump(new_jobs_file);
+        }
+
+        s_SyncFile(new_jobs_file);
+        fclose(new_jobs_file);
+        new_jobs_file = NULL;
+    } catch (const exception &  ex) {
+        if (old_jobs_file != NULL)
+            fclose(old_jobs_file);
+        if (new_jobs_file != NULL)
+            fclose(new_jobs_file);
+        remove(tmp_jobs_file_name.c_str());
+        throw runtime_error("Error merging the journal of queue " +
+                            m_QueueName + ": " + string(ex.what()));
+    }
+
+    x_WriteDictionary(aff_file_name, true, state.affinities,
+                      used_affinities);
+    x_WriteDictionary(group_file_name, false, state.groups, used_groups);
+
+    if (!CFile(tmp_jobs_file_name).Rename(jobs_file_name,
+                                          CFile::fRF_Overwrite))
+        throw runtime_error("Cannot rename " + tmp_jobs_file_name +
+                            " to " + jobs_file_name);
+    return records;
+}
+
+
+// Reads the segment records into the merge state. A record which cannot be
+// read completely or does not match its checksum ends the segment: that is
+// how the tail written at the moment of a crash looks like.
+size_t CNSJobJournal::x_ReadSegment(unsigned int  segment,
+                                    SMergeState &  state,
+                                    char *  input_buf, char *  output_buf)
+{
+    string      file_name = x_GetSegmentFileName(segment);
+    FILE *      f = fopen(file_name.c_str(), "rb");
+    size_t      records = 0;
+
+    if (f == NULL)
+        throw runtime_error("Cannot open file " + file_name +
+                            " to read the jobs journal");
+
+    try {
+        SJournalDumpHeader      header;
+        if (header.Read(f) != 0) {
+            fclose(f);
+            return 0;
+        }
+
+        string      body;
+        for (;;) {
+            Uint4       record_header[2];   // Record type and body size
+            size_t      bytes = fread(record_header, 1,
+                                      sizeof(record_header), f);
+            if (bytes == 0 && feof(f))
+                break;
+
+            try {
+                if (bytes != sizeof(record_header))
+                    throw runtime_error("Incomplete record header");
+                if (record_header[1] == 0 ||
+                    record_header[1] > kMaxJournalRecordSize)
+                    throw runtime_error("Invalid record size " +
+                                        to_string(record_header[1]));
+
+                body.resize(record_header[1]);
+                if (fread(&body[0], body.size(), 1, f) != 1)
+                    throw runtime_error("Incomplete record");
+
+                Uint4       checksum;
+                if (fread(&checksum, sizeof(checksum), 1, f) != 1)
+                    throw runtime_error("Incomplete record checksum");
+                if (checksum != s_GetRecordChecksum(record_header, body))
+                    throw runtime_error("Record checksum mismatch");
+
+                x_ApplyRecord(record_header[0], body, header, state,
+                              input_buf, output_buf);
+            } catch (const exception &  ex) {
+                ERR_POST(Warning << "Journal file " << file_name <<
+                         " is truncated or damaged after " << records <<
+                         " records (" << ex.what() << "). The rest of the "
+                         "file is ignored.");
+                break;
+            }
+            ++records;
+        }
+    } catch (...) {
+        fclose(f);
+        throw;
+    }
+
+    fclose(f);
+    return records;
+}
+
+
+// Applies a record which checksum has been verified
+void CNSJobJournal::x_ApplyRecord(Uint4  record_type,
+                                  string &  body,
+                                  const SJournalDumpHeader &  header,
+                                  SMergeState &  state,
+                                  char *  input_buf, char *  output_buf)
+{
+    FILE *      f = fmemopen(&body[0], body.size(), "rb");
+    if (f == NULL)
+        throw runtime_error("Cannot open a memory stream for a journal "
+                            "record: " + string(strerror(errno)));
+
+    try {
+        CJob                job;
+        SAffinityDictDump   aff_dump;
+        SGroupDictDump      group_dump;
+        Uint4               job_id;
+
+        switch (record_type) {
+        case eJobRecord:
+            if (!job.LoadFromDump(f, input_buf, output_buf,
+                                  header.job_header))
+                throw runtime_error("Unexpected end of job record");
+            state.jobs[job.GetId()] = job;
+            state.deleted.set_bit(job.GetId(), false);
+            break;
+        case eDeletedJobRecord:
+            if (fread(&job_id, sizeof(job_id), 1, f) != 1)
+                throw runtime_error("Incomplete deleted job id");
+            state.jobs.erase(job_id);
+            state.deleted.set_bit(job_id);
+            break;
+        case eAffinityRecord:
+            if (aff_dump.Read(f, header.aff_fixed_size) != 0)
+                throw runtime_error("Unexpected end of affinity record");
+            state.affinities[aff_dump.aff_id] =
+                    string(aff_dump.token, aff_dump.token_size);
+            break;
+        case eGroupRecord:
+            if (group_dump.Read(f, header.group_fixed_size) != 0)
+                throw runtime_error("Unexpected end of group record");
+            state.groups[group_dump.group_id] =
+                    string(group_dump.token, group_dump.token_size);
+            break;
+        default:
+            throw runtime_error("Unknown record type " +
+                                to_string(record_type));
+        }
+    } catch (...) {
+        fclose(f);
+        throw;
+    }
+    fclose(f);
+}
+
+
+void CNSJobJournal::x_ReadDictionary(const string &  file_name,
+                                     bool  affinities,
+                                     map<unsigned int, string> &  dict)
+{
+    if (!CFile(file_name).Exists())
+        return;
+
+    FILE *      f = fopen(file_name.c_str(), "rb");
+    if (f == NULL)
+        throw runtime_error("Cannot open file " + file_name +
+                            " to read the journal snapshot");
+
+    try {
+        SOneStructDumpHeader    header;
+        if (header.Read(f) == 0) {
+            if (affinities) {
+                SAffinityDictDump   aff_dump;
+                while (aff_dump.Read(f, header.fixed_size) == 0)
+                    dict[aff_dump.aff_id] = string(aff_dump.token,
+                                                   aff_dump.token_size);
+            } else {
+                SGroupDictDump      group_dump;
+                while (group_dump.Read(f, header.fixed_size) == 0)
+                    dict[group_dump.group_id] = string(group_dump.token,
+                                                       group_dump.token_size);
+            }
+        }
+    } catch (...) {
+        fclose(f);
+        throw;
+    }
+    fclose(f);
+}
+
+
+void CNSJobJournal::x_WriteDictionary(const string &  file_name,
+                                      bool  affinities,
+                                      const map<unsigned int, string> &  dict,
+                                      const TNSBitVector &  used_ids)
+{
+    string      tmp_file_name = file_name + kTmpSuffix;
+    FILE *      f = fopen(tmp_file_name.c_str(), "wb");
+
+    if (f == NULL)
+        throw runtime_error("Cannot open file " + tmp_file_name +
+                            " to write the journal snapshot");
+
+    try {
+        SOneStructDumpHeader    header;
+        if (affinities)
+            header.fixed_size = sizeof(SAffinityDictDump);
+        else
+            header.fixed_size = sizeof(SGroupDictDump);
+        header.Write(f);
+
+        TNSBitVector::enumerator    en(used_ids.first());
+        for ( ; en.valid(); ++en) {
+            map<unsigned int, string>::const_iterator   k = dict.find(*en);
+            if (k == dict.end())
+                continue;
+
+            if (affinities) {
+                SAffinityDictDump   aff_dump;
+                aff_dump.aff_id = k->first;
+                aff_dump.token_size = min(k->second.size(),
+                                          sizeof(aff_dump.token));
+                memcpy(aff_dump.token, k->second.data(),
+                       aff_dump.token_size);
+                aff_dump.Write(f);
+            } else {
+                SGroupDictDump      group_dump;
+                group_dump.group_id = k->first;
+                group_dump.token_size = min(k->second.size(),
+                                            sizeof(group_dump.token));
+                memcpy(group_dump.token, k->second.data(),
+                       group_dump.token_size);
+                group_dump.Write(f);
+            }
+        }
+        s_SyncFile(f);
+    } catch (const exception &  ex) {
+        fclose(f);
+        remove(tmp_file_name.c_str());
+        throw runtime_error("Error writing the journal snapshot " +
+                            file_name + ": " + string(ex.what()));
+    }
+    fclose(f);
+
+    if (!CFile(tmp_file_name).Rename(file_name, CFile::fRF_Overwrite))
+        throw runtime_error("Cannot rename " + tmp_file_name +
+                            " to " + file_name);
+}
+
+
+void CNSJobJournal::x_WriteRecord(FILE *  f, ERecordType  record_type,
+                                  const string &  body)
+{
+    Uint4       record_header[2] = { Uint4(record_type),
+                                     Uint4(body.size()) };
+    Uint4       checksum = s_GetRecordChecksum(record_header, body);
+
+    errno = 0;
+    if (fwrite(record_header, sizeof(record_header), 1, f) != 1 ||
+        fwrite(body.data(), body.size(), 1, f) != 1 ||
+        fwrite(&checksum, sizeof(checksum), 1, f) != 1)
+        throw runtime_error(strerror(errno));
+}
+
+
+END_NCBI_SCOPE
@@ -0,0 +1,169 @@
+#ifndef NETSCHEDULE_JOURNAL__HPP
+#define NETSCHEDULE_JOURNAL__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   NetSchedule queue jobs journal
+ *
+ */
+
+
+#include "ns_types.hpp"
+#include "job.hpp"
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+
+BEGIN_NCBI_SCOPE
+
+
+struct SJournalDumpHeader;
+
+
+// The journal keeps the jobs of a queue on disk between the graceful
+// shutdowns, so that the jobs survive a crash.
+// It is not a write-ahead log: the clients get the replies before the
+// changes are journaled. The owning queue appends and syncs the changed
+// jobs every journal_sync_interval, so a crash loses the changes made
+// since the last completed sync.
+// The journal directory holds for each queue:
+// - a snapshot: the jobs and the affinity/group dictionary files exactly in
+//   the shutdown dump format, so the queue loads it as a dump
+// - segments: append only files with the job changes made after the
+//   snapshot. The last state of a job wins.
+// When the current segment grows large enough it is closed and merged with
+// the snapshot into a new snapshot.
+// The class is not thread safe; the owning queue serializes the calls.
+class CNSJobJournal
+{
+    public:
+        // What the journal is started from. Whatever it is, the snapshot
+        // must describe the jobs the queue has in memory at the moment.
+        enum EStartFrom {
+            eFromSnapshot,      // The queue has been loaded from the journal
+            eFromDump,          // The queue has been loaded from the dump
+            eFromScratch        // The queue has no jobs
+        };
+
+    public:
+        CNSJobJournal(const string &  journal_dname,
+                      const string &  qname);
+        ~CNSJobJournal();
+
+        // Merges all the segments into the snapshot.
+        // Returns the number of the replayed records.
+        size_t Recover(void);
+
+        void Start(EStartFrom       from,
+                   const string &   dump_dname,
+                   bool             keep_dump);
+        void Close(bool  remove_files);
+
+        // The dictionary records are written once per segment,
+        // before the first job which refers to them
+        bool IsAffinityWritten(unsigned int  aff_id) const
+        { return m_WrittenAffinities.get_bit(aff_id); }
+        bool IsGroupWritten(unsigned int  group_id) const
+        { return m_WrittenGroups.get_bit(group_id); }
+
+        // The records are durable only after Sync()
+        void AppendJob(const CJob &    job,
+                       const string &  aff_token,
+                       const string &  group_token);
+        void AppendDeletedJob(unsigned int  job_id);
+        void Sync(void);
+
+        Int8 GetSegmentSize(void) const;
+        void Compact(void);
+
+        // true if the file in a journal directory belongs to the queue
+        static bool IsQueueFile(const string &  file_name,
+                                const string &  qname);
+
+    private:
+        enum ERecordType {
+            eJobRecord = 1,
+            eDeletedJobRecord = 2,
+            eAffinityRecord = 3,
+            eGroupRecord = 4
+        };
+
+        struct SMergeState
+        {
+            map<unsigned int, CJob>     jobs;       // The last journaled state
+            TNSBitVector                deleted;
+            map<unsigned int, string>   affinities;
+            map<unsigned int, string>   groups;
+        };
+
+        string x_GetSnapshotFileName(const string &  prefix) const;
+        string x_GetSegmentFileName(unsigned int  segment) const;
+        vector<unsigned int> x_GetSegments(void) const;
+        void x_OpenSegment(unsigned int  segment);
+        void x_CloseSegment(void);
+        void x_RemoveSegments(const vector<unsigned int> &  segments);
+        void x_RemoveSnapshot(void);
+
+        size_t x_Merge(const vector<unsigned int> &  segments);
+        size_t x_ReadSegment(unsigned int  segment,
+                             SMergeState &  state,
+                             char *  input_buf, char *  output_buf);
+        void x_ApplyRecord(Uint4  record_type,
+                           string &  body,
+                           const SJournalDumpHeader &  header,
+                           SMergeState &  state,
+                           char *  input_buf, char *  output_buf);
+        void x_ReadDictionary(const string &  file_name,
+                              bool  affinities,
+                              map<unsigned int, string> &  dict);
+        void x_WriteDictionary(const string &  file_name,
+                               bool  affinities,
+                               const map<unsigned int, string> &  dict,
+                               const TNSBitVector &  used_ids);
+        void x_WriteRecord(FILE *  f, ERecordType  record_type,
+                           const string &  body);
+
+    private:
+        string          m_DirName;
+        string          m_QueueName;        // Upper case, as in dump files
+        FILE *          m_Segment;
+        unsigned int    m_SegmentNumber;
+        TNSBitVector    m_WrittenAffinities;
+        TNSBitVector    m_WrittenGroups;
+
+    private:
+        CNSJobJournal(const CNSJobJournal &);
+        CNSJobJournal &  operator=(const CNSJobJournal &);
+};
+
+
+END_NCBI_SCOPE
+
+#endif /* NETSCHEDULE_JOURNAL__HPP */
@@ -309,10 +309,48 @@ CNSNotificationList::NotifyJobChanges(unsigned int      address,
                                       unsigned short    port,
                                       const string &    notification)
 {
+    // Goes through the queue so that it does not overtake the notifications
+    // queued earlier and not sent yet
+    QueueJobChanges(address, port, notification);
+    SendQueuedJobChanges();
+}
+
+
+void
+CNSNotificationList::QueueJobChanges(unsigned int      address,
+                                     unsigned short    port,
+                                     const string &    notification)
+{
+    SJobChangeNotif     notif;
+    notif.m_Address = address;
+    notif.m_Port = port;
+    notif.m_Notification = notification;
+
+    CFastMutexGuard     guard(m_JobChangeNotifsLock);
+    m_JobChangeNotifs.push_back(std::move(notif));
+}
+
+
+void
+CNSNotificationList::SendQueuedJobChanges(void)
+{
+    // The notifications are taken from the queue and sent under the socket
+    // lock so they go out in the order of the job transitions
     CFastMutexGuard     guard(m_StatusNotificationSocketLock);
-    m_StatusNotificationSocket.Send(notification.c_str(),
-                                    notification.size() + 1,
-                                    CSocketAPI::ntoa(address), port);
+    for (;;) {
+        SJobChangeNotif     notif;
+        {{
+            CFastMutexGuard     queue_guard(m_JobChangeNotifsLock);
+            if (m_JobChangeNotifs.empty())
+                return;
+            notif = std::move(m_JobChangeNotifs.front());
+            m_JobChangeNotifs.pop_front();
+        }}
+        m_StatusNotificationSocket.Send(notif.m_Notification.c_str(),
+                                        notif.m_Notification.size() + 1,
+                                        CSocketAPI::ntoa(notif.m_Address),
+                                        notif.m_Port);
+    }
 }
 
 
@@ -39,6 +39,7 @@
 #include <corelib/ncbithr.hpp>
 
 #include <list>
+#include <deque>
 
 #include "ns_types.hpp"
 #include "ns_precise_time.hpp"
@@ -144,6 +145,13 @@ class CNSNotificationList
         void NotifyJobChanges(unsigned int      address,
                               unsigned short    port,
                               const string &    notification);
+        // The job change notifications are sent in the order they are
+        // queued. The queue is cheap to fill under the queue operation lock
+        // while the datagrams can be sent after the lock is released.
+        void QueueJobChanges(unsigned int      address,
+                             unsigned short    port,
+                             const string &    notification);
+        void SendQueuedJobChanges(void);
 
         string BuildJobChangedNotification(const CJob &         job,
                                            const string &       job_key,
@@ -245,6 +253,15 @@ class CNSNotificationList
 
         CDatagramSocket     m_StatusNotificationSocket;
         CFastMutex          m_StatusNotificationSocketLock;
+
+        struct SJobChangeNotif
+        {
+            unsigned int    m_Address;
+            unsigned short  m_Port;
+            string          m_Notification;
+        };
+        deque<SJobChangeNotif>  m_JobChangeNotifs;
+        CFastMutex              m_JobChangeNotifsLock;
         string              m_JobChangeNotifConstPart;
 
         CQueueDataBase &    m_QueueDB;
@@ -52,6 +52,7 @@
 #include <util/qparse/query_exec.hpp>
 #include <util/qparse/query_exec_bv.hpp>
 #include <util/bitset/bmalgo.h>
+#include <util/bitset/bmaggregator.h>
 
 
 BEGIN_NCBI_SCOPE
@@ -62,6 +63,9 @@ BEGIN_NCBI_SCOPE
 // s_ReserveDelta value is used to avoid to often DB updates
 static const unsigned int       s_ReserveDelta = 10000;
 
+// Max number of jobs copied for the journal under one operation lock
+static const size_t             s_JournalBatchSize = 1000;
+
 
 CQueue::CQueue(const string &        queue_name,
                TQueueKind            queue_kind,
@@ -124,7 +128,11 @@ CQueue::CQueue(const string &        queue_name,
     m_ClientRegistryMinReaders(default_client_registry_min_readers),
     m_ClientRegistryTimeoutUnknown(default_client_registry_timeout_unknown),
     m_ClientRegistryMinUnknowns(default_client_registry_min_unknowns),
-    m_ShouldPerfLogTransitions(false)
+    m_ShouldPerfLogTransitions(false),
+    m_Journal(NULL),
+    m_JournalActive(false),
+    m_JournalPassesStarted(0),
+    m_JournalPassesSynced(0)
 {
     _ASSERT(!queue_name.empty());
     m_ClientsRegistry.SetRegistries(&m_AffinityRegistry,
@@ -139,6 +147,7 @@ CQueue::CQueue(const string &        queue_name,
 CQueue::~CQueue()
 {
     delete m_RunTimeLine;
+    delete m_Journal;
 }
 
 
@@ -423,8 +432,8 @@ unsigned int  CQueue::Submit(const CNSClientId &        client,
     event.SetStatus(CNetScheduleAPI::ePending);
     event.SetEvent(CJobEvent::eSubmit);
     event.SetTimestamp(op_begin_time);
-    event.SetClientNode(client.GetNode());
-    event.SetClientSession(client.GetSession());
+    event.SetClientNode(client.GetInternedNode());
+    event.SetClientSession(client.GetInternedSession());
 
     // Special treatment for system job masks
     if (job.GetMask() & CNetScheduleAPI::eOutOfOrder)
@@ -478,7 +487,8 @@ unsigned int  CQueue::Submit(const CNSClientId &        client,
             job.SetAffinityId(aff_id);
         }
 
-        m_Jobs[job_id] = job;
+        // Job ids only grow so the new job almost always goes to the end
+        m_Jobs.emplace_hint(m_Jobs.end(), job_id, job);
 
         m_StatusTracker.AddPendingJob(job_id);
 
@@ -585,8 +595,8 @@ CQueue::SubmitBatch(const CNSClientId &             client,
             event.SetStatus(CNetScheduleAPI::ePending);
             event.SetEvent(CJobEvent::eBatchSubmit);
             event.SetTimestamp(curr_time);
-            event.SetClientNode(client.GetNode());
-            event.SetClientSession(client.GetSession());
+            event.SetClientNode(client.GetInternedNode());
+            event.SetClientSession(client.GetInternedSession());
 
             if (!aff_token.empty()) {
                 unsigned int    aff_id = m_AffinityRegistry.
@@ -599,7 +609,7 @@ CQueue::SubmitBatch(const CNSClientId &             client,
                 affinities.set_bit(aff_id);
             }
 
-            m_Jobs[job_id_cnt] = job;
+            m_Jobs.emplace_hint(m_Jobs.end(), job_id_cnt, job);
             ++job_id_cnt;
         }
 
@@ -663,52 +673,61 @@ TJobStatus  CQueue::PutResult(const CNSClientId &     client,
         NCBI_THROW(CNetScheduleException, eDataTooLong,
                    "Output is too long");
 
-    CFastMutexGuard     guard(m_OperationLock);
-    TJobStatus          old_status = GetJobStatus(job_id);
+    TJobStatus          old_status;
 
-    if (old_status == CNetScheduleAPI::eDone) {
-        m_StatisticsCounters.CountTransition(CNetScheduleAPI::eDone,
-                                             CNetScheduleAPI::eDone);
-        return old_status;
-    }
+    {{
+        CFastMutexGuard     guard(m_OperationLock);
 
-    if (old_status != CNetScheduleAPI::ePending &&
-        old_status != CNetScheduleAPI::eRunning &&
-        old_status != CNetScheduleAPI::eFailed)
-        return old_status;
+        old_status = GetJobStatus(job_id);
+        if (old_status == CNetScheduleAPI::eDone) {
+            m_StatisticsCounters.CountTransition(CNetScheduleAPI::eDone,
+                                                 CNetScheduleAPI::eDone);
+            return old_status;
+        }
 
-    x_UpdateDB_PutResultNoLock(job_id, auth_token, curr, ret_code, output,
-                               job, client);
+        if (old_status != CNetScheduleAPI::ePending &&
+            old_status != CNetScheduleAPI::eRunning &&
+            old_status != CNetScheduleAPI::eFailed)
+            return old_status;
 
-    m_StatusTracker.SetStatus(job_id, CNetScheduleAPI::eDone);
-    m_StatisticsCounters.CountTransition(old_status,
-                                         CNetScheduleAPI::eDone);
-    g_DoPerfLogging(*this, job, 200);
-    m_ClientsRegistry.UnregisterJob(job_id, eGet);
+        x_UpdateDB_PutResultNoLock(job_id, auth_token, curr, ret_code, output,
+                                   job, client);
 
-    m_GCRegistry.UpdateLifetime(job_id,
-                                job.GetExpirationTime(m_Timeout,
-                                                      m_RunTimeout,
-                                                      m_ReadTimeout,
-                                                      m_PendingTimeout,
-                                                      curr));
+        m_StatusTracker.SetStatus(job_id, CNetScheduleAPI::eDone);
+        m_StatisticsCounters.CountTransition(old_status,
+                                             CNetScheduleAPI::eDone);
+        m_ClientsRegistry.UnregisterJob(job_id, eGet);
 
-    TimeLineRemove(job_id);
+        m_GCRegistry.UpdateLifetime(job_id,
+                                    job.GetExpirationTime(m_Timeout,
+                                                          m_RunTimeout,
+                                                          m_ReadTimeout,
+                                                          m_PendingTimeout,
+                                                          curr));
 
-    x_NotifyJobChanges(job, job_key, eStatusChanged, curr);
+        TimeLineRemove(job_id);
 
-    // Notify the readers if the job has not been given for reading yet
-    if (!m_ReadJobs.get_bit(job_id)) {
-        m_GCRegistry.UpdateReadVacantTime(job_id, curr);
-        m_NotificationsList.Notify(job_id, job.GetAffinityId(),
-                                   m_ClientsRegistry,
-                                   m_AffinityRegistry,
-                                   m_GroupRegistry,
-                                   m_ScopeRegistry,
-                                   m_NotifHifreqPeriod,
-                                   m_HandicapTimeout,
-                                   eRead);
-    }
+        // Queued under the lock to keep the order of the job transitions
+        x_QueueJobChanges(job, job_key, eStatusChanged, curr);
+
+        // Notify the readers if the job has not been given for reading yet
+        if (!m_ReadJobs.get_bit(job_id)) {
+            m_GCRegistry.UpdateReadVacantTime(job_id, curr);
+            m_NotificationsList.Notify(job_id, job.GetAffinityId(),
+                                       m_ClientsRegistry,
+                                       m_AffinityRegistry,
+                                       m_GroupRegistry,
+                                       m_ScopeRegistry,
+                                       m_NotifHifreqPeriod,
+                                       m_HandicapTimeout,
+                                       eRead);
+        }
+    }}
+
+    // The perf logging uses only the job copy and the queued notifications
+    // are sent in order, so both are done without holding the queue lock
+    g_DoPerfLogging(*this, job, 200);
+    m_NotificationsList.SendQueuedJobChanges();
     return old_status;
 }
 
@@ -729,7 +748,9 @@ CQueue::GetJobOrWait(const CNSClientId &       client,
                      const list<string> *      group_list,
                      CJob *                    new_job,
                      CNSRollbackInterface * &  rollback_action,
-                     string &                  added_pref_aff)
+                     string &                  added_pref_aff,
+                     unsigned int              max_extra_jobs,
+                     vector<CJob> *            extra_jobs)
 {
     // We need exactly 1 parameter - m_RunTimeout, so we can access it without
     // CQueueParamAccessor
@@ -859,44 +880,197 @@ CQueue::GetJobOrWait(const CNSClientId &       client,
                 }
             }
 
-            x_UpdateDB_ProvideJobNoLock(client, curr, job_pick.job_id, eGet,
-                                        *new_job);
-            m_StatusTracker.SetStatus(job_pick.job_id,
-                                      CNetScheduleAPI::eRunning);
-
-            m_StatisticsCounters.CountTransition(
-                                        CNetScheduleAPI::ePending,
-                                        CNetScheduleAPI::eRunning);
-            g_DoPerfLogging(*this, *new_job, 200);
+            x_StartJobNoLock(client, curr, job_pick.job_id, *new_job);
+            x_QueueJobChanges(*new_job, MakeJobKey(job_pick.job_id),
+                              eStatusChanged, curr);
             if (outdated_job)
                 m_StatisticsCounters.CountOutdatedPick(eGet);
 
-            m_GCRegistry.UpdateLifetime(
-                        job_pick.job_id,
-                        new_job->GetExpirationTime(m_Timeout,
-                                                   m_RunTimeout,
-                                                   m_ReadTimeout,
-                                                   m_PendingTimeout,
-                                                   curr));
-            TimeLineAdd(job_pick.job_id, curr + m_RunTimeout);
-            m_ClientsRegistry.RegisterJob(client, job_pick.job_id, eGet);
-
-            x_NotifyJobChanges(*new_job, MakeJobKey(job_pick.job_id),
-                               eStatusChanged, curr);
-
             // If there are no more pending jobs, let's clear the
             // list of delayed exact notifications.
             if (!m_StatusTracker.AnyPending())
                 m_NotificationsList.ClearExactGetNotifications();
-
-            rollback_action = new CNSGetJobRollback(client, job_pick.job_id);
-            return true;
         }}
+
+        vector<unsigned int>    job_ids(1, job_pick.job_id);
+        if (extra_jobs != NULL && max_extra_jobs > 0 &&
+            m_MaxJobsPerClient == 0 && !prioritized_aff) {
+            // The jobs of the affinity the client has just got exclusively
+            // are its jobs now as well
+            TNSBitVector    extra_affs = aff_ids_vector;
+            if (!added_pref_aff.empty() && job_pick.aff_id != 0)
+                extra_affs.set_bit(job_pick.aff_id);
+
+            x_StartExtraJobs(client, curr, extra_affs, wnode_affinity,
+                             any_affinity, group_ids_vector, has_groups,
+                             max_extra_jobs, *extra_jobs);
+            for (vector<CJob>::const_iterator  k = extra_jobs->begin();
+                    k != extra_jobs->end(); ++k)
+                job_ids.push_back(k->GetId());
+        }
+
+        // The jobs are ours now; the rest needs only the job copies and
+        // the notifications queued under the lock
+        g_DoPerfLogging(*this, *new_job, 200);
+        if (extra_jobs != NULL) {
+            for (vector<CJob>::const_iterator  k = extra_jobs->begin();
+                    k != extra_jobs->end(); ++k)
+                g_DoPerfLogging(*this, *k, 200);
+        }
+        m_NotificationsList.SendQueuedJobChanges();
+
+        rollback_action = new CNSGetJobRollback(client, job_ids);
+        return true;
     }
     return true;
 }
 
 
+// Picks up to max_count more pending jobs for the client which has just got
+// a job by GET2 with count > 1. The extra jobs must match the explicit
+// affinities, the preferred ones (if wnode_affinity) or any affinity (if
+// any_affinity); a new exclusive affinity is never claimed for them.
+// All the candidates are selected in one pass over the registry bit vectors
+// and then confirmed under a single acquisition of the operation lock.
+// The run timeout of every extra job starts here as for the first one; it is
+// the client that asks for no more jobs than it can start right away.
+void
+CQueue::x_StartExtraJobs(const CNSClientId &     client,
+                         const CNSPreciseTime &  curr,
+                         const TNSBitVector &    explicit_affs,
+                         bool                    use_pref_affinity,
+                         bool                    any_affinity,
+                         const TNSBitVector &    group_ids,
+                         bool                    has_groups,
+                         unsigned int            max_count,
+                         vector<CJob> &          jobs)
+{
+    // See CXX-5324: the virtual scope jobs go first
+    vector<TNSBitVector>    candidates;
+    string                  virtual_scope = client.GetVirtualScope();
+
+    if (!virtual_scope.empty())
+        candidates.push_back(x_FindVacantJobs(client, explicit_affs,
+                                              use_pref_affinity, any_affinity,
+                                              group_ids, has_groups,
+                                              virtual_scope));
+    candidates.push_back(x_FindVacantJobs(client, explicit_affs,
+                                          use_pref_affinity, any_affinity,
+                                          group_ids, has_groups,
+                                          client.GetScope()));
+
+    CFastMutexGuard     guard(m_OperationLock);
+
+    // The queue could be paused after the handler checked it for the first
+    // job; no more jobs are given out then
+    if (m_PauseStatus != eNoPause)
+        return;
+
+    for (vector<TNSBitVector>::const_iterator  k = candidates.begin();
+            k != candidates.end() && jobs.size() < max_count; ++k) {
+        TNSBitVector::enumerator    en(k->first());
+        for (; en.valid() && jobs.size() < max_count; ++en) {
+            unsigned int    job_id = *en;
+
+            // The job could be grabbed by another WN or GC in between;
+            // the virtual scope may also have given it already
+            if (GetJobStatus(job_id) != CNetScheduleAPI::ePending)
+                continue;
+
+            jobs.push_back(CJob());
+            x_StartJobNoLock(client, curr, job_id, jobs.back());
+            x_QueueJobChanges(jobs.back(), MakeJobKey(job_id),
+                              eStatusChanged, curr);
+        }
+    }
+
+    if (!jobs.empty() && !m_StatusTracker.AnyPending())
+        m_NotificationsList.ClearExactGetNotifications();
+}
+
+
+// Provides the vacant jobs matching the GET2 criteria for the given scope.
+// The pending jobs are combined with the scope, group and affinity jobs and
+// the out of scope and blacklisted jobs are subtracted by one fused AND-SUB
+// aggregate operation instead of a chain of temporary bit vectors.
+TNSBitVector
+CQueue::x_FindVacantJobs(const CNSClientId &   client,
+                         const TNSBitVector &  explicit_affs,
+                         bool                  use_pref_affinity,
+                         bool                  any_affinity,
+                         const TNSBitVector &  group_ids,
+                         bool                  has_groups,
+                         const string &        scope)
+{
+    TNSBitVector    pending_jobs;
+    TNSBitVector    scope_jobs;
+    TNSBitVector    group_jobs;
+    TNSBitVector    aff_jobs;
+    TNSBitVector    excluded_jobs;
+    TNSBitVector    vacant_jobs;
+
+    m_StatusTracker.GetJobs(CNetScheduleAPI::ePending, pending_jobs);
+    if (!pending_jobs.any())
+        return vacant_jobs;
+
+    bm::aggregator<TNSBitVector>    aggregator;
+    aggregator.add(&pending_jobs, 0);
+
+    if (scope.empty() || scope == kNoScopeOnly) {
+        // Both these cases should consider only the non-scope jobs
+        excluded_jobs = m_ScopeRegistry.GetAllJobsInScopes();
+    } else {
+        scope_jobs = m_ScopeRegistry.GetJobs(scope);
+        aggregator.add(&scope_jobs, 0);
+    }
+
+    if (has_groups) {
+        group_jobs = m_GroupRegistry.GetJobs(group_ids);
+        aggregator.add(&group_jobs, 0);
+    }
+
+    if (!any_affinity) {
+        TNSBitVector    affs = explicit_affs;
+        if (use_pref_affinity)
+            affs |= m_ClientsRegistry.GetPreferredAffinities(client, eGet);
+        if (!affs.any())
+            return vacant_jobs;
+        aff_jobs = m_AffinityRegistry.GetJobsWithAffinities(affs);
+        aggregator.add(&aff_jobs, 0);
+    }
+
+    m_ClientsRegistry.AddBlacklistedJobs(client, eGet, excluded_jobs);
+    aggregator.add(&excluded_jobs, 1);
+
+    aggregator.combine_and_sub(vacant_jobs);
+    return vacant_jobs;
+}
+
+
+// Moves a pending job to the running state on behalf of the client
+void
+CQueue::x_StartJobNoLock(const CNSClientId &     client,
+                         const CNSPreciseTime &  curr,
+                         unsigned int            job_id,
+                         CJob &                  job)
+{
+    x_UpdateDB_ProvideJobNoLock(client, curr, job_id, eGet, job);
+    m_StatusTracker.SetStatus(job_id, CNetScheduleAPI::eRunning);
+
+    m_StatisticsCounters.CountTransition(CNetScheduleAPI::ePending,
+                                         CNetScheduleAPI::eRunning);
+
+    m_GCRegistry.UpdateLifetime(job_id,
+                                job.GetExpirationTime(m_Timeout,
+                                                      m_RunTimeout,
+                                                      m_ReadTimeout,
+                                                      m_PendingTimeout,
+                                                      curr));
+    TimeLineAdd(job_id, curr + m_RunTimeout);
+    m_ClientsRegistry.RegisterJob(client, job_id, eGet);
+}
+
+
 void  CQueue::CancelWaitGet(const CNSClientId &  client)
 {
     bool    result;
@@ -1341,6 +1515,7 @@ bool CQueue::PutProgressMessage(unsigned int    job_id,
 
     job_iter->second.SetProgressMsg(msg);
     job_iter->second.SetLastTouch(curr);
+    m_StatusTracker.MarkChanged(job_id);
 
     m_GCRegistry.UpdateLifetime(
         job_id, job_iter->second.GetExpirationTime(m_Timeout, m_RunTimeout,
@@ -1363,101 +1538,111 @@ TJobStatus  CQueue::ReturnJob(const CNSClientId &     client,
                               TJobReturnOption        how)
 {
     CNSPreciseTime      current_time = CNSPreciseTime::Current();
-    CFastMutexGuard     guard(m_OperationLock);
-    TJobStatus          old_status = GetJobStatus(job_id);
+    TJobStatus          old_status;
 
-    if (old_status != CNetScheduleAPI::eRunning)
-        return old_status;
+    {{
+        CFastMutexGuard     guard(m_OperationLock);
 
-    auto        job_iter = m_Jobs.find(job_id);
-    if (job_iter == m_Jobs.end())
-        NCBI_THROW(CNetScheduleException, eInternalError, "Error fetching job");
+        old_status = GetJobStatus(job_id);
 
-    if (!auth_token.empty()) {
-        // Need to check authorization token first
-        CJob::EAuthTokenCompareResult   token_compare_result =
-                                job_iter->second.CompareAuthToken(auth_token);
-        if (token_compare_result == CJob::eInvalidTokenFormat)
-            NCBI_THROW(CNetScheduleException, eInvalidAuthToken,
-                       "Invalid authorization token format");
-        if (token_compare_result == CJob::eNoMatch)
-            NCBI_THROW(CNetScheduleException, eInvalidAuthToken,
-                       "Authorization token does not match");
-        if (token_compare_result == CJob::ePassportOnlyMatch) {
-            // That means the job has been given to another worker node
-            // by whatever reason (expired/failed/returned before)
-            ERR_POST(Warning << "Received RETURN2 with only "
-                                "passport matched.");
-            warning = "eJobPassportOnlyMatch:Only job passport matched. "
-                      "Command is ignored.";
-            job = job_iter->second;
+        if (old_status != CNetScheduleAPI::eRunning)
             return old_status;
+
+        auto        job_iter = m_Jobs.find(job_id);
+        if (job_iter == m_Jobs.end())
+            NCBI_THROW(CNetScheduleException, eInternalError,
+                       "Error fetching job");
+
+        if (!auth_token.empty()) {
+            // Need to check authorization token first
+            CJob::EAuthTokenCompareResult   token_compare_result =
+                            job_iter->second.CompareAuthToken(auth_token);
+            if (token_compare_result == CJob::eInvalidTokenFormat)
+                NCBI_THROW(CNetScheduleException, eInvalidAuthToken,
+                           "Invalid authorization token format");
+            if (token_compare_result == CJob::eNoMatch)
+                NCBI_THROW(CNetScheduleException, eInvalidAuthToken,
+                           "Authorization token does not match");
+            if (token_compare_result == CJob::ePassportOnlyMatch) {
+                // That means the job has been given to another worker node
+                // by whatever reason (expired/failed/returned before)
+                ERR_POST(Warning << "Received RETURN2 with only "
+                                    "passport matched.");
+                warning = "eJobPassportOnlyMatch:Only job passport matched. "
+                          "Command is ignored.";
+                job = job_iter->second;
+                return old_status;
+            }
+            // Here: the authorization token is OK, we can continue
         }
-        // Here: the authorization token is OK, we can continue
-    }
 
-    unsigned int    run_count = job_iter->second.GetRunCount();
-    CJobEvent *     event = job_iter->second.GetLastEvent();
+        unsigned int    run_count = job_iter->second.GetRunCount();
+        CJobEvent *     event = job_iter->second.GetLastEvent();
 
-    if (!event)
-        ERR_POST("No JobEvent for running job");
+        if (!event)
+            ERR_POST("No JobEvent for running job");
 
-    event = &job_iter->second.AppendEvent();
-    event->SetNodeAddr(client.GetAddress());
-    event->SetStatus(CNetScheduleAPI::ePending);
-    switch (how) {
-        case eWithBlacklist:
-            event->SetEvent(CJobEvent::eReturn);
-            break;
-        case eWithoutBlacklist:
-            event->SetEvent(CJobEvent::eReturnNoBlacklist);
-            break;
-        case eRollback:
-            event->SetEvent(CJobEvent::eNSGetRollback);
-            break;
-    }
-    event->SetTimestamp(current_time);
-    event->SetClientNode(client.GetNode());
-    event->SetClientSession(client.GetSession());
+        event = &job_iter->second.AppendEvent();
+        event->SetNodeAddr(client.GetAddress());
+        event->SetStatus(CNetScheduleAPI::ePending);
+        switch (how) {
+            case eWithBlacklist:
+                event->SetEvent(CJobEvent::eReturn);
+                break;
+            case eWithoutBlacklist:
+                event->SetEvent(CJobEvent::eReturnNoBlacklist);
+                break;
+            case eRollback:
+                event->SetEvent(CJobEvent::eNSGetRollback);
+                break;
+        }
+        event->SetTimestamp(current_time);
+        event->SetClientNode(client.GetInternedNode());
+        event->SetClientSession(client.GetInternedSession());
 
-    if (run_count)
-        job_iter->second.SetRunCount(run_count - 1);
+        if (run_count)
+            job_iter->second.SetRunCount(run_count - 1);
 
-    job_iter->second.SetStatus(CNetScheduleAPI::ePending);
-    job_iter->second.SetLastTouch(current_time);
+        job_iter->second.SetStatus(CNetScheduleAPI::ePending);
+        job_iter->second.SetLastTouch(current_time);
 
-    m_StatusTracker.SetStatus(job_id, CNetScheduleAPI::ePending);
-    switch (how) {
-        case eWithBlacklist:
-            m_StatisticsCounters.CountTransition(old_status,
-                                                 CNetScheduleAPI::ePending);
-            break;
-        case eWithoutBlacklist:
-            m_StatisticsCounters.CountToPendingWithoutBlacklist(1);
-            break;
-        case eRollback:
-            m_StatisticsCounters.CountNSGetRollback(1);
-            break;
-    }
-    g_DoPerfLogging(*this, job_iter->second, 200);
-    TimeLineRemove(job_id);
-    m_ClientsRegistry.UnregisterJob(job_id, eGet);
-    if (how == eWithBlacklist)
-        m_ClientsRegistry.RegisterBlacklistedJob(client, job_id, eGet);
-    m_GCRegistry.UpdateLifetime(
-        job_id, job_iter->second.GetExpirationTime(m_Timeout, m_RunTimeout,
-                                                   m_ReadTimeout, m_PendingTimeout,
-                                                   current_time));
+        m_StatusTracker.SetStatus(job_id, CNetScheduleAPI::ePending);
+        switch (how) {
+            case eWithBlacklist:
+                m_StatisticsCounters.CountTransition(old_status,
+                                                     CNetScheduleAPI::ePending);
+                break;
+            case eWithoutBlacklist:
+                m_StatisticsCounters.CountToPendingWithoutBlacklist(1);
+                break;
+            case eRollback:
+                m_StatisticsCounters.CountNSGetRollback(1);
+                break;
+        }
+        TimeLineRemove(job_id);
+        m_ClientsRegistry.UnregisterJob(job_id, eGet);
+        if (how == eWithBlacklist)
+            m_ClientsRegistry.RegisterBlacklistedJob(client, job_id, eGet);
+        m_GCRegistry.UpdateLifetime(
+            job_id, job_iter->second.GetExpirationTime(m_Timeout, m_RunTimeout,
+                                                       m_ReadTimeout,
+                                                       m_PendingTimeout,
+                                                       current_time));
 
-    x_NotifyJobChanges(job_iter->second, job_key, eStatusChanged, current_time);
+        if (m_PauseStatus == eNoPause)
+            m_NotificationsList.Notify(
+                job_id, job_iter->second.GetAffinityId(), m_ClientsRegistry,
+                m_AffinityRegistry, m_GroupRegistry, m_ScopeRegistry,
+                m_NotifHifreqPeriod, m_HandicapTimeout, eGet);
 
-    if (m_PauseStatus == eNoPause)
-        m_NotificationsList.Notify(
-            job_id, job_iter->second.GetAffinityId(), m_ClientsRegistry,
-            m_AffinityRegistry, m_GroupRegistry, m_ScopeRegistry,
-            m_NotifHifreqPeriod, m_HandicapTimeout, eGet);
+        job = job_iter->second;
+        x_QueueJobChanges(job, job_key, eStatusChanged, current_time);
+    }}
 
-    job = job_iter->second;
+    // Logging works on the job copy; the notifications are sent in the
+    // order they were queued
+    g_DoPerfLogging(*this, job, 200);
+    m_NotificationsList.SendQueuedJobChanges();
     return old_status;
 }
 
@@ -1531,8 +1716,8 @@ TJobStatus  CQueue::RescheduleJob(const CNSClientId &     client,
     event->SetStatus(CNetScheduleAPI::ePending);
     event->SetEvent(CJobEvent::eReschedule);
     event->SetTimestamp(current_time);
-    event->SetClientNode(client.GetNode());
-    event->SetClientSession(client.GetSession());
+    event->SetClientNode(client.GetInternedNode());
+    event->SetClientSession(client.GetInternedSession());
 
     if (run_count)
         job_iter->second.SetRunCount(run_count - 1);
@@ -1612,8 +1797,8 @@ TJobStatus  CQueue::RedoJob(const CNSClientId &     client,
     event->SetStatus(CNetScheduleAPI::ePending);
     event->SetEvent(CJobEvent::eRedo);
     event->SetTimestamp(current_time);
-    event->SetClientNode(client.GetNode());
-    event->SetClientSession(client.GetSession());
+    event->SetClientNode(client.GetInternedNode());
+    event->SetClientSession(client.GetInternedSession());
 
     job_iter->second.SetStatus(CNetScheduleAPI::ePending);
     job_iter->second.SetLastTouch(current_time);
@@ -1708,8 +1893,8 @@ TJobStatus  CQueue::Cancel(const CNSClientId &  client,
     else
         event->SetEvent(CJobEvent::eCancel);
     event->SetTimestamp(current_time);
-    event->SetClientNode(client.GetNode());
-    event->SetClientSession(client.GetSession());
+    event->SetClientNode(client.GetInternedNode());
+    event->SetClientSession(client.GetInternedSession());
 
     job_iter->second.SetStatus(CNetScheduleAPI::eCanceled);
     job_iter->second.SetLastTouch(current_time);
@@ -1811,8 +1996,8 @@ unsigned int CQueue::x_CancelJobs(const CNSClientId &   client,
         event->SetStatus(CNetScheduleAPI::eCanceled);
         event->SetEvent(CJobEvent::eCancel);
         event->SetTimestamp(current_time);
-        event->SetClientNode(client.GetNode());
-        event->SetClientSession(client.GetSession());
+        event->SetClientNode(client.GetInternedNode());
+        event->SetClientSession(client.GetInternedSession());
 
         job_iter->second.SetStatus(CNetScheduleAPI::eCanceled);
         job_iter->second.SetLastTouch(current_time);
@@ -2293,8 +2478,8 @@ TJobStatus  CQueue::RereadJob(const CNSClientId &     client,
     event->SetStatus(state_before_read);
     event->SetEvent(CJobEvent::eReread);
     event->SetTimestamp(current_time);
-    event->SetClientNode(client.GetNode());
-    event->SetClientSession(client.GetSession());
+    event->SetClientNode(client.GetInternedNode());
+    event->SetClientSession(client.GetInternedSession());
 
     job_iter->second.SetStatus(state_before_read);
     job_iter->second.SetLastTouch(current_time);
@@ -2382,8 +2567,8 @@ TJobStatus  CQueue::x_ChangeReadingStatus(const CNSClientId &  client,
     CJobEvent &     event = job_iter->second.AppendEvent();
     event.SetTimestamp(current_time);
     event.SetNodeAddr(client.GetAddress());
-    event.SetClientNode(client.GetNode());
-    event.SetClientSession(client.GetSession());
+    event.SetClientNode(client.GetInternedNode());
+    event.SetClientSession(client.GetInternedSession());
     event.SetErrorMsg(err_msg);
 
     if (is_ns_rollback) {
@@ -2722,6 +2907,30 @@ CQueue::x_FindVacantJob(const CNSClientId  &          client,
             m_ClientsRegistry.AddBlacklistedJobs(client, cmd_group,
                                                  jobs_in_scope);
 
+            if (running_jobs_per_client.empty()) {
+                // No per client limit: the first suitable job is taken
+                // straight from the status vector without copying all the
+                // pending jobs, so concurrent GETs do not pay for it
+                if (no_scope_only) {
+                    if (has_groups)
+                        job_id = m_StatusTracker.GetJobByStatus(
+                                        CNetScheduleAPI::ePending,
+                                        jobs_in_scope,
+                                        m_GroupRegistry.GetJobs(group_ids),
+                                        true);
+                    else
+                        job_id = m_StatusTracker.GetJobByStatus(
+                                        CNetScheduleAPI::ePending,
+                                        jobs_in_scope, kEmptyBitVector,
+                                        false);
+                } else {
+                    job_id = m_StatusTracker.GetJobByStatus(
+                                        CNetScheduleAPI::ePending,
+                                        jobs_in_scope, restricted_jobs, true);
+                }
+                return x_SJobPick(job_id, false, 0);
+            }
+
             TNSBitVector    pending_jobs;
             m_StatusTracker.GetJobs(CNetScheduleAPI::ePending, pending_jobs);
             TNSBitVector::enumerator    en = pending_jobs.first();
@@ -3060,8 +3269,8 @@ TJobStatus CQueue::FailJob(const CNSClientId &    client,
     event->SetErrorMsg(err_msg);
     event->SetRetCode(ret_code);
     event->SetNodeAddr(client.GetAddress());
-    event->SetClientNode(client.GetNode());
-    event->SetClientSession(client.GetSession());
+    event->SetClientNode(client.GetInternedNode());
+    event->SetClientSession(client.GetInternedSession());
 
     if (no_retries) {
         job_iter->second.SetStatus(CNetScheduleAPI::eFailed);
@@ -4148,8 +4357,8 @@ TJobStatus  CQueue::x_ResetDueTo(const CNSClientId &     client,
     event->SetStatus(new_status);
     event->SetEvent(event_type);
     event->SetTimestamp(current_time);
-    event->SetClientNode(client.GetNode());
-    event->SetClientSession(client.GetSession());
+    event->SetClientNode(client.GetInternedNode());
+    event->SetClientSession(client.GetInternedSession());
 
     // Update the memory map
     m_StatusTracker.SetStatus(job_id, new_status);
@@ -4572,8 +4781,8 @@ void CQueue::x_UpdateDB_PutResultNoLock(unsigned                job_id,
     event->SetTimestamp(curr);
     event->SetRetCode(ret_code);
 
-    event->SetClientNode(client.GetNode());
-    event->SetClientSession(client.GetSession());
+    event->SetClientNode(client.GetInternedNode());
+    event->SetClientSession(client.GetInternedSession());
     event->SetNodeAddr(client.GetAddress());
 
     job_iter->second.SetStatus(CNetScheduleAPI::eDone);
@@ -4599,8 +4808,8 @@ void CQueue::x_UpdateDB_ProvideJobNoLock(const CNSClientId &     client,
     CJobEvent &     event = job_iter->second.AppendEvent();
     event.SetTimestamp(curr);
     event.SetNodeAddr(client.GetAddress());
-    event.SetClientNode(client.GetNode());
-    event.SetClientSession(client.GetSession());
+    event.SetClientNode(client.GetInternedNode());
+    event.SetClientSession(client.GetInternedSession());
 
     if (cmd_group == eGet) {
         event.SetStatus(CNetScheduleAPI::eRunning);
@@ -4816,6 +5025,210 @@ unsigned int  CQueue::LoadFromDump(const string &  dump_dname)
 }
 
 
+// Merges the journal left by a crashed instance into its snapshot and loads
+// the snapshot the same way as a dump
+unsigned int  CQueue::LoadFromJournal(const string &  journal_dname)
+{
+    size_t      records;
+    {{
+        CNSJobJournal   journal(journal_dname, m_QueueName);
+        records = journal.Recover();
+    }}
+
+    GetDiagContext().Extra()
+        .Print("_type", "startup")
+        .Print("_queue", m_QueueName)
+        .Print("info", "replay_journal")
+        .Print("records", records);
+    return LoadFromDump(journal_dname);
+}
+
+
+void CQueue::StartJournal(const string &                journal_dname,
+                          CNSJobJournal::EStartFrom     from,
+                          const string &                dump_dname,
+                          bool                          keep_dump)
+{
+    CFastMutexGuard             guard(m_JournalLock);
+    unique_ptr<CNSJobJournal>   journal(new CNSJobJournal(journal_dname,
+                                                          m_QueueName));
+
+    journal->Start(from, dump_dname, keep_dump);
+    delete m_Journal;
+    m_Journal = journal.release();
+    m_StatusTracker.TrackChanges(true);
+    x_SetJournalActive(true);
+}
+
+
+// Appends the jobs changed since the previous call to the journal and syncs
+// it, i.e. all the changes made since the previous pass are committed at
+// once. The jobs are copied in batches under the operation lock and written
+// without it.
+void CQueue::SyncJournal(void)
+{
+    CFastMutexGuard     journal_guard(m_JournalLock);
+    if (m_Journal == NULL)
+        return;
+
+    // The pass number must be taken before the changes are collected, see
+    // WaitJournalSync()
+    Uint8               pass;
+    {{
+        CFastMutexGuard     guard(m_JournalPassLock);
+        pass = ++m_JournalPassesStarted;
+    }}
+
+    TNSBitVector        changed_jobs;
+    m_StatusTracker.GetChangedJobs(changed_jobs);
+
+    // The jobs in scopes are not dumped at shutdown, so they are not
+    // journaled either
+    changed_jobs -= m_ScopeRegistry.GetAllJobsInScopes();
+    if (!changed_jobs.any()) {
+        x_JournalPassSynced(pass);
+        return;
+    }
+
+    try {
+        TNSBitVector::enumerator    en(changed_jobs.first());
+        vector<CJob>                jobs;
+        vector<unsigned int>        deleted_jobs;
+
+        while (en.valid()) {
+            jobs.clear();
+            deleted_jobs.clear();
+
+            {{
+                CFastMutexGuard     guard(m_OperationLock);
+
+                for (size_t  k = 0; en.valid() && k < s_JournalBatchSize;
+                     ++en, ++k) {
+                    unsigned int    job_id = *en;
+
+                    // The status goes first when a job is deleted
+                    if (m_StatusTracker.GetStatus(job_id) ==
+                                            CNetScheduleAPI::eJobNotFound) {
+                        deleted_jobs.push_back(job_id);
+                        continue;
+                    }
+
+                    auto    job_iter = m_Jobs.find(job_id);
+                    if (job_iter == m_Jobs.end()) {
+                        // The job is being submitted; take it next time
+                        m_StatusTracker.MarkChanged(job_id);
+                        continue;
+                    }
+                    jobs.push_back(job_iter->second);
+                }
+            }}
+
+            for (const auto &  job : jobs) {
+                unsigned int    aff_id = job.GetAffinityId();
+                unsigned int    group_id = job.GetGroupId();
+                string          aff_token;
+                string          group_token;
+
+                if (aff_id != 0 && !m_Journal->IsAffinityWritten(aff_id))
+                    aff_token = m_AffinityRegistry.GetTokenByID(aff_id);
+                if (group_id != 0 && !m_Journal->IsGroupWritten(group_id)) {
+                    try {
+                        group_token = m_GroupRegistry.ResolveGroup(group_id);
+                    } catch (...) {
+                        // The group has gone together with the job
+                    }
+                }
+                m_Journal->AppendJob(job, aff_token, group_token);
+            }
+            for (const auto &  job_id : deleted_jobs)
+                m_Journal->AppendDeletedJob(job_id);
+        }
+        m_Journal->Sync();
+        x_JournalPassSynced(pass);
+
+        if (m_Journal->GetSegmentSize() >=
+                                m_Server->GetJournalCompactionSize()) {
+            CNSPreciseTime      start = CNSPreciseTime::Current();
+            m_Journal->Compact();
+            LOG_POST(Note << "Journal of queue " << m_QueueName <<
+                     " compacted in " <<
+                     (double)(CNSPreciseTime::Current() - start) << " sec");
+        }
+    } catch (const exception &  ex) {
+        string      msg = "Error writing the jobs journal of queue " +
+                          m_QueueName + ": " + ex.what();
+        ERR_POST(Critical << msg << ". The queue journaling is stopped.");
+        m_Server->RegisterAlert(eDumpError, msg);
+
+        x_SetJournalActive(false);
+        m_StatusTracker.TrackChanges(false);
+        delete m_Journal;
+        m_Journal = NULL;
+    }
+}
+
+
+// Group commit: a reply to a command which changed jobs is held till the
+// journal pass which picked up the changes is synced. The replies which are
+// waiting at the same time are released by the same sync.
+// The change counter is taken before the command is executed; if it has not
+// moved there is nothing to wait for.
+void CQueue::WaitJournalSync(Uint8  change_count)
+{
+    if (m_StatusTracker.GetChangeCount() == change_count)
+        return;
+
+    CFastMutexGuard     guard(m_JournalPassLock);
+    if (!m_JournalActive)
+        return;
+
+    // A pass which has already started might have collected the changes
+    // before they were made, so the next one is waited for
+    Uint8       pass = m_JournalPassesStarted + 1;
+
+    m_QueueDB.WakeupJournalThread();
+    while (m_JournalActive && m_JournalPassesSynced < pass)
+        m_JournalPassSignal.WaitForSignal(m_JournalPassLock);
+}
+
+
+// Switching the journal off releases all the waiting replies
+void CQueue::x_SetJournalActive(bool  active)
+{
+    CFastMutexGuard     guard(m_JournalPassLock);
+    m_JournalActive = active;
+    if (!active)
+        m_JournalPassSignal.SignalAll();
+}
+
+
+void CQueue::x_JournalPassSynced(Uint8  pass)
+{
+    CFastMutexGuard     guard(m_JournalPassLock);
+    m_JournalPassesSynced = pass;
+    m_JournalPassSignal.SignalAll();
+}
+
+
+void CQueue::StopJournal(bool  remove_files)
+{
+    CFastMutexGuard     guard(m_JournalLock);
+    if (m_Journal == NULL)
+        return;
+
+    x_SetJournalActive(false);
+    m_StatusTracker.TrackChanges(false);
+    try {
+        m_Journal->Close(remove_files);
+    } catch (const exception &  ex) {
+        ERR_POST("Error closing the jobs journal of queue " << m_QueueName <<
+                 ": " << ex.what());
+    }
+    delete m_Journal;
+    m_Journal = NULL;
+}
+
+
 // The member does not grab the operational lock.
 // The member is used at the time of loading jobs from dump and at that time
 // there is no concurrent access.
@@ -4839,6 +5252,16 @@ void CQueue::x_NotifyJobChanges(const CJob &            job,
                                 const string &          job_key,
                                 ENotificationReason     reason,
                                 const CNSPreciseTime &  current_time)
+{
+    x_QueueJobChanges(job, job_key, reason, current_time);
+    m_NotificationsList.SendQueuedJobChanges();
+}
+
+
+void CQueue::x_QueueJobChanges(const CJob &            job,
+                               const string &          job_key,
+                               ENotificationReason     reason,
+                               const CNSPreciseTime &  current_time)
 {
     string      notification;
     TJobStatus  job_status = job.GetStatus();
@@ -4850,9 +5273,9 @@ void CQueue::x_NotifyJobChanges(const CJob &            job,
         if (job.ShouldNotifyListener(current_time)) {
             notification = m_NotificationsList.BuildJobChangedNotification(
                     job, job_key, job_status, reason);
-            m_NotificationsList.NotifyJobChanges(job.GetListenerNotifAddr(),
-                                                 job.GetListenerNotifPort(),
-                                                 notification);
+            m_NotificationsList.QueueJobChanges(job.GetListenerNotifAddr(),
+                                                job.GetListenerNotifPort(),
+                                                notification);
         }
     }
 
@@ -4862,9 +5285,9 @@ void CQueue::x_NotifyJobChanges(const CJob &            job,
                 if (notification.empty())
                     notification = m_NotificationsList.BuildJobChangedNotification(
                             job, job_key, job_status, reason);
-                m_NotificationsList.NotifyJobChanges(job.GetSubmAddr(),
-                                                     job.GetSubmNotifPort(),
-                                                     notification);
+                m_NotificationsList.QueueJobChanges(job.GetSubmAddr(),
+                                                    job.GetSubmNotifPort(),
+                                                    notification);
             }
         }
     }
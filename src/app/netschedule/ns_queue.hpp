@@ -59,6 +59,7 @@
 #include "ns_precise_time.hpp"
 #include "ns_scope.hpp"
 #include "ns_server_params.hpp"
+#include "ns_journal.hpp"
 
 #include <map>
 
@@ -193,7 +194,9 @@ public:
                       const list<string> *      group_list,
                       CJob *                    new_job,
                       CNSRollbackInterface * &  rollback_action,
-                      string &                  added_pref_aff);
+                      string &                  added_pref_aff,
+                      unsigned int              max_extra_jobs = 0,
+                      vector<CJob> *            extra_jobs = NULL);
 
     void CancelWaitGet(const CNSClientId &  client);
     void CancelWaitRead(const CNSClientId &  client);
@@ -435,6 +438,8 @@ public:
     void PrintJobCounters(void) const;
     unsigned int GetJobsToDeleteCount(void) const;
     string PrintTransitionCounters(void) const;
+    string PrintTransitionCountersPrometheus(void) const
+    { return m_StatisticsCounters.PrintTransitionsPrometheus(m_QueueName); }
     string PrintJobsStat(const CNSClientId &  client,
                          const string &    group_token,
                          const string &    aff_token,
@@ -468,6 +473,18 @@ public:
     void Dump(const string &  dump_dir_name);
     void RemoveDump(const string &  dump_dir_name);
     unsigned int LoadFromDump(const string &  dump_dir_name);
+
+    // Group committed jobs journal support
+    unsigned int LoadFromJournal(const string &  journal_dir_name);
+    void StartJournal(const string &                journal_dir_name,
+                      CNSJobJournal::EStartFrom     from,
+                      const string &                dump_dir_name,
+                      bool                          keep_dump);
+    void SyncJournal(void);
+    void StopJournal(bool  remove_files);
+    Uint8 GetJournalChangeCount(void) const
+    { return m_StatusTracker.GetChangeCount(); }
+    void WaitJournalSync(Uint8  change_count);
     bool ShouldPerfLogTransitions(void) const
     { return m_ShouldPerfLogTransitions; }
     void UpdatePerfLoggingSettings(const string &  qclass);
@@ -520,6 +537,26 @@ private:
                     bool                          has_groups,
                     ECommandGroup                 cmd_group,
                     const string &                scope);
+    void x_StartExtraJobs(const CNSClientId &     client,
+                          const CNSPreciseTime &  curr,
+                          const TNSBitVector &    explicit_affs,
+                          bool                    use_pref_affinity,
+                          bool                    any_affinity,
+                          const TNSBitVector &    group_ids,
+                          bool                    has_groups,
+                          unsigned int            max_count,
+                          vector<CJob> &          jobs);
+    TNSBitVector x_FindVacantJobs(const CNSClientId &   client,
+                                  const TNSBitVector &  explicit_affs,
+                                  bool                  use_pref_affinity,
+                                  bool                  any_affinity,
+                                  const TNSBitVector &  group_ids,
+                                  bool                  has_groups,
+                                  const string &        scope);
+    void x_StartJobNoLock(const CNSClientId &     client,
+                          const CNSPreciseTime &  curr,
+                          unsigned int            job_id,
+                          CJob &                  job);
     map<string, size_t> x_GetRunningJobsPerClientIP(void);
     bool x_ValidateMaxJobsPerClientIP(unsigned int  job_id,
                                       const map<string, size_t> &  jobs_per_client_ip) const;
@@ -627,6 +664,14 @@ private:
                             const string &          job_key,
                             ENotificationReason     reason,
                             const CNSPreciseTime &  current_time);
+    // Same as x_NotifyJobChanges() but the notifications are only queued;
+    // they are sent by the next SendQueuedJobChanges() of the list
+    void x_QueueJobChanges(const CJob &            job,
+                           const string &          job_key,
+                           ENotificationReason     reason,
+                           const CNSPreciseTime &  current_time);
+    void x_SetJournalActive(bool  active);
+    void x_JournalPassSynced(Uint8  pass);
 
 private:
     friend class CJob;
@@ -751,6 +796,18 @@ private:
     // States from which the jobs could be taken for the READ[2] commands
     vector<CNetScheduleAPI::EJobStatus>
                                 m_StatesForRead;
+
+    // Jobs journal; NULL if it is switched off
+    CNSJobJournal *             m_Journal;
+    CFastMutex                  m_JournalLock;
+
+    // Group commit support. The journal passes are counted so that a reply
+    // could wait for the sync of a pass which started after the change.
+    CFastMutex                  m_JournalPassLock;
+    CConditionVariable          m_JournalPassSignal;
+    bool                        m_JournalActive;
+    Uint8                       m_JournalPassesStarted;
+    Uint8                       m_JournalPassesSynced;
 };
 
 
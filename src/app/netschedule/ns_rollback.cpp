@@ -93,18 +93,21 @@ void CNSGetJobRollback::Rollback(CQueue *  queue)
 
     // It is basically the same as returning a job but without putting the job
     // into a blacklist.
-    try {
-        string  warning;    // used for auth tokens only, so
-                            // not analyzed here
-        CJob        job;    // Not used here
+    for (vector<unsigned int>::const_iterator  k = m_JobIds.begin();
+            k != m_JobIds.end(); ++k) {
+        try {
+            string  warning;    // used for auth tokens only, so
+                                // not analyzed here
+            CJob        job;    // Not used here
 
-        // true -> returned due to rollback
-        queue->ReturnJob(m_Client, m_JobId, queue->MakeJobKey(m_JobId),
-                         job, "", warning, CQueue::eRollback);
-    } catch (const exception &  ex) {
-        ERR_POST("Error while rolling back requested job: " << ex.what());
-    } catch (...) {
-        ERR_POST("Unknown error while rolling back requested job");
+            // true -> returned due to rollback
+            queue->ReturnJob(m_Client, *k, queue->MakeJobKey(*k),
+                             job, "", warning, CQueue::eRollback);
+        } catch (const exception &  ex) {
+            ERR_POST("Error while rolling back requested job: " << ex.what());
+        } catch (...) {
+            ERR_POST("Unknown error while rolling back requested job");
+        }
     }
 }
 
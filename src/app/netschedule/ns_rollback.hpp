@@ -106,7 +106,12 @@ class CNSGetJobRollback : public CNSRollbackInterface
     public:
         CNSGetJobRollback(const CNSClientId &  client,
                           unsigned int         job_id) :
-            m_Client(client), m_JobId(job_id)
+            m_Client(client), m_JobIds(1, job_id)
+        {}
+        // GET2 with count > 1 gives all the jobs in one response
+        CNSGetJobRollback(const CNSClientId &            client,
+                          const vector<unsigned int> &  job_ids) :
+            m_Client(client), m_JobIds(job_ids)
         {}
 
         virtual ~CNSGetJobRollback() {}
@@ -115,8 +120,8 @@ class CNSGetJobRollback : public CNSRollbackInterface
         virtual void  Rollback(CQueue *  queue);
 
     private:
-        CNSClientId     m_Client;
-        unsigned int    m_JobId;
+        CNSClientId             m_Client;
+        vector<unsigned int>    m_JobIds;
 };
 
 
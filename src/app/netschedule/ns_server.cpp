@@ -76,7 +76,11 @@ CNetScheduleServer::CNetScheduleServer(const string &  dbpath,
       m_SessionID("s" + x_GenerateGUID()),
       m_StartIDs(dbpath, diskless),
       m_AnybodyCanReconfigure(false),
-      m_ReserveDumpSpace(default_reserve_dump_space)
+      m_ReserveDumpSpace(default_reserve_dump_space),
+      m_Journal(default_journal),
+      m_JournalSyncInterval(default_journal_sync_interval),
+      m_JournalSyncReplies(default_journal_sync_replies),
+      m_JournalCompactionSize(default_journal_compaction_size)
 {
     m_CurrentSubmitsCounter.Set(kSubmitCounterInitialValue);
     sm_netschedule_server = this;
@@ -274,6 +278,12 @@ CJsonNode CNetScheduleServer::SetNSParameters(const SNS_Parameters &  params,
     m_ScanBatchSize = params.scan_batch_size;
     m_PurgeTimeout = params.purge_timeout;
 
+    // Journal related parameters
+    m_Journal = params.journal;
+    m_JournalSyncInterval = params.journal_sync_interval;
+    m_JournalSyncReplies = params.journal_sync_replies;
+    m_JournalCompactionSize = params.journal_compaction_size;
+
     m_AffRegistrySettings = params.affinity_reg;
     m_GroupRegistrySettings = params.group_reg;
     m_ScopeRegistrySettings = params.scope_reg;
@@ -443,6 +453,14 @@ string CNetScheduleServer::PrintTransitionCounters(void)
 }
 
 
+// All the metrics in the Prometheus text exposition format
+string CNetScheduleServer::PrintMetrics(void)
+{
+    return m_CommandLatencies.PrintPrometheus() +
+           m_QueueDB->PrintTransitionCountersPrometheus();
+}
+
+
 string CNetScheduleServer::PrintJobsStat(const CNSClientId &  client)
 {
     return m_QueueDB->PrintJobsStat(client);
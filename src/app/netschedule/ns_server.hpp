@@ -41,6 +41,7 @@
 #include "ns_queue.hpp"
 #include "ns_alert.hpp"
 #include "ns_start_ids.hpp"
+#include "ns_command_latencies.hpp"
 
 BEGIN_NCBI_SCOPE
 
@@ -97,12 +98,22 @@ public:
     { return m_ScanBatchSize; }
     double GetPurgeTimeout(void) const
     { return m_PurgeTimeout; }
+    bool GetJournal(void) const
+    { return m_Journal && !m_Diskless; }
+    double GetJournalSyncInterval(void) const
+    { return m_JournalSyncInterval; }
+    bool GetJournalSyncReplies(void) const
+    { return GetJournal() && m_JournalSyncReplies; }
+    unsigned int GetJournalCompactionSize(void) const
+    { return m_JournalCompactionSize; }
     unsigned GetHostNetAddr() const
     { return m_HostNetAddr; }
     const CTime & GetStartTime(void) const
     { return m_StartTime; }
     CBackgroundHost & GetBackgroundHost()
     { return m_BackgroundHost; }
+    CNSCommandLatencies & GetCommandLatencies(void)
+    { return m_CommandLatencies; }
     unsigned int GetMaxClientData(void) const
     { return m_MaxClientData; }
     string GetNodeID(void) const
@@ -165,6 +176,7 @@ public:
     SQueueParameters  QueueInfo(const string &  qname) const;
     string  GetQueueNames(const string &  sep) const;
     string PrintTransitionCounters(void);
+    string PrintMetrics(void);
     string PrintJobsStat(const CNSClientId &  client);
     string GetQueueClassesInfo(void) const;
     string GetQueueClassesConfig(void) const;
@@ -291,6 +303,14 @@ private:
 
     unsigned int                    m_ReserveDumpSpace;
 
+    // Jobs journal settings; taken at the startup only
+    bool                            m_Journal;
+    double                          m_JournalSyncInterval;
+    bool                            m_JournalSyncReplies;
+    unsigned int                    m_JournalCompactionSize;
+
+    CNSCommandLatencies             m_CommandLatencies;
+
 private:
     string x_GenerateGUID(void) const;
     CJsonNode x_SetAdminClientNames(const string &  client_names);
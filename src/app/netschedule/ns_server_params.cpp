@@ -263,6 +263,19 @@ void SNS_Parameters::Read(const IRegistry &  reg)
 
     diskless = GetBoolNoErr("diskless", default_diskless);
 
+    journal = GetBoolNoErr("journal", default_journal);
+    journal_sync_interval = GetDoubleNoErr("journal_sync_interval",
+                                           default_journal_sync_interval);
+    if (journal_sync_interval <= 0.0)
+        journal_sync_interval = default_journal_sync_interval;
+    journal_sync_replies = GetBoolNoErr("journal_sync_replies",
+                                        default_journal_sync_replies);
+    journal_compaction_size = NS_GetDataSize(reg, "server",
+                                             "journal_compaction_size",
+                                             default_journal_compaction_size);
+    if (journal_compaction_size == 0)
+        journal_compaction_size = default_journal_compaction_size;
+
     #if defined(_DEBUG) && !defined(NDEBUG)
     ReadErrorEmulatorSection(reg);
     #endif
@@ -164,6 +164,11 @@ struct SNS_Parameters : SServer_Parameters
     unsigned int    max_queues;
     bool            diskless;
 
+    bool            journal;            // Group committed journal of jobs
+    double          journal_sync_interval;
+    bool            journal_sync_replies;
+    unsigned int    journal_compaction_size;
+
     void Read(const IRegistry &  reg);
 
     #if defined(_DEBUG) && !defined(NDEBUG)
@@ -416,6 +416,38 @@ void CStatisticsCounters::PrintDelta(CDiagContext_Extra &  extra,
 }
 
 
+// The samples of the netschedule_job_transitions_total metric; the metric
+// header is printed by the caller once for all the queues
+string
+CStatisticsCounters::PrintTransitionsPrometheus(const string &  qname) const
+{
+    string result;
+    result.reserve(4096);
+
+    for (size_t  index_from = 0;
+         index_from < g_ValidJobStatusesSize; ++index_from) {
+        for (size_t  index_to = 0;
+             index_to < g_ValidJobStatusesSize + 1; ++index_to) {
+            TNCBIAtomicValue    value =
+                                m_Transitions[index_from][index_to].Get();
+            if (value == static_cast<TNCBIAtomicValue>(-1))
+                continue;
+
+            result.append("netschedule_job_transitions_total{queue=\"")
+                  .append(qname)
+                  .append("\",from=\"")
+                  .append(s_ValidStatusesNames[index_from])
+                  .append("\",to=\"")
+                  .append(s_ValidStatusesNames[index_to])
+                  .append("\"} ")
+                  .append(to_string(value))
+                  .append(kNewLine);
+        }
+    }
+    return result;
+}
+
+
 string CStatisticsCounters::PrintTransitions(void) const
 {
     string result;
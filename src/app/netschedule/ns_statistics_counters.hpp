@@ -70,6 +70,7 @@ public:
     void PrintDelta(CDiagContext_Extra &  extra,
                     const CStatisticsCounters &  prev) const;
     string PrintTransitions(void) const;
+    string PrintTransitionsPrometheus(const string &  qname) const;
     void CountTransition(CNetScheduleAPI::EJobStatus  from,
                          CNetScheduleAPI::EJobStatus  to,
                          ETransitionPathOption        path_option = eNone);
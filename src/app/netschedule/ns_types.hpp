@@ -81,6 +81,10 @@ const string    kDumpReservedSpaceFileName("space_keeper.dat");
 const string    kQClassDescriptionFileName("qclass_descr.dump");
 const string    kLinkedSectionsFileName("linked_sections.dump");
 const string    kJobsFileName("jobs.dump");
+const string    kAffDictFileName("aff_dict_dump");
+const string    kGroupDictFileName("group_dict_dump");
+const string    kJournalSubdirName("journal");
+const string    kJournalFileName("jobs.journal");
 const string    kDBStorageVersionFileName("DB_STORAGE_VER");
 const string    kStartJobIDsFileName("STARTJOBIDS");
 const string    kNodeIDFileName("NODE_ID");
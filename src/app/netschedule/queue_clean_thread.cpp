@@ -106,6 +106,7 @@ void CJobQueueCleanerThread::x_DoJob(void)
         m_QueueDB.Purge();
         m_QueueDB.PurgeAffinities();
         m_QueueDB.PurgeGroups();
+        m_QueueDB.PurgeInternedStrings();
         m_QueueDB.StaleWNodes();
         m_QueueDB.PurgeBlacklistedJobs();
         m_QueueDB.PurgeClientRegistry();
@@ -224,5 +225,72 @@ void CJobQueueExecutionWatcherThread::x_DoJob(void)
 }
 
 
+CJobJournalThread::CJobJournalThread(CBackgroundHost &     host,
+                                     CQueueDataBase &      qdb,
+                                     unsigned int          sec_delay,
+                                     unsigned int          nanosec_delay) :
+    m_Host(host),
+    m_QueueDB(qdb),
+    m_SecDelay(sec_delay),
+    m_NanosecDelay(nanosec_delay),
+    m_StopSignal(0, 10000000)
+{}
+
+
+CJobJournalThread::~CJobJournalThread()
+{}
+
+
+void CJobJournalThread::RequestStop(void)
+{
+    m_StopFlag.Add(1);
+    m_StopSignal.Post();
+}
+
+
+void CJobJournalThread::WakeUp(void)
+{
+    m_StopSignal.Post();
+}
+
+
+void *  CJobJournalThread::Main(void)
+{
+    SetCurrentThreadName("netscheduled_jj");
+    while (1) {
+        x_DoJob();
+
+        if (m_StopSignal.TryWait(m_SecDelay, m_NanosecDelay)) {
+            // All the wakeups posted so far are served by the next pass
+            while (m_StopSignal.TryWait())
+                ;
+            if (m_StopFlag.Get() != 0)
+                break;
+        }
+    } // while (1)
+
+    return 0;
+}
+
+
+// The thread runs too often to produce request start/stop records.
+// The errors are handled on a per queue basis.
+void CJobJournalThread::x_DoJob(void)
+{
+    if (!m_Host.ShouldRun())
+        return;
+
+    try {
+        m_QueueDB.SyncJournals();
+    }
+    catch (exception &  ex) {
+        ERR_POST("Error while writing jobs journals: " << ex.what());
+    }
+    catch (...) {
+        ERR_POST("Unknown error while writing jobs journals");
+    }
+}
+
+
 END_NCBI_SCOPE
 
@@ -134,6 +134,42 @@ private:
 };
 
 
+// Thread class, periodically writes the job changes to the queue journals.
+// It is woken up earlier when a reply waits for the changes to be synced.
+class CJobJournalThread : public CThread
+{
+public:
+    CJobJournalThread(CBackgroundHost &     host,
+                      CQueueDataBase &      qdb,
+                      unsigned int          sec_delay,
+                      unsigned int          nanosec_delay);
+    ~CJobJournalThread();
+
+    void RequestStop(void);
+    void WakeUp(void);
+
+protected:
+    virtual void *  Main(void);
+
+private:
+    void x_DoJob(void);
+
+private:
+    CBackgroundHost &   m_Host;
+    CQueueDataBase &    m_QueueDB;
+    unsigned int        m_SecDelay;
+    unsigned int        m_NanosecDelay;
+
+private:
+    mutable CSemaphore                      m_StopSignal;
+    mutable CAtomicCounter_WithAutoInit     m_StopFlag;
+
+private:
+    CJobJournalThread(const CJobJournalThread&);
+    CJobJournalThread& operator=(const CJobJournalThread&);
+};
+
+
 
 END_NCBI_SCOPE
 
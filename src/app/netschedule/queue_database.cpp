@@ -62,6 +62,7 @@ CQueueDataBase::CQueueDataBase(CNetScheduleServer *  server,
                                bool  diskless,
                                bool  reinit)
 : m_Host(server->GetBackgroundHost()),
+  m_JournalStarted(false),
   m_MaxQueues(max_queues),
   m_Diskless(diskless),
   m_StopPurge(false),
@@ -75,6 +76,8 @@ CQueueDataBase::CQueueDataBase(CNetScheduleServer *  server,
     m_DataPath = CDirEntry::AddTrailingPathSeparator(path);
     m_DumpPath = CDirEntry::AddTrailingPathSeparator(m_DataPath +
                                                      kDumpSubdirName);
+    m_JournalPath = CDirEntry::AddTrailingPathSeparator(m_DataPath +
+                                                        kJournalSubdirName);
 
     // First, load the previous session start job IDs if file existed
     // The diskless flag will be considered when IDs are loaded.
@@ -121,10 +124,13 @@ void  CQueueDataBase::x_Open(bool  reinit)
 {
     // Checks preconditions and provides the final reinit value
     // It sets alerts and throws exceptions if needed.
+    bool    from_journal = false;
     if (m_Diskless) {
         reinit = false;
     } else {
-        reinit = x_CheckOpenPreconditions(reinit);
+        from_journal = x_CanRecoverFromJournal(reinit);
+        if (!from_journal)
+            reinit = x_CheckOpenPreconditions(reinit);
     }
 
     CDir    data_dir(m_DataPath);
@@ -150,6 +156,10 @@ void  CQueueDataBase::x_Open(bool  reinit)
         data_dir.Create();
     }
 
+    // The jobs come from the dump, so the journal is outdated if it is there
+    if (!m_Diskless && !from_journal)
+        x_RemoveJournal();
+
     // The initialization must be done before the queues are created but after
     // the directory is possibly re-created
     m_Server->InitNodeID(m_DataPath);
@@ -162,11 +172,15 @@ void  CQueueDataBase::x_Open(bool  reinit)
         PNocase>            dump_dynamic_queues;    // qname -> qclass
     TQueueParams            dump_queue_classes;
 
+    // The dynamic queues come from the same place as the jobs
+    string                  queues_dir = from_journal ? m_JournalPath
+                                                      : m_DumpPath;
     if (!m_Diskless)
-        x_ReadDumpQueueDesrc(dump_static_queues, dump_dynamic_queues,
-                             dump_queue_classes);
+        x_ReadDumpQueueDesrc(queues_dir, dump_static_queues,
+                             dump_dynamic_queues, dump_queue_classes);
 
     set<string, PNocase>    config_static_queues = x_GetConfigQueues();
+    set<string, PNocase>    loaded_queues;
     string                  last_queue_load_error;
     size_t                  queue_load_error_count = 0;
 
@@ -203,7 +217,7 @@ void  CQueueDataBase::x_Open(bool  reinit)
                              unused_diff);
 
         if (!m_Diskless)
-            x_AppendDumpLinkedSections();
+            x_AppendDumpLinkedSections(queues_dir);
 
         // Read the queue classes from the config file and append those which
         // come from the dump
@@ -252,12 +266,18 @@ void  CQueueDataBase::x_Open(bool  reinit)
             for (TQueueInfo::iterator  k = m_Queues.begin();
                     k != m_Queues.end(); ++k) {
                 try {
-                    unsigned int   records =
-                                        k->second.second->LoadFromDump(m_DumpPath);
+                    unsigned int    records;
+                    if (from_journal)
+                        records = k->second.second->LoadFromJournal(
+                                                            m_JournalPath);
+                    else
+                        records = k->second.second->LoadFromDump(m_DumpPath);
+                    loaded_queues.insert(k->first);
                     GetDiagContext().Extra()
                         .Print("_type", "startup")
                         .Print("_queue", k->first)
-                        .Print("info", "load_from_dump")
+                        .Print("info", from_journal ? "load_from_journal"
+                                                    : "load_from_dump")
                         .Print("records", records);
                 } catch (const exception &  ex) {
                     ERR_POST(Warning << ex.what());
@@ -281,6 +301,10 @@ void  CQueueDataBase::x_Open(bool  reinit)
         ++queue_load_error_count;
     }
 
+    if (m_Server->GetJournal())
+        x_StartJournals(from_journal, loaded_queues,
+                        queue_load_error_count > 0);
+
     if (!m_Diskless) {
         x_CreateCrashFlagFile();
         x_CreateDumpErrorFlagFile();
@@ -925,6 +949,7 @@ time_t  CQueueDataBase::Configure(const IRegistry &  reg,
     // configuration.
     x_ConfigureQueueClasses(classes_from_ini, diff);
     x_ConfigureQueues(queues_from_ini, diff);
+    x_JournalDynamicQueues();
     return CalculateRuntimePrecision();
 }
 
@@ -1007,6 +1032,21 @@ CQueueDataBase::x_CreateAndMountQueue(const string &            qname,
     q->Attach();
     q->SetParameters(params);
 
+    // The queues mounted at the startup start their journals after the jobs
+    // are loaded
+    if (m_JournalStarted) {
+        try {
+            q->StartJournal(m_JournalPath, CNSJobJournal::eFromScratch,
+                            kEmptyStr, false);
+        } catch (const exception &  ex) {
+            ERR_POST("Error starting the jobs journal of queue " << qname <<
+                     ": " << ex.what());
+            m_Server->RegisterAlert(eDumpError,
+                                    "Error starting the jobs journal of "
+                                    "queue " + qname + ": " + ex.what());
+        }
+    }
+
     m_Queues[qname] = make_pair(params, q.release());
 
     GetDiagContext().Extra()
@@ -1103,6 +1143,7 @@ void CQueueDataBase::CreateDynamicQueue(const CNSClientId &  client,
     params.description = description;
 
     x_CreateAndMountQueue(qname, params);
+    x_JournalDynamicQueues();
 }
 
 
@@ -1193,6 +1234,15 @@ void CQueueDataBase::Close(void)
     StopServiceThread();
     StopExecutionWatcherThread();
 
+    // The last changes are journaled in case the dump fails
+    StopJournalThread();
+    if (m_JournalStarted) {
+        SyncJournals();
+        for (TQueueInfo::iterator  k = m_Queues.begin();
+                k != m_Queues.end(); ++k)
+            k->second.second->StopJournal(false);
+    }
+
     // Print the statistics counters last time
     if (m_Server->IsLogStatisticsThread()) {
         size_t      aff_count = 0;
@@ -1201,6 +1251,7 @@ void CQueueDataBase::Close(void)
         CStatisticsCounters::PrintServerWide(aff_count);
     }
 
+    bool    dumped = true;
     if (m_Server->IsDrainShutdown() && m_Server->WasDBDrained()) {
         // That was a not interrupted drain shutdown so there is no
         // need to dump anything
@@ -1218,7 +1269,7 @@ void CQueueDataBase::Close(void)
 
         // Dump all the queues/queue classes/queue parameters to flat files
         if (!m_Diskless)
-            x_Dump();
+            dumped = x_Dump();
 
         m_QueueClasses.clear();
 
@@ -1229,7 +1280,16 @@ void CQueueDataBase::Close(void)
 
     if (!m_Diskless) {
         x_RemoveDataFiles();
-        x_RemoveCrashFlagFile();
+
+        if (dumped || !m_JournalStarted) {
+            x_RemoveJournal();
+            x_RemoveCrashFlagFile();
+        } else {
+            // The crash flag makes the next instance to take the jobs
+            // from the journal
+            ERR_POST("Error dumping jobs. The jobs will be restored from "
+                     "the journal at the next start.");
+        }
     }
 }
 
@@ -1246,6 +1306,20 @@ string CQueueDataBase::PrintTransitionCounters(void)
 }
 
 
+string CQueueDataBase::PrintTransitionCountersPrometheus(void)
+{
+    string      result = "# HELP netschedule_job_transitions_total "
+                         "Number of the job status transitions\n"
+                         "# TYPE netschedule_job_transitions_total "
+                         "counter\n";
+    CFastMutexGuard             guard(m_ConfigureLock);
+    for (TQueueInfo::const_iterator  k = m_Queues.begin();
+         k != m_Queues.end(); ++k)
+        result += k->second.second->PrintTransitionCountersPrometheus();
+    return result;
+}
+
+
 string CQueueDataBase::PrintJobsStat(const CNSClientId &  client)
 {
     string                      result;
@@ -1513,8 +1587,10 @@ void  CQueueDataBase::x_DeleteQueuesAndClasses(void)
         // Deallocation of the DB block will be done later when the queue
         // is actually deleted
         // queue->second.second->MarkForTruncating();
+        queue->second.second->StopJournal(true);
         m_Queues.erase(queue);
     }
+    x_JournalDynamicQueues();
 
     // Now, while still holding the lock, let's check queue classes
     vector< string >    classes_to_delete;
@@ -1928,6 +2004,49 @@ void CQueueDataBase::StopPurgeThread(void)
 }
 
 
+void CQueueDataBase::SyncJournals(void)
+{
+    for (unsigned int  index = 0; ; ++index) {
+        CRef<CQueue>  queue = x_GetQueueAt(index);
+        if (queue.IsNull())
+            break;
+        queue->SyncJournal();
+    }
+}
+
+
+void CQueueDataBase::RunJournalThread(void)
+{
+    if (!m_JournalStarted)
+        return;
+
+    double              sync_interval = m_Server->GetJournalSyncInterval();
+    unsigned int        sec_delay = sync_interval;
+    unsigned int        nanosec_delay = (sync_interval - sec_delay)*1000000000;
+
+    m_JournalThread.Reset(new CJobJournalThread(m_Host, *this,
+                                                sec_delay, nanosec_delay));
+    m_JournalThread->Run();
+}
+
+
+void CQueueDataBase::StopJournalThread(void)
+{
+    if (!m_JournalThread.Empty()) {
+        m_JournalThread->RequestStop();
+        m_JournalThread->Join();
+        m_JournalThread.Reset(0);
+    }
+}
+
+
+void CQueueDataBase::WakeupJournalThread(void)
+{
+    if (!m_JournalThread.Empty())
+        m_JournalThread->WakeUp();
+}
+
+
 void CQueueDataBase::PurgeAffinities(void)
 {
     for (unsigned int  index = 0; ; ++index) {
@@ -1954,6 +2073,21 @@ void CQueueDataBase::PurgeGroups(void)
 }
 
 
+void CQueueDataBase::PurgeInternedStrings(void)
+{
+    // The pool holds a few distinct client nodes, sessions and addresses, so
+    // there is no need to scan it more often than once a minute
+    static CNSPreciseTime   last_purge(0, 0);
+    CNSPreciseTime          current_time = CNSPreciseTime::Current();
+
+    if (current_time.Sec() - last_purge.Sec() < 60)
+        return;
+    last_purge = current_time;
+
+    CNSInternedString::Prune();
+}
+
+
 void CQueueDataBase::StaleWNodes(void)
 {
     // Worker nodes have the last access time in seconds since 1970
@@ -2125,7 +2259,7 @@ void CQueueDataBase::StopExecutionWatcherThread(void)
 }
 
 
-void CQueueDataBase::x_Dump()
+bool CQueueDataBase::x_Dump()
 {
     LOG_POST(Note << "Start dumping jobs");
 
@@ -2156,11 +2290,8 @@ void CQueueDataBase::x_Dump()
         }
     }
 
-    // Dump the required queue classes. The only classes required are those
-    // which were used by dynamic queues. The dynamic queue classes may also
-    // use linked sections
-    set<string>     classes_to_dump;
-    set<string>     linked_sections_to_dump;
+    // Dump the dynamic queues and their classes. The dynamic queue classes
+    // may also use linked sections
     set<string>     dynamic_queues_to_dump;
     for (TQueueInfo::iterator  k = m_Queues.begin();
             k != m_Queues.end(); ++k) {
@@ -2170,98 +2301,16 @@ void CQueueDataBase::x_Dump()
             continue;
         if (dumped_queues.find(k->first) == dumped_queues.end())
             continue;   // There was a dumping error
-
-        classes_to_dump.insert(k->second.first.qclass);
-        for (map<string, string>::const_iterator
-                j = k->second.first.linked_sections.begin();
-                j != k->second.first.linked_sections.end(); ++j)
-            linked_sections_to_dump.insert(j->second);
         dynamic_queues_to_dump.insert(k->first);
     }
 
-
-    // Dump classes if so and linked sections if so
-    if (!classes_to_dump.empty()) {
-        string      qclasses_dump_file_name = m_DumpPath +
-                                            kQClassDescriptionFileName;
-        string      linked_sections_dump_file_name = m_DumpPath +
-                                            kLinkedSectionsFileName;
-        FILE *      qclasses_dump_file = NULL;
-        FILE *      linked_sections_dump_file = NULL;
+    if (!dynamic_queues_to_dump.empty()) {
         try {
-            qclasses_dump_file = fopen(qclasses_dump_file_name.c_str(), "wb");
-            if (qclasses_dump_file == NULL)
-                throw runtime_error("Cannot open file " +
-                                    qclasses_dump_file_name);
-            setbuf(qclasses_dump_file, NULL);
-
-            if (classes_to_dump.size() > 0 ||
-                dynamic_queues_to_dump.size() > 0) {
-                SOneStructDumpHeader    header;
-                header.fixed_size = sizeof(SQueueDescriptionDump);
-                header.Write(qclasses_dump_file);
-            }
-
-            // Dump dynamic queue classes
-            for (set<string>::const_iterator  k = classes_to_dump.begin();
-                    k != classes_to_dump.end(); ++k) {
-                TQueueParams::const_iterator  queue_class =
-                                                    m_QueueClasses.find(*k);
-                x_DumpQueueOrClass(qclasses_dump_file, "", *k, false,
-                                   queue_class->second);
-            }
-
-            // Dump dynamic queues: qname and its class.
-            for (set<string>::const_iterator
-                    k = dynamic_queues_to_dump.begin();
-                    k != dynamic_queues_to_dump.end(); ++k) {
-                TQueueInfo::const_iterator  q = m_Queues.find(*k);
-                x_DumpQueueOrClass(qclasses_dump_file, *k,
-                                   q->second.first.qclass, true,
-                                   q->second.first);
-            }
-
-            fclose(qclasses_dump_file);
-            qclasses_dump_file = NULL;
-
-            // Dump linked sections if so
-            if (!linked_sections_to_dump.empty()) {
-                linked_sections_dump_file = fopen(
-                                linked_sections_dump_file_name.c_str(), "wb");
-                if (linked_sections_dump_file == NULL)
-                    throw runtime_error("Cannot open file " +
-                                         linked_sections_dump_file_name);
-                setbuf(linked_sections_dump_file, NULL);
-
-                SOneStructDumpHeader    header;
-                header.fixed_size = sizeof(SLinkedSectionDump);
-                header.Write(linked_sections_dump_file);
-
-                for (set<string>::const_iterator
-                        k = linked_sections_to_dump.begin();
-                        k != linked_sections_to_dump.end(); ++k) {
-                    map<string, map<string, string> >::const_iterator
-                        j = m_LinkedSections.find(*k);
-                    x_DumpLinkedSection(linked_sections_dump_file, *k,
-                                        j->second);
-                }
-                fclose(linked_sections_dump_file);
-                linked_sections_dump_file = NULL;
-            }
+            x_DumpDynamicQueues(m_DumpPath, dynamic_queues_to_dump, false);
         } catch (const exception &  ex) {
             dump_error = true;
             ERR_POST("Error dumping dynamic queue classes and "
                      "their linked sections. Dynamic queue dumps are lost.");
-            if (qclasses_dump_file != NULL)
-                fclose(qclasses_dump_file);
-            if (linked_sections_dump_file != NULL)
-                fclose(linked_sections_dump_file);
-
-            // Remove the classes and linked sections files
-            if (access(qclasses_dump_file_name.c_str(), F_OK) != -1)
-                remove(qclasses_dump_file_name.c_str());
-            if (access(linked_sections_dump_file_name.c_str(), F_OK) != -1)
-                remove(linked_sections_dump_file_name.c_str());
 
             // Remove dynamic queues dumps
             for (set<string>::const_iterator
@@ -2276,6 +2325,160 @@ void CQueueDataBase::x_Dump()
         x_RemoveDumpErrorFlagFile();
 
     LOG_POST(Note << "Dumping jobs finished");
+    return !dump_error;
+}
+
+
+// Writes the given dynamic queues, their classes and the linked sections
+// the classes use to the directory. The shutdown dump and the journal use
+// the same files. If sync is requested the files are synced and replace the
+// previous ones only when they are complete.
+void CQueueDataBase::x_DumpDynamicQueues(const string &       dir_name,
+                                         const set<string> &  queues,
+                                         bool                 sync)
+{
+    set<string>     classes_to_dump;
+    set<string>     linked_sections_to_dump;
+    for (set<string>::const_iterator  k = queues.begin();
+            k != queues.end(); ++k) {
+        TQueueInfo::const_iterator  q = m_Queues.find(*k);
+
+        classes_to_dump.insert(q->second.first.qclass);
+        for (map<string, string>::const_iterator
+                j = q->second.first.linked_sections.begin();
+                j != q->second.first.linked_sections.end(); ++j)
+            linked_sections_to_dump.insert(j->second);
+    }
+
+    string      tmp_suffix = sync ? ".tmp" : "";
+    string      qclasses_dump_file_name = dir_name +
+                                          kQClassDescriptionFileName;
+    string      linked_sections_dump_file_name = dir_name +
+                                                 kLinkedSectionsFileName;
+    FILE *      qclasses_dump_file = NULL;
+    FILE *      linked_sections_dump_file = NULL;
+    try {
+        string  file_name = qclasses_dump_file_name + tmp_suffix;
+        qclasses_dump_file = fopen(file_name.c_str(), "wb");
+        if (qclasses_dump_file == NULL)
+            throw runtime_error("Cannot open file " + file_name);
+        setbuf(qclasses_dump_file, NULL);
+
+        SOneStructDumpHeader    header;
+        header.fixed_size = sizeof(SQueueDescriptionDump);
+        header.Write(qclasses_dump_file);
+
+        // Dump dynamic queue classes
+        for (set<string>::const_iterator  k = classes_to_dump.begin();
+                k != classes_to_dump.end(); ++k) {
+            TQueueParams::const_iterator  queue_class =
+                                                m_QueueClasses.find(*k);
+            x_DumpQueueOrClass(qclasses_dump_file, "", *k, false,
+                               queue_class->second);
+        }
+
+        // Dump dynamic queues: qname and its class.
+        for (set<string>::const_iterator  k = queues.begin();
+                k != queues.end(); ++k) {
+            TQueueInfo::const_iterator  q = m_Queues.find(*k);
+            x_DumpQueueOrClass(qclasses_dump_file, *k,
+                               q->second.first.qclass, true,
+                               q->second.first);
+        }
+
+        if (sync && fsync(fileno(qclasses_dump_file)) != 0)
+            throw runtime_error("Cannot sync file " + file_name);
+        fclose(qclasses_dump_file);
+        qclasses_dump_file = NULL;
+
+        // Dump linked sections if so
+        if (!linked_sections_to_dump.empty()) {
+            file_name = linked_sections_dump_file_name + tmp_suffix;
+            linked_sections_dump_file = fopen(file_name.c_str(), "wb");
+            if (linked_sections_dump_file == NULL)
+                throw runtime_error("Cannot open file " + file_name);
+            setbuf(linked_sections_dump_file, NULL);
+
+            header.fixed_size = sizeof(SLinkedSectionDump);
+            header.Write(linked_sections_dump_file);
+
+            CFastMutexGuard     guard(m_LinkedSectionsGuard);
+            for (set<string>::const_iterator
+                    k = linked_sections_to_dump.begin();
+                    k != linked_sections_to_dump.end(); ++k) {
+                map<string, map<string, string> >::const_iterator
+                    j = m_LinkedSections.find(*k);
+                x_DumpLinkedSection(linked_sections_dump_file, *k,
+                                    j->second);
+            }
+
+            if (sync && fsync(fileno(linked_sections_dump_file)) != 0)
+                throw runtime_error("Cannot sync file " + file_name);
+            fclose(linked_sections_dump_file);
+            linked_sections_dump_file = NULL;
+        }
+
+        if (sync) {
+            // The linked sections go first: the extra sections are
+            // harmless while the missing ones are not
+            if (linked_sections_to_dump.empty())
+                CFile(linked_sections_dump_file_name).Remove();
+            else if (!CFile(linked_sections_dump_file_name + tmp_suffix).
+                            Rename(linked_sections_dump_file_name,
+                                   CDirEntry::fRF_Overwrite))
+                throw runtime_error("Cannot rename file to " +
+                                    linked_sections_dump_file_name);
+            if (!CFile(qclasses_dump_file_name + tmp_suffix).
+                            Rename(qclasses_dump_file_name,
+                                   CDirEntry::fRF_Overwrite))
+                throw runtime_error("Cannot rename file to " +
+                                    qclasses_dump_file_name);
+        }
+    } catch (...) {
+        if (qclasses_dump_file != NULL)
+            fclose(qclasses_dump_file);
+        if (linked_sections_dump_file != NULL)
+            fclose(linked_sections_dump_file);
+
+        // Remove the classes and linked sections files
+        string  file_name = qclasses_dump_file_name + tmp_suffix;
+        if (access(file_name.c_str(), F_OK) != -1)
+            remove(file_name.c_str());
+        file_name = linked_sections_dump_file_name + tmp_suffix;
+        if (access(file_name.c_str(), F_OK) != -1)
+            remove(file_name.c_str());
+        throw;
+    }
+}
+
+
+// The dynamic queues are journaled as a whole each time the set of them
+// changes so that they are recreated before the jobs are restored from the
+// journal. The caller holds m_ConfigureLock or it is the startup time.
+void CQueueDataBase::x_JournalDynamicQueues(void)
+{
+    if (!m_JournalStarted)
+        return;
+
+    set<string>     dynamic_queues;
+    for (TQueueInfo::const_iterator  k = m_Queues.begin();
+            k != m_Queues.end(); ++k)
+        if (k->second.first.kind == CQueue::eKindDynamic)
+            dynamic_queues.insert(k->first);
+
+    try {
+        if (dynamic_queues.empty()) {
+            CFile(m_JournalPath + kQClassDescriptionFileName).Remove();
+            CFile(m_JournalPath + kLinkedSectionsFileName).Remove();
+        } else {
+            x_DumpDynamicQueues(m_JournalPath, dynamic_queues, true);
+        }
+    } catch (const exception &  ex) {
+        string  msg = "Error journaling the dynamic queues: " +
+                      string(ex.what());
+        ERR_POST(msg);
+        m_Server->RegisterAlert(eDumpError, msg);
+    }
 }
 
 
@@ -2429,6 +2632,109 @@ void CQueueDataBase::x_RemoveDump(void)
 }
 
 
+void CQueueDataBase::x_RemoveJournal(void)
+{
+    try {
+        CDir    journal_dir(m_JournalPath);
+        if (journal_dir.Exists())
+            journal_dir.Remove();
+    } catch (const exception &  ex) {
+        ERR_POST("Error removing the journal directory: " << ex.what());
+    } catch (...) {
+        ERR_POST("Unknown error removing the journal directory");
+    }
+}
+
+
+// The jobs are restored from the journal instead of the database
+// reinitialization if the server did not stop gracefully and the journal
+// is there
+bool CQueueDataBase::x_CanRecoverFromJournal(bool  reinit)
+{
+    if (reinit || !m_Server->GetJournal())
+        return false;
+    if (!x_DoesCrashFlagFileExist())
+        return false;
+    if (!CDir(m_JournalPath).Exists())
+        return false;
+
+    ERR_POST("The server did not stop gracefully last time. "
+             "The jobs will be restored from the journal " << m_JournalPath);
+    m_Server->RegisterAlert(eStartAfterCrash, "The server did not stop "
+                            "gracefully last time. The jobs have been "
+                            "restored from the journal");
+
+    // The dump could be partially written at the time of the crash
+    x_RemoveDump();
+    return true;
+}
+
+
+void
+CQueueDataBase::x_StartJournals(bool                          from_journal,
+                                const set<string, PNocase> &  loaded_queues,
+                                bool                          keep_dump)
+{
+    try {
+        CDir    journal_dir(m_JournalPath);
+        if (!journal_dir.Exists())
+            journal_dir.Create();
+
+        // The files of the queues which are not configured any more
+        if (from_journal) {
+            CDir::TEntries  entries = journal_dir.GetEntries(
+                                        kEmptyStr, CDir::fIgnoreRecursive);
+            for (CDir::TEntries::const_iterator  k = entries.begin();
+                    k != entries.end(); ++k) {
+                if ((*k)->IsDir())
+                    continue;
+
+                string  entry_name = (*k)->GetName();
+                if (entry_name == kQClassDescriptionFileName ||
+                    entry_name == kLinkedSectionsFileName)
+                    continue;   // Rewritten when the journals are started
+
+                bool    known = false;
+                for (TQueueInfo::const_iterator  q = m_Queues.begin();
+                        q != m_Queues.end(); ++q) {
+                    if (CNSJobJournal::IsQueueFile(entry_name, q->first)) {
+                        known = true;
+                        break;
+                    }
+                }
+                if (!known)
+                    CFile(m_JournalPath + entry_name).Remove();
+            }
+        }
+    } catch (const exception &  ex) {
+        ERR_POST("Error preparing the journal directory: " << ex.what());
+        m_Server->RegisterAlert(eDumpError, "Error preparing the journal "
+                                "directory: " + string(ex.what()));
+        return;
+    }
+
+    for (TQueueInfo::iterator  k = m_Queues.begin();
+            k != m_Queues.end(); ++k) {
+        CNSJobJournal::EStartFrom   from = CNSJobJournal::eFromScratch;
+        if (loaded_queues.find(k->first) != loaded_queues.end())
+            from = from_journal ? CNSJobJournal::eFromSnapshot
+                                : CNSJobJournal::eFromDump;
+        try {
+            k->second.second->StartJournal(m_JournalPath, from,
+                                           m_DumpPath, keep_dump);
+        } catch (const exception &  ex) {
+            ERR_POST("Error starting the jobs journal of queue " << k->first <<
+                     ": " << ex.what());
+            m_Server->RegisterAlert(eDumpError,
+                                    "Error starting the jobs journal of "
+                                    "queue " + k->first + ": " + ex.what());
+        }
+    }
+    m_JournalStarted = true;
+    x_JournalDynamicQueues();
+}
+
+
 // Removes unnecessary files in the data directory
 void CQueueDataBase::x_RemoveDataFiles(void)
 {
@@ -2594,17 +2900,19 @@ void CQueueDataBase::x_CreateStorageVersionFile(void)
 
 
 void
-CQueueDataBase::x_ReadDumpQueueDesrc(set<string, PNocase> &  dump_static_queues,
+CQueueDataBase::x_ReadDumpQueueDesrc(const string &  dump_dir_name,
+                                     set<string, PNocase> &  dump_static_queues,
                                      map<string, string,
                                          PNocase> &  dump_dynamic_queues,
                                      TQueueParams &  dump_queue_classes)
 {
-    CDir        dump_dir(m_DumpPath);
+    CDir        dump_dir(dump_dir_name);
     if (!dump_dir.Exists())
         return;
 
     // The file contains dynamic queue classes and dynamic queue names
-    string      queue_desrc_file_name = m_DumpPath + kQClassDescriptionFileName;
+    string      queue_desrc_file_name = dump_dir_name +
+                                        kQClassDescriptionFileName;
     CFile       queue_desrc_file(queue_desrc_file_name);
     if (queue_desrc_file.Exists()) {
         FILE *      f = fopen(queue_desrc_file_name.c_str(), "rb");
@@ -2781,15 +3089,17 @@ set<string, PNocase> CQueueDataBase::x_GetConfigQueues(void)
 }
 
 
-void CQueueDataBase::x_AppendDumpLinkedSections(void)
+void
+CQueueDataBase::x_AppendDumpLinkedSections(const string &  dump_dir_name)
 {
     // Here: the m_LinkedSections has already been read from the configuration
     //       file. Let's append the sections from the dump.
-    CDir        dump_dir(m_DumpPath);
+    CDir        dump_dir(dump_dir_name);
     if (!dump_dir.Exists())
         return;
 
-    string  linked_sections_file_name = m_DumpPath + kLinkedSectionsFileName;
+    string  linked_sections_file_name = dump_dir_name +
+                                        kLinkedSectionsFileName;
     CFile   linked_sections_file(linked_sections_file_name);
 
     if (linked_sections_file.Exists()) {
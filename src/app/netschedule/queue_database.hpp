@@ -107,6 +107,7 @@ public:
     // Collect garbage from affinities
     void PurgeAffinities(void);
     void PurgeGroups(void);
+    void PurgeInternedStrings(void);
     void StaleWNodes(void);
     void PurgeBlacklistedJobs(void);
     void PurgeClientRegistry(void);
@@ -128,7 +129,14 @@ public:
     void RunExecutionWatcherThread(const CNSPreciseTime &  run_delay);
     void StopExecutionWatcherThread(void);
 
+    // Group committed journal of the job changes
+    void SyncJournals(void);
+    void RunJournalThread(void);
+    void StopJournalThread(void);
+    void WakeupJournalThread(void);
+
     string PrintTransitionCounters(void);
+    string PrintTransitionCountersPrometheus(void);
     string PrintJobsStat(const CNSClientId &  client);
     string GetQueueClassesInfo(void) const;
     string GetQueueClassesConfig(void) const;
@@ -170,6 +178,8 @@ private:
     CBackgroundHost &    m_Host;
     string               m_DataPath;
     string               m_DumpPath;
+    string               m_JournalPath;
+    bool                 m_JournalStarted;
     unsigned int         m_MaxQueues;
     bool                 m_Diskless;
 
@@ -189,6 +199,7 @@ private:
     CRef<CServiceThread>                    m_ServiceThread;
     CRef<CGetJobNotificationThread>         m_NotifThread;
     CRef<CJobQueueExecutionWatcherThread>   m_ExeWatchThread;
+    CRef<CJobJournalThread>                 m_JournalThread;
 
     CNetScheduleServer *                    m_Server;
 
@@ -257,24 +268,34 @@ private:
 
     CRef<CQueue>  x_GetQueueAt(unsigned int  index);
 
-    void x_Dump(void);
+    bool x_Dump(void);
     void x_DumpQueueOrClass(FILE *  f,
                             const string &  qname, const string &  qclass,
                             bool  is_queue,
                             const SQueueParameters &  params);
     void x_DumpLinkedSection(FILE *  f, const string &  sname,
                              const map<string, string> &  values);
+    void x_DumpDynamicQueues(const string &  dir_name,
+                             const set<string> &  queues,
+                             bool  sync);
+    void x_JournalDynamicQueues(void);
     void x_RemoveDump(void);
     void x_RemoveDataFiles(void);
     void x_CreateStorageVersionFile(void);
 
     bool x_CheckOpenPreconditions(bool  reinit);
-    void x_ReadDumpQueueDesrc(set<string, PNocase> &  dump_static_queues,
+    bool x_CanRecoverFromJournal(bool  reinit);
+    void x_StartJournals(bool  from_journal,
+                         const set<string, PNocase> &  loaded_queues,
+                         bool  keep_dump);
+    void x_RemoveJournal(void);
+    void x_ReadDumpQueueDesrc(const string &  dump_dir_name,
+                              set<string, PNocase> &  dump_static_queues,
                               map<string, string,
                                   PNocase> &  dump_dynamic_queues,
                               TQueueParams &  dump_queue_classes);
     set<string, PNocase> x_GetConfigQueues(void);
-    void x_AppendDumpLinkedSections(void);
+    void x_AppendDumpLinkedSections(const string &  dump_dir_name);
     CNSPreciseTime CalculateRuntimePrecision(void) const;
     void x_BackupDump(void);
     void x_CreateSpaceReserveFile(void);
@@ -12,7 +12,10 @@ from netschedule_tests_pack import TestBase
 from netschedule_tests_pack_4_10 import execAny
 
 from urllib.parse import parse_qs
+import glob
+import os
 import socket
+import struct
 import time
 
 
@@ -245,3 +248,249 @@ class Scenario2004(TestBase):
 
         return True
 
+
+
+class Scenario2005(TestBase):
+
+    """Scenario 2005"""
+
+    def __init__(self, netschedule):
+        TestBase.__init__(self, netschedule)
+
+    @staticmethod
+    def getScenario():
+        """Provides the scenario"""
+        return "Enable the jobs journal; submit 5 jobs; submit one more " \
+               "job; kill -9 NS; damage the last journal record and " \
+               "append a truncated record; start NS -> 5 jobs restored"
+
+    def execute(self):
+        """Should return True if the execution completed successfully"""
+        self.fromScratch(1300)
+
+        jobIDs = []
+        for _ in range(5):
+            jobIDs.append(self.ns.submitJob('TEST', 'blah'))
+        # The replies are held till the jobs are synced, so the last job
+        # goes in a separate sync anyway
+        lostJobID = self.ns.submitJob('TEST', 'blah')
+        time.sleep(1)
+        self.ns.kill("SIGKILL")
+
+        journalPath = os.path.join(self.ns.getDBPath(), 'journal')
+        segments = glob.glob(os.path.join(journalPath,
+                                          'jobs.journal.TEST.*'))
+        if not segments:
+            raise Exception("No journal segment found in " + journalPath)
+        segment = max(segments,
+                      key=lambda name: int(name.rsplit('.', 1)[1]))
+
+        # The last record is the last job; its checksum ends the file
+        with open(segment, 'r+b') as f:
+            f.seek(-1, os.SEEK_END)
+            lastByte = f.read(1)
+            f.seek(-1, os.SEEK_END)
+            f.write(bytes([lastByte[0] ^ 0xFF]))
+            f.seek(0, os.SEEK_END)
+            # Record type and a part of the body size
+            f.write(b'\x01\x00\x00\x00\x10\x00')
+
+        self.ns.start()
+        if not self.ns.isRunning():
+            raise Exception("Cannot start netschedule")
+
+        count = self.ns.getActiveJobsCount('TEST')
+        if count != 5:
+            raise Exception("Expected 5 restored jobs, got " + str(count))
+        for jobID in jobIDs:
+            status = self.ns.getFastJobStatus('TEST', jobID)
+            if status != 'Pending':
+                raise Exception("Unexpected restored job " + jobID +
+                                " status: " + status)
+
+        try:
+            status = self.ns.getFastJobStatus('TEST', lostJobID)
+        except Exception as exc:
+            if 'eJobNotFound' in str(exc):
+                return True
+            raise
+        if status not in ['', 'NotFound']:
+            raise Exception("The job with the damaged journal record " +
+                            "is restored: " + status)
+        return True
+
+
+class Scenario2006(TestBase):
+
+    """Scenario 2006"""
+
+    def __init__(self, netschedule):
+        TestBase.__init__(self, netschedule)
+
+    @staticmethod
+    def getScenario():
+        """Provides the scenario"""
+        return "Submit 5 jobs; GET2 count=3 -> 3 jobs in one line; " \
+               "GET2 count=10 -> the other 2 jobs; GET2 -> no jobs"
+
+    def execute(self):
+        """Should return True if the execution completed successfully"""
+        self.fromScratch()
+
+        jobIDs = []
+        for _ in range(5):
+            jobIDs.append(self.ns.submitJob('TEST', 'blah'))
+
+        ns_client = self.getNetScheduleService('TEST', 'scenario2006')
+        ns_client.set_client_identification('node', 'session')
+
+        output = execAny(ns_client, 'GET2 wnode_aff=0 any_aff=1 count=3')
+        values = parse_qs(output, True, True)
+        if values['job_key'] != jobIDs[:3]:
+            raise Exception("Unexpected GET2 count=3 job keys: " +
+                            str(values['job_key']))
+        # Each job has its own fields
+        if len(values['auth_token']) != 3 or len(values['input']) != 3:
+            raise Exception("Unexpected GET2 count=3 output: " + output)
+
+        output = execAny(ns_client, 'GET2 wnode_aff=0 any_aff=1 count=10')
+        values = parse_qs(output, True, True)
+        if values['job_key'] != jobIDs[3:]:
+            raise Exception("Unexpected GET2 count=10 job keys: " +
+                            str(values['job_key']))
+
+        for jobID in jobIDs:
+            status = self.ns.getFastJobStatus('TEST', jobID)
+            if status != 'Running':
+                raise Exception("Unexpected job " + jobID +
+                                " status: " + status)
+
+        output = execAny(ns_client, 'GET2 wnode_aff=0 any_aff=1 count=3')
+        if output.strip() != '':
+            raise Exception("Unexpected GET2 output; expected no jobs")
+        return True
+
+
+class Scenario2007(TestBase):
+
+    """Scenario 2007"""
+
+    def __init__(self, netschedule):
+        TestBase.__init__(self, netschedule)
+
+    @staticmethod
+    def getScenario():
+        """Provides the scenario"""
+        return "Submit 20 jobs with 512K input; GET2 count=20 and reset " \
+               "the connection while NS writes the reply -> " \
+               "all 20 jobs are rolled back to Pending"
+
+    def execute(self):
+        """Should return True if the execution completed successfully"""
+        self.fromScratch()
+
+        # The reply is much larger than the socket buffers, so NS is
+        # blocked on writing it when the connection is reset
+        jobInput = 'x' * (512 * 1024)
+        jobIDs = []
+        submitter = self.connectDirect('TEST', 'scenario2007')
+        for _ in range(20):
+            jobIDs.append(self.executeDirect(submitter,
+                                             'SUBMIT input=' + jobInput))
+        submitter.close()
+
+        worker = self.connectDirect('TEST', 'scenario2007', 4096)
+        worker.sendall(b'GET2 wnode_aff=0 any_aff=1 count=20\n')
+        if not worker.recv(16).startswith(b'OK:job_key='):
+            raise Exception("Unexpected GET2 reply")
+        time.sleep(1)
+        worker.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER,
+                          struct.pack('ii', 1, 0))
+        worker.close()
+        time.sleep(1)
+
+        # The run timeout is 7 seconds so the jobs which were not rolled
+        # back are still running
+        for jobID in jobIDs:
+            status = self.ns.getFastJobStatus('TEST', jobID)
+            if status != 'Pending':
+                raise Exception("Job " + jobID + " is not rolled back; "
+                                "status: " + status)
+        return True
+
+    def connectDirect(self, qname, clientName, rcvbuf=None):
+        """Connects to NS bypassing the client API"""
+        sock = socket.socket()
+        if rcvbuf is not None:
+            # Must be set before connecting to limit the window
+            sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, rcvbuf)
+        sock.settimeout(30)
+        sock.connect((self.ns.getHost(), self.ns.getPort()))
+        sock.sendall(b'netschedule_admin client_node=' +
+                     clientName.encode() + b' client_session=' +
+                     clientName.encode() + b'\n' + qname.encode() + b'\n')
+        return sock
+
+    @staticmethod
+    def executeDirect(sock, cmd):
+        """Executes a single line command and provides the reply"""
+        sock.sendall(cmd.encode() + b'\n')
+        reply = b''
+        while not reply.endswith(b'\n'):
+            data = sock.recv(8192)
+            if not data:
+                raise Exception("Connection closed by NS")
+            reply += data
+        reply = reply.decode().strip()
+        if not reply.startswith('OK:'):
+            raise Exception("Unexpected NS reply: " + reply)
+        return reply[3:]
+
+
+class Scenario2008(TestBase):
+
+    """Scenario 2008"""
+
+    def __init__(self, netschedule):
+        TestBase.__init__(self, netschedule)
+
+    @staticmethod
+    def getScenario():
+        """Provides the scenario"""
+        return "Enable the jobs journal; create dynamic queue DYN; " \
+               "submit 3 jobs to DYN; kill -9 NS right after the replies; " \
+               "start NS -> DYN is there with 3 pending jobs"
+
+    def execute(self):
+        """Should return True if the execution completed successfully"""
+        self.fromScratch(1300)
+
+        self.ns.createQueue('DYN', 'class1')
+        jobIDs = []
+        for _ in range(3):
+            jobIDs.append(self.ns.submitJob('DYN', 'blah'))
+        # No delay: the replies are sent after the jobs are journaled
+        self.ns.kill("SIGKILL")
+
+        self.ns.start()
+        if not self.ns.isRunning():
+            raise Exception("Cannot start netschedule")
+
+        queues = self.ns.getQueueList()
+        if not [q for q in queues if q.strip() == 'DYN']:
+            raise Exception("The dynamic queue is not restored; queues: " +
+                            str(queues))
+        info = self.ns.getQueueInfo('DYN')
+        if info.get('kind') != 'dynamic':
+            raise Exception("Unexpected restored queue kind: " +
+                            str(info.get('kind')))
+
+        count = self.ns.getActiveJobsCount('DYN')
+        if count != 3:
+            raise Exception("Expected 3 restored jobs, got " + str(count))
+        for jobID in jobIDs:
+            status = self.ns.getFastJobStatus('DYN', jobID)
+            if status != 'Pending':
+                raise Exception("Unexpected restored job " + jobID +
+                                " status: " + status)
+        return True
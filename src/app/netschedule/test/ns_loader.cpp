@@ -48,6 +48,9 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <thread>
+
 
 USING_NCBI_SCOPE;
 
@@ -65,6 +68,7 @@ class CNetScheduleLoader : public CNcbiApplication
 
 
         CNetScheduleLoader()
+            : m_JobsDone(0), m_Failed(false)
         {}
 
         ~CNetScheduleLoader()
@@ -72,11 +76,18 @@ class CNetScheduleLoader : public CNcbiApplication
 
     private:
         unsigned int  x_GetTotalJobs(const CArgs &  args);
+        unsigned int  x_GetThreads(const CArgs &  args);
         CNetScheduleAPI  x_GetAPI(const string &  service,
-                                  const string &  qname);
-        string  x_GetAffinity(void);
+                                  const string &  qname,
+                                  unsigned int  thread_no);
+        string  x_GetAffinity(unsigned int  thread_no);
         CNetScheduleJob  x_SubmitJob(CNetScheduleSubmitter &  submitter,
                                      const string &  aff);
+        void  x_RunJobs(unsigned int  thread_no, unsigned int  total_jobs);
+
+    private:
+        std::atomic<unsigned int>   m_JobsDone;
+        std::atomic<bool>           m_Failed;
 };
 
 
@@ -117,6 +128,13 @@ void CNetScheduleLoader::Init(void)
                              "Number of jobs to submit",
                              CArgDescriptions::eInteger);
 
+    arg_desc->AddOptionalKey("threads",
+                             "threads",
+                             "Number of threads running the jobs in parallel; "
+                             "each thread uses its own affinity and the jobs "
+                             "are split evenly between them",
+                             CArgDescriptions::eInteger);
+
     // Setup arg.descriptions for this application
     SetupArgDescriptions(arg_desc.release());
 }
@@ -130,11 +148,20 @@ unsigned int  CNetScheduleLoader::x_GetTotalJobs(const CArgs &  args)
 }
 
 
+unsigned int  CNetScheduleLoader::x_GetThreads(const CArgs &  args)
+{
+    if (args["threads"] && args["threads"].AsInteger() > 1)
+        return args["threads"].AsInteger();
+    return 1;       // default
+}
+
+
 CNetScheduleAPI  CNetScheduleLoader::x_GetAPI(const string &  service,
-                                              const string &  qname)
+                                              const string &  qname,
+                                              unsigned int  thread_no)
 {
     char        buffer[ 64 ];
-    sprintf(buffer, "node_%d", getpid());
+    sprintf(buffer, "node_%d_%u", getpid(), thread_no);
 
     CNetScheduleAPI     cl = CNetScheduleAPI(service, "crash_test", qname);
     cl.SetProgramVersion("ns_loader 1.0.0");
@@ -143,10 +170,10 @@ CNetScheduleAPI  CNetScheduleLoader::x_GetAPI(const string &  service,
     return cl;
 }
 
-string  CNetScheduleLoader::x_GetAffinity(void)
+string  CNetScheduleLoader::x_GetAffinity(unsigned int  thread_no)
 {
     char        buffer[ 64 ];
-    sprintf(buffer, "aff_%d", getpid());
+    sprintf(buffer, "aff_%d_%u", getpid(), thread_no);
     return buffer;
 }
 
@@ -164,22 +191,20 @@ CNetScheduleLoader::x_SubmitJob(CNetScheduleSubmitter &  submitter,
 }
 
 
-int CNetScheduleLoader::Run(void)
+void CNetScheduleLoader::x_RunJobs(unsigned int  thread_no,
+                                   unsigned int  total_jobs)
 {
     const CArgs &           args = GetArgs();
-    unsigned                total_jobs = x_GetTotalJobs(args);
-    string                  aff = x_GetAffinity();
+    string                  aff = x_GetAffinity(thread_no);
     CNetScheduleAPI         cl = x_GetAPI(args["service"].AsString(),
-                                          args["queue"].AsString());
+                                          args["queue"].AsString(),
+                                          thread_no);
     CNetScheduleSubmitter   submitter = cl.GetSubmitter();
     CNetScheduleExecutor    executor = cl.GetExecutor();
 
-    cl.GetAdmin().PrintServerVersion(NcbiCout);
-
-
     CNetScheduleJob                 job;
     CNetScheduleAPI::EJobStatus     status;
-    while (total_jobs > 0) {
+    while (total_jobs > 0 && !m_Failed) {
         // Submit
         job.Reset();
         job = x_SubmitJob(submitter, aff);
@@ -209,9 +234,61 @@ int CNetScheduleLoader::Run(void)
             throw runtime_error("Unexpected job status after PUT2");
 
         --total_jobs;
+        ++m_JobsDone;
     }
+}
+
+
+int CNetScheduleLoader::Run(void)
+{
+    const CArgs &           args = GetArgs();
+    unsigned                total_jobs = x_GetTotalJobs(args);
+    unsigned                threads = x_GetThreads(args);
 
-    return 0;
+    CNetScheduleAPI         cl = x_GetAPI(args["service"].AsString(),
+                                          args["queue"].AsString(), 0);
+    cl.GetAdmin().PrintServerVersion(NcbiCout);
+
+    if (threads == 1) {
+        x_RunJobs(0, total_jobs);
+        return 0;
+    }
+
+    // Many threads with different affinities: the server is expected to
+    // serve them in parallel, so the reported rate should grow with the
+    // number of threads until the server saturates
+    vector<std::thread>     workers;
+    CStopWatch              sw(CStopWatch::eStart);
+
+    for (unsigned int  k = 0; k < threads; ++k) {
+        unsigned int    jobs = total_jobs / threads +
+                               (k < total_jobs % threads ? 1 : 0);
+        workers.push_back(std::thread([this, k, jobs]() {
+            try {
+                x_RunJobs(k, jobs);
+            } catch (const exception &  ex) {
+                ERR_POST("Thread " << k << ": " << ex.what());
+                m_Failed = true;
+            }
+        }));
+    }
+    for (auto &  worker : workers)
+        worker.join();
+
+    double          elapsed = sw.Elapsed();
+    unsigned int    done = m_JobsDone;
+
+    // Each job takes 6 commands: SUBMIT, SST, GET2, WST, PUT2, WST
+    NcbiCout << "Threads: " << threads
+             << ", jobs: " << done
+             << ", time: " << NStr::DoubleToString(elapsed, 3) << " sec"
+             << ", jobs/sec: "
+             << NStr::DoubleToString(elapsed > 0 ? done / elapsed : 0.0, 1)
+             << ", commands/sec: "
+             << NStr::DoubleToString(elapsed > 0 ? 6 * done / elapsed : 0.0, 1)
+             << NcbiEndl;
+
+    return m_Failed ? 1 : 0;
 }
 
 
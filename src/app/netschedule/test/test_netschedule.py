@@ -821,7 +821,11 @@ def main():
               pack_4_30.Scenario2002( netschedule ),
               pack_4_30.Scenario2003( netschedule ),
 
-              pack_4_30.Scenario2004( netschedule )
+              pack_4_30.Scenario2004( netschedule ),
+              pack_4_30.Scenario2005( netschedule ),
+              pack_4_30.Scenario2006( netschedule ),
+              pack_4_30.Scenario2007( netschedule ),
+              pack_4_30.Scenario2008( netschedule )
             ]
 
     # Calculate the start test index
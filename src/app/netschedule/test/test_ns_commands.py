@@ -176,6 +176,7 @@ class NSCommandsSender:
             "STAT ALERTS":          self.__statAlerts,
             "STAT ALL":             self.__statAll,
             "STAT SERVICES":        self.__statServices,
+            "STAT METRICS":         self.__statMetrics,
             "ACKALERT":             self.__ackAlert,
             "DUMP":                 self.__dump,
             "GETP":                 self.__getp,
@@ -201,6 +202,7 @@ class NSCommandsSender:
             "SETAFF":               self.__setaff,
             "GET":                  self.__get,
             "GET2":                 self.__get2,
+            "GET2 count":           self.__get2Count,
             "PUT":                  self.__put,
             "PUT2":                 self.__put2,
             "RETURN":               self.__return,
@@ -366,6 +368,11 @@ class NSCommandsSender:
         self.__nsConnect.execute( "STAT SERVICES", False )
         return
 
+    def __statMetrics( self ):
+        self.__submit()
+        self.__nsConnect.execute( "STAT METRICS", True )
+        return
+
     def __ackAlert( self ):
         self.__nsConnect.execute( "ACKALERT config somebody", False )
         return
@@ -490,6 +497,24 @@ class NSCommandsSender:
         authToken = values[ 'auth_token' ][ 0 ]
         return jobKey, authToken
 
+    def __get2Count( self ):
+        for _ in range( 3 ):
+            self.__submit()
+        output = self.__nsConnect.execute( "GET2 wnode_aff=0 any_aff=0 "
+                                           "exclusive_new_aff=0 aff=a1 "
+                                           "count=3", False )
+
+        # All the jobs come in one line, each with its own fields
+        values = parse_qs( output, True, True )
+        jobKeys = values[ 'job_key' ]
+        if len( jobKeys ) != 3 or len( set( jobKeys ) ) != 3:
+            raise UnexpectedNSResponse( "Unexpected GET2 count=3 response: " +
+                                        output )
+        if len( values[ 'auth_token' ] ) != 3:
+            raise UnexpectedNSResponse( "Unexpected GET2 count=3 response: " +
+                                        output )
+        return jobKeys
+
     def __put( self ):
         jobKey = self.__get()
         self.__nsConnect.execute( "PUT " + jobKey + " 0 MyOutput", False )
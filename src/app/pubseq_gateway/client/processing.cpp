@@ -1173,6 +1173,134 @@ int CProcessing::Performance(const SPerformanceParams& params)
     return 0;
 }
 
+shared_ptr<CPSG_Request> s_CreateLoadTestRequest(const string& type, const string& id, shared_ptr<void> user_context)
+{
+    if (type == "biodata") return make_shared<CPSG_Request_Biodata>(CPSG_BioId(id), move(user_context));
+    if (type == "blob")    return make_shared<CPSG_Request_Blob>(CPSG_BlobId(id), move(user_context));
+    return make_shared<CPSG_Request_Resolve>(CPSG_BioId(id), move(user_context));
+}
+
+// Request ID (user request IDs are on) and the time the request was due to be submitted at
+struct SLoadTestContext : string
+{
+    chrono::steady_clock::time_point scheduled;
+
+    SLoadTestContext(size_t id, chrono::steady_clock::time_point s) : string(to_string(id)), scheduled(s) {}
+};
+
+int CProcessing::LoadTest(const SLoadTestParams& params)
+{
+    if ((params.rate <= 0.0) || (params.duration <= 0.0)) {
+        cerr << "RATE and DURATION must be positive" << endl;
+        return -1;
+    }
+
+    using TClock = chrono::steady_clock;
+    using TMilli = chrono::duration<double, milli>;
+
+    vector<string> ids;
+
+    for (string line; ReadLine(line); ) {
+        ids.emplace_back(move(line));
+    }
+
+    if (ids.empty()) {
+        cerr << "No IDs to request" << endl;
+        return -1;
+    }
+
+    const auto total = max<size_t>(1, static_cast<size_t>(params.rate * params.duration));
+    const auto user_threads = max<size_t>(1, params.user_threads);
+
+    CPSG_Queue queue(params.service);
+    queue.SetUserArgs(params.user_args);
+
+    atomic_size_t finished(0);
+    vector<vector<double>> latencies(user_threads);
+    vector<size_t> errors(user_threads);
+
+    auto l = [&](vector<double>& thread_latencies, size_t& thread_errors) {
+        while (finished < total) {
+            auto reply = queue.GetNextReply(CDeadline(0, 100 * 1000 * 1000));
+
+            if (!reply) continue;
+
+            for (;;) {
+                auto reply_item = reply->GetNextItem(CDeadline::eInfinite);
+                _ASSERT(reply_item);
+
+                if (reply_item->GetType() == CPSG_ReplyItem::eEndOfReply) break;
+
+                reply_item->GetStatus(CDeadline::eInfinite);
+            }
+
+            const auto status = reply->GetStatus(CDeadline::eInfinite);
+            const auto done = TClock::now();
+
+            // Latency is counted from the scheduled (not the actual) submit time,
+            // so that a client falling behind the target rate is not masked
+            auto context = reply->GetRequest()->GetUserContext<SLoadTestContext>();
+            thread_latencies.push_back(TMilli(done - context->scheduled).count());
+            if (status != EPSG_Status::eSuccess) ++thread_errors;
+            ++finished;
+        }
+    };
+
+    vector<thread> threads;
+    threads.reserve(user_threads);
+
+    for (size_t i = 0; i < user_threads; ++i) {
+        threads.emplace_back(l, ref(latencies[i]), ref(errors[i]));
+    }
+
+    // Requests are submitted on a fixed schedule regardless of how fast replies come back
+    const auto interval = chrono::duration<double>(1.0 / params.rate);
+    const auto start = TClock::now();
+
+    for (size_t i = 0; i < total; ++i) {
+        auto scheduled = start + chrono::duration_cast<TClock::duration>(interval * i);
+        this_thread::sleep_until(scheduled);
+
+        auto user_context = make_shared<SLoadTestContext>(i, scheduled);
+        auto request = s_CreateLoadTestRequest(params.request_type, ids[i % ids.size()], move(user_context));
+        queue.SendRequest(move(request), CDeadline::eInfinite);
+    }
+
+    const auto submitted = TClock::now();
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    const auto elapsed = chrono::duration<double>(TClock::now() - start).count();
+
+    vector<double> all;
+    all.reserve(total);
+
+    for (auto& thread_latencies : latencies) {
+        all.insert(all.end(), thread_latencies.begin(), thread_latencies.end());
+    }
+
+    sort(all.begin(), all.end());
+
+    auto percentile = [&](double p) { return all[min(all.size() - 1, static_cast<size_t>(ceil(p * all.size())) - 1)]; };
+
+    cout << fixed << setprecision(3) <<
+        "requests\t" << all.size() << '\n' <<
+        "errors\t" << accumulate(errors.begin(), errors.end(), size_t(0)) << '\n' <<
+        "elapsed_s\t" << elapsed << '\n' <<
+        "target_rate\t" << params.rate << '\n' <<
+        "submit_rate\t" << total / chrono::duration<double>(submitted - start).count() << '\n' <<
+        "throughput\t" << all.size() / elapsed << '\n' <<
+        "latency_min_ms\t" << all.front() << '\n' <<
+        "latency_p50_ms\t" << percentile(0.5) << '\n' <<
+        "latency_p99_ms\t" << percentile(0.99) << '\n' <<
+        "latency_p999_ms\t" << percentile(0.999) << '\n' <<
+        "latency_max_ms\t" << all.back() << endl;
+
+    return 0;
+}
+
 bool CProcessing::ReadLine(string& line, istream& is)
 {
     for (;;) {
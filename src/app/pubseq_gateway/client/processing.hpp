@@ -247,6 +247,22 @@ struct SPerformanceParams : SParams
     {}
 };
 
+struct SLoadTestParams : SParams
+{
+    const double rate;
+    const double duration;
+    const size_t user_threads;
+    const string request_type;
+
+    SLoadTestParams(string s, SPSG_UserArgs ua, double r, double d, size_t ut, string rt) :
+        SParams(move(s), move(ua)),
+        rate(r),
+        duration(d),
+        user_threads(ut),
+        request_type(move(rt))
+    {}
+};
+
 template <class TParams>
 class CParallelProcessing
 {
@@ -306,6 +322,7 @@ public:
     template <class TParams>
     static int ParallelProcessing(const TParams& params, istream& is = cin);
     static int Performance(const SPerformanceParams& params);
+    static int LoadTest(const SLoadTestParams& params);
     static int JsonCheck(istream* schema_is);
 
     static void ItemComplete(SJsonOut& output, EPSG_Status status, const shared_ptr<CPSG_ReplyItem>& item);
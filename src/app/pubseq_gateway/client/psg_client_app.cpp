@@ -83,6 +83,7 @@ private:
 
 struct SInteractive {};
 struct SPerformance {};
+struct SLoadTest {};
 struct SJsonCheck {};
 
 void s_InitPsgOptions(CArgDescriptions& arg_desc);
@@ -98,6 +99,7 @@ CPsgClientApp::CPsgClientApp() :
             s_GetCommand<CPSG_Request_IpgResolve>    ("ipg_resolve", "Request IPG info"),
             s_GetCommand<SInteractive>               ("interactive", "Interactive JSON-RPC mode", SCommand::fParallel),
             s_GetCommand<SPerformance>               ("performance", "Performance testing", SCommand::fHidden),
+            s_GetCommand<SLoadTest>                  ("load_test",   "Load testing at a target request rate", SCommand::fHidden),
             s_GetCommand<SJsonCheck>                 ("json_check",  "JSON document validate", SCommand::fHidden),
         })
 {
@@ -285,6 +287,17 @@ void CPsgClientApp::s_InitRequest<SPerformance>(CArgDescriptions& arg_desc)
     arg_desc.AddDefaultKey("output-file", "FILENAME", "Output file to contain raw performance metrics", CArgDescriptions::eOutputFile, "-");
 }
 
+template <>
+void CPsgClientApp::s_InitRequest<SLoadTest>(CArgDescriptions& arg_desc)
+{
+    arg_desc.AddDefaultKey("id-file", "FILENAME", "File containing IDs to request (one per line, used in turn)", CArgDescriptions::eInputFile, "-");
+    arg_desc.AddDefaultKey("request-type", "TYPE", "Type of requests to submit", CArgDescriptions::eString, "resolve");
+    arg_desc.SetConstraint("request-type", new CArgAllow_Strings{"resolve", "biodata", "blob"});
+    arg_desc.AddDefaultKey("rate", "RATE", "Number of requests to submit per second", CArgDescriptions::eDouble, "100.0");
+    arg_desc.AddDefaultKey("duration", "SECONDS", "For how long to submit requests", CArgDescriptions::eDouble, "10.0");
+    arg_desc.AddDefaultKey("user-threads", "THREADS_NUM", "Number of user threads reading replies", CArgDescriptions::eInteger, "4");
+}
+
 template <>
 void CPsgClientApp::s_InitRequest<SJsonCheck>(CArgDescriptions& arg_desc)
 {
@@ -453,6 +466,21 @@ struct SPerformance : SBase<SPerformanceParams>, SIoRedirector
     }
 };
 
+struct SLoadTest : SBase<SLoadTestParams>, SIoRedirector
+{
+    SLoadTest(const CArgs& args) :
+        SBase<SLoadTestParams>{
+            args,
+            args["rate"].AsDouble(),
+            args["duration"].AsDouble(),
+            static_cast<size_t>(args["user-threads"].AsInteger()),
+            args["request-type"].AsString()
+        },
+        SIoRedirector(cin, args["id-file"].AsInputFile())
+    {
+    }
+};
+
 }
 
 template <>
@@ -565,6 +593,12 @@ int CPsgClientApp::RunRequest<SPerformance>(const CArgs& args)
     return CProcessing::Performance(NParamsBuilder::SPerformance(args));
 }
 
+template <>
+int CPsgClientApp::RunRequest<SLoadTest>(const CArgs& args)
+{
+    return CProcessing::LoadTest(NParamsBuilder::SLoadTest(args));
+}
+
 template <>
 int CPsgClientApp::RunRequest<SJsonCheck>(const CArgs& args)
 {
@@ -0,0 +1,726 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Local stand-in for PSG server (for load testing of the PSG client).
+ *   Serves canned resolve/biodata/blob replies over plain HTTP/2,
+ *   with optional reply delays and error injection.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+
+#include <map>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbi_url.hpp>
+#include <corelib/request_status.hpp>
+#include <connect/impl/ncbi_uv_nghttp2.hpp>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+
+struct SServerParams
+{
+    enum EError { eNoError, eStatus500, eStatus503, eMessage, eReset, eAnyError };
+
+    SUv_Tcp::TPort port;
+    uint32_t max_streams;
+    uint64_t delay;
+    uint64_t delay_jitter;
+    double error_rate;
+    EError error;
+    size_t blob_size;
+    size_t chunk_size;
+
+    static EError GetError(const string& error);
+};
+
+SServerParams::EError SServerParams::GetError(const string& error)
+{
+    if (error == "500")     return eStatus500;
+    if (error == "503")     return eStatus503;
+    if (error == "message") return eMessage;
+    if (error == "reset")   return eReset;
+    return eAnyError;
+}
+
+// Reply body in PSG protocol format
+struct SReplyBuilder
+{
+    SReplyBuilder& Chunk(const string& args, const string& data = string())
+    {
+        m_Os << "\n\nPSG-Reply-Chunk: " << args;
+        if (!data.empty()) m_Os << "&size=" << data.size();
+        m_Os << '\n' << data;
+        ++m_Chunks;
+        return *this;
+    }
+
+    string Get()
+    {
+        Chunk("item_id=0&item_type=reply&chunk_type=meta&n_chunks=" + to_string(m_Chunks + 1));
+        return m_Os.str();
+    }
+
+private:
+    ostringstream m_Os;
+    size_t m_Chunks = 0;
+};
+
+struct SCannedReplies
+{
+    SCannedReplies(const SServerParams& params);
+
+    string Get(const string& path) const;
+    static string Error(int status, const string& message);
+
+private:
+    static size_t GetSatKey(const string& seq_id) { return hash<string>()(seq_id) % 100000000; }
+
+    void BioseqInfo(SReplyBuilder& builder, const string& seq_id) const;
+    void Blob(SReplyBuilder& builder, const string& blob_id) const;
+
+    const string m_BlobData;
+    const size_t m_ChunkSize;
+};
+
+SCannedReplies::SCannedReplies(const SServerParams& params) :
+    m_BlobData(params.blob_size, 'N'),
+    m_ChunkSize(max<size_t>(params.chunk_size, 1))
+{
+}
+
+string SCannedReplies::Get(const string& path) const
+{
+    auto query_pos = path.find('?');
+    auto method = path.substr(0, query_pos);
+    CUrlArgs args(query_pos == string::npos ? kEmptyStr : path.substr(query_pos + 1));
+    SReplyBuilder builder;
+
+    if (method == "/ID/resolve") {
+        BioseqInfo(builder, args.GetValue("seq_id"));
+
+    } else if (method == "/ID/get") {
+        const auto& seq_id = args.GetValue("seq_id");
+        BioseqInfo(builder, seq_id);
+        Blob(builder, "4." + to_string(GetSatKey(seq_id)));
+
+    } else if (method == "/ID/getblob") {
+        Blob(builder, args.GetValue("blob_id"));
+
+    } else {
+        return Error(CRequestStatus::e404_NotFound, "Unknown request '" + method + '\'');
+    }
+
+    return builder.Get();
+}
+
+string SCannedReplies::Error(int status, const string& message)
+{
+    return SReplyBuilder()
+        .Chunk("item_id=0&item_type=reply&chunk_type=message&severity=error&status=" + to_string(status), message)
+        .Get();
+}
+
+void SCannedReplies::BioseqInfo(SReplyBuilder& builder, const string& seq_id) const
+{
+    ostringstream os;
+    os << "{\"accession\":\"" << NStr::JsonEncode(seq_id) << "\",\"version\":1,\"seq_id_type\":10"
+        ",\"mol\":1,\"length\":" << m_BlobData.size() << ",\"state\":10,\"seq_state\":0,\"tax_id\":9606"
+        ",\"hash\":0,\"date_changed\":0,\"sat\":4,\"sat_key\":" << GetSatKey(seq_id) << '}';
+
+    builder.Chunk("item_id=1&item_type=bioseq_info&chunk_type=data_and_meta&n_chunks=1", os.str());
+}
+
+void SCannedReplies::Blob(SReplyBuilder& builder, const string& blob_id) const
+{
+    ostringstream os;
+    os << "{\"last_modified\":0,\"flags\":0,\"size\":" << m_BlobData.size() <<
+        ",\"size_unpacked\":" << m_BlobData.size() << ",\"class\":0,\"div\":\"\",\"username\":\"\""
+        ",\"hup_date\":0,\"owner\":0,\"date_asn1\":0,\"n_chunks\":0,\"id2_info\":\"\"}";
+
+    const auto encoded_id = NStr::URLEncode(blob_id);
+    const auto n_chunks = (m_BlobData.size() + m_ChunkSize - 1) / m_ChunkSize;
+
+    builder.Chunk("item_id=2&item_type=blob_prop&chunk_type=data_and_meta&n_chunks=1&blob_id=" + encoded_id, os.str());
+    builder.Chunk("item_id=3&item_type=blob&chunk_type=meta&n_chunks=" + to_string(n_chunks + 1) + "&blob_id=" + encoded_id);
+
+    for (size_t i = 0; i < n_chunks; ++i) {
+        builder.Chunk("item_id=3&item_type=blob&chunk_type=data&blob_chunk=" + to_string(i) + "&blob_id=" + encoded_id,
+                m_BlobData.substr(i * m_ChunkSize, m_ChunkSize));
+    }
+}
+
+class CPsgTestServer;
+
+struct SConnection : SUv_Handle<uv_tcp_t>
+{
+    using TId = uint64_t;
+
+    SConnection(CPsgTestServer& server, TId id);
+    ~SConnection();
+
+    int Init(uv_loop_t* loop);
+    int Accept(uv_stream_t* listener);
+    void Respond(int32_t stream_id);
+    void Send();
+    void Close();
+
+    TId GetId() const { return m_Id; }
+
+private:
+    struct SStream
+    {
+        string path;
+        string body;
+        size_t sent = 0;
+    };
+
+    template <class THandle, class ...TArgs1, class ...TArgs2>
+    static void OnCallback(void (SConnection::*member)(THandle*, TArgs1...), THandle* handle, TArgs2&&... args)
+    {
+        auto that = static_cast<SConnection*>(handle->data);
+        (that->*member)(handle, forward<TArgs2>(args)...);
+    }
+
+    static SConnection* GetThat(void* user_data) { _ASSERT(user_data); return static_cast<SConnection*>(user_data); }
+
+    void OnAlloc(uv_handle_t*, size_t suggested_size, uv_buf_t* buf);
+    void OnRead(uv_stream_t*, ssize_t nread, const uv_buf_t* buf);
+    void OnWrite(uv_write_t* req, int status);
+
+    int OnBeginHeaders(const nghttp2_frame* frame);
+    int OnHeader(const nghttp2_frame* frame, const uint8_t* name, size_t namelen, const uint8_t* value, size_t valuelen);
+    int OnFrameRecv(const nghttp2_frame* frame);
+    int OnStreamClose(int32_t stream_id);
+    ssize_t OnDataRead(int32_t stream_id, uint8_t* buf, size_t length, uint32_t* data_flags);
+
+    static void s_OnAlloc(uv_handle_t* handle, size_t suggested_size, uv_buf_t* buf) { OnCallback(&SConnection::OnAlloc, handle, suggested_size, buf); }
+    static void s_OnRead(uv_stream_t* stream, ssize_t nread, const uv_buf_t* buf) { OnCallback(&SConnection::OnRead, stream, nread, buf); }
+    static void s_OnWrite(uv_write_t* req, int status) { OnCallback(&SConnection::OnWrite, req, status); }
+    static void s_OnClose(uv_handle_t* handle) { delete static_cast<SConnection*>(handle->data); }
+
+    static int s_OnBeginHeaders(nghttp2_session*, const nghttp2_frame* frame, void* user_data)
+    {
+        return GetThat(user_data)->OnBeginHeaders(frame);
+    }
+
+    static int s_OnHeader(nghttp2_session*, const nghttp2_frame* frame, const uint8_t* name, size_t namelen,
+            const uint8_t* value, size_t valuelen, uint8_t, void* user_data)
+    {
+        return GetThat(user_data)->OnHeader(frame, name, namelen, value, valuelen);
+    }
+
+    static int s_OnFrameRecv(nghttp2_session*, const nghttp2_frame* frame, void* user_data)
+    {
+        return GetThat(user_data)->OnFrameRecv(frame);
+    }
+
+    static int s_OnStreamClose(nghttp2_session*, int32_t stream_id, uint32_t, void* user_data)
+    {
+        return GetThat(user_data)->OnStreamClose(stream_id);
+    }
+
+    static ssize_t s_OnDataRead(nghttp2_session*, int32_t stream_id, uint8_t* buf, size_t length,
+            uint32_t* data_flags, nghttp2_data_source*, void* user_data)
+    {
+        return GetThat(user_data)->OnDataRead(stream_id, buf, length, data_flags);
+    }
+
+    CPsgTestServer& m_Server;
+    const TId m_Id;
+    nghttp2_session* m_Session = nullptr;
+    vector<char> m_ReadBuffer;
+    SUv_Write m_Write;
+    unordered_map<int32_t, SStream> m_Streams;
+    bool m_Closing = false;
+};
+
+class CPsgTestServer
+{
+public:
+    CPsgTestServer(const SServerParams& params);
+
+    int Run();
+
+    void OnRequest(SConnection& connection, int32_t stream_id);
+    void OnClose(SConnection& connection) { m_Connections.erase(connection.GetId()); }
+
+    SServerParams::EError GetError();
+    uint32_t GetMaxStreams() const { return m_Params.max_streams; }
+    const SCannedReplies& GetReplies() const { return m_Replies; }
+
+private:
+    using TDelayed = multimap<uint64_t, pair<SConnection::TId, int32_t>>;
+
+    void OnConnection(uv_stream_t* listener, int status);
+    void OnTimer();
+
+    static void s_OnConnection(uv_stream_t* listener, int status) { static_cast<CPsgTestServer*>(listener->data)->OnConnection(listener, status); }
+    static void s_OnTimer(uv_timer_t* timer) { static_cast<CPsgTestServer*>(timer->data)->OnTimer(); }
+
+    const SServerParams& m_Params;
+    const SCannedReplies m_Replies;
+    SUv_Loop m_Loop;
+    uv_tcp_t m_Listener;
+    uv_timer_t m_Timer;
+    TDelayed m_Delayed;
+    unordered_map<SConnection::TId, SConnection*> m_Connections;
+    SConnection::TId m_NextId = 0;
+    mt19937_64 m_Random;
+};
+
+SConnection::SConnection(CPsgTestServer& server, TId id) :
+    SUv_Handle<uv_tcp_t>(s_OnClose),
+    m_Server(server),
+    m_Id(id),
+    m_Write(this, 64 * 1024)
+{
+    nghttp2_session_callbacks* callbacks;
+    nghttp2_session_callbacks_new(&callbacks);
+
+    nghttp2_session_callbacks_set_on_begin_headers_callback(callbacks, s_OnBeginHeaders);
+    nghttp2_session_callbacks_set_on_header_callback(       callbacks, s_OnHeader);
+    nghttp2_session_callbacks_set_on_frame_recv_callback(   callbacks, s_OnFrameRecv);
+    nghttp2_session_callbacks_set_on_stream_close_callback( callbacks, s_OnStreamClose);
+
+    nghttp2_session_server_new(&m_Session, callbacks, this);
+    nghttp2_session_callbacks_del(callbacks);
+
+    nghttp2_settings_entry iv[1] = {
+        {NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS, m_Server.GetMaxStreams()}
+    };
+
+    if (auto rv = nghttp2_submit_settings(m_Session, NGHTTP2_FLAG_NONE, iv, sizeof(iv) / sizeof(iv[0]))) {
+        ERR_POST("nghttp2_submit_settings failed " << SUvNgHttp2_Error::NgHttp2Str(rv));
+    }
+}
+
+SConnection::~SConnection()
+{
+    nghttp2_session_del(m_Session);
+}
+
+int SConnection::Init(uv_loop_t* loop)
+{
+    auto rv = uv_tcp_init(loop, this);
+    data = this;
+    return rv;
+}
+
+int SConnection::Accept(uv_stream_t* listener)
+{
+    auto stream = reinterpret_cast<uv_stream_t*>(static_cast<uv_tcp_t*>(this));
+
+    if (auto rv = uv_accept(listener, stream)) {
+        return rv;
+    }
+
+    uv_tcp_nodelay(this, 1);
+
+    if (auto rv = uv_read_start(stream, s_OnAlloc, s_OnRead)) {
+        return rv;
+    }
+
+    Send();
+    return 0;
+}
+
+void SConnection::Respond(int32_t stream_id)
+{
+    auto it = m_Streams.find(stream_id);
+
+    if (it == m_Streams.end()) return;
+
+    auto& stream = it->second;
+    const char* status = "200";
+
+    switch (m_Server.GetError()) {
+        case SServerParams::eNoError:
+            stream.body = m_Server.GetReplies().Get(stream.path);
+            break;
+
+        case SServerParams::eStatus500:
+            status = "500";
+            break;
+
+        case SServerParams::eStatus503:
+            status = "503";
+            break;
+
+        case SServerParams::eMessage:
+            stream.body = SCannedReplies::Error(CRequestStatus::e500_InternalServerError, "Injected error");
+            break;
+
+        case SServerParams::eReset:
+        case SServerParams::eAnyError:
+            nghttp2_submit_rst_stream(m_Session, NGHTTP2_FLAG_NONE, stream_id, NGHTTP2_INTERNAL_ERROR);
+            return;
+    }
+
+    SNgHttp2_Header<NGHTTP2_NV_FLAG_NO_COPY_NAME> headers[] = {
+        { ":status", status },
+        { "content-type", "application/x-ncbi-psg" },
+    };
+
+    nghttp2_data_provider data_prd;
+    data_prd.source.ptr = nullptr;
+    data_prd.read_callback = s_OnDataRead;
+
+    if (auto rv = nghttp2_submit_response(m_Session, stream_id, headers, sizeof(headers) / sizeof(headers[0]), &data_prd)) {
+        ERR_POST("nghttp2_submit_response failed " << SUvNgHttp2_Error::NgHttp2Str(rv));
+    }
+}
+
+void SConnection::Send()
+{
+    if (m_Closing) return;
+
+    auto& buffer = m_Write.GetBuffer();
+
+    for (;;) {
+        const uint8_t* out;
+        auto rv = nghttp2_session_mem_send(m_Session, &out);
+
+        if (rv < 0) {
+            ERR_POST(Trace << "nghttp2_session_mem_send failed " << SUvNgHttp2_Error::NgHttp2Str(static_cast<int>(rv)));
+            Close();
+            return;
+        } else if (rv == 0) {
+            break;
+        }
+
+        buffer.insert(buffer.end(), out, out + rv);
+    }
+
+    auto stream = reinterpret_cast<uv_stream_t*>(static_cast<uv_tcp_t*>(this));
+
+    if (auto rv = m_Write.Write(stream, s_OnWrite)) {
+        ERR_POST(Trace << "write failed " << SUvNgHttp2_Error::LibuvStr(rv));
+        Close();
+
+    } else if (!nghttp2_session_want_read(m_Session) && !nghttp2_session_want_write(m_Session)) {
+        Close();
+    }
+}
+
+void SConnection::Close()
+{
+    if (m_Closing) return;
+
+    m_Closing = true;
+    m_Server.OnClose(*this);
+    SUv_Handle<uv_tcp_t>::Close();
+}
+
+void SConnection::OnAlloc(uv_handle_t*, size_t suggested_size, uv_buf_t* buf)
+{
+    m_ReadBuffer.resize(suggested_size);
+    buf->base = m_ReadBuffer.data();
+    buf->len = static_cast<decltype(buf->len)>(m_ReadBuffer.size());
+}
+
+void SConnection::OnRead(uv_stream_t*, ssize_t nread, const uv_buf_t* buf)
+{
+    if (nread < 0) {
+        Close();
+        return;
+    }
+
+    auto rv = nghttp2_session_mem_recv(m_Session, reinterpret_cast<const uint8_t*>(buf->base), static_cast<size_t>(nread));
+
+    if (rv < 0) {
+        ERR_POST(Trace << "nghttp2_session_mem_recv failed " << SUvNgHttp2_Error::NgHttp2Str(static_cast<int>(rv)));
+        Close();
+        return;
+    }
+
+    Send();
+}
+
+void SConnection::OnWrite(uv_write_t* req, int status)
+{
+    if (m_Closing) return;
+
+    if (status < 0) {
+        Close();
+        return;
+    }
+
+    m_Write.OnWrite(req);
+    Send();
+}
+
+int SConnection::OnBeginHeaders(const nghttp2_frame* frame)
+{
+    if ((frame->hd.type == NGHTTP2_HEADERS) && (frame->headers.cat == NGHTTP2_HCAT_REQUEST)) {
+        m_Streams.emplace(frame->hd.stream_id, SStream());
+    }
+
+    return 0;
+}
+
+int SConnection::OnHeader(const nghttp2_frame* frame, const uint8_t* name, size_t namelen, const uint8_t* value, size_t valuelen)
+{
+    const CTempString kPath(":path");
+
+    if ((frame->hd.type == NGHTTP2_HEADERS) && (kPath == CTempString(reinterpret_cast<const char*>(name), namelen))) {
+        if (auto it = m_Streams.find(frame->hd.stream_id); it != m_Streams.end()) {
+            it->second.path.assign(reinterpret_cast<const char*>(value), valuelen);
+        }
+    }
+
+    return 0;
+}
+
+int SConnection::OnFrameRecv(const nghttp2_frame* frame)
+{
+    const bool request_frame = (frame->hd.type == NGHTTP2_HEADERS) || (frame->hd.type == NGHTTP2_DATA);
+
+    if (request_frame && (frame->hd.flags & NGHTTP2_FLAG_END_STREAM)) {
+        if (m_Streams.count(frame->hd.stream_id)) {
+            m_Server.OnRequest(*this, frame->hd.stream_id);
+        }
+    }
+
+    return 0;
+}
+
+int SConnection::OnStreamClose(int32_t stream_id)
+{
+    m_Streams.erase(stream_id);
+    return 0;
+}
+
+ssize_t SConnection::OnDataRead(int32_t stream_id, uint8_t* buf, size_t length, uint32_t* data_flags)
+{
+    auto it = m_Streams.find(stream_id);
+
+    if (it == m_Streams.end()) {
+        return NGHTTP2_ERR_TEMPORAL_CALLBACK_FAILURE;
+    }
+
+    auto& stream = it->second;
+    const auto to_copy = min(length, stream.body.size() - stream.sent);
+
+    memcpy(buf, stream.body.data() + stream.sent, to_copy);
+    stream.sent += to_copy;
+
+    if (stream.sent == stream.body.size()) {
+        *data_flags |= NGHTTP2_DATA_FLAG_EOF;
+    }
+
+    return static_cast<ssize_t>(to_copy);
+}
+
+CPsgTestServer::CPsgTestServer(const SServerParams& params) :
+    m_Params(params),
+    m_Replies(params),
+    m_Random(random_device()())
+{
+    m_Listener.data = this;
+    m_Timer.data = this;
+}
+
+int CPsgTestServer::Run()
+{
+    struct sockaddr_in addr;
+
+    if (auto rv = uv_ip4_addr("0.0.0.0", m_Params.port, &addr)) {
+        ERR_POST("uv_ip4_addr failed " << SUvNgHttp2_Error::LibuvStr(rv));
+        return 1;
+    }
+
+    if (auto rv = uv_tcp_init(&m_Loop, &m_Listener)) {
+        ERR_POST("uv_tcp_init failed " << SUvNgHttp2_Error::LibuvStr(rv));
+        return 1;
+    }
+
+    if (auto rv = uv_tcp_bind(&m_Listener, reinterpret_cast<const sockaddr*>(&addr), 0)) {
+        ERR_POST("uv_tcp_bind failed " << SUvNgHttp2_Error::LibuvStr(rv));
+        return 1;
+    }
+
+    if (auto rv = uv_listen(reinterpret_cast<uv_stream_t*>(&m_Listener), SOMAXCONN, s_OnConnection)) {
+        ERR_POST("uv_listen failed " << SUvNgHttp2_Error::LibuvStr(rv));
+        return 1;
+    }
+
+    if (auto rv = uv_timer_init(&m_Loop, &m_Timer)) {
+        ERR_POST("uv_timer_init failed " << SUvNgHttp2_Error::LibuvStr(rv));
+        return 1;
+    }
+
+    ERR_POST(Note << "Listening on port " << m_Params.port);
+    m_Loop.Run();
+    return 0;
+}
+
+void CPsgTestServer::OnConnection(uv_stream_t* listener, int status)
+{
+    if (status < 0) {
+        ERR_POST("Incoming connection failed " << SUvNgHttp2_Error::LibuvStr(status));
+        return;
+    }
+
+    auto id = m_NextId++;
+    auto connection = new SConnection(*this, id);
+
+    if (auto rv = connection->Init(&m_Loop)) {
+        ERR_POST("uv_tcp_init failed " << SUvNgHttp2_Error::LibuvStr(rv));
+        delete connection;
+        return;
+    }
+
+    m_Connections.emplace(id, connection);
+
+    if (auto rv = connection->Accept(listener)) {
+        ERR_POST("Accepting connection failed " << SUvNgHttp2_Error::LibuvStr(rv));
+        connection->Close();
+    }
+}
+
+void CPsgTestServer::OnRequest(SConnection& connection, int32_t stream_id)
+{
+    auto delay = m_Params.delay;
+
+    if (m_Params.delay_jitter) {
+        delay += uniform_int_distribution<uint64_t>(0, m_Params.delay_jitter)(m_Random);
+    }
+
+    // Replies are submitted right away (and sent by the caller) if there is no delay
+    if (!delay) {
+        connection.Respond(stream_id);
+        return;
+    }
+
+    auto due = uv_now(&m_Loop) + delay;
+    m_Delayed.emplace(due, make_pair(connection.GetId(), stream_id));
+
+    if (m_Delayed.begin()->first == due) {
+        uv_timer_start(&m_Timer, s_OnTimer, delay, 0);
+    }
+}
+
+void CPsgTestServer::OnTimer()
+{
+    const auto now = uv_now(&m_Loop);
+    unordered_set<SConnection*> to_send;
+
+    while (!m_Delayed.empty() && (m_Delayed.begin()->first <= now)) {
+        auto [id, stream_id] = m_Delayed.begin()->second;
+        m_Delayed.erase(m_Delayed.begin());
+
+        // The connection might have been closed meanwhile
+        if (auto it = m_Connections.find(id); it != m_Connections.end()) {
+            it->second->Respond(stream_id);
+            to_send.insert(it->second);
+        }
+    }
+
+    for (auto connection : to_send) {
+        connection->Send();
+    }
+
+    if (!m_Delayed.empty()) {
+        uv_timer_start(&m_Timer, s_OnTimer, m_Delayed.begin()->first - now, 0);
+    }
+}
+
+SServerParams::EError CPsgTestServer::GetError()
+{
+    if ((m_Params.error_rate <= 0.0) || (uniform_real_distribution<>()(m_Random) >= m_Params.error_rate)) {
+        return SServerParams::eNoError;
+    }
+
+    if (m_Params.error != SServerParams::eAnyError) {
+        return m_Params.error;
+    }
+
+    const SServerParams::EError kErrors[] = {
+        SServerParams::eStatus500,
+        SServerParams::eStatus503,
+        SServerParams::eMessage,
+        SServerParams::eReset
+    };
+
+    return kErrors[uniform_int_distribution<size_t>(0, size(kErrors) - 1)(m_Random)];
+}
+
+
+class CPsgTestServerApp : public CNcbiApplication
+{
+public:
+    virtual void Init();
+    virtual int Run();
+};
+
+void CPsgTestServerApp::Init()
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions());
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(), "Local stand-in PSG server for load testing");
+
+    arg_desc->AddDefaultKey("port", "PORT", "Port to listen on", CArgDescriptions::eInteger, "2180");
+    arg_desc->SetConstraint("port", new CArgAllow_Integers(1, 65535));
+    arg_desc->AddDefaultKey("max-streams", "STREAMS_NUM", "Maximum number of concurrent streams per connection", CArgDescriptions::eInteger, "200");
+    arg_desc->AddDefaultKey("delay", "MS", "Delay before replying (in milliseconds)", CArgDescriptions::eInteger, "0");
+    arg_desc->AddDefaultKey("delay-jitter", "MS", "Maximum random delay added to each reply (in milliseconds)", CArgDescriptions::eInteger, "0");
+    arg_desc->AddDefaultKey("error-rate", "RATE", "Fraction of requests to fail (0.0 - 1.0)", CArgDescriptions::eDouble, "0.0");
+    arg_desc->SetConstraint("error-rate", new CArgAllow_Doubles(0.0, 1.0));
+    arg_desc->AddDefaultKey("error", "ERROR", "How requests fail", CArgDescriptions::eString, "any");
+    arg_desc->SetConstraint("error", new CArgAllow_Strings{"any", "500", "503", "message", "reset"});
+    arg_desc->AddDefaultKey("blob-size", "BYTES", "Size of blobs to serve", CArgDescriptions::eInteger, "16384");
+    arg_desc->AddDefaultKey("chunk-size", "BYTES", "Size of blob chunks", CArgDescriptions::eInteger, "4096");
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+int CPsgTestServerApp::Run()
+{
+    const auto& args = GetArgs();
+
+    const SServerParams params{
+        static_cast<SUv_Tcp::TPort>(args["port"].AsInteger()),
+        static_cast<uint32_t>(max(1, args["max-streams"].AsInteger())),
+        static_cast<uint64_t>(max(0, args["delay"].AsInteger())),
+        static_cast<uint64_t>(max(0, args["delay-jitter"].AsInteger())),
+        args["error-rate"].AsDouble(),
+        SServerParams::GetError(args["error"].AsString()),
+        static_cast<size_t>(max(0, args["blob-size"].AsInteger())),
+        static_cast<size_t>(max(1, args["chunk-size"].AsInteger())),
+    };
+
+    return CPsgTestServer(params).Run();
+}
+
+int main(int argc, const char* argv[])
+{
+    return CPsgTestServerApp().AppMain(argc, argv);
+}
@@ -176,6 +176,7 @@ void CPubseqGatewayApp::OpenCache(void)
                 new CPubseqGatewayCache(m_Settings.m_BioseqInfoDbFile,
                                         m_Settings.m_Si2csiDbFile,
                                         m_Settings.m_BlobPropDbFile));
+        m_LookupCache->SetBioseqInfoLruSize(m_Settings.m_BioseqInfoLruSize);
 
         // The format of the sat ids is different
         set<int>        sat_ids;
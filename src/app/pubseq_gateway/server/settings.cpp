@@ -81,6 +81,7 @@ const double            kDefaultResendTimeoutSec = 0.2;
 const double            kDefaultRequestTimeoutSec = 30.0;
 const size_t            kDefaultProcessorMaxConcurrency = 1200;
 const size_t            kDefaultSplitInfoBlobCacheSize = 1000;
+const size_t            kDefaultBioseqInfoLruSize = 0;
 const string            kDefaultIPGKeyspace = "ipg_storage";
 const size_t            kDefaultIPGPageSize = 1024;
 const bool              kDefaultEnableHugeIPG = true;
@@ -128,6 +129,7 @@ SPubseqGatewaySettings::SPubseqGatewaySettings() :
     m_StatScaleType(kStatScaleType),
     m_TickSpan(kTickSpan),
     m_OnlyForProcessor(kDefaultOnlyForProcessor),
+    m_BioseqInfoLruSize(kDefaultBioseqInfoLruSize),
     m_ExcludeCacheMaxSize(kDefaultExcludeCacheMaxSize),
     m_ExcludeCachePurgePercentage(kDefaultExcludeCachePurgePercentage),
     m_ExcludeCacheInactivityPurge(kDefaultExcludeCacheInactivityPurge),
@@ -260,6 +262,9 @@ void SPubseqGatewaySettings::x_ReadLmdbCacheSection(const CNcbiRegistry &   regi
                                             "dbfile_bioseq_info", "");
     m_BlobPropDbFile = registry.GetString(kLmdbCacheSection,
                                           "dbfile_blob_prop", "");
+    m_BioseqInfoLruSize = registry.GetInt(kLmdbCacheSection,
+                                          "bioseq_info_lru_size",
+                                          kDefaultBioseqInfoLruSize);
 }
 
 
@@ -85,6 +85,7 @@ struct SPubseqGatewaySettings
     string                              m_Si2csiDbFile;
     string                              m_BioseqInfoDbFile;
     string                              m_BlobPropDbFile;
+    size_t                              m_BioseqInfoLruSize;
 
     // [AUTO_EXCLUDE]
     unsigned int                        m_ExcludeCacheMaxSize;
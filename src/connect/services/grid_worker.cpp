@@ -372,6 +372,7 @@ SGridWorkerNodeImpl::SGridWorkerNodeImpl(CNcbiApplicationAPI& app,
     m_ThreadPool(NULL),
     m_MaxThreads(1),
     m_NSTimeout(DEFAULT_NS_TIMEOUT),
+    m_MaxJobsPerGet(1),
     m_CommitJobInterval(2),
     m_CheckStatusPeriod(2),
     m_ExclusiveJobSemaphore(1, 1),
@@ -470,6 +471,12 @@ void SGridWorkerNodeImpl::x_WNCoreInit()
     }
     m_NSTimeout = m_SynRegistry->Get("server", "job_wait_timeout", DEFAULT_NS_TIMEOUT);
 
+    // Jobs are asked for only as many threads as are idle at the moment
+    // (see CMainLoopThread::CImpl::CheckEntry), so it makes no sense to ask
+    // for more of them than there are threads
+    m_MaxJobsPerGet = m_SynRegistry->Get("server", "max_jobs_per_get", 1);
+    m_MaxJobsPerGet = max(1u, min(m_MaxJobsPerGet, m_MaxThreads));
+
     {{
         string memlimitstr = m_SynRegistry->Get("server", "total_memory_limit", kEmptyStr);
 
@@ -241,6 +241,7 @@ struct SGridWorkerNodeImpl : public CObject, IWorkerNodeInitContext
 
     unsigned int                 m_MaxThreads;
     unsigned int                 m_NSTimeout;
+    unsigned int                 m_MaxJobsPerGet;
     mutable CFastMutex           m_JobProcessorMutex;
     unsigned                     m_CommitJobInterval;
     unsigned                     m_CheckStatusPeriod;
@@ -390,7 +391,8 @@ private:
                 const string& prio_aff_list,
                 bool any_affinity,
                 CNetScheduleJob& job,
-                CNetScheduleAPI::EJobStatus* job_status);
+                CNetScheduleAPI::EJobStatus* job_status,
+                TPrefetchedJobs* extra_jobs);
         void ReturnJob(CNetScheduleJob& job);
 
         CNetScheduleAPI m_API;
@@ -42,7 +42,9 @@ BEGIN_NCBI_SCOPE
 
 using namespace grid::netschedule;
 
-bool s_DoParseGet2JobResponse(CNetScheduleJob& job, const string& response)
+bool s_DoParseGet2JobResponse(CNetScheduleJob& job,
+        CUrlArgs::TArgs::const_iterator& field,
+        CUrlArgs::TArgs::const_iterator end)
 {
     enum {
         eJobKey,
@@ -56,10 +58,13 @@ bool s_DoParseGet2JobResponse(CNetScheduleJob& job, const string& response)
         eNumberOfJobBits
     };
     int job_bits = 0;
-    CUrlArgs url_parser(response);
-    ITERATE(CUrlArgs::TArgs, field, url_parser.GetArgs()) {
+    for (; field != end; ++field) {
 
         if (field->name == "job_key") {
+            // The next job of a multi-job response starts here
+            if (job_bits & (1 << eJobKey))
+                break;
+
             job_bits |= (1 << eJobKey);
             job.job_id = field->value;
 
@@ -91,22 +96,37 @@ bool s_DoParseGet2JobResponse(CNetScheduleJob& job, const string& response)
             job_bits |= (1 << ePageHitID);
             job.page_hit_id = field->value;
         }
-
-        if (job_bits == (1 << eNumberOfJobBits) - 1)
-            break;
     }
     return !job.job_id.empty();
 }
 
 string s_GET2(CNetScheduleExecutor::EJobAffinityPreference affinity_preference);
 
-bool s_ParseGetJobResponse(CNetScheduleJob& job, const string& response)
+bool s_ParseGetJobResponse(CNetScheduleJob& job, const string& response,
+        CNetScheduleGetJob::TPrefetchedJobs* extra_jobs = NULL)
 {
     if (response.empty())
         return false;
 
     try {
-        return s_DoParseGet2JobResponse(job, response);
+        CUrlArgs url_parser(response);
+        const CUrlArgs::TArgs& args(url_parser.GetArgs());
+        CUrlArgs::TArgs::const_iterator field = args.begin();
+
+        if (!s_DoParseGet2JobResponse(job, field, args.end()))
+            return false;
+
+        // GET2 with count > 1: the other jobs follow the first one
+        while (extra_jobs && field != args.end()) {
+            CNetScheduleJob extra_job;
+
+            if (!s_DoParseGet2JobResponse(extra_job, field, args.end()))
+                break;
+
+            extra_jobs->push_back(extra_job);
+        }
+
+        return true;
     }
     catch (CUrlParserException&) {
         NCBI_THROW(CNetScheduleException, eProtocolSyntaxError,
@@ -217,7 +237,8 @@ string SNetScheduleExecutorImpl::MkSETAFFCmd()
 }
 
 bool SNetScheduleExecutorImpl::ExecGET(SNetServerImpl* server,
-        const string& get_cmd, CNetScheduleJob& job)
+        const string& get_cmd, CNetScheduleJob& job,
+        CNetScheduleGetJob::TPrefetchedJobs* extra_jobs)
 {
     CNetScheduleGETCmdListener get_cmd_listener(this);
 
@@ -244,7 +265,10 @@ bool SNetScheduleExecutorImpl::ExecGET(SNetServerImpl* server,
                 exec_result, NULL, &get_cmd_listener);
     }
 
-    if (!s_ParseGetJobResponse(job, exec_result.response))
+    CNetScheduleGetJob::TPrefetchedJobs new_jobs;
+
+    if (!s_ParseGetJobResponse(job, exec_result.response,
+                extra_jobs ? &new_jobs : NULL))
         return false;
 
     // Remember the server that issued this job.
@@ -254,12 +278,21 @@ bool SNetScheduleExecutorImpl::ExecGET(SNetServerImpl* server,
     // register it with the rest of servers.
     ClaimNewPreferredAffinity(server, job.affinity);
 
+    for (auto& extra_job : new_jobs) {
+        extra_job.server = server;
+        ClaimNewPreferredAffinity(server, extra_job.affinity);
+    }
+
+    if (extra_jobs)
+        extra_jobs->splice(extra_jobs->end(), new_jobs);
+
     return true;
 }
 
 bool SNetScheduleExecutorImpl::x_GetJobWithAffinityLadder(
         SNetServerImpl* server, const CDeadline& timeout, 
-        const string& prio_aff_list, bool any_affinity, CNetScheduleJob& job)
+        const string& prio_aff_list, bool any_affinity, CNetScheduleJob& job,
+        unsigned max_jobs, CNetScheduleGetJob::TPrefetchedJobs* extra_jobs)
 {
     // Ask for any affinity only when requested and configured
     // (it's not requested when we have a job already).
@@ -276,7 +309,13 @@ bool SNetScheduleExecutorImpl::x_GetJobWithAffinityLadder(
 
     if (have_affinities) cmd += " prioritized_aff=1";
 
-    return ExecGET(server, cmd, job);
+    // Prioritized affinities need one job at a time
+    if (!have_affinities && extra_jobs && max_jobs > 1) {
+        cmd += " count=";
+        cmd += NStr::UIntToString(max_jobs);
+    }
+
+    return ExecGET(server, cmd, job, have_affinities ? NULL : extra_jobs);
 }
 
 bool CNetScheduleExecutor::GetJob(CNetScheduleJob& job,
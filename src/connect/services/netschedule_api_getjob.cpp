@@ -52,7 +52,29 @@ CNetScheduleGetJob::EResult CNetScheduleGetJobImpl<TImpl>::GetJob(
         bool any_affinity)
 {
     if (any_affinity) {
-        CAnyAffinityJob<TImpl> holder(job, job_status, m_ImmediateActions);
+        // Jobs given by an earlier request go first; the state is checked
+        // as if the job was requested from a server right now
+        while (!m_PrefetchedJobs.empty()) {
+            EState state = m_Impl.CheckState();
+
+            if (state == eStopped) {
+                ReturnPrefetchedJobs();
+                return eInterrupt;
+            }
+
+            if (state == eRestarted) {
+                ReturnPrefetchedJobs();
+                Restart();
+                break;
+            }
+
+            job = m_PrefetchedJobs.front();
+            m_PrefetchedJobs.pop_front();
+            return eJob;
+        }
+
+        CAnyAffinityJob<TImpl> holder(job, job_status, m_ImmediateActions,
+                m_PrefetchedJobs);
         return GetJobImpl(deadline, holder);
     } else {
         ReturnNotFullyCheckedServers();
@@ -64,6 +86,7 @@ CNetScheduleGetJob::EResult CNetScheduleGetJobImpl<TImpl>::GetJob(
 typedef list<SSocketAddress> TServers;
 typedef list<CNetScheduleGetJob::SEntry> TTimeline;
 typedef TTimeline::iterator TIterator;
+typedef CNetScheduleGetJob::TPrefetchedJobs TPrefetchedJobs;
 
 template <class TImpl>
 class CAnyAffinityJob
@@ -73,8 +96,9 @@ public:
     CNetScheduleAPI::EJobStatus* job_status;
 
     CAnyAffinityJob(CNetScheduleJob& j, CNetScheduleAPI::EJobStatus* js,
-            TTimeline& timeline) :
-        job(j), job_status(js), m_Timeline(timeline)
+            TTimeline& timeline, TPrefetchedJobs& prefetched_jobs) :
+        job(j), job_status(js), m_Timeline(timeline),
+        m_PrefetchedJobs(prefetched_jobs)
     {}
 
     void Interrupt()                {}
@@ -83,9 +107,11 @@ public:
     const string& Affinity() const  { return kEmptyStr; }
     bool Done()                     { return true; }
     bool HasJob() const             { return false; }
+    TPrefetchedJobs* ExtraJobs()    { return &m_PrefetchedJobs; }
 
 private:
     TTimeline& m_Timeline;
+    TPrefetchedJobs& m_PrefetchedJobs;
 };
 
 template <class TImpl>
@@ -202,6 +228,9 @@ public:
         return m_JobPriority < numeric_limits<size_t>::max();
     }
 
+    // Jobs of lower priorities may be returned later, so only one at a time
+    TPrefetchedJobs* ExtraJobs()    { return NULL; }
+
 private:
     size_t m_JobPriority;
     TTimeline& m_Timeline;
@@ -252,7 +281,7 @@ CNetScheduleGetJob::EResult CNetScheduleGetJobImpl<TImpl>::GetJobImmediately(TJo
             const bool any_affinity = !holder.HasJob();
 
             if (m_Impl.CheckEntry(*i, prio_aff_list, any_affinity,
-                        holder.job, holder.job_status)) {
+                        holder.job, holder.job_status, holder.ExtraJobs())) {
                 if (i == m_ImmediateActions.begin()) {
                     increment = true;
                 } else {
@@ -375,6 +404,22 @@ inline void Filter(TTimeline& timeline, TServers& servers)
     }
 }
 
+template <class TImpl>
+void CNetScheduleGetJobImpl<TImpl>::ReturnPrefetchedJobs()
+{
+    for (auto& job : m_PrefetchedJobs) {
+        try {
+            m_Impl.ReturnJob(job);
+        }
+        catch (exception& ex) {
+            ERR_POST(Warning << "Could not return job " << job.job_id <<
+                    ": " << ex.what());
+        }
+    }
+
+    m_PrefetchedJobs.clear();
+}
+
 template <class TImpl>
 void CNetScheduleGetJobImpl<TImpl>::Restart()
 {
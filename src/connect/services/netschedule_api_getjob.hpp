@@ -53,6 +53,9 @@ struct CNetScheduleGetJob
     // { "c", "a, b, c" }
     typedef vector<pair<string, string> > TAffinityLadder;
 
+    // Jobs received in addition to the requested one (GET2 with count > 1)
+    typedef list<CNetScheduleJob> TPrefetchedJobs;
+
     enum EState {
         eWorking,
         eRestarted,
@@ -105,6 +108,9 @@ public:
             CNetScheduleAPI::EJobStatus* job_status,
             bool any_affinity);
 
+    // Give back the jobs received in advance but not taken by GetJob() yet
+    void ReturnPrefetchedJobs();
+
 private:
     template <class TJobHolder>
     EResult GetJobImmediately(TJobHolder& holder);
@@ -120,6 +126,7 @@ private:
     TImpl& m_Impl;
     list<SEntry> m_ImmediateActions, m_ScheduledActions;
     SEntry m_DiscoveryAction;
+    TPrefetchedJobs m_PrefetchedJobs;
 };
 
 
@@ -452,12 +452,15 @@ struct SNetScheduleExecutorImpl : public CObject
         const string& affinity);
     string MkSETAFFCmd();
     bool ExecGET(SNetServerImpl* server,
-            const string& get_cmd, CNetScheduleJob& job);
+            const string& get_cmd, CNetScheduleJob& job,
+            CNetScheduleGetJob::TPrefetchedJobs* extra_jobs = NULL);
     bool x_GetJobWithAffinityLadder(SNetServerImpl* server,
             const CDeadline& timeout,
             const string& prio_aff_list,
             bool any_affinity,
-            CNetScheduleJob& job);
+            CNetScheduleJob& job,
+            unsigned max_jobs = 1,
+            CNetScheduleGetJob::TPrefetchedJobs* extra_jobs = NULL);
 
     void ReturnJob(const CNetScheduleJob& job, bool blacklist = true);
 
@@ -542,7 +545,8 @@ private:
                 const string& prio_aff_list,
                 bool any_affinity,
                 CNetScheduleJob& job,
-                CNetScheduleAPI::EJobStatus* job_status);
+                CNetScheduleAPI::EJobStatus* job_status,
+                TPrefetchedJobs* extra_jobs);
         void ReturnJob(CNetScheduleJob& job);
 
         CNetScheduleAPI m_API;
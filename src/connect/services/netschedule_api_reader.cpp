@@ -104,7 +104,8 @@ bool SNetScheduleJobReaderImpl::CImpl::CheckEntry(
         const string& prio_aff_list,
         bool any_affinity,
         CNetScheduleJob& job,
-        CNetScheduleAPI::EJobStatus* job_status)
+        CNetScheduleAPI::EJobStatus* job_status,
+        TPrefetchedJobs* /*extra_jobs*/)
 {
     CNetServer server(m_API.GetService()->GetServer(entry.server_address));
     bool no_more_jobs = true;
@@ -639,6 +639,7 @@ void* CMainLoopThread::Main()
         try_count = 0;
     }
 
+    m_Timeline.ReturnPrefetchedJobs();
     return NULL;
 }
 
@@ -706,11 +707,28 @@ bool CMainLoopThread::CImpl::CheckEntry(
         const string& prio_aff_list,
         bool any_affinity,
         CNetScheduleJob& job,
-        CNetScheduleAPI::EJobStatus* /*job_status*/)
-{
+        CNetScheduleAPI::EJobStatus* /*job_status*/,
+        TPrefetchedJobs* extra_jobs)
+{
+    // The run timeout of every job given by the server starts right away,
+    // so extra jobs are asked for only as many threads as are idle now.
+    // The main loop then passes them to those threads without waiting.
+    unsigned max_jobs = 1;
+
+    if (extra_jobs) {
+        unsigned busy = CGridGlobals::GetInstance().GetJobWatcher().
+                GetJobsRunningNumber() +
+                unsigned(m_WorkerNode->m_ThreadPool->GetQueueSize());
+        unsigned max_threads = m_WorkerNode->m_MaxThreads;
+
+        if (busy < max_threads)
+            max_jobs = min(m_WorkerNode->m_MaxJobsPerGet, max_threads - busy);
+    }
+
     CNetServer server(m_API.GetService()->GetServer(entry.server_address));
     return m_WorkerNode->m_NSExecutor->x_GetJobWithAffinityLadder(server,
-            m_Timeout, prio_aff_list, any_affinity, job);
+            m_Timeout, prio_aff_list, any_affinity, job,
+            max_jobs, extra_jobs);
 }
 
 void CMainLoopThread::CImpl::ReturnJob(CNetScheduleJob& job)
@@ -118,8 +118,7 @@ CSeq_id_Handle CSeq_id_Handle::GetHandle(const CSeq_id& id)
 
 CSeq_id_Handle CSeq_id_Handle::GetHandle(const string& str_id)
 {
-    CSeq_id id(str_id);
-    return CSeq_id_Mapper::GetInstance()->GetHandle(id);
+    return CSeq_id_Mapper::GetInstance()->GetHandle(CTempString(str_id));
 }
 
 
@@ -125,6 +125,100 @@ CSeq_id_Handle CSeq_id_Mapper::GetHandle(const CSeq_id& id, bool do_not_create)
 }
 
 
+// Check if the string is a bare accession with optional version,
+// which CSeq_id would store as accession and version of a Textseq-id.
+static bool s_ParsePlainAccession(const CTempString& str_id,
+                                  CTempString& acc,
+                                  int& version)
+{
+    if ( str_id.empty() ) {
+        return false;
+    }
+    SIZE_TYPE dot = NPOS;
+    for ( SIZE_TYPE i = 0; i < str_id.size(); ++i ) {
+        char c = str_id[i];
+        if ( c == '.' ) {
+            if ( dot != NPOS ) {
+                return false;
+            }
+            dot = i;
+        }
+        else if ( !isalnum((unsigned char)c) && c != '_' ) {
+            return false;
+        }
+    }
+    if ( dot == NPOS ) {
+        acc = str_id;
+        version = 0;
+        return true;
+    }
+    acc = str_id.substr(0, dot);
+    version = NStr::StringToNonNegativeInt(str_id.substr(dot+1));
+    return !acc.empty() && version > 0;
+}
+
+
+CSeq_id_Handle CSeq_id_Mapper::GetHandle(const CTempString& str_id)
+{
+    CTempString acc;
+    int version;
+    if ( s_ParsePlainAccession(str_id, acc, version) ) {
+        // the same type CSeq_id(str_id) would get
+        CSeq_id::E_Choice type =
+            CSeq_id::GetAccType(CSeq_id::IdentifyAccession
+                                (str_id,
+                                 CSeq_id::fParse_AnyRaw |
+                                 CSeq_id::fParse_FallbackOK));
+        switch ( type ) {
+        case CSeq_id::e_not_set:
+        case CSeq_id::e_Gi:
+        case CSeq_id::e_Prf:
+        case CSeq_id::e_Pdb:
+            break;
+        default:
+            {
+                CSeq_id_Handle idh =
+                    x_GetTree(type).FindOrCreateAcc(type, acc, version);
+                if ( idh ) {
+                    return idh;
+                }
+            }
+            break;
+        }
+    }
+    CSeq_id id(str_id);
+    return GetHandle(id);
+}
+
+
+void CSeq_id_Mapper::GetHandles(const TSeq_ids& ids, TSeq_id_Handles& handles)
+{
+    handles.clear();
+    handles.resize(ids.size());
+    // indexes of the ids in each tree
+    typedef map<CSeq_id_Which_Tree*, vector<size_t> > TTreeIds;
+    TTreeIds tree_ids;
+    for ( size_t i = 0; i < ids.size(); ++i ) {
+        tree_ids[&x_GetTree(*ids[i])].push_back(i);
+    }
+    CSeq_id_Which_Tree::TSeq_id_Ptrs tree_id_ptrs;
+    CSeq_id_Which_Tree::TSeq_id_Handles tree_handles;
+    ITERATE ( TTreeIds, it, tree_ids ) {
+        const vector<size_t>& indexes = it->second;
+        tree_id_ptrs.resize(indexes.size());
+        for ( size_t i = 0; i < indexes.size(); ++i ) {
+            tree_id_ptrs[i] = ids[indexes[i]].GetPointer();
+        }
+        tree_handles.clear();
+        tree_handles.resize(indexes.size());
+        it->first->FindOrCreateHandles(tree_id_ptrs, tree_handles);
+        for ( size_t i = 0; i < indexes.size(); ++i ) {
+            handles[indexes[i]].Swap(tree_handles[i]);
+        }
+    }
+}
+
+
 bool CSeq_id_Mapper::HaveMatchingHandles(const CSeq_id_Handle& idh)
 {
     return x_GetTree(idh).HaveMatch(idh);
@@ -217,9 +217,33 @@ CSeq_id_Info* CSeq_id_Which_Tree::CreateInfo(const CSeq_id& id)
 }
 
 
+void CSeq_id_Which_Tree::FindOrCreateHandles(const TSeq_id_Ptrs& ids,
+                                             TSeq_id_Handles& handles)
+{
+    _ASSERT(ids.size() == handles.size());
+    for ( size_t i = 0; i < ids.size(); ++i ) {
+        handles[i] = FindOrCreate(*ids[i]);
+    }
+}
+
+
+CSeq_id_Handle CSeq_id_Which_Tree::FindOrCreateAcc(CSeq_id::E_Choice /*type*/,
+                                                   const CTempString& /*acc*/,
+                                                   int /*version*/)
+{
+    return null;
+}
+
+
 void CSeq_id_Which_Tree::DropInfo(const CSeq_id_Info* info)
 {
     TWriteLockGuard guard(m_TreeLock);
+    x_DropInfo(info);
+}
+
+
+void CSeq_id_Which_Tree::x_DropInfo(const CSeq_id_Info* info)
+{
     if ( info->IsLocked() ) {
         _ASSERT(info->m_Seq_id_Type != CSeq_id::e_not_set);
         return;
@@ -1147,13 +1171,7 @@ CSeq_id_Handle CSeq_id_Textseq_Tree::FindInfo(const CSeq_id& id) const
         const string& acc = tid.GetAccession();
         TPackedKey key = CSeq_id_Textseq_Info::ParseAcc(acc, tid);
         if ( key ) {
-            TPacked packed = CSeq_id_Textseq_Info::Pack(key, tid);
-            TReadLockGuard guard(m_TreeLock);
-            TPackedMap_CI it = m_PackedMap.find(key);
-            if ( it == m_PackedMap.end() ) {
-                return null;
-            }
-            return CSeq_id_Handle(it->second, packed, it->first.ParseCaseVariant(acc));
+            return x_FindPacked(key, CSeq_id_Textseq_Info::Pack(key, tid), acc);
         }
     }
     TReadLockGuard guard(m_TreeLock);
@@ -1171,20 +1189,9 @@ CSeq_id_Handle CSeq_id_Textseq_Tree::FindOrCreate(const CSeq_id& id)
         const string& acc = tid.GetAccession();
         TPackedKey key = CSeq_id_Textseq_Info::ParseAcc(acc, tid);
         if ( key ) {
-            TPacked packed = CSeq_id_Textseq_Info::Pack(key, tid);
-            CSeq_id_Handle::TVariant variant = 0;
-            TWriteLockGuard guard(m_TreeLock);
-            TPackedMap_I it = m_PackedMap.lower_bound(key);
-            if ( it == m_PackedMap.end() ||
-                 m_PackedMap.key_comp()(key, it->first) ) {
-                CConstRef<CSeq_id_Textseq_Info> info
-                    (new CSeq_id_Textseq_Info(id.Which(), m_Mapper, key));
-                it = m_PackedMap.insert(it, TPackedMapValue(key, info));
-            }
-            else {
-                variant = it->first.ParseCaseVariant(acc);
-            }
-            return CSeq_id_Handle(it->second, packed, variant);
+            return x_FindOrCreatePacked(id.Which(), key,
+                                        CSeq_id_Textseq_Info::Pack(key, tid),
+                                        acc);
         }
     }
     TWriteLockGuard guard(m_TreeLock);
@@ -1208,6 +1215,109 @@ CSeq_id_Handle CSeq_id_Textseq_Tree::FindOrCreate(const CSeq_id& id)
 }
 
 
+CSeq_id_Handle CSeq_id_Textseq_Tree::x_FindPacked(const TPackedKey& key,
+                                                  TPacked packed,
+                                                  const string& acc) const
+{
+    CFastReadGuard guard(m_PackedMapLock);
+    TPackedMap_CI it = m_PackedMap.find(key);
+    if ( it == m_PackedMap.end() ) {
+        return null;
+    }
+    return CSeq_id_Handle(it->second, packed, it->first.ParseCaseVariant(acc));
+}
+
+
+CSeq_id_Handle
+CSeq_id_Textseq_Tree::x_FindOrCreatePacked(CSeq_id::E_Choice type,
+                                           const TPackedKey& key,
+                                           TPacked packed,
+                                           const string& acc)
+{
+    // most accessions share an already existing info
+    CSeq_id_Handle ret = x_FindPacked(key, packed, acc);
+    if ( ret ) {
+        return ret;
+    }
+    CSeq_id_Handle::TVariant variant = 0;
+    TWriteLockGuard guard(m_TreeLock);
+    CFastWriteGuard packed_guard(m_PackedMapLock);
+    TPackedMap_I it = m_PackedMap.lower_bound(key);
+    if ( it == m_PackedMap.end() ||
+         m_PackedMap.key_comp()(key, it->first) ) {
+        CConstRef<CSeq_id_Textseq_Info> info
+            (new CSeq_id_Textseq_Info(type, m_Mapper, key));
+        it = m_PackedMap.insert(it, TPackedMapValue(key, info));
+    }
+    else {
+        variant = it->first.ParseCaseVariant(acc);
+    }
+    return CSeq_id_Handle(it->second, packed, variant);
+}
+
+
+void CSeq_id_Textseq_Tree::FindOrCreateHandles(const TSeq_id_Ptrs& ids,
+                                               TSeq_id_Handles& handles)
+{
+    _ASSERT(ids.size() == handles.size());
+    if ( s_PackTextidEnabled() ) {
+        // resolve all accessions with already existing infos in one pass
+        CFastReadGuard guard(m_PackedMapLock);
+        for ( size_t i = 0; i < ids.size(); ++i ) {
+            _ASSERT(x_Check(*ids[i]));
+            const CTextseq_id& tid = x_Get(*ids[i]);
+            if ( !tid.IsSetAccession() || tid.IsSetName() || tid.IsSetRelease() ) {
+                continue;
+            }
+            const string& acc = tid.GetAccession();
+            TPackedKey key = CSeq_id_Textseq_Info::ParseAcc(acc, tid);
+            if ( !key ) {
+                continue;
+            }
+            TPackedMap_CI it = m_PackedMap.find(key);
+            if ( it != m_PackedMap.end() ) {
+                handles[i] = CSeq_id_Handle(it->second,
+                                            CSeq_id_Textseq_Info::Pack(key, tid),
+                                            it->first.ParseCaseVariant(acc));
+            }
+        }
+    }
+    for ( size_t i = 0; i < ids.size(); ++i ) {
+        if ( !handles[i] ) {
+            handles[i] = FindOrCreate(*ids[i]);
+        }
+    }
+}
+
+
+CSeq_id_Handle CSeq_id_Textseq_Tree::FindOrCreateAcc(CSeq_id::E_Choice type,
+                                                     const CTempString& acc_in,
+                                                     int version)
+{
+    _ASSERT(x_Check(type));
+    if ( !s_PackTextidEnabled() ) {
+        return null;
+    }
+    string acc = acc_in;
+    TVersion ver = version;
+    TPackedKey key = CSeq_id_Textseq_Info::ParseAcc(acc, version > 0? &ver: 0);
+    if ( !key ) {
+        return null;
+    }
+    return x_FindOrCreatePacked(type, key,
+                                CSeq_id_Textseq_Info::Pack(key, acc), acc);
+}
+
+
+void CSeq_id_Textseq_Tree::DropInfo(const CSeq_id_Info* info)
+{
+    TWriteLockGuard guard(m_TreeLock);
+    // packed infos can be locked again by lookups holding m_PackedMapLock only
+    CFastWriteGuard packed_guard(m_PackedMapLock);
+    x_DropInfo(info);
+}
+
+
 void CSeq_id_Textseq_Tree::x_Erase(TStringMap& str_map,
                                    const string& key,
                                    const CSeq_id_Info* info)
@@ -140,6 +140,19 @@ public:
     virtual CSeq_id_Handle FindOrCreate(const CSeq_id& id) = 0;
     virtual CSeq_id_Handle GetGiHandle(TGi gi);
 
+    // Batch version, handles[i] is set to the handle of *ids[i]
+    typedef vector<const CSeq_id*> TSeq_id_Ptrs;
+    typedef vector<CSeq_id_Handle> TSeq_id_Handles;
+    virtual void FindOrCreateHandles(const TSeq_id_Ptrs& ids,
+                                     TSeq_id_Handles& handles);
+
+    // Find or create handle of a plain accession with optional version
+    // (0 - not set) without constructing CSeq_id object.
+    // Returns null handle if the accession cannot be stored this way.
+    virtual CSeq_id_Handle FindOrCreateAcc(CSeq_id::E_Choice type,
+                                           const CTempString& acc,
+                                           int version);
+
     virtual void DropInfo(const CSeq_id_Info* info);
 
     typedef set<CSeq_id_Handle> TSeq_id_MatchList;
@@ -184,6 +197,8 @@ protected:
             return info->m_Seq_id.GetPointerOrNull();
         }
     virtual void x_Unindex(const CSeq_id_Info* info) = 0;
+    // unindex the info unless it got locked again, the tree must be locked
+    void x_DropInfo(const CSeq_id_Info* info);
 
     typedef CFastMutex TTreeLock;
     typedef TTreeLock::TReadLockGuard TReadLockGuard;
@@ -487,6 +502,13 @@ public:
 
     virtual CSeq_id_Handle FindInfo(const CSeq_id& id) const;
     virtual CSeq_id_Handle FindOrCreate(const CSeq_id& id);
+    virtual void FindOrCreateHandles(const TSeq_id_Ptrs& ids,
+                                     TSeq_id_Handles& handles);
+    virtual CSeq_id_Handle FindOrCreateAcc(CSeq_id::E_Choice type,
+                                           const CTempString& acc,
+                                           int version);
+
+    virtual void DropInfo(const CSeq_id_Info* info);
 
     virtual bool HaveMatch(const CSeq_id_Handle& id) const;
     virtual void FindMatch(const CSeq_id_Handle& id,
@@ -541,6 +563,14 @@ private:
                                              CSeq_id::E_Choice type,
                                              const CTextseq_id& tid) const;
 
+    CSeq_id_Handle x_FindPacked(const TPackedKey& key,
+                                TPacked packed,
+                                const string& acc) const;
+    CSeq_id_Handle x_FindOrCreatePacked(CSeq_id::E_Choice type,
+                                        const TPackedKey& key,
+                                        TPacked packed,
+                                        const string& acc);
+
     void x_FindMatchByAcc(TSeq_id_MatchList& id_list,
                           const string& acc,
                           const TVersion* ver = 0) const;
@@ -585,6 +615,10 @@ private:
     TStringMap m_ByAcc;
     TStringMap m_ByName; // Used for searching by string
     TPackedMap m_PackedMap;
+    // Existing packed infos are looked up under this lock only, so that
+    // threads interning accessions of the same kind do not serialize on
+    // m_TreeLock. Any change of m_PackedMap holds both locks.
+    mutable CFastRWLock m_PackedMapLock;
 };
 
 
@@ -40,6 +40,7 @@
 #include <objects/general/Dbtag.hpp>
 #include <objects/general/Object_id.hpp>
 #include <objects/seq/Seq_inst.hpp>
+#include <objects/seq/seq_id_mapper.hpp>
 #include <objects/seqloc/seqloc__.hpp>
 #include <objects/seqfeat/Seq_feat.hpp>
 #include <objects/seqfeat/SeqFeatData.hpp>
@@ -167,6 +168,35 @@ BOOST_AUTO_TEST_CASE(s_MTGiTest)
         tt[i].join();
     }
 }
+
+
+BOOST_AUTO_TEST_CASE(s_MTAccTest)
+{
+    const size_t NQ = 20;
+    const int kCount = 10000;
+    vector<thread> tt(NQ);
+    vector< vector<CSeq_id_Handle> > handles(NQ);
+    for ( size_t i = 0; i < NQ; ++i ) {
+        tt[i] =
+            thread([&]
+                   (size_t t)
+                   {
+                       for ( int j = 0; j < kCount; ++j ) {
+                           string num = NStr::IntToString(j+1);
+                           string acc = "NC_"+string(6-num.size(), '0')+num+".1";
+                           handles[t].push_back(CSeq_id_Handle::GetHandle(acc));
+                       }
+                   }, i);
+    }
+    for ( size_t i = 0; i < NQ; ++i ) {
+        tt[i].join();
+    }
+    for ( size_t i = 1; i < NQ; ++i ) {
+        BOOST_CHECK(handles[i] == handles[0]);
+    }
+    BOOST_CHECK_EQUAL(handles[0][0].AsString(), "ref|NC_000001.1|");
+    BOOST_CHECK_EQUAL(handles[0][kCount-1].AsString(), "ref|NC_010000.1|");
+}
 #endif
 
 
@@ -2474,3 +2504,39 @@ BOOST_AUTO_TEST_CASE(TestPDB)
         BOOST_CHECK_EQUAL(idh_set_ne.size(), size(idh_ne));
     }}
 }
+
+
+BOOST_AUTO_TEST_CASE(TestGetHandles)
+{
+    const char* const strs[] = {
+        "NC_000001.11",
+        "nc_000001.11",
+        "NC_000001",
+        "NC_000001.10",
+        "NM_000170.2",
+        "AY123456.1",
+        "AAAA01000001.1",
+        "P12345",
+        "1234",
+        "gi|1234",
+        "lcl|contig1",
+        "gb|AY123456.1|",
+    };
+    CSeq_id_Mapper::TSeq_ids ids;
+    for ( auto str : strs ) {
+        ids.push_back(ConstRef(new CSeq_id(str)));
+    }
+    CSeq_id_Mapper::TSeq_id_Handles handles;
+    CSeq_id_Mapper::GetInstance()->GetHandles(ids, handles);
+    BOOST_REQUIRE_EQUAL(handles.size(), ids.size());
+    for ( size_t i = 0; i < ids.size(); ++i ) {
+        CSeq_id_Handle idh = CSeq_id_Handle::GetHandle(*ids[i]);
+        CSeq_id_Handle str_idh = CSeq_id_Handle::GetHandle(string(strs[i]));
+        BOOST_CHECK_EQUAL(handles[i], idh);
+        BOOST_CHECK_EQUAL(str_idh, idh);
+        BOOST_CHECK(str_idh.GetSeqId()->Equals(*ids[i]));
+        BOOST_CHECK_EQUAL(str_idh.AsString(), ids[i]->AsFastaString());
+    }
+    NCBI_CHECK_THROW_SEQID(CSeq_id_Handle::GetHandle(string("NC_000001.0")));
+    NCBI_CHECK_THROW_SEQID(CSeq_id_Handle::GetHandle(string("JUNK")));
+}
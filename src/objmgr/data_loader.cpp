@@ -38,6 +38,7 @@
 #include <objmgr/annot_name.hpp>
 #include <objmgr/annot_type_selector.hpp>
 #include <objmgr/impl/tse_info.hpp>
+#include <objmgr/impl/data_source.hpp>
 #include <objmgr/impl/bioseq_info.hpp>
 #include <objmgr/impl/tse_chunk_info.hpp>
 #include <objmgr/objmgr_exception.hpp>
@@ -973,6 +974,15 @@ bool CDataLoader::GetTrackSplitSeq() const
 }
 
 
+CDataLoader::SBlobCacheStats CDataLoader::GetBlobCacheStats(void) const
+{
+    if ( !m_DataSource ) {
+        return SBlobCacheStats();
+    }
+    return m_DataSource->GetBlobCacheStats();
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 // CBlobId
 
@@ -100,6 +100,18 @@ unsigned CDataSource::GetDefaultBlobCacheSizeLimit(void)
 }
 
 
+// estimated memory size limit of unlocked blobs cache, 0 - unlimited
+NCBI_PARAM_DECL(size_t, OBJMGR, BLOB_CACHE_BYTES);
+NCBI_PARAM_DEF_EX(size_t, OBJMGR, BLOB_CACHE_BYTES, 0,
+                  eParam_NoThread, OBJMGR_BLOB_CACHE_BYTES);
+
+size_t CDataSource::GetDefaultBlobCacheBytesLimit(void)
+{
+    static CSafeStatic<NCBI_PARAM_TYPE(OBJMGR, BLOB_CACHE_BYTES)> sx_Value;
+    return sx_Value->Get();
+}
+
+
 NCBI_PARAM_DECL(bool, OBJMGR, BULK_CHUNKS);
 NCBI_PARAM_DEF_EX(bool, OBJMGR, BULK_CHUNKS, true,
                   eParam_NoThread, OBJMGR_BULK_CHUNKS);
@@ -115,6 +127,9 @@ CDataSource::CDataSource(void)
     : m_DefaultPriority(CObjectManager::kPriority_Entry),
       m_Blob_Cache_Size(0),
       m_Blob_Cache_Size_Limit(GetDefaultBlobCacheSizeLimit()),
+      m_Blob_Cache_Bytes(0),
+      m_Blob_Cache_Bytes_Limit(GetDefaultBlobCacheBytesLimit()),
+      m_Blob_Cache_Clock(0),
       m_StaticBlobCounter(0),
       m_TrackSplitSeq(false)
 {
@@ -127,6 +142,9 @@ CDataSource::CDataSource(CDataLoader& loader)
       m_Blob_Cache_Size(0),
       m_Blob_Cache_Size_Limit(min(GetDefaultBlobCacheSizeLimit(),
                                   loader.GetDefaultBlobCacheSizeLimit())),
+      m_Blob_Cache_Bytes(0),
+      m_Blob_Cache_Bytes_Limit(GetDefaultBlobCacheBytesLimit()),
+      m_Blob_Cache_Clock(0),
       m_StaticBlobCounter(0),
       m_TrackSplitSeq(loader.GetTrackSplitSeq())
 {
@@ -139,6 +157,9 @@ CDataSource::CDataSource(const CObject& shared_object, const CSeq_entry& entry)
       m_DefaultPriority(CObjectManager::kPriority_Entry),
       m_Blob_Cache_Size(0),
       m_Blob_Cache_Size_Limit(GetDefaultBlobCacheSizeLimit()),
+      m_Blob_Cache_Bytes(0),
+      m_Blob_Cache_Bytes_Limit(GetDefaultBlobCacheBytesLimit()),
+      m_Blob_Cache_Clock(0),
       m_StaticBlobCounter(0),
       m_TrackSplitSeq(false)
 {
@@ -207,6 +228,8 @@ void CDataSource::DropAllTSEs(void)
         m_Blob_Map.clear();
         m_Blob_Cache.clear();
         m_Blob_Cache_Size = 0;
+        m_Blob_Cache_Bytes = 0;
+        m_Blob_Cache_Clock = 0;
         m_StaticBlobCounter = 0;
     }}
 }
@@ -2165,6 +2188,7 @@ CTSE_LoadLock CDataSource::GetTSE_LoadLock(const TBlobId& blob_id)
             TCacheLock::TWriteLockGuard guard(m_DSCacheLock);
             TTSE_Ref& slot = m_Blob_Map[blob_id];
             if ( !slot ) {
+                m_Blob_Cache_Stats.misses += 1;
                 slot.Reset(new CTSE_Info(blob_id));
                 _ASSERT(!IsLoaded(*slot));
                 _ASSERT(!slot->m_LoadMutex);
@@ -2256,6 +2280,41 @@ void CDataSource::SetLoaded(CTSE_LoadLock& lock)
 }
 
 
+// Reload cost estimation of a cached blob: fixed request overhead
+// plus transfer time (see CDataLoader::EstimateLoadSeconds()).
+static const double kBlobLoadSeconds = 0.001;
+static const double kBlobLoadSecondsPerByte = 2.5e-8;
+
+void CDataSource::x_GetBlobCacheCost(const CTSE_Info& tse,
+                                     size_t& tse_bytes,
+                                     double& reload_seconds)
+{
+    reload_seconds = kBlobLoadSeconds;
+    if ( tse.HasSplitInfo() ) {
+        pair<size_t, double> chunks_cost =
+            tse.GetSplitInfo().x_GetLoadedChunksCost();
+        tse_bytes = tse.x_GetEstimatedMemory(chunks_cost.first);
+        reload_seconds += chunks_cost.second;
+    }
+    else {
+        tse_bytes = tse.x_GetEstimatedMemory(0);
+        reload_seconds += tse_bytes * kBlobLoadSecondsPerByte;
+    }
+}
+
+
+double CDataSource::x_GetBlobCachePriority(const CTSE_Info& tse,
+                                           double reload_seconds) const
+{
+    // GreedyDual-Size-Frequency: blobs that are used often and are expensive
+    // to reload relative to their size stay in the cache longer,
+    // while the clock ages out blobs that are not used anymore.
+    _ASSERT(tse.m_CacheBytes > 0);
+    return m_Blob_Cache_Clock +
+        (tse.m_CacheHits + 1) * reload_seconds / tse.m_CacheBytes;
+}
+
+
 void CDataSource::x_ReleaseLastTSELock(CRef<CTSE_Info> tse)
 {
     if ( !m_Loader ) {
@@ -2263,6 +2322,12 @@ void CDataSource::x_ReleaseLastTSELock(CRef<CTSE_Info> tse)
         return;
     }
     _ASSERT(tse);
+    // the size and reload cost walk the TSE indexes and split chunks
+    // under their own locks, so they are estimated before taking
+    // the cache lock
+    size_t tse_bytes;
+    double reload_seconds;
+    x_GetBlobCacheCost(*tse, tse_bytes, reload_seconds);
     vector<TTSE_Ref> to_delete;
     {{
         TCacheLock::TWriteLockGuard guard(m_DSCacheLock);
@@ -2279,23 +2344,34 @@ void CDataSource::x_ReleaseLastTSELock(CRef<CTSE_Info> tse)
         _ASSERT(&tse->GetDataSource() == this);
 
         if ( tse->m_CacheState != CTSE_Info::eInCache ) {
-            _ASSERT(find(m_Blob_Cache.begin(), m_Blob_Cache.end(), tse) ==
-                    m_Blob_Cache.end());
-            tse->m_CachePosition = m_Blob_Cache.insert(m_Blob_Cache.end(),tse);
+            tse->m_CacheBytes = tse_bytes;
+            tse->m_CachePosition =
+                m_Blob_Cache.insert(TBlob_Cache::value_type
+                                    (x_GetBlobCachePriority(*tse,
+                                                            reload_seconds),
+                                     tse));
             m_Blob_Cache_Size += 1;
+            m_Blob_Cache_Bytes += tse->m_CacheBytes;
             _ASSERT(m_Blob_Cache_Size == m_Blob_Cache.size());
             tse->m_CacheState = CTSE_Info::eInCache;
         }
-        _ASSERT(tse->m_CachePosition ==
-                find(m_Blob_Cache.begin(), m_Blob_Cache.end(), tse));
+        _ASSERT(tse->m_CachePosition->second == tse);
         _ASSERT(m_Blob_Cache_Size == m_Blob_Cache.size());
         
         unsigned cache_size = m_Blob_Cache_Size_Limit;
-        while ( m_Blob_Cache_Size > cache_size ) {
-            CRef<CTSE_Info> del_tse = m_Blob_Cache.front();
-            m_Blob_Cache.pop_front();
+        size_t cache_bytes = m_Blob_Cache_Bytes_Limit;
+        while ( m_Blob_Cache_Size > cache_size ||
+                (cache_bytes && m_Blob_Cache_Bytes > cache_bytes) ) {
+            _ASSERT(!m_Blob_Cache.empty());
+            TBlob_Cache::iterator del_it = m_Blob_Cache.begin();
+            m_Blob_Cache_Clock = del_it->first;
+            CRef<CTSE_Info> del_tse = del_it->second;
+            m_Blob_Cache.erase(del_it);
             m_Blob_Cache_Size -= 1;
+            m_Blob_Cache_Bytes -= del_tse->m_CacheBytes;
             _ASSERT(m_Blob_Cache_Size == m_Blob_Cache.size());
+            m_Blob_Cache_Stats.evicted += 1;
+            m_Blob_Cache_Stats.evicted_bytes += del_tse->m_CacheBytes;
             del_tse->m_CacheState = CTSE_Info::eNotInCache;
             to_delete.push_back(del_tse);
             _VERIFY(DropTSE(*del_tse));
@@ -2304,6 +2380,18 @@ void CDataSource::x_ReleaseLastTSELock(CRef<CTSE_Info> tse)
 }
 
 
+CDataSource::SBlobCacheStats CDataSource::GetBlobCacheStats(void) const
+{
+    TCacheLock::TReadLockGuard guard(m_DSCacheLock);
+    SBlobCacheStats stats = m_Blob_Cache_Stats;
+    stats.cached = m_Blob_Cache_Size;
+    stats.cached_bytes = m_Blob_Cache_Bytes;
+    stats.size_limit = m_Blob_Cache_Size_Limit;
+    stats.bytes_limit = m_Blob_Cache_Bytes_Limit;
+    return stats;
+}
+
+
 void CDataSource::x_SetLock(CTSE_Lock& lock, CConstRef<CTSE_Info> tse) const
 {
     _ASSERT(!lock);
@@ -2316,16 +2404,15 @@ void CDataSource::x_SetLock(CTSE_Lock& lock, CConstRef<CTSE_Info> tse) const
 
     TCacheLock::TWriteLockGuard guard(m_DSCacheLock);
     if ( tse->m_CacheState == CTSE_Info::eInCache ) {
-        _ASSERT(tse->m_CachePosition ==
-                find(m_Blob_Cache.begin(), m_Blob_Cache.end(), tse));
+        _ASSERT(tse->m_CachePosition->second == tse);
         tse->m_CacheState = CTSE_Info::eNotInCache;
         m_Blob_Cache.erase(tse->m_CachePosition);
         m_Blob_Cache_Size -= 1;
+        m_Blob_Cache_Bytes -= tse->m_CacheBytes;
         _ASSERT(m_Blob_Cache_Size == m_Blob_Cache.size());
+        tse->m_CacheHits += 1;
+        m_Blob_Cache_Stats.hits += 1;
     }
-    
-    _ASSERT(find(m_Blob_Cache.begin(), m_Blob_Cache.end(), tse) ==
-            m_Blob_Cache.end());
 }
 
 
@@ -379,5 +379,141 @@ CIRef<IPrefetchAction> CPrefetchFeat_CIActionSource::GetNextAction(void)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+// CPrefetchFeat_CIBatch
+
+class CPrefetchFeat_CIBatch::CListener
+    : public CObject, public IPrefetchListener
+{
+public:
+    CListener(void)
+        : m_Sema(0, kMax_Int)
+        {
+        }
+
+    virtual void PrefetchNotify(CRef<CPrefetchRequest> token, EEvent /*event*/)
+        {
+            if ( token->IsDone() ) {
+                {{
+                    CFastMutexGuard guard(m_Mutex);
+                    m_Done.push_back(token);
+                }}
+                m_Sema.Post();
+            }
+        }
+
+    CRef<CPrefetchRequest> WaitNext(void)
+        {
+            m_Sema.Wait();
+            CFastMutexGuard guard(m_Mutex);
+            _ASSERT(!m_Done.empty());
+            CRef<CPrefetchRequest> ret = m_Done.front();
+            m_Done.pop_front();
+            return ret;
+        }
+
+    void Reset(void)
+        {
+            CFastMutexGuard guard(m_Mutex);
+            m_Done.clear();
+        }
+
+private:
+    CSemaphore                      m_Sema;
+    CFastMutex                      m_Mutex;
+    list< CRef<CPrefetchRequest> >  m_Done;
+};
+
+
+CPrefetchFeat_CIBatch::CPrefetchFeat_CIBatch(CPrefetchManager& manager,
+                                             const CScopeSource& scope,
+                                             const TQueries& queries,
+                                             size_t active_size)
+    : m_Manager(&manager),
+      m_Scope(scope),
+      m_Queries(queries),
+      m_NextQuery(0),
+      m_Listener(new CListener)
+{
+    // resolve all Bioseqs of the batch in one bulk request
+    CScope::TIds ids;
+    ids.reserve(m_Queries.size());
+    ITERATE ( TQueries, it, m_Queries ) {
+        ids.push_back(it->m_Seq_id);
+    }
+    m_Bioseqs = m_Scope.GetScope().GetBioseqHandles(ids);
+    _ASSERT(m_Bioseqs.size() == m_Queries.size());
+
+    CMutexGuard guard(m_Mutex);
+    for ( size_t i = 0; i < max(active_size, size_t(1)); ++i ) {
+        EnqueNextAction();
+    }
+}
+
+
+CPrefetchFeat_CIBatch::~CPrefetchFeat_CIBatch(void)
+{
+    CMutexGuard guard(m_Mutex);
+    ITERATE ( TActiveTokens, it, m_ActiveTokens ) {
+        it->first.GetNCPointer()->RequestToCancel();
+    }
+    // every active token is reported to the listener once when it's done,
+    // canceled or not; wait for all of them so none is added to the
+    // listener after the reset below
+    for ( size_t count = m_ActiveTokens.size(); count > 0; --count ) {
+        m_Listener->WaitNext();
+    }
+    m_ActiveTokens.clear();
+    // break token <-> listener references of finished queries
+    m_Listener->Reset();
+}
+
+
+void CPrefetchFeat_CIBatch::EnqueNextAction(void)
+{
+    if ( m_NextQuery >= m_Queries.size() ) {
+        return;
+    }
+    size_t index = m_NextQuery++;
+    const SQuery& query = m_Queries[index];
+    CIRef<IPrefetchAction> action;
+    if ( m_Bioseqs[index] ) {
+        action.Reset(new CPrefetchFeat_CI(m_Bioseqs[index],
+                                          query.m_Range,
+                                          query.m_Strand,
+                                          query.m_Selector));
+    }
+    else {
+        // unresolved id will be reported as failed action
+        action.Reset(new CPrefetchFeat_CI(m_Scope, query.m_Seq_id,
+                                          query.m_Range,
+                                          query.m_Strand,
+                                          query.m_Selector));
+    }
+    CRef<CPrefetchRequest> token =
+        m_Manager->AddAction(action, m_Listener.GetPointer());
+    m_ActiveTokens[token] = index;
+}
+
+
+CRef<CPrefetchRequest> CPrefetchFeat_CIBatch::GetNextToken(size_t* index)
+{
+    CRef<CPrefetchRequest> ret;
+    CMutexGuard guard(m_Mutex);
+    if ( m_ActiveTokens.empty() ) {
+        return ret;
+    }
+    ret = m_Listener->WaitNext();
+    TActiveTokens::iterator it = m_ActiveTokens.find(ret);
+    _ASSERT(it != m_ActiveTokens.end());
+    if ( index ) {
+        *index = it->second;
+    }
+    m_ActiveTokens.erase(it);
+    EnqueNextAction();
+    return ret;
+}
+
+
 END_SCOPE(objects)
 END_NCBI_SCOPE
@@ -1530,6 +1530,31 @@ void CTSE_ScopeInfo::RemoveFromHistory(const CTSE_Handle& tseh,
 }
 
 
+CRef<CObjectEx> CTSE_ScopeInfo::GetAttachedObject(const string& key) const
+{
+    CFastMutexGuard guard(m_AttachedObjectsMutex);
+    TAttachedObjects::const_iterator it = m_AttachedObjects.find(key);
+    if ( it == m_AttachedObjects.end() ) {
+        return null;
+    }
+    return Ref(it->second.Lock().GetPointerOrNull());
+}
+
+
+CRef<CObjectEx> CTSE_ScopeInfo::AttachObject(const string& key,
+                                             CObjectEx& obj)
+{
+    CFastMutexGuard guard(m_AttachedObjectsMutex);
+    CWeakRef<CObjectEx>& slot = m_AttachedObjects[key];
+    CRef<CObjectEx> ret(slot.Lock().GetPointerOrNull());
+    if ( !ret ) {
+        ret = &obj;
+        slot.Reset(&obj);
+    }
+    return ret;
+}
+
+
 bool CTSE_ScopeInfo::HasResolvedBioseq(const CSeq_id_Handle& id) const
 {
     return m_BioseqById.find(id) != m_BioseqById.end();
@@ -820,6 +820,7 @@ CSeq_annot_SNP_Info::CSeq_annot_SNP_Info(CSeq_annot& annot)
 CSeq_annot_SNP_Info::CSeq_annot_SNP_Info(const CSeq_annot_SNP_Info& info)
     : m_Seq_id(info.m_Seq_id),
       m_SNP_Set(info.m_SNP_Set),
+      m_SNP_Positions(info.m_SNP_Positions),
       m_Comments(info.m_Comments),
       m_Alleles(info.m_Alleles),
       m_QualityCodesStr(info.m_QualityCodesStr),
@@ -936,14 +937,14 @@ size_t CIndexedStrings::GetIndex(const string& s, size_t max_index)
             m_Indices->insert(TIndices::value_type(m_Strings[i], i));
         }
     }
-    TIndices::iterator it = m_Indices->lower_bound(s);
-    if ( it != m_Indices->end() && it->first == s ) {
+    TIndices::const_iterator it = m_Indices->find(s);
+    if ( it != m_Indices->end() ) {
         return it->second;
     }
     size_t index = m_Strings.size();
     if ( index <= max_index ) {
         m_Strings.push_back(s);
-        m_Indices->insert(it, TIndices::value_type(m_Strings.back(), index));
+        m_Indices->insert(TIndices::value_type(s, index));
     }
     return index;
 }
@@ -1086,11 +1087,21 @@ void CSeq_annot_SNP_Info::x_FinishParsing(void)
     m_Extra.ClearIndices();
     
     sort(m_SNP_Set.begin(), m_SNP_Set.end());
+    x_UpdatePositions();
     
     x_SetDirtyAnnotIndex();
 }
 
 
+void CSeq_annot_SNP_Info::x_UpdatePositions(void)
+{
+    m_SNP_Positions.resize(m_SNP_Set.size());
+    for ( size_t i = 0; i < m_SNP_Set.size(); ++i ) {
+        m_SNP_Positions[i] = m_SNP_Set[i].m_ToPosition;
+    }
+}
+
+
 void CSeq_annot_SNP_Info::Reset(void)
 {
     m_Seq_id.Reset();
@@ -1100,6 +1111,7 @@ void CSeq_annot_SNP_Info::Reset(void)
     m_QualityCodesOs.Clear();
     m_Extra.Clear();
     m_SNP_Set.clear();
+    m_SNP_Positions.clear();
     m_Seq_annot.Reset();
 }
 
@@ -45,7 +45,12 @@
 #include <objmgr/graph_ci.hpp>
 #include <objmgr/seq_table_ci.hpp>
 #include <objmgr/annot_ci.hpp>
+#include <objmgr/prefetch_manager.hpp>
+#include <objmgr/prefetch_actions.hpp>
 #include <objmgr/impl/synonyms.hpp>
+#include <objmgr/impl/data_source.hpp>
+#include <objmgr/impl/tse_loadlock.hpp>
+#include <objmgr/data_loader.hpp>
 
 #include <objects/general/general__.hpp>
 #include <objects/seqfeat/seqfeat__.hpp>
@@ -1259,3 +1264,188 @@ BOOST_AUTO_TEST_CASE(AddSeqIdHistory)
     }}
     SetDiagPostLevel(old_level);
 }
+
+
+// Loader of blobs with the given number of Bioseqs.
+// Bioseqs of blob N have gis N*1000+1, N*1000+2, ...
+class CBlobCacheTestLoader : public CDataLoader
+{
+public:
+    typedef SRegisterLoaderInfo<CBlobCacheTestLoader> TRegisterLoaderInfo;
+    static TRegisterLoaderInfo RegisterInObjectManager(CObjectManager& om)
+        {
+            CSimpleLoaderMaker<CBlobCacheTestLoader> maker;
+            CDataLoader::RegisterInObjectManager(om, maker,
+                                                 CObjectManager::eNonDefault,
+                                                 CObjectManager::kPriority_Default);
+            return maker.GetRegisterInfo();
+        }
+    static string GetLoaderNameFromArgs(void)
+        {
+            return "BlobCacheTestLoader";
+        }
+
+    CBlobCacheTestLoader(const string& name)
+        : CDataLoader(name)
+        {
+        }
+
+    // keep only two unlocked blobs
+    virtual unsigned GetDefaultBlobCacheSizeLimit() const
+        {
+            return 2;
+        }
+
+    virtual TTSE_LockSet GetRecords(const CSeq_id_Handle& idh,
+                                    EChoice /*choice*/)
+        {
+            TTSE_LockSet locks;
+            if ( !idh.IsGi() ) {
+                return locks;
+            }
+            int blob = (GI_TO(int, idh.GetGi()) - 1) / 1000;
+            if ( !m_BlobSizes.count(blob) ) {
+                return locks;
+            }
+            TBlobId blob_id(new CBlobIdInt(blob));
+            CTSE_LoadLock load_lock = GetDataSource()->GetTSE_LoadLock(blob_id);
+            if ( !load_lock.IsLoaded() ) {
+                CRef<CSeq_entry> entry(new CSeq_entry);
+                for ( int i = 0; i < m_BlobSizes[blob]; ++i ) {
+                    entry->SetSet().SetSeq_set().push_back(s_GetEntry(blob*1000+i));
+                }
+                load_lock->SetSeq_entry(*entry);
+                load_lock.SetLoaded();
+                m_LoadCount[blob] += 1;
+            }
+            locks.insert(CTSE_Lock(load_lock));
+            return locks;
+        }
+
+    map<int, int> m_BlobSizes;
+    map<int, int> m_LoadCount;
+};
+
+
+// Request the blob in a temporary scope, so the blob is unlocked
+// and goes into the blob cache when the scope is destroyed.
+static void s_UseBlob(CObjectManager& om, int blob)
+{
+    CScope scope(om);
+    scope.AddDataLoader(CBlobCacheTestLoader::GetLoaderNameFromArgs());
+    BOOST_REQUIRE(scope.GetBioseqHandle(*s_GetId(blob*1000)));
+}
+
+
+BOOST_AUTO_TEST_CASE(TestBlobCacheGDSFSize)
+{
+    CRef<CObjectManager> om = CObjectManager::GetInstance();
+    CBlobCacheTestLoader* loader =
+        CBlobCacheTestLoader::RegisterInObjectManager(*om).GetLoader();
+    loader->m_BlobSizes[1] = 1;
+    loader->m_BlobSizes[2] = 100;
+    loader->m_BlobSizes[3] = 1;
+
+    s_UseBlob(*om, 1);
+    s_UseBlob(*om, 2);
+    // the third blob overflows the cache
+    s_UseBlob(*om, 3);
+    CDataLoader::SBlobCacheStats stats = loader->GetBlobCacheStats();
+    BOOST_CHECK_EQUAL(stats.cached, 2u);
+    BOOST_CHECK_EQUAL(stats.evicted, 1u);
+    BOOST_CHECK_EQUAL(stats.misses, 3u);
+
+    // FIFO would drop the oldest blob 1, GDSF drops the biggest blob 2
+    s_UseBlob(*om, 1);
+    BOOST_CHECK_EQUAL(loader->m_LoadCount[1], 1);
+    s_UseBlob(*om, 2);
+    BOOST_CHECK_EQUAL(loader->m_LoadCount[2], 2);
+
+    om->RevokeDataLoader(CBlobCacheTestLoader::GetLoaderNameFromArgs());
+}
+
+
+BOOST_AUTO_TEST_CASE(TestBlobCacheGDSFFrequency)
+{
+    CRef<CObjectManager> om = CObjectManager::GetInstance();
+    CBlobCacheTestLoader* loader =
+        CBlobCacheTestLoader::RegisterInObjectManager(*om).GetLoader();
+    loader->m_BlobSizes[1] = 100;
+    loader->m_BlobSizes[2] = 1;
+    loader->m_BlobSizes[3] = 1;
+
+    // frequently used big blob outweighs small blobs used once
+    for ( int i = 0; i < 10; ++i ) {
+        s_UseBlob(*om, 1);
+    }
+    s_UseBlob(*om, 2);
+    s_UseBlob(*om, 3);
+    CDataLoader::SBlobCacheStats stats = loader->GetBlobCacheStats();
+    BOOST_CHECK_EQUAL(stats.hits, 9u);
+    BOOST_CHECK_EQUAL(stats.evicted, 1u);
+
+    s_UseBlob(*om, 1);
+    BOOST_CHECK_EQUAL(loader->m_LoadCount[1], 1);
+    s_UseBlob(*om, 2);
+    BOOST_CHECK_EQUAL(loader->m_LoadCount[2], 2);
+
+    om->RevokeDataLoader(CBlobCacheTestLoader::GetLoaderNameFromArgs());
+}
+
+
+#ifdef NCBI_THREADS
+BOOST_AUTO_TEST_CASE(TestPrefetchFeat_CIBatch)
+{
+    const int kCount = 20;
+    CScope scope(*CObjectManager::GetInstance());
+    SAnnotSelector sel(CSeqFeatData::e_Region);
+    CPrefetchFeat_CIBatch::TQueries queries;
+    for ( int i = 0; i <= kCount; ++i ) {
+        if ( i < kCount ) {
+            CRef<CSeq_entry> entry = s_GetEntry(i);
+            entry->SetSeq().SetAnnot().push_back(s_GetAnnot(*s_GetId(i),
+                                                            i % 5 + 1));
+            scope.AddTopLevelSeqEntry(*entry);
+        }
+        // the last query is for a Seq-id that isn't resolved
+        queries.push_back(CPrefetchFeat_CIBatch::SQuery
+                          (CSeq_id_Handle::GetHandle(*s_GetId(i)),
+                           CRange<TSeqPos>::GetWhole(),
+                           eNa_strand_unknown,
+                           sel));
+    }
+
+    CRef<CPrefetchManager> manager(new CPrefetchManager);
+    {{
+        // every query is returned once, whatever the order of completion
+        CPrefetchFeat_CIBatch batch(*manager, CScopeSource(scope),
+                                    queries, 2);
+        vector<bool> returned(queries.size());
+        for ( size_t n = 0; n < queries.size(); ++n ) {
+            size_t index = queries.size();
+            CRef<CPrefetchRequest> token = batch.GetNextToken(&index);
+            BOOST_REQUIRE(token);
+            BOOST_REQUIRE(index < queries.size());
+            BOOST_CHECK(!returned[index]);
+            returned[index] = true;
+            BOOST_CHECK(token->IsDone());
+            if ( index < size_t(kCount) ) {
+                BOOST_CHECK_EQUAL(token->GetState(),
+                                  SPrefetchTypes::eCompleted);
+                BOOST_CHECK_EQUAL(CStdPrefetch::GetFeat_CI(token).GetSize(),
+                                  index % 5 + 1);
+            }
+            else {
+                BOOST_CHECK_EQUAL(token->GetState(),
+                                  SPrefetchTypes::eFailed);
+            }
+        }
+        BOOST_CHECK(!batch.GetNextToken());
+    }}
+    {{
+        // queries still in flight are canceled by the destructor
+        CPrefetchFeat_CIBatch batch(*manager, CScopeSource(scope),
+                                    queries, 2);
+    }}
+}
+#endif // NCBI_THREADS
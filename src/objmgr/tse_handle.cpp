@@ -232,6 +232,19 @@ bool CTSE_Handle::CanBeEdited(void) const
 }
 
 
+CRef<CObjectEx> CTSE_Handle::GetAttachedObject(const string& key) const
+{
+    return x_GetScopeInfo().GetAttachedObject(key);
+}
+
+
+CRef<CObjectEx> CTSE_Handle::AttachObject(const string& key,
+                                          CObjectEx& obj) const
+{
+    return x_GetScopeInfo().AttachObject(key, obj);
+}
+
+
 CTSE_Handle::ETopLevelObjectType CTSE_Handle::GetTopLevelObjectType() const
 {
     return x_GetTSE_Info().GetTopLevelObjectType();
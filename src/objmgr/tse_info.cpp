@@ -295,6 +295,8 @@ void CTSE_Info::x_Initialize(void)
     m_UsedMemory = 0;
     m_LoadState = eNotLoaded;
     m_CacheState = eNotInCache;
+    m_CacheBytes = 0;
+    m_CacheHits = 0;
     m_AnnotIdsFlags = 0;
 }
 
@@ -348,6 +350,38 @@ void CTSE_Info::AddUsedMemory(size_t size)
 }
 
 
+// Rough per-object memory estimations used when data loader doesn't
+// report actual memory usage of the TSE.
+static const size_t kTSEOverheadMemory = 4096;
+static const size_t kBioObjectMemory = 1024;
+static const size_t kAnnotIndexMemory = 512;
+// ratio of in-memory size to transferred size of a split chunk
+static const size_t kChunkExpansionFactor = 4;
+
+size_t CTSE_Info::x_GetEstimatedMemory(size_t loaded_chunks_bytes) const
+{
+    size_t size = kTSEOverheadMemory;
+    {{
+        CFastMutexGuard guard(m_BioseqsMutex);
+        size += m_Bioseqs.size() * kBioObjectMemory;
+    }}
+    // the annot index may be updated by relocking or split chunk loading
+    TAnnotLockReadGuard guard(GetAnnotLock());
+    ITERATE ( TNamedAnnotObjs, nit, m_NamedAnnotObjs ) {
+        ITERATE ( TAnnotObjs, it, nit->second ) {
+            const SIdAnnotObjs& objs = it->second;
+            for ( size_t i = 0; i < objs.x_GetRangeMapCount(); ++i ) {
+                if ( !objs.x_RangeMapIsEmpty(i) ) {
+                    size += objs.x_GetRangeMap(i).size() * kAnnotIndexMemory;
+                }
+            }
+        }
+    }
+    size += loaded_chunks_bytes * kChunkExpansionFactor;
+    return max(size, m_UsedMemory);
+}
+
+
 void CTSE_Info::SetSeq_entry(CSeq_entry& entry, CTSE_SetObjectInfo* set_info)
 {
     if ( m_Which != CSeq_entry::e_not_set ) {
@@ -696,6 +696,30 @@ void CTSE_Split_Info::x_AddUsedMemory(size_t size)
 }
 
 
+pair<size_t, double> CTSE_Split_Info::x_GetLoadedChunksCost(void) const
+{
+    pair<size_t, double> ret(0, 0);
+    CMutexGuard guard(m_ChunksMutex);
+    ITERATE ( TChunks, it, m_Chunks ) {
+        const CTSE_Chunk_Info& chunk = *it->second;
+        if ( !chunk.IsLoaded() ) {
+            continue;
+        }
+        pair<Uint4, double> cost;
+        if ( m_DataLoader && m_DataLoader->GetDataLoader() ) {
+            cost = chunk.GetLoadCost();
+        }
+        else {
+            cost.first = chunk.GetLoadBytes();
+            cost.second = chunk.GetLoadSeconds();
+        }
+        ret.first += cost.first;
+        ret.second += cost.second;
+    }
+    return ret;
+}
+
+
 void CTSE_Split_Info::x_SetBioseqUpdater(CRef<CBioseqUpdater> updater)
 {
     NON_CONST_ITERATE ( TTSE_Set, it, m_TSE_Set ) {
@@ -1968,6 +1968,33 @@ CFeatTree::~CFeatTree(void)
 }
 
 
+static const char kTSEFeatTreeKey[] = "feature::CFeatTree";
+
+CRef<CFeatTree> CFeatTree::GetTSEFeatTree(const CTSE_Handle& tse)
+{
+    bool shared = !tse.CanBeEdited();
+    if ( shared ) {
+        CRef<CFeatTree> tree(dynamic_cast<CFeatTree*>
+                             (tse.GetAttachedObject(kTSEFeatTreeKey)
+                              .GetPointerOrNull()));
+        if ( tree ) {
+            return tree;
+        }
+    }
+    CRef<CFeatTree> tree(new CFeatTree(tse.GetTopLevelEntry()));
+    tree->x_AssignParents();
+    tree->x_AssignGenes();
+    if ( shared ) {
+        // another thread may have attached its tree in the meantime
+        tree.Reset(dynamic_cast<CFeatTree*>
+                   (tse.AttachObject(kTSEFeatTreeKey, *tree)
+                    .GetPointerOrNull()));
+        _ASSERT(tree);
+    }
+    return tree;
+}
+
+
 CFeatTree::CFeatTree(const CFeatTree& ft)
 {
     *this = ft;
@@ -1997,6 +2024,54 @@ CFeatTree& CFeatTree::operator=(const CFeatTree& ft)
 }
 
 
+CRef<CFeatTree> CFeatTree::Clone(void) const
+{
+    CRef<CFeatTree> tree(new CFeatTree);
+    tree->x_CopyAssigned(*this);
+    return tree;
+}
+
+
+void CFeatTree::x_CopyAssigned(const CFeatTree& ft)
+{
+    _ASSERT(m_InfoArray.empty());
+    m_AssignedParents = ft.m_AssignedParents;
+    m_AssignedGenes = ft.m_AssignedGenes;
+    m_FeatIdMode = ft.m_FeatIdMode;
+    m_BestGeneFeatIdMode = ft.m_BestGeneFeatIdMode;
+    m_GeneCheckMode = ft.m_GeneCheckMode;
+    m_IgnoreMissingGeneXref = ft.m_IgnoreMissingGeneXref;
+    m_SNPStrandMode = ft.m_SNPStrandMode;
+    // the overlap index will be re-created if more features are added
+    m_Index = null;
+    m_InfoArray.reserve(ft.m_InfoArray.size());
+    ITERATE ( TInfoArray, it, ft.m_InfoArray ) {
+        CFeatInfo& info = m_InfoMap[(*it)->m_Feat.GetSeq_feat_Handle()];
+        info = **it;
+        m_InfoArray.push_back(&info);
+    }
+    // links to the infos of the source tree are replaced by links
+    // to their copies, which have the same add index
+    NON_CONST_ITERATE ( TInfoArray, it, m_InfoArray ) {
+        CFeatInfo& info = **it;
+        _ASSERT(info.m_AddIndex == size_t(it - m_InfoArray.begin()));
+        if ( info.m_Parent ) {
+            info.m_Parent = m_InfoArray[info.m_Parent->m_AddIndex];
+        }
+        if ( info.m_Gene ) {
+            info.m_Gene = m_InfoArray[info.m_Gene->m_AddIndex];
+        }
+        NON_CONST_ITERATE ( TChildren, cit, info.m_Children ) {
+            *cit = m_InfoArray[(*cit)->m_AddIndex];
+        }
+    }
+    m_RootInfo = ft.m_RootInfo;
+    NON_CONST_ITERATE ( TChildren, cit, m_RootInfo.m_Children ) {
+        *cit = m_InfoArray[(*cit)->m_AddIndex];
+    }
+}
+
+
 void CFeatTree::x_Init(void)
 {
     m_AssignedParents = 0;
@@ -2180,7 +2180,10 @@ void CBioseqIndex::x_InitFeats (CSeq_loc* slpp)
 
                 // end of RW-1215 changes
 
-                ft->AddFeature(mf);
+                {
+                    CFastMutexGuard guard(idxl->GetFeatTreeMutex());
+                    ft->AddFeature(mf);
+                }
 
                 // CFeatureIndex from CMappedFeat for use with GetBestGene
                 m_FeatIndexMap[mf] = sfx;
@@ -3204,6 +3207,7 @@ CRef<CFeatureIndex> CFeatureIndex::GetBestGene (void)
             CWeakRef<CSeqMasterIndex> idx = bsxl->GetSeqMasterIndex();
             auto idxl = idx.Lock();
             if (idxl) {
+                 CFastMutexGuard guard(idxl->GetFeatTreeMutex());
                  best = feature::GetBestGeneForFeat(m_Mf, idxl->GetFeatTree(), 0,
                                                    /* feature::CFeatTree::eBestGene_AllowOverlapped */
                                                    feature::CFeatTree::eBestGene_TreeOnly);
@@ -3240,7 +3244,10 @@ CRef<CFeatureIndex> CFeatureIndex::GetBestParent (void)
                  };
                  for ( const CSeqFeatData::ESubtype* type_ptr = sm_SpecialVDJTypes;
                      *type_ptr != CSeqFeatData::eSubtype_bad; ++type_ptr ) {
-                     best = feature::GetBestParentForFeat(m_Mf, *type_ptr, idxl->GetFeatTree(), 0);
+                     {
+                         CFastMutexGuard guard(idxl->GetFeatTreeMutex());
+                         best = feature::GetBestParentForFeat(m_Mf, *type_ptr, idxl->GetFeatTree(), 0);
+                     }
                      if (best) {
                          return bsxl->GetFeatIndex(best);
                      }
@@ -3278,6 +3285,7 @@ CRef<CFeatureIndex> CFeatureIndex::GetOverlappingSource (void)
                 if (idxl) {
                     CRef<feature::CFeatTree> ft = idxl->GetFeatTree();
                     try {
+                        CFastMutexGuard guard(idxl->GetFeatTreeMutex());
                         best = ft->GetParent(m_Mf, CSeqFeatData::eSubtype_biosrc);
                     } catch (CException& e) {
                         ERR_POST_X(9, Error << "Error in CFeatureIndex::GetOverlappingSource: " << e.what());
@@ -0,0 +1,245 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Unit tests for the feature tree shared by all users of a TSE.
+*
+* ===========================================================================
+*/
+
+#include <ncbi_pch.hpp>
+
+#include <objects/seqset/Seq_entry.hpp>
+#include <objects/seq/Bioseq.hpp>
+#include <objects/seq/Seq_annot.hpp>
+#include <objects/seq/Seq_inst.hpp>
+#include <objects/seq/Seq_data.hpp>
+#include <objects/seq/IUPACna.hpp>
+#include <objects/seqfeat/Seq_feat.hpp>
+#include <objects/seqfeat/Gene_ref.hpp>
+#include <objects/seqfeat/RNA_ref.hpp>
+#include <objects/seqfeat/Cdregion.hpp>
+#include <objects/seqloc/Seq_id.hpp>
+#include <objects/seqloc/Seq_loc.hpp>
+#include <objmgr/object_manager.hpp>
+#include <objmgr/scope.hpp>
+#include <objmgr/feat_ci.hpp>
+#include <objmgr/seq_entry_handle.hpp>
+#include <objmgr/seq_annot_handle.hpp>
+#include <objmgr/tse_handle.hpp>
+#include <objmgr/util/feature.hpp>
+
+#ifdef NCBI_THREADS
+# include <thread>
+#endif // NCBI_THREADS
+
+// This header must be included before all Boost.Test headers if there are any
+#include <corelib/test_boost.hpp>
+
+#include <common/test_assert.h> // This header must go last
+
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+static CRef<CSeq_feat> s_GetFeat(CSeqFeatData::ESubtype subtype,
+                                 TSeqPos from, TSeqPos to)
+{
+    CRef<CSeq_feat> feat(new CSeq_feat);
+    switch ( subtype ) {
+    case CSeqFeatData::eSubtype_gene:
+        feat->SetData().SetGene().SetLocus("gene" + NStr::NumericToString(from));
+        break;
+    case CSeqFeatData::eSubtype_mRNA:
+        feat->SetData().SetRna().SetType(CRNA_ref::eType_mRNA);
+        break;
+    default:
+        feat->SetData().SetCdregion();
+        break;
+    }
+    CRef<CSeq_id> id(new CSeq_id("lcl|feat_tree"));
+    feat->SetLocation().SetInt().SetId(*id);
+    feat->SetLocation().SetInt().SetFrom(from);
+    feat->SetLocation().SetInt().SetTo(to);
+    return feat;
+}
+
+
+// Nucleotide with two genes, each with a mRNA and a CDS
+static CRef<CSeq_entry> s_GetEntry(void)
+{
+    CRef<CSeq_entry> entry(new CSeq_entry);
+    CBioseq& seq = entry->SetSeq();
+    seq.SetId().push_back(Ref(new CSeq_id("lcl|feat_tree")));
+    seq.SetInst().SetRepr(CSeq_inst::eRepr_raw);
+    seq.SetInst().SetMol(CSeq_inst::eMol_dna);
+    seq.SetInst().SetLength(1000);
+    seq.SetInst().SetSeq_data().SetIupacna().Set(string(1000, 'A'));
+
+    CRef<CSeq_annot> annot(new CSeq_annot);
+    CSeq_annot::TData::TFtable& ftable = annot->SetData().SetFtable();
+    ftable.push_back(s_GetFeat(CSeqFeatData::eSubtype_gene, 0, 299));
+    ftable.push_back(s_GetFeat(CSeqFeatData::eSubtype_mRNA, 0, 299));
+    ftable.push_back(s_GetFeat(CSeqFeatData::eSubtype_cdregion, 10, 279));
+    ftable.push_back(s_GetFeat(CSeqFeatData::eSubtype_gene, 500, 799));
+    ftable.push_back(s_GetFeat(CSeqFeatData::eSubtype_mRNA, 500, 799));
+    ftable.push_back(s_GetFeat(CSeqFeatData::eSubtype_cdregion, 510, 779));
+    seq.SetAnnot().push_back(annot);
+    return entry;
+}
+
+
+// Expected parents of the features in the order of the feature table
+static void s_CheckParents(feature::CFeatTree& tree,
+                           const CSeq_entry_Handle& seh)
+{
+    vector<CMappedFeat> feats;
+    for ( CFeat_CI it(seh); it; ++it ) {
+        feats.push_back(*it);
+    }
+    BOOST_REQUIRE_EQUAL(feats.size(), 6u);
+    for ( size_t i = 0; i < feats.size(); i += 3 ) {
+        const CMappedFeat& gene = feats[i];
+        const CMappedFeat& mrna = feats[i+1];
+        const CMappedFeat& cds = feats[i+2];
+        BOOST_CHECK(!tree.GetParent(gene));
+        BOOST_CHECK(tree.GetParent(mrna) == gene);
+        BOOST_CHECK(tree.GetParent(cds) == mrna);
+        BOOST_CHECK(tree.GetBestGene(cds) == gene);
+        BOOST_CHECK_EQUAL(tree.GetChildren(gene).size(), 1u);
+    }
+    BOOST_CHECK_EQUAL(tree.GetChildren(CMappedFeat()).size(), 2u);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestTSEFeatTreeReuse)
+{
+    CScope scope(*CObjectManager::GetInstance());
+    CConstRef<CSeq_entry> entry = s_GetEntry();
+    CSeq_entry_Handle seh = scope.AddTopLevelSeqEntry(*entry);
+    CTSE_Handle tse = seh.GetTSE_Handle();
+
+    CRef<feature::CFeatTree> tree = feature::CFeatTree::GetTSEFeatTree(tse);
+    BOOST_REQUIRE(tree);
+    s_CheckParents(*tree, seh);
+    // the same tree is returned while it's referenced
+    BOOST_CHECK(feature::CFeatTree::GetTSEFeatTree(tse) == tree);
+
+    // the clone has the same parents without re-assigning them
+    CRef<feature::CFeatTree> clone = tree->Clone();
+    BOOST_CHECK(clone != tree);
+    s_CheckParents(*clone, seh);
+
+    // features added to the clone are not visible in the shared tree
+    CRef<CSeq_annot> annot(new CSeq_annot);
+    annot->SetData().SetFtable().push_back
+        (s_GetFeat(CSeqFeatData::eSubtype_cdregion, 20, 250));
+    CSeq_annot_Handle sah = scope.AddSeq_annot(*annot);
+    CFeat_CI added_it(sah);
+    BOOST_REQUIRE(added_it);
+    CMappedFeat added = *added_it;
+    clone->AddFeature(added);
+    BOOST_CHECK(clone->GetBestGene(added));
+    BOOST_CHECK_THROW(tree->GetParent(added), CException);
+    s_CheckParents(*tree, seh);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestTSEFeatTreeInvalidation)
+{
+    CScope scope(*CObjectManager::GetInstance());
+    CConstRef<CSeq_entry> entry = s_GetEntry();
+    CSeq_entry_Handle seh = scope.AddTopLevelSeqEntry(*entry);
+    CTSE_Handle tse = seh.GetTSE_Handle();
+
+    // the TSE keeps only a weak reference to the tree
+    CRef<feature::CFeatTree> tree = feature::CFeatTree::GetTSEFeatTree(tse);
+    CWeakRef<feature::CFeatTree> weak_tree(tree);
+    tree.Reset();
+    BOOST_CHECK(!weak_tree.Lock());
+    tree = feature::CFeatTree::GetTSEFeatTree(tse);
+    BOOST_REQUIRE(tree);
+    BOOST_CHECK(!weak_tree.Lock());
+    s_CheckParents(*tree, seh);
+
+    // trees of an editable TSE are not shared, and see the edits
+    CSeq_entry_EditHandle edit = seh.GetEditHandle();
+    CTSE_Handle edit_tse = edit.GetTSE_Handle();
+    BOOST_REQUIRE(edit_tse.CanBeEdited());
+    CRef<feature::CFeatTree> edit_tree =
+        feature::CFeatTree::GetTSEFeatTree(edit_tse);
+    BOOST_CHECK(feature::CFeatTree::GetTSEFeatTree(edit_tse) != edit_tree);
+    CRef<CSeq_annot> annot(new CSeq_annot);
+    annot->SetData().SetFtable().push_back
+        (s_GetFeat(CSeqFeatData::eSubtype_gene, 900, 950));
+    edit.AttachAnnot(*annot);
+    CRef<feature::CFeatTree> new_tree =
+        feature::CFeatTree::GetTSEFeatTree(edit_tse);
+    BOOST_CHECK_EQUAL(new_tree->GetChildren(CMappedFeat()).size(), 3u);
+}
+
+
+#ifdef NCBI_THREADS
+BOOST_AUTO_TEST_CASE(TestTSEFeatTreeConcurrent)
+{
+    CScope scope(*CObjectManager::GetInstance());
+    CConstRef<CSeq_entry> entry = s_GetEntry();
+    CSeq_entry_Handle seh = scope.AddTopLevelSeqEntry(*entry);
+    CTSE_Handle tse = seh.GetTSE_Handle();
+    CRef<CSeq_annot> annot(new CSeq_annot);
+    annot->SetData().SetFtable().push_back
+        (s_GetFeat(CSeqFeatData::eSubtype_cdregion, 20, 250));
+    CSeq_annot_Handle sah = scope.AddSeq_annot(*annot);
+
+    // consumers query the shared tree and extend their private copies
+    const size_t kThreads = 8;
+    vector< CRef<feature::CFeatTree> > trees(kThreads);
+    vector<thread> threads;
+    for ( size_t i = 0; i < kThreads; ++i ) {
+        threads.push_back(thread([&, i]() {
+            CRef<feature::CFeatTree> tree =
+                feature::CFeatTree::GetTSEFeatTree(tse);
+            for ( int pass = 0; pass < 100; ++pass ) {
+                for ( CFeat_CI it(seh); it; ++it ) {
+                    tree->GetParent(*it);
+                    tree->GetBestGene(*it);
+                }
+            }
+            CRef<feature::CFeatTree> clone = tree->Clone();
+            clone->AddGenesForFeat(*CFeat_CI(sah), 0);
+            trees[i] = tree;
+        }));
+    }
+    for ( auto& t : threads ) {
+        t.join();
+    }
+    for ( size_t i = 1; i < kThreads; ++i ) {
+        BOOST_CHECK(trees[i] == trees[0]);
+    }
+    s_CheckParents(*trees[0], seh);
+    BOOST_CHECK_THROW(trees[0]->GetParent(*CFeat_CI(sah)), CException);
+}
+#endif // NCBI_THREADS
@@ -41,8 +41,18 @@
 #include <objtools/data_loaders/asn_cache/Cache_blob.hpp>
 
 #include <corelib/rwstream.hpp>
+#include <corelib/ncbimtx.hpp>
+#include <corelib/ncbifile.hpp>
+#include <util/checksum.hpp>
 #include <util/compress/stream.hpp>
 #include <util/compress/zlib.hpp>
+#include <util/compress/zstd.hpp>
+#include <objtools/data_loaders/asn_cache/asn_cache_exception.hpp>
+
+#if defined(HAVE_LIBZSTD)
+#  include <zstd.h>
+#  include <zdict.h>
+#endif
 
 #include "md5_writer.hpp"
 
@@ -60,6 +70,105 @@ BEGIN_NCBI_SCOPE
 BEGIN_objects_SCOPE // namespace ncbi::objects::
 
 
+/////////////////////////////////////////////////////////////////////////////
+// Version 2 blob header, all numbers are big-endian:
+//   1 byte  - codec (ECodec)
+//   4 bytes - id of the zstd dictionary, 0 if none
+//   8 bytes - size of the uncompressed data
+// followed by the compressed data.
+
+static const size_t kHeaderSize = 1 + 4 + 8;
+
+static void s_PutNumber(char* dst, Uint8 value, size_t size)
+{
+    for ( size_t i = size; i--; ) {
+        dst[i] = char(value & 0xff);
+        value >>= 8;
+    }
+}
+
+static Uint8 s_GetNumber(const char* src, size_t size)
+{
+    Uint8 value = 0;
+    for ( size_t i = 0; i < size; ++i ) {
+        value = (value << 8) | (unsigned char)src[i];
+    }
+    return value;
+}
+
+
+#if defined(HAVE_LIBZSTD)
+
+// Loaded dictionary with pools of (de)compressors that have it loaded already,
+// as loading a dictionary is much more expensive than packing a small entry.
+struct SCacheBlobDictionary
+{
+    typedef vector< unique_ptr<CZstdCompression> > TPool;
+
+    string data;
+    CFastMutex mutex;
+    TPool compressors;
+    TPool decompressors;
+
+    unique_ptr<CZstdCompression> GetCompression(bool compress)
+    {
+        {{
+            CFastMutexGuard guard(mutex);
+            TPool& pool = compress ? compressors : decompressors;
+            if ( !pool.empty() ) {
+                unique_ptr<CZstdCompression> ret = move(pool.back());
+                pool.pop_back();
+                return ret;
+            }
+        }}
+        unique_ptr<CZstdCompression> ret(new CZstdCompression);
+        if ( !data.empty() ) {
+            ret->SetDictionary(*new CCompressionDictionary(data.data(), data.size()),
+                               eTakeOwnership);
+        }
+        return ret;
+    }
+
+    void PutCompression(bool compress, unique_ptr<CZstdCompression> compression)
+    {
+        CFastMutexGuard guard(mutex);
+        (compress ? compressors : decompressors).push_back(move(compression));
+    }
+};
+
+#else
+
+struct SCacheBlobDictionary
+{
+    string data;
+};
+
+#endif
+
+
+typedef map<Uint4, shared_ptr<SCacheBlobDictionary> > TCacheBlobDictionaries;
+static CSafeStatic<TCacheBlobDictionaries> s_Dictionaries;
+DEFINE_STATIC_FAST_MUTEX(s_DictionariesMutex);
+
+
+static shared_ptr<SCacheBlobDictionary> s_GetDictionary(Uint4 dict_id)
+{
+    CFastMutexGuard guard(s_DictionariesMutex);
+    shared_ptr<SCacheBlobDictionary>& dict = s_Dictionaries.Get()[dict_id];
+    if ( !dict ) {
+        if ( dict_id ) {
+            s_Dictionaries->erase(dict_id);
+            NCBI_THROW_FMT(CASNCacheException, eUnsupportedBlobFormat,
+                           "ASN cache blob is compressed with zstd dictionary "
+                           << dict_id << " that is not loaded");
+        }
+        // no-dictionary compression
+        dict = make_shared<SCacheBlobDictionary>();
+    }
+    return dict;
+}
+
+
 // constructor
 CCache_blob::CCache_blob(void)
 {
@@ -72,26 +181,237 @@ CCache_blob::~CCache_blob(void)
 }
 
 
+Uint4 CCache_blob::LoadDictionary(const string& file_name)
+{
+    shared_ptr<SCacheBlobDictionary> dict = make_shared<SCacheBlobDictionary>();
+    {{
+        CNcbiIfstream in(file_name.c_str(), IOS_BASE::in | IOS_BASE::binary);
+        if ( !in ) {
+            NCBI_THROW(CASNCacheException, eCantOpenDictionary,
+                       "cannot open zstd dictionary " + file_name);
+        }
+        dict->data.assign(istreambuf_iterator<char>(in),
+                          istreambuf_iterator<char>());
+    }}
+    CChecksum checksum(CChecksum::eCRC32);
+    checksum.AddChars(dict->data.data(), dict->data.size());
+    Uint4 dict_id = checksum.GetChecksum();
+    if ( !dict_id ) {
+        // 0 means no dictionary
+        dict_id = 1;
+    }
+
+    CFastMutexGuard guard(s_DictionariesMutex);
+    shared_ptr<SCacheBlobDictionary>& slot = s_Dictionaries.Get()[dict_id];
+    if ( !slot ) {
+        slot = dict;
+    }
+    return dict_id;
+}
+
+
+void CCache_blob::TrainDictionary(const vector< vector<unsigned char> >& samples,
+                                  const string& file_name,
+                                  size_t dict_size)
+{
+#if defined(HAVE_LIBZSTD)
+    vector<char> samples_data;
+    vector<size_t> sample_sizes;
+    ITERATE ( vector< vector<unsigned char> >, it, samples ) {
+        if ( it->empty() ) {
+            continue;
+        }
+        samples_data.insert(samples_data.end(), it->begin(), it->end());
+        sample_sizes.push_back(it->size());
+    }
+    vector<char> dict(dict_size);
+    size_t size = ZDICT_trainFromBuffer(dict.data(), dict.size(),
+                                        samples_data.data(),
+                                        sample_sizes.data(),
+                                        unsigned(sample_sizes.size()));
+    if ( ZDICT_isError(size) ) {
+        NCBI_THROW(CASNCacheException, eCantOpenDictionary,
+                   string("failed to build zstd dictionary: ") +
+                   ZDICT_getErrorName(size));
+    }
+    CNcbiOfstream out(file_name.c_str(), IOS_BASE::out | IOS_BASE::binary);
+    out.write(dict.data(), size);
+    if ( !out.flush() ) {
+        NCBI_THROW(CASNCacheException, eCantOpenDictionary,
+                   "cannot write zstd dictionary " + file_name);
+    }
+#else
+    NCBI_THROW(CASNCacheException, eUnsupportedBlobFormat,
+               "zstd compression is not available");
+#endif
+}
+
+
+CCache_blob::ECodec CCache_blob::GetCodec(void) const
+{
+    if ( GetMagic() != kMagicNumV2 ) {
+        return eCodec_Zlib;
+    }
+    const TBlob& raw_data = GetBlob();
+    if ( raw_data.size() < kHeaderSize ) {
+        NCBI_THROW_FMT(CASNCacheException, eUnsupportedBlobFormat,
+                       "ASN cache blob of " << raw_data.size() <<
+                       " bytes is too short for its header");
+    }
+    int codec = (unsigned char)raw_data[0];
+    if ( codec != eCodec_Zlib  &&  codec != eCodec_Zstd ) {
+        NCBI_THROW_FMT(CASNCacheException, eUnsupportedBlobFormat,
+                       "unknown ASN cache blob codec " << codec);
+    }
+    return ECodec(codec);
+}
+
+
 void CCache_blob::Pack(const CSeq_entry& entry)
 {
-    CMD5StreamWriter<TBlob> md5_buffer(SetBlob());
+    Pack(entry, eCodec_Zlib);
+}
+
 
+void CCache_blob::Pack(const CSeq_entry& entry, ECodec codec, Uint4 dict_id)
+{
+    if ( codec == eCodec_Zlib ) {
+        // keep writing version 1 blobs for zlib, they are readable by
+        // older versions of the library
+        CMD5StreamWriter<TBlob> md5_buffer(SetBlob());
+
+        {{
+            CWStream flatten_stream(&md5_buffer);
+            CZipStreamCompressor comp;
+            CCompressionOStream compress_stream(flatten_stream, &comp);
+            CObjectOStreamAsnBinary asn_stream(compress_stream);
+            asn_stream << entry;
+            asn_stream.Flush();
+            compress_stream.flush();
+            md5_buffer.Flush();
+        }}
+
+        vector<unsigned char> md5_digest(md5_buffer.GetMD5Sum() );
+        vector<char>& blob_md5_digest = SetMd5_digest();
+        blob_md5_digest.resize(md5_digest.size());
+        memcpy(&blob_md5_digest[0], &md5_digest[0], md5_digest.size());
+        SetMagic(kMagicNum);
+        return;
+    }
+
+    // small entries are compressed in one call, so serialize it first
+    vector<char> raw_data;
     {{
-        CWStream flatten_stream(&md5_buffer);
-        CZipStreamCompressor comp;
-        CCompressionOStream compress_stream(flatten_stream, &comp);
-        CObjectOStreamAsnBinary asn_stream(compress_stream);
+        CBufferWriter< vector<char> > raw_buffer(raw_data, eCreateMode_Truncate);
+        CWStream raw_stream(&raw_buffer);
+        CObjectOStreamAsnBinary asn_stream(raw_stream);
         asn_stream << entry;
         asn_stream.Flush();
-        compress_stream.flush();
-        md5_buffer.Flush();
+        raw_stream.flush();
     }}
+    x_Pack(raw_data.data(), raw_data.size(), codec, dict_id);
+}
+
+
+void CCache_blob::PackRaw(const vector<unsigned char>& raw_bytes,
+                          ECodec codec, Uint4 dict_id)
+{
+    x_Pack((const char*)raw_bytes.data(), raw_bytes.size(), codec, dict_id);
+}
+
+
+void CCache_blob::x_Pack(const char* data, size_t size,
+                         ECodec codec, Uint4 dict_id)
+{
+    CMD5StreamWriter<TBlob> md5_buffer(SetBlob());
+
+    if ( codec == eCodec_Zlib ) {
+        {{
+            CWStream flatten_stream(&md5_buffer);
+            CZipStreamCompressor comp;
+            CCompressionOStream compress_stream(flatten_stream, &comp);
+            compress_stream.write(data, size);
+            compress_stream.flush();
+            md5_buffer.Flush();
+        }}
+        SetMagic(kMagicNum);
+    }
+    else if ( codec == eCodec_Zstd ) {
+#if defined(HAVE_LIBZSTD)
+        shared_ptr<SCacheBlobDictionary> dict = s_GetDictionary(dict_id);
+        unique_ptr<CZstdCompression> compression = dict->GetCompression(true);
+
+        vector<char> buffer(kHeaderSize +
+                            compression->EstimateCompressionBufferSize(size));
+        buffer[0] = char(codec);
+        s_PutNumber(&buffer[1], dict_id, 4);
+        s_PutNumber(&buffer[5], size, 8);
+        size_t compressed_size = 0;
+        if ( !compression->CompressBuffer(data, size,
+                                          &buffer[kHeaderSize],
+                                          buffer.size() - kHeaderSize,
+                                          &compressed_size) ) {
+            NCBI_THROW(CASNCacheException, eUnsupportedBlobFormat,
+                       "zstd compression failed: " +
+                       compression->GetErrorDescription());
+        }
+        dict->PutCompression(true, move(compression));
+        md5_buffer.Write(buffer.data(), kHeaderSize + compressed_size);
+        SetMagic(kMagicNumV2);
+#else
+        NCBI_THROW(CASNCacheException, eUnsupportedBlobFormat,
+                   "zstd compression is not available");
+#endif
+    }
+    else {
+        NCBI_THROW_FMT(CASNCacheException, eUnsupportedBlobFormat,
+                       "unknown ASN cache blob codec " << int(codec));
+    }
 
     vector<unsigned char> md5_digest(md5_buffer.GetMD5Sum() );
     vector<char>& blob_md5_digest = SetMd5_digest();
     blob_md5_digest.resize(md5_digest.size());
     memcpy(&blob_md5_digest[0], &md5_digest[0], md5_digest.size());
-    SetMagic(kMagicNum);
+}
+
+
+void CCache_blob::x_UnPackZstd(vector<unsigned char>& raw_bytes) const
+{
+    const TBlob& raw_data = GetBlob();
+    _ASSERT(GetCodec() == eCodec_Zstd);
+
+#if defined(HAVE_LIBZSTD)
+    Uint4 dict_id = Uint4(s_GetNumber(&raw_data[1], 4));
+    Uint8 size = s_GetNumber(&raw_data[5], 8);
+    const char* data = raw_data.data() + kHeaderSize;
+    size_t data_size = raw_data.size() - kHeaderSize;
+    // the buffer is allocated by the size from the header,
+    // so it must match the size recorded in the zstd frame itself
+    unsigned long long frame_size = ZSTD_getFrameContentSize(data, data_size);
+    if ( frame_size == ZSTD_CONTENTSIZE_UNKNOWN  ||
+         frame_size == ZSTD_CONTENTSIZE_ERROR  ||  frame_size != size ) {
+        NCBI_THROW_FMT(CASNCacheException, eUnsupportedBlobFormat,
+                       "corrupted zstd ASN cache blob: header size " <<
+                       size << " doesn't match the compressed data");
+    }
+    shared_ptr<SCacheBlobDictionary> dict = s_GetDictionary(dict_id);
+    unique_ptr<CZstdCompression> decompression = dict->GetCompression(false);
+
+    raw_bytes.resize(size_t(size));
+    size_t decompressed_size = 0;
+    if ( !decompression->DecompressBuffer(data, data_size,
+                                          raw_bytes.data(), raw_bytes.size(),
+                                          &decompressed_size)  ||
+         decompressed_size != size ) {
+        NCBI_THROW(CASNCacheException, eUnsupportedBlobFormat,
+                   "zstd decompression failed: " +
+                   decompression->GetErrorDescription());
+    }
+    dict->PutCompression(false, move(decompression));
+#else
+    NCBI_THROW(CASNCacheException, eUnsupportedBlobFormat,
+               "zstd compression is not available");
+#endif
 }
 
 
@@ -99,7 +419,20 @@ void CCache_blob::UnPack(CSeq_entry& entry) const
 {
     const TBlob& raw_data = GetBlob();
 
-    istrstream istr(&raw_data[0], raw_data.size() );
+    ECodec codec = GetCodec();
+    if ( codec == eCodec_Zstd ) {
+        vector<unsigned char> raw_bytes;
+        x_UnPackZstd(raw_bytes);
+        unique_ptr<CObjectIStream> asn_str
+            (CObjectIStream::CreateFromBuffer(eSerial_AsnBinary,
+                                              (const char*)raw_bytes.data(),
+                                              raw_bytes.size()));
+        *asn_str >> entry;
+        return;
+    }
+    size_t offset = GetMagic() == kMagicNumV2 ? kHeaderSize : 0;
+
+    istrstream istr(&raw_data[offset], raw_data.size() - offset);
 
     CZipStreamDecompressor decomp;
     CCompressionIStream decomp_str(istr, &decomp);
@@ -112,7 +445,14 @@ void CCache_blob::UnPack(vector<unsigned char>& raw_bytes) const
 {
     const TBlob& raw_data = GetBlob();
 
-    istrstream istr(&raw_data[0], raw_data.size() );
+    ECodec codec = GetCodec();
+    if ( codec == eCodec_Zstd ) {
+        x_UnPackZstd(raw_bytes);
+        return;
+    }
+    size_t offset = GetMagic() == kMagicNumV2 ? kHeaderSize : 0;
+
+    istrstream istr(&raw_data[offset], raw_data.size() - offset);
 
     CZipStreamDecompressor decomp;
     CCompressionIStream decomp_str(istr, &decomp);
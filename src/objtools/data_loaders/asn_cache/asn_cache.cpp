@@ -173,6 +173,12 @@ bool CAsnCache::GetMultipleIndexEntries(const objects::CSeq_id_Handle & id,
     return m_Store->GetMultipleIndexEntries(id, info);
 }
 
+size_t CAsnCache::GetIndexEntries(const vector<objects::CSeq_id_Handle>& ids,
+                                  vector<CAsnIndex::SIndexInfo>& info)
+{
+    return m_Store->GetIndexEntries(ids, info);
+}
+
 
 // AsnCacheStats implementation
 
@@ -84,6 +84,34 @@ CAsnCacheStore::CAsnCacheStore(const string& db_path)
 
     m_Index->Open(main_fname, CBDB_RawFile::eReadOnly);
 
+    /// The sorted index is a snapshot of the BDB one; don't use it if the
+    /// cache was updated since it was built
+    string sorted_fname = NASNCacheFileName::GetSortedIndex(db_path);
+    if (CFile(sorted_fname).Exists()) {
+        CTime main_time, sorted_time;
+        CFile(main_fname).GetTime(&main_time);
+        CFile(sorted_fname).GetTime(&sorted_time);
+        if (sorted_time < main_time) {
+            ERR_POST(Warning << "sorted index " << sorted_fname
+                     << " is older than " << main_fname << ": ignoring it");
+        }
+        else {
+            try {
+                m_SortedIndex.reset(new CAsnSortedIndex(sorted_fname));
+            }
+            catch (CException& e) {
+                ERR_POST(Error << "error opening sorted index: disabling: "
+                         << e);
+                m_SortedIndex.reset();
+            }
+        }
+    }
+
+    string dict_fname = NASNCacheFileName::GetZstdDictionary(db_path);
+    if (CFile(dict_fname).Exists()) {
+        CCache_blob::LoadDictionary(dict_fname);
+    }
+
     string fname = NASNCacheFileName::GetBDBIndex(db_path, CAsnIndex::e_seq_id);
     if (CFile(fname).Exists()) {
         try {
@@ -132,29 +160,74 @@ bool CAsnCacheStore::s_GetChunkAndOffset(const CSeq_id_Handle&   idh,
             break;
         }
 
-        bool should_report = (!version || version == current_info.version) &&
-           (
-            info.empty() || 
-            multiple ||
-            ( (!version &&
-             /// versionless - choose best version and timestamp
-             (info[0].version < current_info.version ||
-              (info[0].version == current_info.version && info[0].timestamp < current_info.timestamp))) ||
-                /// version specified; choose best timestamp for this version
-                    (version && info[0].timestamp < current_info.timestamp))
-           );
-        if (should_report) {
+        if (s_SelectIndexInfo(version, current_info, info, multiple)) {
             was_id_found = true;
-            if (!multiple) {
-                info.clear();
-            }
-            info.push_back(current_info);
         }
     }
 
     return  was_id_found;
 }
 
+bool CAsnCacheStore::s_SelectIndexInfo(CAsnIndex::TVersion              version,
+                                       const CAsnIndex::SIndexInfo&     current_info,
+                                       vector<CAsnIndex::SIndexInfo>&  info,
+                                       bool                             multiple)
+{
+    bool should_report = (!version || version == current_info.version) &&
+       (
+        info.empty() || 
+        multiple ||
+        ( (!version &&
+         /// versionless - choose best version and timestamp
+         (info[0].version < current_info.version ||
+          (info[0].version == current_info.version && info[0].timestamp < current_info.timestamp))) ||
+            /// version specified; choose best timestamp for this version
+                (version && info[0].timestamp < current_info.timestamp))
+       );
+    if (should_report) {
+        if (!multiple) {
+            info.clear();
+        }
+        info.push_back(current_info);
+    }
+    return should_report;
+}
+
+bool CAsnCacheStore::x_GetMainIndexEntries(const CSeq_id_Handle&           idh,
+                                           vector<CAsnIndex::SIndexInfo>&  info,
+                                           bool                            multiple)
+{
+    if ( !m_SortedIndex.get() ) {
+        return s_GetChunkAndOffset(idh, *m_Index, info, multiple);
+    }
+
+    string seq_id;
+    Uint4 version;
+    GetNormalizedSeqId(idh, seq_id, version);
+
+    vector<CAsnIndex::SIndexInfo> found;
+    m_SortedIndex->Find(seq_id, version, found);
+
+    bool was_id_found = false;
+    ITERATE (vector<CAsnIndex::SIndexInfo>, it, found) {
+        if (s_SelectIndexInfo(version, *it, info, multiple)) {
+            was_id_found = true;
+        }
+    }
+    return was_id_found;
+}
+
+bool CAsnCacheStore::x_GetMainIndexEntry(const CSeq_id_Handle&   idh,
+                                         CAsnIndex::SIndexInfo&  info)
+{
+    vector<CAsnIndex::SIndexInfo> info_vector;
+    if (!x_GetMainIndexEntries(idh, info_vector, false)) {
+        return false;
+    }
+    info = info_vector[0];
+    return true;
+}
+
 bool CAsnCacheStore::s_GetChunkAndOffset(const CSeq_id_Handle&   idh,
                                          CAsnIndex&              index,
                                          CAsnIndex::SIndexInfo&  info)
@@ -179,8 +252,8 @@ bool CAsnCacheStore::GetIdInfo(const CSeq_id_Handle& idh,
     /// However, we need to check whether the cache is old-style, without
     /// a SeqId index, and in that case get the info out of the main index
     ///
-    if ( s_GetChunkAndOffset(idh, m_SeqIdIndex.get() ? *m_SeqIdIndex : *m_Index,
-                             info) )
+    if ( m_SeqIdIndex.get() ? s_GetChunkAndOffset(idh, *m_SeqIdIndex, info)
+                            : x_GetMainIndexEntry(idh, info) )
     {
         this_gi = info.gi;
         this_timestamp = info.timestamp;
@@ -264,7 +337,7 @@ bool CAsnCacheStore::GetBlob(const CSeq_id_Handle& idh,
 
     CAsnIndex::SIndexInfo info;
 
-    was_blob_found = s_GetChunkAndOffset(idh, *m_Index, info);
+    was_blob_found = x_GetMainIndexEntry(idh, info);
 
     if (! was_blob_found ) {
         return false;
@@ -312,7 +385,7 @@ bool CAsnCacheStore::GetMultipleBlobs(const CSeq_id_Handle& id,
 {
     vector<CAsnIndex::SIndexInfo> info;
 
-    bool was_blob_found = s_GetChunkAndOffset(id, *m_Index, info, true);
+    bool was_blob_found = x_GetMainIndexEntries(id, info, true);
 
     if (! was_blob_found ) {
         return false;
@@ -389,13 +462,49 @@ vector< CRef<CSeq_entry> > CAsnCacheStore::GetMultipleEntries(const CSeq_id_Hand
 bool CAsnCacheStore::GetIndexEntry( const CSeq_id_Handle& id_handle,
                                     CAsnIndex::SIndexInfo& info )
 {
-    return  s_GetChunkAndOffset(id_handle, *m_Index, info);
+    return  x_GetMainIndexEntry(id_handle, info);
 }
 
 bool CAsnCacheStore::GetMultipleIndexEntries(const objects::CSeq_id_Handle & id,
                                              vector<CAsnIndex::SIndexInfo> &info)
 {
-    return s_GetChunkAndOffset(id, *m_Index, info, true);
+    return x_GetMainIndexEntries(id, info, true);
+}
+
+size_t CAsnCacheStore::GetIndexEntries(const vector<CSeq_id_Handle>& ids,
+                                       vector<CAsnIndex::SIndexInfo>& info)
+{
+    info.clear();
+    info.resize(ids.size());
+
+    size_t count = 0;
+    if ( !m_SortedIndex.get() ) {
+        for (size_t i = 0;  i < ids.size();  ++i) {
+            if (s_GetChunkAndOffset(ids[i], *m_Index, info[i])) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    vector<CAsnSortedIndex::SKey> keys(ids.size());
+    for (size_t i = 0;  i < ids.size();  ++i) {
+        GetNormalizedSeqId(ids[i], keys[i].seq_id, keys[i].version);
+    }
+    vector< vector<CAsnIndex::SIndexInfo> > found;
+    m_SortedIndex->Find(keys, found);
+
+    for (size_t i = 0;  i < ids.size();  ++i) {
+        vector<CAsnIndex::SIndexInfo> best;
+        ITERATE (vector<CAsnIndex::SIndexInfo>, it, found[i]) {
+            s_SelectIndexInfo(keys[i].version, *it, best, false);
+        }
+        if ( !best.empty() ) {
+            info[i] = best[0];
+            ++count;
+        }
+    }
+    return count;
 }
 
 // IAsnCacheStats implementation
@@ -637,6 +746,43 @@ bool CAsnCacheStoreMany::GetMultipleIndexEntries(const objects::CSeq_id_Handle &
     return false;
 }
 
+size_t CAsnCacheStoreMany::GetIndexEntries(const vector<objects::CSeq_id_Handle>& ids,
+                                           vector<CAsnIndex::SIndexInfo>& info)
+{
+    info.clear();
+    info.resize(ids.size());
+
+    /// Ask each store only for the ids not found in the previous ones
+    vector<size_t> missing(ids.size());
+    std::iota(missing.begin(), missing.end(), 0);
+    size_t count = 0;
+    for ( auto const& store: m_Stores ) {
+        if ( missing.empty() ) {
+            break;
+        }
+        vector<objects::CSeq_id_Handle> store_ids;
+        for ( auto i: missing ) {
+            store_ids.push_back(ids[i]);
+        }
+        vector<CAsnIndex::SIndexInfo> store_info;
+        if ( !store->GetIndexEntries(store_ids, store_info) ) {
+            continue;
+        }
+        vector<size_t> still_missing;
+        for (size_t j = 0;  j < missing.size();  ++j) {
+            if ( store_info[j].seq_id.empty() ) {
+                still_missing.push_back(missing[j]);
+            }
+            else {
+                info[missing[j]] = store_info[j];
+                ++count;
+            }
+        }
+        missing.swap(still_missing);
+    }
+    return count;
+}
+
 // IAsnCacheStats implementation
 
 size_t CAsnCacheStoreMany::GetGiCount() const
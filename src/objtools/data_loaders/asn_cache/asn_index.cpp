@@ -43,6 +43,8 @@
 #include <objects/seqfeat/BioSource.hpp>
 #include <objects/seqfeat/Org_ref.hpp>
 
+#include <algorithm>
+
 
 BEGIN_NCBI_SCOPE
 
@@ -194,6 +196,27 @@ CNcbiOstream &operator<<(CNcbiOstream &ostr, const CAsnIndex::SIndexInfo &info)
                     return ostr;
 }
 
+static void s_InsertIndexEntry( CAsnIndex & index,
+                                const CAsnIndex::SIndexInfo & info )
+{
+    index.SetSeqId(info.seq_id);
+    index.SetVersion(info.version);
+    index.SetGi(info.gi);
+    index.SetTimestamp(info.timestamp);
+    index.SetChunkId(info.chunk);
+    index.SetOffset(info.offs);
+    index.SetSize(info.size);
+    index.SetSeqLength(info.sequence_length);
+    index.SetTaxId(info.taxonomy_id);
+
+    if (index.UpdateInsert() != eBDB_Ok) {
+        std::string error_string = "Failed to add seq id ";
+        error_string += info.seq_id + " to " + (index.GetIndexType() == CAsnIndex::e_main ? "main" : "seqid");
+        error_string += " index at " + index.GetFileName();
+        NCBI_THROW( CException, eUnknown, error_string );
+    }
+}
+
 size_t  IndexABioseq( const objects::CBioseq&   bioseq,
                         CAsnIndex &             index,
                         CAsnIndex::TTimestamp   timestamp,
@@ -201,6 +224,22 @@ size_t  IndexABioseq( const objects::CBioseq&   bioseq,
                         CAsnIndex::TOffset      offset,
                         CAsnIndex::TSize        size
                     )
+{
+    vector<CAsnIndex::SIndexInfo> entries;
+    IndexABioseq(bioseq, entries, timestamp, chunk_id, offset, size);
+    ITERATE (vector<CAsnIndex::SIndexInfo>, it, entries) {
+        s_InsertIndexEntry(index, *it);
+    }
+    return  entries.size();
+}
+
+size_t  IndexABioseq( const objects::CBioseq&           bioseq,
+                        vector<CAsnIndex::SIndexInfo> & entries,
+                        CAsnIndex::TTimestamp           timestamp,
+                        CAsnIndex::TChunkId             chunk_id,
+                        CAsnIndex::TOffset              offset,
+                        CAsnIndex::TSize                size
+                    )
 {
     size_t  seqid_count = 0;
     CAsnIndex::TGi gi = 0;
@@ -210,26 +249,16 @@ size_t  IndexABioseq( const objects::CBioseq&   bioseq,
 
     /// Next, extract all the other IDs (including the GI again).
     ITERATE (objects::CBioseq::TId, id_iter, bioseq.GetId()) {
-        string id_str;
-        Uint4 version = 0;
-        GetNormalizedSeqId(**id_iter, id_str, version);
-
-        index.SetSeqId(id_str);
-        index.SetVersion(version);
-        index.SetGi(gi);
-        index.SetTimestamp(timestamp);
-        index.SetChunkId(chunk_id);
-        index.SetOffset(offset);
-        index.SetSize(size);
-        index.SetSeqLength(seq_length);
-        index.SetTaxId(taxid);
-
-        if (index.UpdateInsert() != eBDB_Ok) {
-            std::string error_string = "Failed to add seq id ";
-            error_string += id_str + " to " + (index.GetIndexType() == CAsnIndex::e_main ? "main" : "seqid");
-            error_string += " index at " + index.GetFileName();
-            NCBI_THROW( CException, eUnknown, error_string );
-        }
+        CAsnIndex::SIndexInfo info;
+        GetNormalizedSeqId(**id_iter, info.seq_id, info.version);
+        info.gi = gi;
+        info.timestamp = timestamp;
+        info.chunk = chunk_id;
+        info.offs = offset;
+        info.size = size;
+        info.sequence_length = seq_length;
+        info.taxonomy_id = taxid;
+        entries.push_back(info);
 
         ++seqid_count;
     }
@@ -237,6 +266,29 @@ size_t  IndexABioseq( const objects::CBioseq&   bioseq,
     return  seqid_count;
 }
 
+void    InsertIndexEntries( CAsnIndex &                     index,
+                            vector<CAsnIndex::SIndexInfo> & entries )
+{
+    stable_sort(entries.begin(), entries.end(),
+                [](const CAsnIndex::SIndexInfo& a,
+                   const CAsnIndex::SIndexInfo& b)
+                {
+                    if (a.seq_id != b.seq_id) {
+                        return a.seq_id < b.seq_id;
+                    }
+                    if (a.version != b.version) {
+                        return a.version < b.version;
+                    }
+                    if (a.gi != b.gi) {
+                        return a.gi < b.gi;
+                    }
+                    return a.timestamp < b.timestamp;
+                });
+    ITERATE (vector<CAsnIndex::SIndexInfo>, it, entries) {
+        s_InsertIndexEntry(index, *it);
+    }
+}
+
 void     BioseqIndexData( const objects::CBioseq&   bioseq,
                           CAsnIndex::TGi&           gi,
                           CAsnIndex::TSeqLength&    seq_length,
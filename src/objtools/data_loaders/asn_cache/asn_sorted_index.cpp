@@ -0,0 +1,312 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Immutable, memory-mapped alternative to the BDB main index of the cache
+ *
+ */
+
+#include <ncbi_pch.hpp>
+
+#include <db/bdb/bdb_cursor.hpp>
+
+#include <objtools/data_loaders/asn_cache/asn_sorted_index.hpp>
+#include <objtools/data_loaders/asn_cache/asn_cache_exception.hpp>
+
+#include <algorithm>
+
+
+BEGIN_NCBI_SCOPE
+
+
+typedef pair<Uint8, size_t> TProbe;
+
+/// Also tells whether the file was written with the same byte order
+static const Uint8 kSortedIndexMagic = NCBI_CONST_UINT8(0x4153434e53494458);
+static const Uint4 kSortedIndexVersion = 1;
+
+
+struct CAsnSortedIndex::SHeader
+{
+    Uint8 magic;
+    Uint4 format_version;
+    Uint4 record_size;
+    Uint8 count;
+    Uint8 seq_ids_size;
+};
+
+
+struct CAsnSortedIndex::SRecord
+{
+    Uint8 seq_id_offs;
+    Uint8 gi;
+    Uint8 offs;
+    Uint4 seq_id_size;
+    Uint4 version;
+    Uint4 timestamp;
+    Uint4 chunk;
+    Uint4 size;
+    Uint4 sequence_length;
+    Uint4 taxonomy_id;
+    Uint4 reserved;
+};
+
+
+static size_t s_Align8(size_t size)
+{
+    return (size + 7) & ~size_t(7);
+}
+
+
+Uint8 CAsnSortedIndex::HashSeqId(const CAsnIndex::TSeqId& seq_id)
+{
+    /// 64-bit FNV-1a; it has to stay the same as long as the files exist
+    Uint8 hash = NCBI_CONST_UINT8(14695981039346656037);
+    ITERATE (CAsnIndex::TSeqId, it, seq_id) {
+        hash ^= (unsigned char)*it;
+        hash *= NCBI_CONST_UINT8(1099511628211);
+    }
+    return hash;
+}
+
+
+CAsnSortedIndex::CAsnSortedIndex(const string& file_name)
+    : m_File(file_name),
+      m_Count(0),
+      m_Hashes(0),
+      m_Records(0),
+      m_SeqIds(0),
+      m_SeqIdsSize(0)
+{
+    const char* data = static_cast<const char*>(m_File.GetPtr());
+    size_t file_size = m_File.GetSize();
+    if ( file_size < sizeof(SHeader) ) {
+        NCBI_THROW(CASNCacheException, eBadSortedIndex,
+                   file_name + ": file is too short");
+    }
+    const SHeader* header = reinterpret_cast<const SHeader*>(data);
+    if ( header->magic != kSortedIndexMagic  ||
+         header->format_version != kSortedIndexVersion  ||
+         header->record_size != sizeof(SRecord) ) {
+        NCBI_THROW(CASNCacheException, eBadSortedIndex,
+                   file_name + ": unsupported format");
+    }
+    m_Count = size_t(header->count);
+    m_SeqIdsSize = size_t(header->seq_ids_size);
+
+    size_t hashes_offs = sizeof(SHeader);
+    size_t records_offs = hashes_offs + m_Count * sizeof(Uint8);
+    size_t seq_ids_offs = records_offs + m_Count * sizeof(SRecord);
+    if ( file_size < seq_ids_offs + m_SeqIdsSize ) {
+        NCBI_THROW(CASNCacheException, eBadSortedIndex,
+                   file_name + ": file is truncated");
+    }
+    m_Hashes = reinterpret_cast<const Uint8*>(data + hashes_offs);
+    m_Records = reinterpret_cast<const SRecord*>(data + records_offs);
+    m_SeqIds = data + seq_ids_offs;
+
+    /// Lookups jump all over the file
+    m_File.MemMapAdvise(CMemoryFile::eMMA_Random);
+}
+
+
+size_t CAsnSortedIndex::x_LowerBound(Uint8 hash, size_t from) const
+{
+    /// Branch-free binary search: the loop runs exactly log2(n) times and
+    /// the comparison result only selects the next base, which compiles
+    /// to a conditional move instead of a mispredicted jump
+    const Uint8* base = m_Hashes + from;
+    size_t n = m_Count - from;
+    if ( n == 0 ) {
+        return m_Count;
+    }
+    while ( n > 1 ) {
+        size_t half = n / 2;
+        base = base[half] < hash ? base + half : base;
+        n -= half;
+    }
+    return (base - m_Hashes) + (*base < hash);
+}
+
+
+size_t CAsnSortedIndex::x_Collect(size_t pos, Uint8 hash,
+                                  const CAsnIndex::TSeqId& seq_id,
+                                  CAsnIndex::TVersion version,
+                                  vector<SIndexInfo>& infos) const
+{
+    size_t count = 0;
+    for ( ;  pos < m_Count  &&  m_Hashes[pos] == hash;  ++pos ) {
+        const SRecord& rec = m_Records[pos];
+        if ( rec.version < version  ||
+             rec.seq_id_offs + rec.seq_id_size > m_SeqIdsSize  ||
+             seq_id.size() != rec.seq_id_size  ||
+             memcmp(seq_id.data(), m_SeqIds + rec.seq_id_offs,
+                    rec.seq_id_size) != 0 ) {
+            continue;
+        }
+        infos.push_back(SIndexInfo());
+        SIndexInfo& info = infos.back();
+        info.seq_id = seq_id;
+        info.version = rec.version;
+        info.gi = rec.gi;
+        info.timestamp = rec.timestamp;
+        info.chunk = rec.chunk;
+        info.offs = rec.offs;
+        info.size = rec.size;
+        info.sequence_length = rec.sequence_length;
+        info.taxonomy_id = rec.taxonomy_id;
+        ++count;
+    }
+    return count;
+}
+
+
+size_t CAsnSortedIndex::Find(const CAsnIndex::TSeqId& seq_id,
+                             CAsnIndex::TVersion version,
+                             vector<SIndexInfo>& infos) const
+{
+    Uint8 hash = HashSeqId(seq_id);
+    return x_Collect(x_LowerBound(hash, 0), hash, seq_id, version, infos);
+}
+
+
+void CAsnSortedIndex::Find(const vector<SKey>& keys,
+                           vector< vector<SIndexInfo> >& infos) const
+{
+    infos.clear();
+    infos.resize(keys.size());
+
+    vector<TProbe> order;
+    order.reserve(keys.size());
+    ITERATE (vector<SKey>, it, keys) {
+        order.push_back(make_pair(HashSeqId(it->seq_id), it - keys.begin()));
+    }
+    sort(order.begin(), order.end());
+
+    /// Hashes only grow, so each search starts where the previous ended
+    size_t pos = 0;
+    ITERATE (vector<TProbe>, it, order) {
+        pos = x_LowerBound(it->first, pos);
+        const SKey& key = keys[it->second];
+        x_Collect(pos, it->first, key.seq_id, key.version,
+                  infos[it->second]);
+    }
+}
+
+
+void CAsnSortedIndex::Build(CAsnIndex& index, const string& file_name)
+{
+    if ( index.GetIndexType() != CAsnIndex::e_main ) {
+        NCBI_THROW(CASNCacheException, eBadSortedIndex,
+                   "only the main cache index can be converted");
+    }
+
+    /// Read all entries; the cursor returns them sorted by seq-id, so
+    /// repeated seq-ids share one copy of the string
+    typedef pair<Uint8, SRecord> TEntry;
+    vector<TEntry> entries;
+    string seq_ids;
+    {{
+        CAsnIndex::TSeqId last_seq_id;
+        Uint8 last_offs = 0;
+        CBDB_FileCursor cursor(index);
+        cursor.InitMultiFetch(1 * 1024 * 1024);
+        cursor.SetCondition(CBDB_FileCursor::eFirst, CBDB_FileCursor::eLast);
+        while (cursor.Fetch() == eBDB_Ok) {
+            CAsnIndex::SIndexInfo info(index);
+            if ( entries.empty()  ||  info.seq_id != last_seq_id ) {
+                last_seq_id = info.seq_id;
+                last_offs = seq_ids.size();
+                seq_ids += info.seq_id;
+            }
+            SRecord rec;
+            memset(&rec, 0, sizeof(rec));
+            rec.seq_id_offs = last_offs;
+            rec.seq_id_size = Uint4(info.seq_id.size());
+            rec.version = info.version;
+            rec.gi = info.gi;
+            rec.timestamp = info.timestamp;
+            rec.chunk = info.chunk;
+            rec.offs = info.offs;
+            rec.size = info.size;
+            rec.sequence_length = info.sequence_length;
+            rec.taxonomy_id = info.taxonomy_id;
+            entries.push_back(make_pair(HashSeqId(info.seq_id), rec));
+        }
+    }}
+
+    /// Within one hash, keep the order of the BDB index
+    const string& ids = seq_ids;
+    stable_sort(entries.begin(), entries.end(),
+                [&ids](const TEntry& a, const TEntry& b)
+                {
+                    if ( a.first != b.first ) {
+                        return a.first < b.first;
+                    }
+                    return ids.compare(a.second.seq_id_offs,
+                                       a.second.seq_id_size,
+                                       ids,
+                                       b.second.seq_id_offs,
+                                       b.second.seq_id_size) < 0;
+                });
+
+    SHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = kSortedIndexMagic;
+    header.format_version = kSortedIndexVersion;
+    header.record_size = sizeof(SRecord);
+    header.count = entries.size();
+    header.seq_ids_size = seq_ids.size();
+
+    /// Write to a temporary file, so readers never see a partial index
+    string tmp_name = file_name + ".tmp";
+    {{
+        CNcbiOfstream ostr(tmp_name.c_str(), ios::binary | ios::trunc);
+        ostr.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        ITERATE (vector<TEntry>, it, entries) {
+            ostr.write(reinterpret_cast<const char*>(&it->first),
+                       sizeof(it->first));
+        }
+        ITERATE (vector<TEntry>, it, entries) {
+            ostr.write(reinterpret_cast<const char*>(&it->second),
+                       sizeof(it->second));
+        }
+        ostr.write(seq_ids.data(), seq_ids.size());
+        static const char kPadding[8] = { 0 };
+        ostr.write(kPadding, s_Align8(seq_ids.size()) - seq_ids.size());
+        ostr.flush();
+        if ( !ostr ) {
+            NCBI_THROW(CASNCacheException, eBadSortedIndex,
+                       "failed to write " + tmp_name);
+        }
+    }}
+    if ( !CFile(tmp_name).Rename(file_name, CFile::fRF_Overwrite) ) {
+        NCBI_THROW(CASNCacheException, eBadSortedIndex,
+                   "failed to rename " + tmp_name + " to " + file_name);
+    }
+}
+
+
+END_NCBI_SCOPE
@@ -66,8 +66,27 @@ void    CChunkFile::OpenForWrite( const string & root_path )
         ++m_ChunkSerialNum;
         m_ChunkSize = 0;
     }
-    string file_path = s_MakeChunkFileName( m_OpenFileRootPath, m_ChunkSerialNum );
+    x_OpenStreamForWrite(
+        s_MakeChunkFileName( m_OpenFileRootPath, m_ChunkSerialNum ) );
+}
+
+
+void    CChunkFile::OpenForWrite( const string & root_path,
+                                  unsigned int chunk )
+{
+    string file_path = s_MakeChunkFileName( root_path, chunk );
+    if ( file_path != GetPath() ) {
+        CFile   chunk_file( file_path );
+        m_OpenFileRootPath = root_path;
+        m_ChunkSerialNum = chunk;
+        m_ChunkSize = chunk_file.Exists() ? chunk_file.GetLength() : 0;
+    }
+    x_OpenStreamForWrite( file_path );
+}
+
 
+void    CChunkFile::x_OpenStreamForWrite( const string & file_path )
+{
     if ( file_path != GetPath() ) {
         Reset( file_path );
     
@@ -154,6 +173,26 @@ void    CChunkFile::RawWrite( const char * raw_data, size_t raw_data_size )
 }
 
 
+void    CChunkFile::Flush()
+{
+    if ( ! m_FileStream.is_open() ) {
+        return;
+    }
+    if ( ! m_FileStream.flush() ) {
+        int saved_errno = NCBI_ERRNO_CODE_WRAPPER();
+        string error_string = "Unable to flush chunk file " + GetPath();
+        error_string += " (errno = " + NStr::NumericToString( saved_errno ) + ": ";
+        error_string += string( NCBI_ERRNO_STR_WRAPPER( saved_errno ) +
+                                string( ")" ) );
+        ERR_POST( Error << error_string );
+        NCBI_THROW( CASNCacheException, eCantOpenChunkFile, error_string );
+    }
+    CFileIO file_io;
+    file_io.Open( GetPath(), CFileIO::eOpen, CFileIO::eRead );
+    file_io.Flush();
+}
+
+
 void    CChunkFile::Read( CCache_blob & target_blob, streampos offset,
                           size_t blob_size )
 {
@@ -0,0 +1,238 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:  See parallel_chunk_writer.hpp
+ */
+
+#include <ncbi_pch.hpp>
+
+#include <objtools/data_loaders/asn_cache/Cache_blob.hpp>
+#include <objtools/data_loaders/asn_cache/chunk_file.hpp>
+#include <objtools/data_loaders/asn_cache/parallel_chunk_writer.hpp>
+
+BEGIN_NCBI_SCOPE
+USING_SCOPE(objects);
+
+
+static const Uint8 kProgressInterval = 100000;
+
+
+CParallelChunkWriter::CParallelChunkWriter(const string& root_path,
+                                           unsigned thread_count,
+                                           TCallback callback,
+                                           size_t max_queued)
+    : m_RootPath(root_path),
+      m_Callback(callback),
+      m_MaxQueued(max_queued ? max_queued : 2 * max(thread_count, 1u)),
+      m_Codec(CCache_blob::eCodec_Zlib),
+      m_Dictionary(0),
+      m_Active(0),
+      m_Stop(false),
+      m_FlushRequest(0),
+      m_Flushed(0),
+      m_NextChunk(CChunkFile::s_FindLastChunk(root_path) + 1),
+      m_BlobCount(0),
+      m_ByteCount(0),
+      m_Elapsed(CStopWatch::eStart)
+{
+    for (unsigned i = 0;  i < max(thread_count, 1u);  ++i) {
+        m_Threads.push_back(std::thread(&CParallelChunkWriter::x_Worker,
+                                        this));
+    }
+}
+
+
+CParallelChunkWriter::~CParallelChunkWriter()
+{
+    {{
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }}
+    m_JobAdded.notify_all();
+    NON_CONST_ITERATE (vector<std::thread>, it, m_Threads) {
+        it->join();
+    }
+}
+
+
+void CParallelChunkWriter::SetCodec(CCache_blob::ECodec codec, Uint4 dict_id)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Codec = codec;
+    m_Dictionary = dict_id;
+}
+
+
+void CParallelChunkWriter::Write(CConstRef<CSeq_entry> entry,
+                                 CAsnIndex::TTimestamp timestamp)
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_JobDone.wait(lock, [this] { return m_Queue.size() < m_MaxQueued; });
+    SJob job;
+    job.entry = entry;
+    job.timestamp = timestamp;
+    m_Queue.push_back(job);
+    lock.unlock();
+    m_JobAdded.notify_one();
+}
+
+
+void CParallelChunkWriter::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_JobDone.wait(lock, [this] { return m_Queue.empty()  &&  !m_Active; });
+
+    /// The workers keep their chunk files open; flush them before the
+    /// caller indexes the blobs
+    ++m_FlushRequest;
+    m_Flushed = 0;
+    m_JobAdded.notify_all();
+    m_JobDone.wait(lock, [this] { return m_Flushed == m_Threads.size(); });
+    if (m_Error) {
+        std::exception_ptr error = m_Error;
+        m_Error = std::exception_ptr();
+        std::rethrow_exception(error);
+    }
+}
+
+
+void CParallelChunkWriter::ReportProgress(const char* what) const
+{
+    Uint8 blobs, bytes;
+    {{
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        blobs = m_BlobCount;
+        bytes = m_ByteCount;
+    }}
+    double elapsed = m_Elapsed.Elapsed();
+    double mb = double(bytes) / (1024 * 1024);
+    LOG_POST(Error << "  " << what << " " << blobs << " blobs, "
+             << NStr::DoubleToString(mb, 1) << " MB in "
+             << NStr::DoubleToString(elapsed, 1) << " seconds ("
+             << NStr::DoubleToString(elapsed > 0 ? blobs / elapsed : 0., 1)
+             << " blobs/s, "
+             << NStr::DoubleToString(elapsed > 0 ? mb / elapsed : 0., 2)
+             << " MB/s, " << m_Threads.size() << " threads)");
+}
+
+
+CAsnIndex::TChunkId CParallelChunkWriter::x_AllocateChunk()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    return m_NextChunk++;
+}
+
+
+void CParallelChunkWriter::x_Worker()
+{
+    CChunkFile chunk_file;
+    CAsnIndex::TChunkId chunk = 0;
+    unsigned flush_request = 0;
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for ( ;; ) {
+        m_JobAdded.wait(lock, [&] { return m_Stop  ||  !m_Queue.empty()  ||
+                                           flush_request != m_FlushRequest; });
+        if (flush_request != m_FlushRequest) {
+            flush_request = m_FlushRequest;
+            lock.unlock();
+            std::exception_ptr error;
+            try {
+                chunk_file.Flush();
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+            lock.lock();
+            if (error  &&  !m_Error) {
+                m_Error = error;
+            }
+            ++m_Flushed;
+            m_JobDone.notify_all();
+            continue;
+        }
+        if (m_Queue.empty()) {
+            /// m_Stop is set and there is nothing left to do
+            break;
+        }
+        SJob job = m_Queue.front();
+        m_Queue.pop_front();
+        ++m_Active;
+        bool skip = bool(m_Error);
+        lock.unlock();
+        m_JobDone.notify_all();
+
+        SBlobLocation location;
+        bool done = false;
+        if ( !skip ) {
+            try {
+                CCache_blob blob;
+                blob.SetTimestamp(job.timestamp);
+                blob.Pack(*job.entry, m_Codec, m_Dictionary);
+
+                if ( !chunk  ||  chunk_file.IsFull() ) {
+                    chunk = x_AllocateChunk();
+                    chunk_file.OpenForWrite(m_RootPath, chunk);
+                }
+                location.timestamp = job.timestamp;
+                location.chunk = chunk;
+                location.offset = chunk_file.GetOffset();
+                chunk_file.Write(blob);
+                location.size = CAsnIndex::TSize(chunk_file.GetOffset() -
+                                                 location.offset);
+
+                m_Callback(*job.entry, location);
+                done = true;
+            }
+            catch (...) {
+                lock.lock();
+                if ( !m_Error ) {
+                    m_Error = std::current_exception();
+                }
+                lock.unlock();
+            }
+        }
+
+        /// Release the entry before taking the lock
+        job.entry.Reset();
+        lock.lock();
+        --m_Active;
+        bool report = false;
+        if (done) {
+            ++m_BlobCount;
+            m_ByteCount += location.size;
+            report = m_BlobCount % kProgressInterval == 0;
+        }
+        m_JobDone.notify_all();
+        if (report) {
+            lock.unlock();
+            ReportProgress();
+            lock.lock();
+        }
+    }
+}
+
+
+END_NCBI_SCOPE
@@ -0,0 +1,239 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Unit tests for packing and unpacking of ASN cache blobs.
+*
+* ===========================================================================
+*/
+
+#include <ncbi_pch.hpp>
+
+#include <corelib/ncbifile.hpp>
+#include <util/compress/stream.hpp>
+#include <util/compress/zlib.hpp>
+#include <serial/serial.hpp>
+#include <serial/objistrasnb.hpp>
+#include <objects/seqset/Seq_entry.hpp>
+#include <objects/seq/Bioseq.hpp>
+#include <objects/seq/Seq_inst.hpp>
+#include <objects/seq/Seq_data.hpp>
+#include <objects/seq/IUPACna.hpp>
+#include <objects/seq/Seq_descr.hpp>
+#include <objects/seq/Seqdesc.hpp>
+#include <objects/seqloc/Seq_id.hpp>
+#include <objtools/data_loaders/asn_cache/Cache_blob.hpp>
+#include <objtools/data_loaders/asn_cache/asn_cache_exception.hpp>
+
+#include <strstream>
+
+// This header must be included before all Boost.Test headers if there are any
+#include <corelib/test_boost.hpp>
+
+#include <common/test_assert.h> // This header must go last
+
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+static CRef<CSeq_entry> s_GetEntry(int index)
+{
+    CRef<CSeq_entry> entry(new CSeq_entry);
+    CBioseq& seq = entry->SetSeq();
+    seq.SetId().push_back
+        (Ref(new CSeq_id("lcl|cache_blob" + NStr::IntToString(index))));
+    CRef<CSeqdesc> title(new CSeqdesc);
+    title->SetTitle("Test sequence number " + NStr::IntToString(index));
+    seq.SetDescr().Set().push_back(title);
+    string data;
+    for ( int i = 0; i < 100 + index; ++i ) {
+        data += "ACGT"[(i * 7 + index) % 4];
+    }
+    seq.SetInst().SetRepr(CSeq_inst::eRepr_raw);
+    seq.SetInst().SetMol(CSeq_inst::eMol_dna);
+    seq.SetInst().SetLength(TSeqPos(data.size()));
+    seq.SetInst().SetSeq_data().SetIupacna().Set(data);
+    return entry;
+}
+
+
+// Reads the blob the way the version 1 library did: the blob is a zlib
+// stream of the ASN.1 binary entry, and the magic number isn't checked.
+static void s_UnPackV1(const CCache_blob& blob, CSeq_entry& entry)
+{
+    const CCache_blob::TBlob& raw_data = blob.GetBlob();
+    istrstream istr(&raw_data[0], raw_data.size());
+    CZipStreamDecompressor decomp;
+    CCompressionIStream decomp_str(istr, &decomp);
+    CObjectIStreamAsnBinary asn_str(decomp_str);
+    asn_str >> entry;
+}
+
+
+static void s_CheckRoundTrip(const CCache_blob& blob, const CSeq_entry& entry)
+{
+    CSeq_entry unpacked;
+    blob.UnPack(unpacked);
+    BOOST_CHECK(unpacked.Equals(entry));
+
+    vector<unsigned char> raw_bytes;
+    blob.UnPack(raw_bytes);
+    CNcbiOstrstream ostr;
+    ostr << MSerial_AsnBinary << entry;
+    string raw = CNcbiOstrstreamToString(ostr);
+    BOOST_CHECK(string(raw_bytes.begin(), raw_bytes.end()) == raw);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestPackV1)
+{
+    CRef<CSeq_entry> entry = s_GetEntry(1);
+    CCache_blob blob;
+    blob.SetTimestamp(12345);
+    blob.Pack(*entry);
+
+    // the default is a version 1 blob readable by older libraries
+    BOOST_CHECK_EQUAL(blob.GetMagic(), int(CCache_blob::kMagicNum));
+    BOOST_CHECK_EQUAL(blob.GetCodec(), CCache_blob::eCodec_Zlib);
+    BOOST_CHECK_EQUAL(blob.GetMd5_digest().size(),
+                      size_t(CCache_blob::kMD5Size));
+    s_CheckRoundTrip(blob, *entry);
+
+    CSeq_entry old_unpacked;
+    s_UnPackV1(blob, old_unpacked);
+    BOOST_CHECK(old_unpacked.Equals(*entry));
+
+    // explicit zlib codec is the same version 1 format
+    CCache_blob zlib_blob;
+    zlib_blob.Pack(*entry, CCache_blob::eCodec_Zlib);
+    BOOST_CHECK(zlib_blob.GetBlob() == blob.GetBlob());
+
+    CNcbiOstrstream ostr;
+    ostr << MSerial_AsnBinary << *entry;
+    string raw = CNcbiOstrstreamToString(ostr);
+    CCache_blob raw_blob;
+    raw_blob.PackRaw(vector<unsigned char>(raw.begin(), raw.end()),
+                     CCache_blob::eCodec_Zlib);
+    BOOST_CHECK_EQUAL(raw_blob.GetMagic(), int(CCache_blob::kMagicNum));
+    s_UnPackV1(raw_blob, old_unpacked);
+    BOOST_CHECK(old_unpacked.Equals(*entry));
+}
+
+
+BOOST_AUTO_TEST_CASE(TestBadHeader)
+{
+    CRef<CSeq_entry> entry = s_GetEntry(3);
+    CSeq_entry unpacked;
+    vector<unsigned char> raw_bytes;
+
+    // version 2 blob too short for its header
+    CCache_blob short_blob;
+    short_blob.SetMagic(CCache_blob::kMagicNumV2);
+    short_blob.SetBlob().assign(3, '\1');
+    BOOST_CHECK_THROW(short_blob.GetCodec(), CASNCacheException);
+    BOOST_CHECK_THROW(short_blob.UnPack(unpacked), CASNCacheException);
+    BOOST_CHECK_THROW(short_blob.UnPack(raw_bytes), CASNCacheException);
+
+    // version 2 blob with unknown codec
+    CCache_blob bad_codec_blob;
+    bad_codec_blob.SetMagic(CCache_blob::kMagicNumV2);
+    bad_codec_blob.SetBlob().assign(64, '\0');
+    bad_codec_blob.SetBlob()[0] = 7;
+    BOOST_CHECK_THROW(bad_codec_blob.GetCodec(), CASNCacheException);
+    BOOST_CHECK_THROW(bad_codec_blob.UnPack(unpacked), CASNCacheException);
+    BOOST_CHECK_THROW(bad_codec_blob.UnPack(raw_bytes), CASNCacheException);
+}
+
+
+#if defined(HAVE_LIBZSTD)
+
+BOOST_AUTO_TEST_CASE(TestPackZstd)
+{
+    CRef<CSeq_entry> entry = s_GetEntry(2);
+    CCache_blob blob;
+    blob.Pack(*entry, CCache_blob::eCodec_Zstd);
+    BOOST_CHECK_EQUAL(blob.GetMagic(), int(CCache_blob::kMagicNumV2));
+    BOOST_CHECK_EQUAL(blob.GetCodec(), CCache_blob::eCodec_Zstd);
+    s_CheckRoundTrip(blob, *entry);
+
+    // the version 1 reader can't read the new blobs
+    CSeq_entry old_unpacked;
+    BOOST_CHECK_THROW(s_UnPackV1(blob, old_unpacked), CException);
+
+    // uncompressed size in the header must match the zstd data,
+    // bytes 5..12 of the header keep it
+    CCache_blob bad_size_blob;
+    bad_size_blob.SetMagic(CCache_blob::kMagicNumV2);
+    bad_size_blob.SetBlob() = blob.GetBlob();
+    bad_size_blob.SetBlob()[5] = '\x7f';
+    vector<unsigned char> raw_bytes;
+    BOOST_CHECK_THROW(bad_size_blob.UnPack(raw_bytes), CASNCacheException);
+
+    // truncated zstd data
+    CCache_blob truncated_blob;
+    truncated_blob.SetMagic(CCache_blob::kMagicNumV2);
+    truncated_blob.SetBlob().assign(blob.GetBlob().begin(),
+                                    blob.GetBlob().begin() + 15);
+    BOOST_CHECK_THROW(truncated_blob.UnPack(raw_bytes), CASNCacheException);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestPackZstdDictionary)
+{
+    vector< vector<unsigned char> > samples;
+    for ( int i = 0; i < 500; ++i ) {
+        CNcbiOstrstream ostr;
+        ostr << MSerial_AsnBinary << *s_GetEntry(i);
+        string raw = CNcbiOstrstreamToString(ostr);
+        samples.push_back(vector<unsigned char>(raw.begin(), raw.end()));
+    }
+    CTmpFile dict_file;
+    CCache_blob::TrainDictionary(samples, dict_file.GetFileName(), 4096);
+    Uint4 dict_id = CCache_blob::LoadDictionary(dict_file.GetFileName());
+    BOOST_CHECK(dict_id != 0);
+    // loading the same dictionary again gives the same id
+    BOOST_CHECK_EQUAL(CCache_blob::LoadDictionary(dict_file.GetFileName()),
+                      dict_id);
+
+    CRef<CSeq_entry> entry = s_GetEntry(1000);
+    CCache_blob blob;
+    blob.Pack(*entry, CCache_blob::eCodec_Zstd, dict_id);
+    BOOST_CHECK_EQUAL(blob.GetCodec(), CCache_blob::eCodec_Zstd);
+    s_CheckRoundTrip(blob, *entry);
+
+    CCache_blob raw_blob;
+    raw_blob.PackRaw(samples[0], CCache_blob::eCodec_Zstd, dict_id);
+    vector<unsigned char> raw_bytes;
+    raw_blob.UnPack(raw_bytes);
+    BOOST_CHECK(raw_bytes == samples[0]);
+
+    // blobs are not packed with a dictionary that isn't loaded
+    BOOST_CHECK_THROW(blob.Pack(*entry, CCache_blob::eCodec_Zstd,
+                                dict_id + 1),
+                      CException);
+}
+
+#endif // HAVE_LIBZSTD
@@ -0,0 +1,137 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Unit tests for the chunk writer used by parallel prime_cache.
+*
+* ===========================================================================
+*/
+
+#include <ncbi_pch.hpp>
+
+#include <corelib/ncbifile.hpp>
+#include <objects/seqset/Seq_entry.hpp>
+#include <objects/seq/Bioseq.hpp>
+#include <objects/seq/Seq_inst.hpp>
+#include <objects/seq/Seq_data.hpp>
+#include <objects/seq/IUPACna.hpp>
+#include <objects/seqloc/Seq_id.hpp>
+#include <objtools/data_loaders/asn_cache/Cache_blob.hpp>
+#include <objtools/data_loaders/asn_cache/chunk_file.hpp>
+#include <objtools/data_loaders/asn_cache/parallel_chunk_writer.hpp>
+
+// This header must be included before all Boost.Test headers if there are any
+#include <corelib/test_boost.hpp>
+
+#include <common/test_assert.h> // This header must go last
+
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+static CRef<CSeq_entry> s_GetEntry(int index)
+{
+    CRef<CSeq_entry> entry(new CSeq_entry);
+    CBioseq& seq = entry->SetSeq();
+    seq.SetId().push_back
+        (Ref(new CSeq_id("lcl|chunk_writer" + NStr::IntToString(index))));
+    string data(1000 + index * 10, "ACGT"[index % 4]);
+    seq.SetInst().SetRepr(CSeq_inst::eRepr_raw);
+    seq.SetInst().SetMol(CSeq_inst::eMol_dna);
+    seq.SetInst().SetLength(TSeqPos(data.size()));
+    seq.SetInst().SetSeq_data().SetIupacna().Set(data);
+    return entry;
+}
+
+
+// Writes the entries in several batches as prime_cache does, and after each
+// Wait() reads back every blob reported so far while the workers still
+// keep their chunk files open.
+static void s_TestParallelWrite(unsigned thread_count)
+{
+    string root = CDirEntry::GetTmpName();
+    CDir(root).CreatePath();
+
+    const int kBatchCount = 4;
+    const int kBatchSize = 100;
+    typedef map<string, CParallelChunkWriter::SBlobLocation> TLocations;
+    vector< CRef<CSeq_entry> > entries;
+    TLocations locations;
+    std::mutex locations_mutex;
+    {{
+        CParallelChunkWriter writer
+            (root, thread_count,
+             [&](const CSeq_entry& entry,
+                 const CParallelChunkWriter::SBlobLocation& location)
+             {
+                 std::lock_guard<std::mutex> guard(locations_mutex);
+                 locations[entry.GetSeq().GetFirstId()->AsFastaString()] =
+                     location;
+             });
+        for ( int batch = 0; batch < kBatchCount; ++batch ) {
+            for ( int i = 0; i < kBatchSize; ++i ) {
+                CRef<CSeq_entry> entry = s_GetEntry(batch * kBatchSize + i);
+                entries.push_back(entry);
+                writer.Write(CConstRef<CSeq_entry>(entry), batch + 1);
+            }
+            writer.Wait();
+
+            BOOST_REQUIRE_EQUAL(locations.size(), entries.size());
+            CChunkFile chunk_file;
+            ITERATE ( vector< CRef<CSeq_entry> >, it, entries ) {
+                const CParallelChunkWriter::SBlobLocation& location =
+                    locations[(*it)->GetSeq().GetFirstId()->AsFastaString()];
+                chunk_file.OpenForRead(root, location.chunk);
+                CCache_blob blob;
+                chunk_file.Read(blob, location.offset, location.size);
+                CSeq_entry unpacked;
+                blob.UnPack(unpacked);
+                BOOST_CHECK(unpacked.Equals(**it));
+                BOOST_CHECK_EQUAL(blob.GetTimestamp(), location.timestamp);
+            }
+        }
+    }}
+
+    // each worker writes its own chunk files
+    set<CAsnIndex::TChunkId> chunks;
+    ITERATE ( TLocations, it, locations ) {
+        chunks.insert(it->second.chunk);
+    }
+    BOOST_CHECK(chunks.size() <= thread_count);
+    CDir(root).Remove();
+}
+
+
+BOOST_AUTO_TEST_CASE(TestParallelChunkWriterOneThread)
+{
+    s_TestParallelWrite(1);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestParallelChunkWriterThreads)
+{
+    s_TestParallelWrite(4);
+}
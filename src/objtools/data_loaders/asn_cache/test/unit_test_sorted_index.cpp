@@ -0,0 +1,276 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Unit tests for the memory-mapped sorted main index of the ASN cache.
+*
+* ===========================================================================
+*/
+
+#include <ncbi_pch.hpp>
+
+#include <corelib/ncbifile.hpp>
+#include <corelib/ncbitime.hpp>
+#include <objects/seq/Bioseq.hpp>
+#include <objects/seq/Seq_inst.hpp>
+#include <objects/seqloc/Seq_id.hpp>
+#include <objtools/data_loaders/asn_cache/asn_index.hpp>
+#include <objtools/data_loaders/asn_cache/asn_sorted_index.hpp>
+#include <objtools/data_loaders/asn_cache/asn_cache_store.hpp>
+#include <objtools/data_loaders/asn_cache/asn_cache_util.hpp>
+#include <objtools/data_loaders/asn_cache/file_names.hpp>
+
+#include <algorithm>
+
+// This header must be included before all Boost.Test headers if there are any
+#include <corelib/test_boost.hpp>
+
+#include <common/test_assert.h> // This header must go last
+
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+static const int kVersions = 2;
+
+
+static string s_GetAccession(int index)
+{
+    return "NC_" + NStr::IntToString(100000 + index);
+}
+
+
+static CRef<CBioseq> s_GetBioseq(int index, int version)
+{
+    CRef<CBioseq> seq(new CBioseq);
+    seq->SetId().push_back
+        (Ref(new CSeq_id(s_GetAccession(index) + "." +
+                         NStr::IntToString(version))));
+    seq->SetInst().SetRepr(CSeq_inst::eRepr_raw);
+    seq->SetInst().SetMol(CSeq_inst::eMol_dna);
+    seq->SetInst().SetLength(100 + index);
+    return seq;
+}
+
+
+// Adds all versions of the sequences [from, to) to the BDB main index
+static void s_AddToIndex(const string& root, int from, int to)
+{
+    CAsnIndex index(CAsnIndex::e_main);
+    index.Open(NASNCacheFileName::GetBDBIndex(root, CAsnIndex::e_main),
+               CBDB_RawFile::eReadWriteCreate);
+    for ( int i = from; i < to; ++i ) {
+        for ( int version = 1; version <= kVersions; ++version ) {
+            IndexABioseq(*s_GetBioseq(i, version), index,
+                         1000 + version, i % 3, i * 1000 + version, 100);
+        }
+    }
+}
+
+
+static void s_BuildSortedIndex(const string& root)
+{
+    CAsnIndex index(CAsnIndex::e_main);
+    index.Open(NASNCacheFileName::GetBDBIndex(root, CAsnIndex::e_main),
+               CBDB_RawFile::eReadOnly);
+    CAsnSortedIndex::Build(index, NASNCacheFileName::GetSortedIndex(root));
+}
+
+
+static CAsnIndex::TSeqId s_GetSeqId(int index)
+{
+    CAsnIndex::TSeqId seq_id;
+    CAsnIndex::TVersion version;
+    GetNormalizedSeqId(CSeq_id(s_GetAccession(index)), seq_id, version);
+    return seq_id;
+}
+
+
+static void s_CheckInfo(const CAsnIndex::SIndexInfo& info,
+                        int index, int version)
+{
+    BOOST_CHECK_EQUAL(info.seq_id, s_GetSeqId(index));
+    BOOST_CHECK_EQUAL(info.version, CAsnIndex::TVersion(version));
+    BOOST_CHECK_EQUAL(info.timestamp, CAsnIndex::TTimestamp(1000 + version));
+    BOOST_CHECK_EQUAL(info.chunk, CAsnIndex::TChunkId(index % 3));
+    BOOST_CHECK_EQUAL(info.offs, CAsnIndex::TOffset(index * 1000 + version));
+    BOOST_CHECK_EQUAL(info.size, CAsnIndex::TSize(100));
+    BOOST_CHECK_EQUAL(info.sequence_length,
+                      CAsnIndex::TSeqLength(100 + index));
+}
+
+
+// Sets the modification time of the file to the given offset from now
+static void s_SetTime(const string& file_name, int seconds)
+{
+    CTime time(CTime::eCurrent);
+    time.AddSecond(seconds);
+    BOOST_REQUIRE(CFile(file_name).SetTime(&time, &time));
+}
+
+
+BOOST_AUTO_TEST_CASE(TestSortedIndexFind)
+{
+    const int kCount = 100;
+    string root = CDirEntry::GetTmpName();
+    CDir(root).CreatePath();
+    s_AddToIndex(root, 0, kCount);
+    s_BuildSortedIndex(root);
+
+    CAsnSortedIndex sorted(NASNCacheFileName::GetSortedIndex(root));
+    BOOST_CHECK_EQUAL(sorted.GetSize(), size_t(kCount * kVersions));
+
+    for ( int i = 0; i < kCount; ++i ) {
+        // all versions in the order of the BDB index
+        vector<CAsnIndex::SIndexInfo> infos;
+        BOOST_REQUIRE_EQUAL(sorted.Find(s_GetSeqId(i), 0, infos),
+                            size_t(kVersions));
+        BOOST_REQUIRE_EQUAL(infos.size(), size_t(kVersions));
+        for ( int version = 1; version <= kVersions; ++version ) {
+            s_CheckInfo(infos[version-1], i, version);
+        }
+
+        // versions not less than the given one
+        infos.clear();
+        BOOST_REQUIRE_EQUAL(sorted.Find(s_GetSeqId(i), kVersions, infos), 1u);
+        s_CheckInfo(infos[0], i, kVersions);
+        infos.clear();
+        BOOST_CHECK_EQUAL(sorted.Find(s_GetSeqId(i), kVersions + 1, infos),
+                          0u);
+        BOOST_CHECK(infos.empty());
+    }
+
+    // missing ids, including one that differs only in case
+    vector<CAsnIndex::SIndexInfo> infos;
+    BOOST_CHECK_EQUAL(sorted.Find(s_GetSeqId(kCount), 0, infos), 0u);
+    BOOST_CHECK_EQUAL(sorted.Find(s_GetSeqId(kCount * 10), 0, infos), 0u);
+    BOOST_CHECK_EQUAL(sorted.Find("", 0, infos), 0u);
+    BOOST_CHECK_EQUAL(sorted.Find(NStr::ToUpper(s_GetSeqId(0)), 0, infos),
+                      0u);
+    BOOST_CHECK(infos.empty());
+
+    CDir(root).Remove();
+}
+
+
+BOOST_AUTO_TEST_CASE(TestSortedIndexBatchFind)
+{
+    const int kCount = 200;
+    string root = CDirEntry::GetTmpName();
+    CDir(root).CreatePath();
+    s_AddToIndex(root, 0, kCount);
+    s_BuildSortedIndex(root);
+    CAsnSortedIndex sorted(NASNCacheFileName::GetSortedIndex(root));
+
+    // misses, repeated ids and all version filters in no particular order
+    vector<CAsnSortedIndex::SKey> keys;
+    for ( int i = kCount + 20; i >= 0; i -= 3 ) {
+        keys.push_back(CAsnSortedIndex::SKey(s_GetSeqId(i), i % 4));
+        keys.push_back(CAsnSortedIndex::SKey(s_GetSeqId(i / 2), 0));
+    }
+
+    vector< vector<CAsnIndex::SIndexInfo> > infos;
+    sorted.Find(keys, infos);
+    BOOST_REQUIRE_EQUAL(infos.size(), keys.size());
+
+    size_t found = 0;
+    for ( size_t i = 0; i < keys.size(); ++i ) {
+        vector<CAsnIndex::SIndexInfo> expected;
+        sorted.Find(keys[i].seq_id, keys[i].version, expected);
+        BOOST_REQUIRE_EQUAL(infos[i].size(), expected.size());
+        for ( size_t j = 0; j < expected.size(); ++j ) {
+            BOOST_CHECK_EQUAL(infos[i][j].seq_id, expected[j].seq_id);
+            BOOST_CHECK_EQUAL(infos[i][j].version, expected[j].version);
+            BOOST_CHECK_EQUAL(infos[i][j].offs, expected[j].offs);
+        }
+        if ( !infos[i].empty() ) {
+            ++found;
+        }
+    }
+    BOOST_CHECK(found > 0);
+    BOOST_CHECK(found < keys.size());
+
+    CDir(root).Remove();
+}
+
+
+BOOST_AUTO_TEST_CASE(TestSortedIndexStale)
+{
+    string root = CDirEntry::GetTmpName();
+    CDir(root).CreatePath();
+    string main_fname =
+        NASNCacheFileName::GetBDBIndex(root, CAsnIndex::e_main);
+    string sorted_fname = NASNCacheFileName::GetSortedIndex(root);
+    CSeq_id_Handle old_id =
+        CSeq_id_Handle::GetHandle(CSeq_id(s_GetAccession(5)));
+    CSeq_id_Handle new_id =
+        CSeq_id_Handle::GetHandle(CSeq_id(s_GetAccession(15)));
+    CSeq_id_Handle newer_id =
+        CSeq_id_Handle::GetHandle(CSeq_id(s_GetAccession(25)));
+    CAsnIndex::SIndexInfo info;
+
+    s_AddToIndex(root, 0, 10);
+    s_BuildSortedIndex(root);
+
+    // the cache is updated after the sorted index was built,
+    // so the sorted index is ignored
+    s_AddToIndex(root, 10, 20);
+    s_SetTime(sorted_fname, -20);
+    s_SetTime(main_fname, -10);
+    {{
+        CAsnCacheStore store(root);
+        BOOST_CHECK(store.GetIndexEntry(old_id, info));
+        BOOST_REQUIRE(store.GetIndexEntry(new_id, info));
+        s_CheckInfo(info, 15, kVersions);
+    }}
+
+    // the rebuilt index is used; an entry added to the BDB index
+    // afterwards is not seen while the sorted index is newer
+    s_BuildSortedIndex(root);
+    s_AddToIndex(root, 20, 30);
+    s_SetTime(main_fname, -10);
+    s_SetTime(sorted_fname, 0);
+    {{
+        CAsnCacheStore store(root);
+        BOOST_CHECK(store.GetIndexEntry(old_id, info));
+        BOOST_REQUIRE(store.GetIndexEntry(new_id, info));
+        s_CheckInfo(info, 15, kVersions);
+        BOOST_CHECK(!store.GetIndexEntry(newer_id, info));
+
+        vector<CSeq_id_Handle> ids;
+        ids.push_back(newer_id);
+        ids.push_back(new_id);
+        ids.push_back(old_id);
+        vector<CAsnIndex::SIndexInfo> infos;
+        BOOST_CHECK_EQUAL(store.GetIndexEntries(ids, infos), 2u);
+        BOOST_REQUIRE_EQUAL(infos.size(), 3u);
+        BOOST_CHECK(infos[0].seq_id.empty());
+        s_CheckInfo(infos[1], 15, kVersions);
+        s_CheckInfo(infos[2], 5, kVersions);
+    }}
+
+    CDir(root).Remove();
+}
@@ -51,6 +51,11 @@
 BEGIN_NCBI_SCOPE
 BEGIN_SCOPE(objects)
 
+ICacheBlobWriter::~ICacheBlobWriter(void)
+{
+}
+
+
 CCacheWriter::CCacheWriter(void)
 {
 }
@@ -503,14 +508,36 @@ public:
             *m_Stream << flush;
             if ( !*m_Stream ) {
                 Abort();
+                return;
             }
             m_Stream.reset();
+            // writers with explicit commit store the blob only on Close()
+            if ( ICacheBlobWriter* writer =
+                 dynamic_cast<ICacheBlobWriter*>(m_Writer.get()) ) {
+                try {
+                    writer->Close();
+                }
+                catch ( exception& exc ) {
+                    ERR_POST("Cache:Write: "<<m_Key<<","<<m_Subkey<<","<<
+                             m_Version<<": "<<exc.what());
+                    Abort();
+                    return;
+                }
+            }
             m_Writer.reset();
         }
 
     void Abort(void)
         {
             m_Stream.reset();
+            if ( ICacheBlobWriter* writer =
+                 dynamic_cast<ICacheBlobWriter*>(m_Writer.get()) ) {
+                try {
+                    writer->Abort();
+                }
+                catch ( exception& ) { // ignored
+                }
+            }
             m_Writer.reset();
             Remove();
         }
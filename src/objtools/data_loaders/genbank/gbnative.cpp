@@ -552,6 +552,10 @@ CRef<CPluginManager<CReader> > CGBDataLoader_Native::x_GetReaderManager(void)
         GenBankReaders_Register_Id1();
         GenBankReaders_Register_Id2();
         GenBankReaders_Register_Cache();
+# if (defined(HAVE_LIBLMDB) || defined(USE_LOCAL_LMDB)) && \
+    defined(NCBI_OS_UNIX) && defined(NCBI_THREADS)
+        GenBankReaders_Register_LMDBCache();
+# endif
 # ifdef HAVE_PUBSEQ_OS
         //GenBankReaders_Register_Pubseq();
 # endif
@@ -570,6 +574,10 @@ CRef<CPluginManager<CWriter> > CGBDataLoader_Native::x_GetWriterManager(void)
 #ifdef REGISTER_READER_ENTRY_POINTS
     if ( NCBI_PARAM_TYPE(GENBANK, REGISTER_READERS)::GetDefault() ) {
         GenBankWriters_Register_Cache();
+# if (defined(HAVE_LIBLMDB) || defined(USE_LOCAL_LMDB)) && \
+    defined(NCBI_OS_UNIX) && defined(NCBI_THREADS)
+        GenBankWriters_Register_LMDBCache();
+# endif
     }
 #endif
 
@@ -383,6 +383,14 @@ void CId2Reader::x_InitConnection(CConn_IOStream& stream, TConn conn)
 }
 
 
+bool CId2Reader::x_CanPipelinePackets(void) const
+{
+    // the service stream is a persistent connection,
+    // replies are matched to requests by serial numbers
+    return true;
+}
+
+
 void CId2Reader::x_SendPacket(TConn conn, const CID2_Request_Packet& packet)
 {
     CConn_IOStream& stream = *x_GetConnection(conn);
@@ -0,0 +1,975 @@
+/*  $Id$
+ * ===========================================================================
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ *  File Description: ICache over LMDB environment shared by processes
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include "lmdb_cache.hpp"
+#include <objtools/data_loaders/genbank/lmdbcache/reader_lmdbcache_params.h>
+#include <objmgr/objmgr_exception.hpp>
+#include <corelib/ncbifile.hpp>
+#include <corelib/reader_writer.hpp>
+#include <objtools/data_loaders/genbank/cache/writer_cache.hpp>
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects)
+
+
+static const MDB_dbi kMaxDbCount = 16;
+
+/////////////////////////////////////////////////////////////////////////////
+// CGBLMDBEnv
+
+
+DEFINE_STATIC_FAST_MUTEX(s_EnvMutex);
+
+
+CRef<CGBLMDBEnv> CGBLMDBEnv::GetEnv(const string& path,
+                                    Uint8 map_size,
+                                    unsigned max_readers)
+{
+    // LMDB environment must be opened only once in a process
+    typedef map<string, CRef<CGBLMDBEnv> > TEnvs;
+    static CSafeStatic<TEnvs> s_Envs;
+    string abs_path =
+        CDirEntry::NormalizePath(CDirEntry::CreateAbsolutePath(path));
+    CFastMutexGuard guard(s_EnvMutex);
+    CRef<CGBLMDBEnv>& env = s_Envs.Get()[abs_path];
+    if ( !env ) {
+        env = new CGBLMDBEnv(abs_path, map_size, max_readers);
+    }
+    return env;
+}
+
+
+CGBLMDBEnv::CGBLMDBEnv(const string& path,
+                       Uint8 map_size,
+                       unsigned max_readers)
+    : m_Path(path),
+      m_Env(lmdb::env::create())
+{
+    CDir(m_Path).CreatePath();
+    m_Env.set_max_dbs(kMaxDbCount);
+    m_Env.set_max_readers(max_readers);
+    m_Env.set_mapsize(size_t(map_size));
+    // Cache content can be always reloaded from the data source,
+    // so durability is traded for write speed.
+    // Read transactions are not bound to threads because IReader
+    // of a blob may be consumed by another thread.
+    m_Env.open(m_Path.c_str(),
+               MDB_NOSYNC | MDB_NOMETASYNC | MDB_NOTLS | MDB_NORDAHEAD,
+               0664);
+}
+
+
+CGBLMDBEnv::~CGBLMDBEnv(void)
+{
+}
+
+
+const CGBLMDBEnv::SDbis& CGBLMDBEnv::GetDbis(const string& name)
+{
+    CFastMutexGuard guard(m_DbisMutex);
+    map<string, SDbis>::iterator it = m_Dbis.find(name);
+    if ( it != m_Dbis.end() ) {
+        return it->second;
+    }
+    lmdb::txn txn = lmdb::txn::begin(m_Env, nullptr, 0);
+    SDbis dbis;
+    dbis.m_Data = lmdb::dbi::open(txn, (name+"_data").c_str(), MDB_CREATE);
+    dbis.m_Versions = lmdb::dbi::open(txn, (name+"_versions").c_str(),
+                                      MDB_CREATE);
+    txn.commit();
+    return m_Dbis[name] = dbis;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// record encoding
+
+
+static inline
+void s_StoreUint4(char* ptr, Uint4 v)
+{
+    ptr[0] = char(v>>24);
+    ptr[1] = char(v>>16);
+    ptr[2] = char(v>>8);
+    ptr[3] = char(v);
+}
+
+
+static inline
+Uint4 s_ParseUint4(const char* ptr)
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(ptr);
+    return (Uint4(p[0])<<24)|(Uint4(p[1])<<16)|(Uint4(p[2])<<8)|Uint4(p[3]);
+}
+
+
+// All records of key/subkey pair share this prefix,
+// it is also the key of the current version record.
+static inline
+string s_MakePrefix(const string& key, const string& subkey)
+{
+    string ret;
+    ret.reserve(key.size()+subkey.size()+2+4);
+    ret += key;
+    ret += '\0';
+    ret += subkey;
+    ret += '\0';
+    return ret;
+}
+
+
+// Big-endian version keeps versions of the same blob in order.
+static inline
+string s_MakeKey(const string& key,
+                 ICache::TBlobVersion version,
+                 const string& subkey)
+{
+    string ret = s_MakePrefix(key, subkey);
+    char buf[4];
+    s_StoreUint4(buf, Uint4(version));
+    ret.append(buf, 4);
+    return ret;
+}
+
+
+static inline
+Uint4 s_Now(void)
+{
+    return Uint4(time(0));
+}
+
+
+static inline
+bool s_HasPrefix(const MDB_val& key, const string& prefix)
+{
+    return key.mv_size >= prefix.size() &&
+        memcmp(key.mv_data, prefix.data(), prefix.size()) == 0;
+}
+
+
+static inline
+MDB_val s_Val(const string& str)
+{
+    MDB_val val;
+    val.mv_size = str.size();
+    val.mv_data = const_cast<char*>(str.data());
+    return val;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// blob streams
+
+
+namespace {
+
+    // Write transaction.  Unlike lmdb::txn it doesn't abort the transaction
+    // after a failed commit, LMDB frees the transaction itself in that case.
+    class CLMDBWriteTxn
+    {
+    public:
+        explicit CLMDBWriteTxn(MDB_env* env)
+            : m_Txn(0)
+            {
+                lmdb::txn_begin(env, nullptr, 0, &m_Txn);
+            }
+        ~CLMDBWriteTxn(void)
+            {
+                if ( m_Txn ) {
+                    lmdb::txn_abort(m_Txn);
+                }
+            }
+
+        operator MDB_txn*(void) const
+            {
+                return m_Txn;
+            }
+
+        void Commit(void)
+            {
+                MDB_txn* txn = m_Txn;
+                m_Txn = 0;
+                lmdb::txn_commit(txn);
+            }
+
+    private:
+        CLMDBWriteTxn(const CLMDBWriteTxn&);
+        void operator=(const CLMDBWriteTxn&);
+
+        MDB_txn* m_Txn;
+    };
+
+    // Reads blob data directly from the memory map,
+    // the read transaction keeps the data pages alive.
+    class CLMDBBlobReader : public IReader
+    {
+    public:
+        CLMDBBlobReader(lmdb::txn&& txn, const char* data, size_t size)
+            : m_Txn(move(txn)), m_Ptr(data), m_Size(size)
+            {
+            }
+        ~CLMDBBlobReader(void)
+            {
+                m_Txn.abort();
+            }
+
+        virtual ERW_Result Read(void* buf,
+                                size_t count,
+                                size_t* bytes_read = 0)
+            {
+                if ( !m_Size ) {
+                    if ( bytes_read ) {
+                        *bytes_read = 0;
+                    }
+                    return eRW_Eof;
+                }
+                count = min(count, m_Size);
+                memcpy(buf, m_Ptr, count);
+                if ( bytes_read ) {
+                    *bytes_read = count;
+                }
+                m_Ptr += count;
+                m_Size -= count;
+                return eRW_Success;
+            }
+        virtual ERW_Result PendingCount(size_t* count)
+            {
+                *count = m_Size;
+                return eRW_Success;
+            }
+
+    private:
+        lmdb::txn   m_Txn;
+        const char* m_Ptr;
+        size_t      m_Size;
+    };
+
+
+    // Collects blob data and stores it in one write transaction
+    // when the writer is closed.  Data of a writer destroyed without
+    // Close() is discarded, so an aborted or failed write never leaves
+    // a truncated blob in the cache.
+    class CLMDBBlobWriter : public ICacheBlobWriter
+    {
+    public:
+        CLMDBBlobWriter(ICache& cache,
+                        const string& key,
+                        ICache::TBlobVersion version,
+                        const string& subkey)
+            : m_Cache(cache),
+              m_Key(key),
+              m_Version(version),
+              m_Subkey(subkey),
+              m_Closed(false)
+            {
+            }
+        ~CLMDBBlobWriter(void)
+            {
+                if ( !m_Closed ) {
+                    _TRACE("CGBLMDBCache: discarded unclosed blob "<<
+                           m_Key<<","<<m_Subkey<<","<<m_Version);
+                }
+            }
+
+        virtual void Close(void)
+            {
+                if ( m_Closed ) {
+                    return;
+                }
+                m_Closed = true;
+                m_Cache.Store(m_Key, m_Version, m_Subkey,
+                              m_Data.data(), m_Data.size());
+                m_Data.clear();
+            }
+        virtual void Abort(void)
+            {
+                m_Closed = true;
+                m_Data.clear();
+            }
+
+        virtual ERW_Result Write(const void* buf,
+                                 size_t count,
+                                 size_t* bytes_written = 0)
+            {
+                if ( m_Closed ) {
+                    return eRW_Error;
+                }
+                m_Data.append(static_cast<const char*>(buf), count);
+                if ( bytes_written ) {
+                    *bytes_written = count;
+                }
+                return eRW_Success;
+            }
+        virtual ERW_Result Flush(void)
+            {
+                return eRW_Success;
+            }
+
+    private:
+        ICache&                 m_Cache;
+        string                  m_Key;
+        ICache::TBlobVersion    m_Version;
+        string                  m_Subkey;
+        string                  m_Data;
+        bool                    m_Closed;
+    };
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// CGBLMDBCache
+
+
+CGBLMDBCache::CGBLMDBCache(CGBLMDBEnv& env, const string& name, int timeout)
+    : m_Env(&env),
+      m_Name(name),
+      m_Dbis(env.GetDbis(name)),
+      m_MaxKeySize(mdb_env_get_maxkeysize(env.GetHandle())),
+      m_Flags(fBestPerformance),
+      m_TimeStampPolicy(fTimeStampOnCreate),
+      m_Timeout(timeout),
+      m_VersionRetention(eKeepAll)
+{
+}
+
+
+CGBLMDBCache::~CGBLMDBCache(void)
+{
+}
+
+
+ICache::TFlags CGBLMDBCache::GetFlags(void)
+{
+    return m_Flags;
+}
+
+
+void CGBLMDBCache::SetFlags(TFlags flags)
+{
+    m_Flags = flags;
+}
+
+
+void CGBLMDBCache::SetTimeStampPolicy(TTimeStampFlags policy,
+                                      unsigned int    timeout,
+                                      unsigned int    /*max_timeout*/)
+{
+    m_TimeStampPolicy = policy;
+    m_Timeout = timeout;
+}
+
+
+ICache::TTimeStampFlags CGBLMDBCache::GetTimeStampPolicy(void) const
+{
+    return m_TimeStampPolicy;
+}
+
+
+int CGBLMDBCache::GetTimeout(void) const
+{
+    return m_Timeout;
+}
+
+
+bool CGBLMDBCache::IsOpen(void) const
+{
+    return true;
+}
+
+
+void CGBLMDBCache::SetVersionRetention(EKeepVersions policy)
+{
+    m_VersionRetention = policy;
+}
+
+
+ICache::EKeepVersions CGBLMDBCache::GetVersionRetention(void) const
+{
+    return m_VersionRetention;
+}
+
+
+lmdb::txn CGBLMDBCache::x_BeginRead(void) const
+{
+    return lmdb::txn::begin(m_Env->GetHandle(), nullptr, MDB_RDONLY);
+}
+
+
+bool CGBLMDBCache::x_IsExpired(TTime time, TTime now) const
+{
+    return m_Timeout > 0 && now > time && now - time > TTime(m_Timeout);
+}
+
+
+bool CGBLMDBCache::x_Get(MDB_txn* txn,
+                         const string& key,
+                         TBlobVersion version,
+                         const string& subkey,
+                         SRecord& record) const
+{
+    string db_key = s_MakeKey(key, version, subkey);
+    if ( db_key.size() > m_MaxKeySize ) {
+        return false;
+    }
+    MDB_val db_key_val = s_Val(db_key), data;
+    if ( !lmdb::dbi_get(txn, m_Dbis.m_Data, &db_key_val, &data) ||
+         data.mv_size < sizeof(TTime) ) {
+        return false;
+    }
+    const char* ptr = static_cast<const char*>(data.mv_data);
+    record.m_Time = s_ParseUint4(ptr);
+    record.m_Data = ptr + sizeof(TTime);
+    record.m_Size = data.mv_size - sizeof(TTime);
+    return !x_IsExpired(record.m_Time, s_Now());
+}
+
+
+bool CGBLMDBCache::x_GetCurrentVersion(MDB_txn* txn,
+                                       const string& key,
+                                       const string& subkey,
+                                       TBlobVersion& version,
+                                       TTime& time) const
+{
+    string db_key = s_MakePrefix(key, subkey);
+    if ( db_key.size() > m_MaxKeySize ) {
+        return false;
+    }
+    MDB_val db_key_val = s_Val(db_key), data;
+    if ( !lmdb::dbi_get(txn, m_Dbis.m_Versions, &db_key_val, &data) ||
+         data.mv_size != 2*sizeof(Uint4) ) {
+        return false;
+    }
+    const char* ptr = static_cast<const char*>(data.mv_data);
+    version = TBlobVersion(s_ParseUint4(ptr));
+    time = s_ParseUint4(ptr+sizeof(Uint4));
+    return true;
+}
+
+
+void CGBLMDBCache::x_Store(MDB_txn* txn,
+                           const string& key,
+                           TBlobVersion version,
+                           const string& subkey,
+                           const void* data,
+                           size_t size,
+                           TTime now)
+{
+    string prefix = s_MakePrefix(key, subkey);
+    string db_key = s_MakeKey(key, version, subkey);
+    if ( db_key.size() > m_MaxKeySize ) {
+        // too long keys are not cached
+        return;
+    }
+    if ( m_VersionRetention != eKeepAll ) {
+        x_DropVersions(txn, prefix, version);
+    }
+    MDB_val db_key_val = s_Val(db_key);
+    MDB_val db_data;
+    db_data.mv_size = sizeof(TTime)+size;
+    db_data.mv_data = 0;
+    // reserve space in the map and copy data directly into it
+    lmdb::dbi_put(txn, m_Dbis.m_Data, &db_key_val, &db_data, MDB_RESERVE);
+    char* ptr = static_cast<char*>(db_data.mv_data);
+    s_StoreUint4(ptr, now);
+    if ( size ) {
+        memcpy(ptr+sizeof(TTime), data, size);
+    }
+
+    // storing an older version doesn't replace the current one,
+    // it's changed explicitly by SetBlobVersionAsCurrent()
+    TBlobVersion current_version;
+    TTime current_time;
+    if ( !x_GetCurrentVersion(txn, key, subkey,
+                              current_version, current_time) ||
+         current_version <= version ) {
+        x_SetCurrentVersion(txn, prefix, version, now);
+    }
+}
+
+
+void CGBLMDBCache::x_SetCurrentVersion(MDB_txn* txn,
+                                       const string& prefix,
+                                       TBlobVersion version,
+                                       TTime now)
+{
+    char ver_buf[2*sizeof(Uint4)];
+    s_StoreUint4(ver_buf, Uint4(version));
+    s_StoreUint4(ver_buf+sizeof(Uint4), now);
+    MDB_val ver_key_val = s_Val(prefix);
+    MDB_val ver_data;
+    ver_data.mv_size = sizeof(ver_buf);
+    ver_data.mv_data = ver_buf;
+    lmdb::dbi_put(txn, m_Dbis.m_Versions, &ver_key_val, &ver_data, 0);
+}
+
+
+void CGBLMDBCache::x_DropVersions(MDB_txn* txn,
+                                  const string& prefix,
+                                  TBlobVersion version)
+{
+    lmdb::cursor cursor = lmdb::cursor::open(txn, m_Dbis.m_Data);
+    MDB_val key = s_Val(prefix), data;
+    bool found = cursor.get(&key, &data, MDB_SET_RANGE);
+    for ( ; found && s_HasPrefix(key, prefix);
+          found = cursor.get(&key, &data, MDB_NEXT) ) {
+        if ( key.mv_size != prefix.size()+sizeof(Uint4) ) {
+            continue;
+        }
+        TBlobVersion v = TBlobVersion(
+            s_ParseUint4(static_cast<const char*>(key.mv_data)+prefix.size()));
+        if ( v == version ||
+             (m_VersionRetention == eDropOlder && v > version) ) {
+            continue;
+        }
+        lmdb::cursor_del(cursor, 0);
+    }
+}
+
+
+void CGBLMDBCache::x_Purge(MDB_txn* txn,
+                           const string& prefix,
+                           TTime min_time)
+{
+    MDB_dbi dbis[2] = { m_Dbis.m_Data, m_Dbis.m_Versions };
+    for ( size_t i = 0; i < 2; ++i ) {
+        // records start with time, version records have it after version
+        size_t time_offset = i == 0? 0: sizeof(Uint4);
+        lmdb::cursor cursor = lmdb::cursor::open(txn, dbis[i]);
+        MDB_val key = s_Val(prefix), data;
+        bool found = prefix.empty()?
+            cursor.get(&key, &data, MDB_FIRST):
+            cursor.get(&key, &data, MDB_SET_RANGE);
+        for ( ; found && s_HasPrefix(key, prefix);
+              found = cursor.get(&key, &data, MDB_NEXT) ) {
+            if ( data.mv_size < time_offset+sizeof(TTime) ||
+                 s_ParseUint4(static_cast<const char*>(data.mv_data)+
+                              time_offset) < min_time ) {
+                lmdb::cursor_del(cursor, 0);
+            }
+        }
+    }
+}
+
+
+void CGBLMDBCache::Store(const string&  key,
+                         TBlobVersion   version,
+                         const string&  subkey,
+                         const void*    data,
+                         size_t         size,
+                         unsigned int   /*time_to_live*/,
+                         const string&  /*owner*/)
+{
+    TTime now = s_Now();
+    MDB_envinfo info;
+    mdb_env_info(m_Env->GetHandle(), &info);
+    size_t record_size = key.size()+subkey.size()+sizeof(TTime)+size;
+    if ( record_size >= info.me_mapsize/2 ) {
+        // blobs too big for the map are skipped without evicting anything
+        ERR_POST(Warning<<"CGBLMDBCache("<<m_Name<<"): "
+                 "blob "<<key<<","<<subkey<<","<<version<<
+                 " of "<<size<<" bytes doesn't fit in the map");
+        return;
+    }
+    // The oldest records are evicted before the map is full because
+    // LMDB needs free pages even to delete records.  Eviction is committed
+    // separately so that the blob can reuse the freed pages.
+    size_t evict_size = max(2*record_size, size_t(info.me_mapsize/8));
+    bool evicted = false;
+    try {
+        if ( x_IsAlmostFull(record_size) ) {
+            x_EvictOldest(evict_size);
+        }
+        for ( ;; ) {
+            try {
+                CLMDBWriteTxn txn(m_Env->GetHandle());
+                x_Store(txn, key, version, subkey, data, size, now);
+                txn.Commit();
+                return;
+            }
+            catch ( lmdb::map_full_error& ) {
+                // free pages may be still used by old read transactions,
+                // or too fragmented for the blob
+                if ( evicted ) {
+                    throw;
+                }
+            }
+            x_EvictOldest(evict_size);
+            evicted = true;
+        }
+    }
+    catch ( lmdb::map_full_error& ) {
+        ERR_POST(Warning<<"CGBLMDBCache("<<m_Name<<"): "
+                 "map is full, blob "<<key<<","<<subkey<<","<<
+                 version<<" is not stored");
+    }
+}
+
+
+bool CGBLMDBCache::x_IsAlmostFull(size_t size) const
+{
+    MDB_envinfo info;
+    mdb_env_info(m_Env->GetHandle(), &info);
+    MDB_stat stat;
+    mdb_env_stat(m_Env->GetHandle(), &stat);
+    size_t reserve = info.me_mapsize/8;
+    size_t pages = info.me_last_pgno+1;
+    if ( pages*stat.ms_psize + size + reserve <= info.me_mapsize ) {
+        return false;
+    }
+    // pages listed in the free page table can be reused,
+    // its records are page lists starting with the page count
+    lmdb::txn txn = x_BeginRead();
+    lmdb::cursor cursor = lmdb::cursor::open(txn, 0);
+    MDB_val key, data;
+    for ( bool found = cursor.get(&key, &data, MDB_FIRST); found;
+          found = cursor.get(&key, &data, MDB_NEXT) ) {
+        size_t count; // MDB_ID
+        memcpy(&count, data.mv_data, sizeof(count));
+        pages -= min(pages, size_t(count));
+    }
+    return pages*stat.ms_psize + size + reserve > info.me_mapsize;
+}
+
+
+void CGBLMDBCache::x_EvictOldest(size_t size)
+{
+    CLMDBWriteTxn txn(m_Env->GetHandle());
+    // creation time and size of all blob records
+    typedef pair<TTime, size_t> TAge;
+    vector<TAge> ages;
+    {{
+        lmdb::cursor cursor = lmdb::cursor::open(txn, m_Dbis.m_Data);
+        MDB_val key, data;
+        for ( bool found = cursor.get(&key, &data, MDB_FIRST); found;
+              found = cursor.get(&key, &data, MDB_NEXT) ) {
+            TTime time = data.mv_size < sizeof(TTime)? 0:
+                s_ParseUint4(static_cast<const char*>(data.mv_data));
+            ages.push_back(TAge(time, key.mv_size+data.mv_size));
+        }
+    }}
+    sort(ages.begin(), ages.end());
+    size_t count = 0, freed = 0;
+    while ( count < ages.size() && freed < size ) {
+        freed += ages[count++].second;
+    }
+    if ( !count ) {
+        return;
+    }
+    // records older than the cutoff time are evicted, and records
+    // created at the cutoff time are evicted in key order
+    TTime cutoff = ages[count-1].first;
+    size_t cutoff_count = count -
+        (lower_bound(ages.begin(), ages.end(), TAge(cutoff, 0)) -
+         ages.begin());
+    ages.clear();
+
+    lmdb::cursor cursor = lmdb::cursor::open(txn, m_Dbis.m_Data);
+    MDB_val key, data;
+    for ( bool found = cursor.get(&key, &data, MDB_FIRST);
+          found && count; // anything left to evict
+          found = cursor.get(&key, &data, MDB_NEXT) ) {
+        TTime time = data.mv_size < sizeof(TTime)? 0:
+            s_ParseUint4(static_cast<const char*>(data.mv_data));
+        if ( time > cutoff || (time == cutoff && !cutoff_count) ) {
+            continue;
+        }
+        if ( time == cutoff ) {
+            --cutoff_count;
+        }
+        --count;
+        // the current version record of evicted blob is evicted too
+        if ( key.mv_size > sizeof(Uint4) ) {
+            MDB_val ver_key = key, ver_data;
+            ver_key.mv_size -= sizeof(Uint4);
+            const char* version =
+                static_cast<const char*>(key.mv_data)+ver_key.mv_size;
+            if ( lmdb::dbi_get(txn, m_Dbis.m_Versions, &ver_key, &ver_data) &&
+                 ver_data.mv_size == 2*sizeof(Uint4) &&
+                 memcmp(ver_data.mv_data, version, sizeof(Uint4)) == 0 ) {
+                lmdb::dbi_del(txn, m_Dbis.m_Versions, &ver_key, 0);
+            }
+        }
+        lmdb::cursor_del(cursor, 0);
+    }
+    cursor.close();
+    txn.Commit();
+    _TRACE("CGBLMDBCache("<<m_Name<<"): evicted "<<freed<<" bytes");
+}
+
+
+size_t CGBLMDBCache::GetSize(const string&  key,
+                             TBlobVersion   version,
+                             const string&  subkey)
+{
+    lmdb::txn txn = x_BeginRead();
+    SRecord record;
+    if ( !x_Get(txn, key, version, subkey, record) ) {
+        return 0;
+    }
+    return record.m_Size;
+}
+
+
+void CGBLMDBCache::GetBlobOwner(const string&  /*key*/,
+                                TBlobVersion   /*version*/,
+                                const string&  /*subkey*/,
+                                string*        owner)
+{
+    _ASSERT(owner);
+    owner->erase();
+}
+
+
+bool CGBLMDBCache::Read(const string& key,
+                        TBlobVersion  version,
+                        const string& subkey,
+                        void*         buf,
+                        size_t        buf_size)
+{
+    lmdb::txn txn = x_BeginRead();
+    SRecord record;
+    if ( !x_Get(txn, key, version, subkey, record) ) {
+        return false;
+    }
+    if ( record.m_Size > buf_size ) {
+        NCBI_THROW(CLoaderException, eLoaderFailed,
+                   "CGBLMDBCache::Read: insufficient buffer size");
+    }
+    memcpy(buf, record.m_Data, record.m_Size);
+    return true;
+}
+
+
+IReader* CGBLMDBCache::GetReadStream(const string&  key,
+                                     TBlobVersion   version,
+                                     const string&  subkey)
+{
+    lmdb::txn txn = x_BeginRead();
+    SRecord record;
+    if ( !x_Get(txn, key, version, subkey, record) ) {
+        return 0;
+    }
+    return new CLMDBBlobReader(move(txn), record.m_Data, record.m_Size);
+}
+
+
+IReader* CGBLMDBCache::GetReadStream(const string&         key,
+                                     const string&         subkey,
+                                     TBlobVersion*         version,
+                                     EBlobVersionValidity* validity)
+{
+    lmdb::txn txn = x_BeginRead();
+    TBlobVersion current_version;
+    TTime time;
+    SRecord record;
+    if ( !x_GetCurrentVersion(txn, key, subkey, current_version, time) ||
+         !x_Get(txn, key, current_version, subkey, record) ) {
+        return 0;
+    }
+    if ( version ) {
+        *version = current_version;
+    }
+    if ( validity ) {
+        *validity = x_IsExpired(time, s_Now())? eExpired: eCurrent;
+    }
+    return new CLMDBBlobReader(move(txn), record.m_Data, record.m_Size);
+}
+
+
+void CGBLMDBCache::SetBlobVersionAsCurrent(const string&  key,
+                                           const string&  subkey,
+                                           TBlobVersion   version)
+{
+    string prefix = s_MakePrefix(key, subkey);
+    if ( prefix.size() > m_MaxKeySize ) {
+        return;
+    }
+    CLMDBWriteTxn txn(m_Env->GetHandle());
+    x_SetCurrentVersion(txn, prefix, version, s_Now());
+    txn.Commit();
+}
+
+
+void CGBLMDBCache::GetBlobAccess(const string&     key,
+                                 TBlobVersion      version,
+                                 const string&     subkey,
+                                 SBlobAccessDescr* blob_descr)
+{
+    blob_descr->reader.reset();
+    blob_descr->blob_size = 0;
+    blob_descr->blob_found = false;
+
+    lmdb::txn txn = x_BeginRead();
+    TTime now = s_Now();
+    TTime time = 0;
+    if ( blob_descr->return_current_version ) {
+        blob_descr->return_current_version_supported = true;
+        if ( !x_GetCurrentVersion(txn, key, subkey, version, time) ) {
+            return;
+        }
+        blob_descr->current_version = version;
+        blob_descr->current_version_validity =
+            x_IsExpired(time, now)? eExpired: eCurrent;
+    }
+    SRecord record;
+    if ( !x_Get(txn, key, version, subkey, record) ) {
+        return;
+    }
+    if ( !blob_descr->return_current_version ) {
+        time = record.m_Time;
+    }
+    unsigned age = now > time? now - time: 0;
+    if ( blob_descr->maximum_age && age > blob_descr->maximum_age ) {
+        return;
+    }
+    blob_descr->actual_age = age;
+    blob_descr->blob_found = true;
+    blob_descr->blob_size = record.m_Size;
+    if ( blob_descr->buf && blob_descr->buf_size >= record.m_Size ) {
+        memcpy(blob_descr->buf, record.m_Data, record.m_Size);
+    }
+    else {
+        blob_descr->reader.reset(new CLMDBBlobReader(move(txn),
+                                                     record.m_Data,
+                                                     record.m_Size));
+    }
+}
+
+
+IWriter* CGBLMDBCache::GetWriteStream(const string&  key,
+                                      TBlobVersion   version,
+                                      const string&  subkey,
+                                      unsigned int   /*time_to_live*/,
+                                      const string&  /*owner*/)
+{
+    return new CLMDBBlobWriter(*this, key, version, subkey);
+}
+
+
+void CGBLMDBCache::Remove(const string&  key,
+                          TBlobVersion   version,
+                          const string&  subkey)
+{
+    string db_key = s_MakeKey(key, version, subkey);
+    if ( db_key.size() > m_MaxKeySize ) {
+        return;
+    }
+    CLMDBWriteTxn txn(m_Env->GetHandle());
+    MDB_val db_key_val = s_Val(db_key);
+    lmdb::dbi_del(txn, m_Dbis.m_Data, &db_key_val, 0);
+    TBlobVersion current_version;
+    TTime time;
+    if ( x_GetCurrentVersion(txn, key, subkey, current_version, time) &&
+         current_version == version ) {
+        string prefix = s_MakePrefix(key, subkey);
+        MDB_val ver_key_val = s_Val(prefix);
+        lmdb::dbi_del(txn, m_Dbis.m_Versions, &ver_key_val, 0);
+    }
+    txn.Commit();
+}
+
+
+time_t CGBLMDBCache::GetAccessTime(const string&  key,
+                                   TBlobVersion   version,
+                                   const string&  subkey)
+{
+    lmdb::txn txn = x_BeginRead();
+    SRecord record;
+    if ( !x_Get(txn, key, version, subkey, record) ) {
+        return 0;
+    }
+    return record.m_Time;
+}
+
+
+bool CGBLMDBCache::HasBlobs(const string&  key,
+                            const string&  subkey)
+{
+    string prefix = s_MakePrefix(key, subkey);
+    if ( prefix.size() > m_MaxKeySize ) {
+        return false;
+    }
+    lmdb::txn txn = x_BeginRead();
+    lmdb::cursor cursor = lmdb::cursor::open(txn, m_Dbis.m_Data);
+    MDB_val db_key = s_Val(prefix), data;
+    return cursor.get(&db_key, &data, MDB_SET_RANGE) &&
+        s_HasPrefix(db_key, prefix);
+}
+
+
+void CGBLMDBCache::Purge(time_t access_timeout)
+{
+    TTime now = s_Now();
+    TTime min_time = now > access_timeout? TTime(now - access_timeout): 0;
+    CLMDBWriteTxn txn(m_Env->GetHandle());
+    x_Purge(txn, kEmptyStr, min_time);
+    txn.Commit();
+}
+
+
+void CGBLMDBCache::Purge(const string&  key,
+                         const string&  subkey,
+                         time_t         access_timeout)
+{
+    string prefix = s_MakePrefix(key, subkey);
+    if ( prefix.size() > m_MaxKeySize ) {
+        return;
+    }
+    TTime now = s_Now();
+    TTime min_time = now > access_timeout? TTime(now - access_timeout): 0;
+    CLMDBWriteTxn txn(m_Env->GetHandle());
+    x_Purge(txn, prefix, min_time);
+    txn.Commit();
+}
+
+
+bool CGBLMDBCache::SameCacheParams(const TCacheParams* params) const
+{
+    if ( !params ) {
+        return false;
+    }
+    const TCacheParams* path =
+        params->FindNode(NCBI_GBLOADER_LMDBCACHE_PARAM_PATH);
+    const TCacheParams* name = params->FindNode("name");
+    return path && name &&
+        CDirEntry::NormalizePath(CDirEntry::CreateAbsolutePath(
+                                     path->GetValue().value)) ==
+        m_Env->GetPath() &&
+        name->GetValue().value == m_Name;
+}
+
+
+string CGBLMDBCache::GetCacheName(void) const
+{
+    return m_Env->GetPath()+'/'+m_Name;
+}
+
+
+END_SCOPE(objects)
+END_NCBI_SCOPE
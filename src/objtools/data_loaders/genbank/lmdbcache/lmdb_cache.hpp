@@ -0,0 +1,215 @@
+#ifndef GENBANK_LMDB_CACHE__HPP_INCLUDED
+#define GENBANK_LMDB_CACHE__HPP_INCLUDED
+
+/*  $Id$
+ * ===========================================================================
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ *  File Description: ICache over LMDB environment shared by processes
+ *
+ */
+
+#include <corelib/ncbiobj.hpp>
+#include <util/cache/icache.hpp>
+#include <util/lmdbxx/lmdb++.h>
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects)
+
+/// LMDB environment opened once per process and path.
+/// The environment memory map is shared by all processes using the same
+/// path: readers never block, and writers are serialized by LMDB.
+class CGBLMDBEnv : public CObject
+{
+public:
+    static CRef<CGBLMDBEnv> GetEnv(const string& path,
+                                   Uint8 map_size,
+                                   unsigned max_readers);
+    ~CGBLMDBEnv(void);
+
+    const string& GetPath(void) const
+        {
+            return m_Path;
+        }
+    MDB_env* GetHandle(void) const
+        {
+            return m_Env.handle();
+        }
+
+    /// Data and current version tables of a cache
+    struct SDbis {
+        MDB_dbi m_Data;
+        MDB_dbi m_Versions;
+    };
+    const SDbis& GetDbis(const string& name);
+
+private:
+    CGBLMDBEnv(const string& path, Uint8 map_size, unsigned max_readers);
+
+    string          m_Path;
+    lmdb::env       m_Env;
+    CFastMutex      m_DbisMutex;
+    map<string, SDbis> m_Dbis;
+};
+
+
+/// ICache over one pair of LMDB tables.
+/// Blob records are keyed by key, subkey and version, and start with
+/// the time of their creation.  The current version of key/subkey pair
+/// is kept in a separate table together with the time it was confirmed.
+class CGBLMDBCache : public ICache
+{
+public:
+    CGBLMDBCache(CGBLMDBEnv& env, const string& name, int timeout);
+    ~CGBLMDBCache(void);
+
+    virtual TFlags GetFlags(void);
+    virtual void SetFlags(TFlags flags);
+
+    virtual void SetTimeStampPolicy(TTimeStampFlags policy,
+                                    unsigned int    timeout,
+                                    unsigned int    max_timeout = 0);
+    virtual TTimeStampFlags GetTimeStampPolicy(void) const;
+    virtual int GetTimeout(void) const;
+    virtual bool IsOpen(void) const;
+
+    virtual void SetVersionRetention(EKeepVersions policy);
+    virtual EKeepVersions GetVersionRetention(void) const;
+
+    virtual void Store(const string&  key,
+                       TBlobVersion   version,
+                       const string&  subkey,
+                       const void*    data,
+                       size_t         size,
+                       unsigned int   time_to_live = 0,
+                       const string&  owner = kEmptyStr);
+    virtual size_t GetSize(const string&  key,
+                           TBlobVersion   version,
+                           const string&  subkey);
+    virtual void GetBlobOwner(const string&  key,
+                              TBlobVersion   version,
+                              const string&  subkey,
+                              string*        owner);
+    virtual bool Read(const string& key,
+                      TBlobVersion  version,
+                      const string& subkey,
+                      void*         buf,
+                      size_t        buf_size);
+    virtual IReader* GetReadStream(const string&  key,
+                                   TBlobVersion   version,
+                                   const string&  subkey);
+    virtual IReader* GetReadStream(const string&         key,
+                                   const string&         subkey,
+                                   TBlobVersion*         version,
+                                   EBlobVersionValidity* validity);
+    virtual void SetBlobVersionAsCurrent(const string&  key,
+                                         const string&  subkey,
+                                         TBlobVersion   version);
+    virtual void GetBlobAccess(const string&     key,
+                               TBlobVersion      version,
+                               const string&     subkey,
+                               SBlobAccessDescr* blob_descr);
+    virtual IWriter* GetWriteStream(const string&  key,
+                                    TBlobVersion   version,
+                                    const string&  subkey,
+                                    unsigned int   time_to_live = 0,
+                                    const string&  owner = kEmptyStr);
+    virtual void Remove(const string&  key,
+                        TBlobVersion   version,
+                        const string&  subkey);
+    virtual time_t GetAccessTime(const string&  key,
+                                 TBlobVersion   version,
+                                 const string&  subkey);
+    virtual bool HasBlobs(const string&  key,
+                          const string&  subkey);
+    virtual void Purge(time_t access_timeout);
+    virtual void Purge(const string&  key,
+                       const string&  subkey,
+                       time_t         access_timeout);
+
+    virtual bool SameCacheParams(const TCacheParams* params) const;
+    virtual string GetCacheName(void) const;
+
+private:
+    typedef Uint4 TTime;
+
+    // blob record found in read transaction
+    struct SRecord {
+        SRecord(void)
+            : m_Time(0), m_Data(0), m_Size(0)
+            {
+            }
+        TTime       m_Time;
+        const char* m_Data;
+        size_t      m_Size;
+    };
+
+    lmdb::txn x_BeginRead(void) const;
+    bool x_Get(MDB_txn* txn,
+               const string& key,
+               TBlobVersion version,
+               const string& subkey,
+               SRecord& record) const;
+    bool x_GetCurrentVersion(MDB_txn* txn,
+                             const string& key,
+                             const string& subkey,
+                             TBlobVersion& version,
+                             TTime& time) const;
+    bool x_IsExpired(TTime time, TTime now) const;
+    void x_Store(MDB_txn* txn,
+                 const string& key,
+                 TBlobVersion version,
+                 const string& subkey,
+                 const void* data,
+                 size_t size,
+                 TTime now);
+    void x_SetCurrentVersion(MDB_txn* txn,
+                             const string& prefix,
+                             TBlobVersion version,
+                             TTime now);
+    void x_DropVersions(MDB_txn* txn,
+                        const string& prefix,
+                        TBlobVersion version);
+    void x_Purge(MDB_txn* txn,
+                 const string& prefix,
+                 TTime min_time);
+    // check if storing the size would leave too little free space
+    bool x_IsAlmostFull(size_t size) const;
+    // evict the oldest blob records to free at least the size
+    void x_EvictOldest(size_t size);
+
+    CRef<CGBLMDBEnv>    m_Env;
+    string              m_Name;
+    CGBLMDBEnv::SDbis   m_Dbis;
+    size_t              m_MaxKeySize;
+    TFlags              m_Flags;
+    TTimeStampFlags     m_TimeStampPolicy;
+    int                 m_Timeout;
+    EKeepVersions       m_VersionRetention;
+};
+
+
+END_SCOPE(objects)
+END_NCBI_SCOPE
+
+#endif // GENBANK_LMDB_CACHE__HPP_INCLUDED
@@ -0,0 +1,268 @@
+/*  $Id$
+ * ===========================================================================
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ *  File Description: Cache reader and writer shared by processes via LMDB
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <objtools/data_loaders/genbank/lmdbcache/reader_lmdbcache.hpp>
+#include <objtools/data_loaders/genbank/lmdbcache/reader_lmdbcache_entry.hpp>
+#include <objtools/data_loaders/genbank/lmdbcache/reader_lmdbcache_params.h>
+#include <objtools/data_loaders/genbank/readers.hpp> // for entry point
+#include <objtools/data_loaders/genbank/impl/cache_manager.hpp>
+
+#include <corelib/plugin_manager_impl.hpp>
+#include <corelib/plugin_manager_store.hpp>
+
+#include "lmdb_cache.hpp"
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects)
+
+
+/////////////////////////////////////////////////////////////////////////////
+// SLMDBCacheInfo
+
+void SLMDBCacheInfo::Init(const TPluginManagerParamTree* params,
+                          const string& driver_name)
+{
+    CConfig conf(params);
+    m_Path = conf.GetString(
+        driver_name,
+        NCBI_GBLOADER_LMDBCACHE_PARAM_PATH,
+        CConfig::eErr_NoThrow,
+        DEFAULT_LMDBCACHE_PATH);
+    m_MapSize = NStr::StringToUInt8_DataSize(conf.GetString(
+        driver_name,
+        NCBI_GBLOADER_LMDBCACHE_PARAM_MAP_SIZE,
+        CConfig::eErr_NoThrow,
+        DEFAULT_LMDBCACHE_MAP_SIZE));
+    m_MaxReaders = conf.GetInt(
+        driver_name,
+        NCBI_GBLOADER_LMDBCACHE_PARAM_MAX_READERS,
+        CConfig::eErr_NoThrow,
+        DEFAULT_LMDBCACHE_MAX_READERS);
+    m_IdTimeout = conf.GetInt(
+        driver_name,
+        NCBI_GBLOADER_LMDBCACHE_PARAM_ID_TIMEOUT,
+        CConfig::eErr_NoThrow,
+        DEFAULT_LMDBCACHE_ID_TIMEOUT);
+    m_BlobTimeout = conf.GetInt(
+        driver_name,
+        NCBI_GBLOADER_LMDBCACHE_PARAM_BLOB_TIMEOUT,
+        CConfig::eErr_NoThrow,
+        DEFAULT_LMDBCACHE_BLOB_TIMEOUT);
+}
+
+
+void SLMDBCacheInfo::InitializeCache(CCacheHolder& holder,
+                                     CReaderCacheManager& cache_manager) const
+{
+    // search for caches already created by paired reader or writer
+    CConfig::TParamTree params;
+    params.AddNode(CConfig::TParamValue(NCBI_GBLOADER_LMDBCACHE_PARAM_PATH,
+                                        m_Path));
+    CConfig::TParamTree* name = params.AddNode(CConfig::TParamValue("name",
+                                                                    "ids"));
+    ICache* id_cache =
+        cache_manager.FindCache(CReaderCacheManager::fCache_Id, &params);
+    name->GetValue().value = "blobs";
+    ICache* blob_cache =
+        cache_manager.FindCache(CReaderCacheManager::fCache_Blob, &params);
+    if ( !id_cache || !blob_cache ) {
+        CRef<CGBLMDBEnv> env =
+            CGBLMDBEnv::GetEnv(m_Path, m_MapSize, m_MaxReaders);
+        if ( !id_cache ) {
+            id_cache = new CGBLMDBCache(*env, "ids", m_IdTimeout);
+            cache_manager.RegisterCache(*id_cache,
+                                        CReaderCacheManager::fCache_Id);
+        }
+        if ( !blob_cache ) {
+            blob_cache = new CGBLMDBCache(*env, "blobs", m_BlobTimeout);
+            cache_manager.RegisterCache(*blob_cache,
+                                        CReaderCacheManager::fCache_Blob);
+        }
+    }
+    holder.SetIdCache(id_cache);
+    holder.SetBlobCache(blob_cache);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// CLMDBCacheReader
+
+CLMDBCacheReader::CLMDBCacheReader(const TPluginManagerParamTree* params,
+                                   const string& driver_name)
+    : CCacheReader(params, driver_name)
+{
+    m_Info.Init(params, driver_name);
+}
+
+
+void CLMDBCacheReader::InitializeCache(CReaderCacheManager& cache_manager,
+                                       const TPluginManagerParamTree* /*params*/)
+{
+    m_Info.InitializeCache(*this, cache_manager);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// CLMDBCacheWriter
+
+CLMDBCacheWriter::CLMDBCacheWriter(const TPluginManagerParamTree* params,
+                                   const string& driver_name)
+{
+    m_Info.Init(params, driver_name);
+}
+
+
+void CLMDBCacheWriter::InitializeCache(CReaderCacheManager& cache_manager,
+                                       const TPluginManagerParamTree* /*params*/)
+{
+    m_Info.InitializeCache(*this, cache_manager);
+}
+
+
+END_SCOPE(objects)
+
+
+using namespace objects;
+
+
+/// Class factory for shared LMDB cache reader
+///
+/// @internal
+///
+class CLMDBCacheReaderCF :
+    public CSimpleClassFactoryImpl<CReader, CLMDBCacheReader>
+{
+    typedef CSimpleClassFactoryImpl<CReader, CLMDBCacheReader> TParent;
+public:
+    CLMDBCacheReaderCF()
+        : TParent(NCBI_GBLOADER_READER_LMDBCACHE_DRIVER_NAME, 0)
+        {
+        }
+    ~CLMDBCacheReaderCF()
+        {
+        }
+
+
+    CReader*
+    CreateInstance(const string& driver  = kEmptyStr,
+                   CVersionInfo version = NCBI_INTERFACE_VERSION(CReader),
+                   const TPluginManagerParamTree* params = 0) const
+    {
+        if ( !driver.empty()  &&  driver != m_DriverName ) {
+            return 0;
+        }
+        if ( !version.Match(NCBI_INTERFACE_VERSION(CReader)) ) {
+            return 0;
+        }
+        return new CLMDBCacheReader(params, m_DriverName);
+    }
+};
+
+
+/// Class factory for shared LMDB cache writer
+///
+/// @internal
+///
+class CLMDBCacheWriterCF :
+    public CSimpleClassFactoryImpl<CWriter, CLMDBCacheWriter>
+{
+    typedef CSimpleClassFactoryImpl<CWriter, CLMDBCacheWriter> TParent;
+public:
+    CLMDBCacheWriterCF()
+        : TParent(NCBI_GBLOADER_WRITER_LMDBCACHE_DRIVER_NAME, 0)
+        {
+        }
+    ~CLMDBCacheWriterCF()
+        {
+        }
+
+
+    CWriter*
+    CreateInstance(const string& driver  = kEmptyStr,
+                   CVersionInfo version = NCBI_INTERFACE_VERSION(CWriter),
+                   const TPluginManagerParamTree* params = 0) const
+    {
+        if ( !driver.empty()  &&  driver != m_DriverName ) {
+            return 0;
+        }
+        if ( !version.Match(NCBI_INTERFACE_VERSION(CWriter)) ) {
+            return 0;
+        }
+        return new CLMDBCacheWriter(params, m_DriverName);
+    }
+};
+
+
+void NCBI_EntryPoint_LMDBCacheReader(
+     CPluginManager<CReader>::TDriverInfoList&   info_list,
+     CPluginManager<CReader>::EEntryPointRequest method)
+{
+    CHostEntryPointImpl<CLMDBCacheReaderCF>::NCBI_EntryPointImpl(info_list,
+                                                                 method);
+}
+
+
+void NCBI_EntryPoint_xreader_lmdbcache(
+     CPluginManager<CReader>::TDriverInfoList&   info_list,
+     CPluginManager<CReader>::EEntryPointRequest method)
+{
+    NCBI_EntryPoint_LMDBCacheReader(info_list, method);
+}
+
+
+void NCBI_EntryPoint_LMDBCacheWriter(
+     CPluginManager<CWriter>::TDriverInfoList&   info_list,
+     CPluginManager<CWriter>::EEntryPointRequest method)
+{
+    CHostEntryPointImpl<CLMDBCacheWriterCF>::NCBI_EntryPointImpl(info_list,
+                                                                 method);
+}
+
+
+void NCBI_EntryPoint_xwriter_lmdbcache(
+     CPluginManager<CWriter>::TDriverInfoList&   info_list,
+     CPluginManager<CWriter>::EEntryPointRequest method)
+{
+    NCBI_EntryPoint_LMDBCacheWriter(info_list, method);
+}
+
+
+void GenBankReaders_Register_LMDBCache(void)
+{
+    RegisterEntryPoint<CReader>(NCBI_EntryPoint_LMDBCacheReader);
+}
+
+
+void GenBankWriters_Register_LMDBCache(void)
+{
+    RegisterEntryPoint<CWriter>(NCBI_EntryPoint_LMDBCacheWriter);
+}
+
+
+END_NCBI_SCOPE
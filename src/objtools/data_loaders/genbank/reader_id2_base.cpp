@@ -79,6 +79,7 @@ BEGIN_SCOPE(objects)
 NCBI_PARAM_DECL(int, GENBANK, ID2_DEBUG);
 NCBI_PARAM_DECL(int, GENBANK, ID2_MAX_CHUNKS_REQUEST_SIZE);
 NCBI_PARAM_DECL(int, GENBANK, ID2_MAX_IDS_REQUEST_SIZE);
+NCBI_PARAM_DECL(int, GENBANK, ID2_MAX_PACKETS_IN_FLIGHT);
 NCBI_PARAM_DECL(string, GENBANK, ID2_PROCESSOR);
 NCBI_PARAM_DECL(bool, GENBANK, VDB_WGS);
 NCBI_PARAM_DECL(bool, GENBANK, VDB_SNP);
@@ -96,6 +97,8 @@ NCBI_PARAM_DEF_EX(int, GENBANK, ID2_MAX_CHUNKS_REQUEST_SIZE, 100,
                   eParam_NoThread, GENBANK_ID2_MAX_CHUNKS_REQUEST_SIZE);
 NCBI_PARAM_DEF_EX(int, GENBANK, ID2_MAX_IDS_REQUEST_SIZE, 100,
                   eParam_NoThread, GENBANK_ID2_MAX_IDS_REQUEST_SIZE);
+NCBI_PARAM_DEF_EX(int, GENBANK, ID2_MAX_PACKETS_IN_FLIGHT, 1,
+                  eParam_NoThread, GENBANK_ID2_MAX_PACKETS_IN_FLIGHT);
 NCBI_PARAM_DEF_EX(string, GENBANK, ID2_PROCESSOR, "",
                   eParam_NoThread, GENBANK_ID2_PROCESSOR);
 NCBI_PARAM_DEF_EX(bool, GENBANK, VDB_WGS, true,
@@ -148,6 +151,16 @@ static size_t GetMaxIdsRequestSize(void)
 }
 
 
+// Number of packets sent over a connection before waiting for replies
+// 0 or 1 = wait for all replies to a packet before sending the next one
+static size_t GetMaxPacketsInFlight(void)
+{
+    static CSafeStatic<NCBI_PARAM_TYPE(GENBANK, ID2_MAX_PACKETS_IN_FLIGHT)> s_Value;
+    int value = s_Value->Get();
+    return value > 1? size_t(value): 1;
+}
+
+
 static inline
 bool
 SeparateChunksRequests(size_t max_request_size = GetMaxChunksRequestSize())
@@ -1478,7 +1491,8 @@ bool CId2ReaderBase::x_LoadSeq_idBlob_idsSet(CReaderRequestResult& result,
         }
         return true;
     }
-    CID2_Request_Packet packet;
+    TPackets packets;
+    CRef<CID2_Request_Packet> packet;
     ITERATE(TSeqIds, id, seq_ids) {
         CLoadLockBlobIds ids(result, *id, 0);
         if ( ids.IsLoaded() ) {
@@ -1487,17 +1501,18 @@ bool CId2ReaderBase::x_LoadSeq_idBlob_idsSet(CReaderRequestResult& result,
 
         CRef<CID2_Request> req(new CID2_Request);
         x_SetResolve(req->SetRequest().SetGet_blob_id(), *id->GetSeqId());
-        packet.Set().push_back(req);
+        if ( !packet ) {
+            packet = new CID2_Request_Packet;
+            packets.push_back(packet);
+        }
+        packet->Set().push_back(req);
         if ( LimitChunksRequests(max_request_size) &&
-             packet.Get().size() >= max_request_size ) {
-            // Request collected chunks
-            x_ProcessPacket(result, packet, 0);
-            packet.Set().clear();
+             packet->Get().size() >= max_request_size ) {
+            // start next packet
+            packet = null;
         }
     }
-    if ( !packet.Get().empty() ) {
-        x_ProcessPacket(result, packet, 0);
-    }
+    x_ProcessPackets(result, packets, 0);
     return true;
 }
 
@@ -1520,7 +1535,8 @@ bool CId2ReaderBase::LoadBlobSet(CReaderRequestResult& result,
     }
 
     set<CBlob_id> load_blob_ids;
-    CID2_Request_Packet packet;
+    TPackets packets;
+    CRef<CID2_Request_Packet> packet;
     ITERATE(TSeqIds, id, seq_ids) {
         if ( !loaded_blob_ids &&
              (m_AvoidRequest & fAvoidRequest_nested_get_blob_info) ) {
@@ -1551,12 +1567,15 @@ bool CId2ReaderBase::LoadBlobSet(CReaderRequestResult& result,
                     req->SetRequest().SetGet_blob_info();
                 x_SetResolve(req2.SetBlob_id().SetBlob_id(), blob_id);
                 x_SetDetails(req2.SetGet_data(), fBlobHasCore);
-                packet.Set().push_back(req);
+                if ( !packet ) {
+                    packet = new CID2_Request_Packet;
+                    packets.push_back(packet);
+                }
+                packet->Set().push_back(req);
+                ++processed_requests;
                 if ( LimitChunksRequests(max_request_size) &&
-                     packet.Get().size() >= max_request_size ) {
-                    processed_requests += packet.Set().size();
-                    x_ProcessPacket(result, packet, 0);
-                    packet.Set().clear();
+                     packet->Get().size() >= max_request_size ) {
+                    packet = null;
                 }
             }
         }
@@ -1568,19 +1587,19 @@ bool CId2ReaderBase::LoadBlobSet(CReaderRequestResult& result,
                          *id->GetSeqId());
             x_SetDetails(req2.SetGet_data(), fBlobHasCore);
             x_SetExclude_blobs(req2, *id, result);
-            packet.Set().push_back(req);
+            if ( !packet ) {
+                packet = new CID2_Request_Packet;
+                packets.push_back(packet);
+            }
+            packet->Set().push_back(req);
+            ++processed_requests;
             if ( LimitChunksRequests(max_request_size) &&
-                 packet.Get().size() >= max_request_size ) {
-                processed_requests += packet.Set().size();
-                x_ProcessPacket(result, packet, 0);
-                packet.Set().clear();
+                 packet->Get().size() >= max_request_size ) {
+                packet = null;
             }
         }
     }
-    if ( !packet.Get().empty() ) {
-        processed_requests += packet.Get().size();
-        x_ProcessPacket(result, packet, 0);
-    }
+    x_ProcessPackets(result, packets, 0);
     if ( !processed_requests && !loaded_blob_ids ) {
         return false;
     }
@@ -1622,15 +1641,62 @@ struct SId2ProcessorStage
 
 struct SId2ProcessingState
 {
+    SId2ProcessingState()
+        : pipeline(0)
+        {
+        }
+
     vector<SId2ProcessorStage> stages;
     unique_ptr<CReaderAllocatedConnection> conn;
+    // set if the packet shares connection with other packets in flight
+    SId2Pipeline* pipeline;
+    // replies received ahead while waiting for replies to other packets
+    deque< CRef<CID2_Reply> > pending_replies;
+
+    CReader::TConn GetConn() const;
+};
+
+
+struct SId2PipelinedPacket
+{
+    CRef<CID2_Request_Packet> packet;
+    SId2PacketInfo info;
+    vector<SId2LoadedSet> loaded_sets;
+    SId2ProcessingState state;
+};
+
+
+struct SId2Pipeline
+{
+    unique_ptr<CReaderAllocatedConnection> conn;
+    // packets in the order they were sent
+    list<SId2PipelinedPacket> packets;
 
-    CReader::TConn GetConn() const {
-        return conn? *conn: 0;
+    SId2ProcessingState* FindState(const CID2_Reply& reply) {
+        if ( !reply.IsSetSerial_number() ) {
+            return 0;
+        }
+        int serial_num = reply.GetSerial_number();
+        NON_CONST_ITERATE ( list<SId2PipelinedPacket>, it, packets ) {
+            int num = serial_num - it->info.start_serial_num;
+            if ( num >= 0 && num < it->info.request_count ) {
+                return &it->state;
+            }
+        }
+        return 0;
     }
 };
 
 
+CReader::TConn SId2ProcessingState::GetConn() const
+{
+    if ( pipeline ) {
+        return pipeline->conn? *pipeline->conn: 0;
+    }
+    return conn? *conn: 0;
+}
+
+
 void CId2ReaderBase::x_SetContextData(CID2_Request& request)
 {
     if ( request.GetRequest().IsInit() ) {
@@ -1797,6 +1863,17 @@ CRef<CID2_Reply> CId2ReaderBase::x_ReceiveFromConnection(TConn conn)
 void CId2ReaderBase::x_SendID2Packet(CReaderRequestResult& result,
                                      SId2ProcessingState& state,
                                      CID2_Request_Packet& packet)
+{
+    if ( !x_PrepareID2Packet(state, packet) ) {
+        return;
+    }
+    state.conn.reset(new CConn(result, this));
+    x_SendID2PacketToConn(state.GetConn(), packet);
+}
+
+
+bool CId2ReaderBase::x_PrepareID2Packet(SId2ProcessingState& state,
+                                        CID2_Request_Packet& packet)
 {
     CProcessor::OffsetAllGisFromOM(packet);
     x_DumpPacket(0, packet, "Processing");
@@ -1804,7 +1881,7 @@ void CId2ReaderBase::x_SendID2Packet(CReaderRequestResult& result,
     state.stages.reserve(proc_count);
     for ( size_t i = 0; i < proc_count; ++i ) {
         if ( packet.Get().empty() ) {
-            return;
+            return false;
         }
         state.stages.resize(i+1);
         SProcessorInfo& info = m_Processors[i];
@@ -1819,11 +1896,13 @@ void CId2ReaderBase::x_SendID2Packet(CReaderRequestResult& result,
         }
         reverse(stage.replies.begin(), stage.replies.end());
     }
-    if ( packet.Get().empty() ) {
-        return;
-    }
-    state.conn.reset(new CConn(result, this));
-    TConn conn = state.GetConn();
+    return !packet.Get().empty();
+}
+
+
+void CId2ReaderBase::x_SendID2PacketToConn(TConn conn,
+                                           CID2_Request_Packet& packet)
+{
     try {
         if ( GetDebugLevel() >= eTraceConn ) {
             CDebugPrinter s(conn, "CId2Reader");
@@ -1864,29 +1943,59 @@ CRef<CID2_Reply> CId2ReaderBase::x_ReceiveID2ReplyStage(SId2ProcessingState& sta
         stage.replies.pop_back();
         return reply;
     }
+    else if ( state.pipeline ) {
+        return x_ReceivePipelinedReply(state);
+    }
     else {
         _ASSERT(state.conn);
-        TConn conn = state.GetConn();
-        for (;;) {
-            if ( GetDebugLevel() >= eTraceConn ) {
-                CDebugPrinter s(conn, "CId2Reader");
-                s << "Receiving ID2-Reply...";
-            }
-            CRef<CID2_Reply> reply(new CID2_Reply);
-            try {
-                x_ReceiveReply(conn, *reply);
-            }
-            catch ( CException& exc ) {
-                NCBI_RETHROW(exc, CLoaderException, eConnectionFailed,
-                             "reply deserialization failed: "+
-                             x_ConnDescription(conn));
-            }
-            x_DumpReply(conn, *reply);
-            if ( reply->IsSetDiscard() ) {
-                continue;
-            }
+        return x_ReceiveID2ReplyFromConn(state.GetConn());
+    }
+}
+
+
+CRef<CID2_Reply> CId2ReaderBase::x_ReceiveID2ReplyFromConn(TConn conn)
+{
+    for (;;) {
+        if ( GetDebugLevel() >= eTraceConn ) {
+            CDebugPrinter s(conn, "CId2Reader");
+            s << "Receiving ID2-Reply...";
+        }
+        CRef<CID2_Reply> reply(new CID2_Reply);
+        try {
+            x_ReceiveReply(conn, *reply);
+        }
+        catch ( CException& exc ) {
+            NCBI_RETHROW(exc, CLoaderException, eConnectionFailed,
+                         "reply deserialization failed: "+
+                         x_ConnDescription(conn));
+        }
+        x_DumpReply(conn, *reply);
+        if ( reply->IsSetDiscard() ) {
+            continue;
+        }
+        return reply;
+    }
+}
+
+
+CRef<CID2_Reply> CId2ReaderBase::x_ReceivePipelinedReply(SId2ProcessingState& state)
+{
+    _ASSERT(state.pipeline && state.pipeline->conn);
+    if ( !state.pending_replies.empty() ) {
+        CRef<CID2_Reply> reply = state.pending_replies.front();
+        state.pending_replies.pop_front();
+        return reply;
+    }
+    for (;;) {
+        CRef<CID2_Reply> reply = x_ReceiveID2ReplyFromConn(state.GetConn());
+        SId2ProcessingState* dst = state.pipeline->FindState(*reply);
+        if ( !dst || dst == &state ) {
+            // replies without known serial number are errors,
+            // let the current packet report them
             return reply;
         }
+        // reply to a later packet, keep it until that packet is processed
+        dst->pending_replies.push_back(reply);
     }
 }
 
@@ -2057,6 +2166,98 @@ void CId2ReaderBase::x_ProcessPacket(CReaderRequestResult& result,
 }
 
 
+void CId2ReaderBase::x_ProcessPackets(CReaderRequestResult& result,
+                                      TPackets& packets,
+                                      const SAnnotSelector* sel)
+{
+    size_t max_in_flight = x_CanPipelinePackets()? GetMaxPacketsInFlight(): 1;
+    if ( max_in_flight <= 1 || packets.size() <= 1 ) {
+        NON_CONST_ITERATE ( TPackets, it, packets ) {
+            x_ProcessPacket(result, **it, sel);
+        }
+        return;
+    }
+
+    SId2Pipeline pipeline;
+    TPackets::iterator next_packet = packets.begin();
+    CRef<CID2_Reply> reply;
+    try {
+        for (;;) {
+            // keep up to max_in_flight packets sent
+            while ( pipeline.packets.size() < max_in_flight &&
+                    next_packet != packets.end() ) {
+                CID2_Request_Packet& packet = **next_packet++;
+                pipeline.packets.push_back(SId2PipelinedPacket());
+                SId2PipelinedPacket& info = pipeline.packets.back();
+                info.packet = &packet;
+                info.state.pipeline = &pipeline;
+                x_AssignSerialNumbers(info.info, packet);
+                info.loaded_sets.resize(info.info.request_count);
+                if ( x_PrepareID2Packet(info.state, packet) ) {
+                    if ( !pipeline.conn ) {
+                        pipeline.conn.reset(new CConn(result, this));
+                    }
+                    x_SendID2PacketToConn(*pipeline.conn, packet);
+                }
+            }
+            if ( pipeline.packets.empty() ) {
+                break;
+            }
+
+            // process replies to the oldest packet,
+            // replies to the other packets are queued in their states
+            SId2PipelinedPacket& info = pipeline.packets.front();
+            while ( info.info.remaining_count > 0 ) {
+                reply = x_ReceiveID2Reply(info.state);
+                int num = x_GetReplyIndex(result, pipeline.conn.get(), info.info, *reply);
+                if ( num >= 0 ) {
+                    try {
+                        x_ProcessReply(result, info.loaded_sets[num], *reply, *info.info.requests[num]);
+                    }
+                    catch ( CException& exc ) {
+                        NCBI_RETHROW(exc, CLoaderException, eOtherError,
+                                     "CId2ReaderBase: failed to process reply: "+
+                                     x_ConnDescription(info.state.GetConn()));
+                    }
+                    if ( x_DoneReply(info.info, num, *reply) ) {
+                        x_UpdateLoadedSet(result, info.loaded_sets[num], sel);
+                    }
+                }
+                reply.Reset();
+            }
+            pipeline.packets.pop_front();
+            // the connection may still have replies to the later packets,
+            // so the end of packet is reported only when all are received
+            if ( pipeline.packets.empty() && pipeline.conn ) {
+                _ASSERT(next_packet == packets.end());
+                x_EndOfPacket(*pipeline.conn);
+            }
+        }
+    }
+    catch ( exception& /*rethrown*/ ) {
+        if ( GetDebugLevel() >= eTraceError ) {
+            CDebugPrinter s(pipeline.conn? TConn(*pipeline.conn): 0, "CId2Reader");
+            s << "Error processing pipelined requests";
+            if ( !pipeline.packets.empty() ) {
+                s << ": " << MSerial_AsnText << *pipeline.packets.front().packet;
+            }
+            if ( reply ) {
+                try {
+                    s << "Last reply: " << MSerial_AsnText << *reply;
+                }
+                catch ( exception& /*ignored*/ ) {
+                }
+            }
+        }
+        // the connection is dropped with unread replies in it
+        throw;
+    }
+    if ( pipeline.conn ) {
+        pipeline.conn->Release();
+    }
+}
+
+
 void CId2ReaderBase::x_ReceiveReply(CObjectIStream& stream,
                                     TConn /*conn*/,
                                     CID2_Reply& reply)
@@ -2071,6 +2272,12 @@ void CId2ReaderBase::x_EndOfPacket(TConn /*conn*/)
 }
 
 
+bool CId2ReaderBase::x_CanPipelinePackets(void) const
+{
+    return false;
+}
+
+
 void CId2ReaderBase::x_UpdateLoadedSet(CReaderRequestResult& result,
                                        SId2LoadedSet& data,
                                        const SAnnotSelector* sel)
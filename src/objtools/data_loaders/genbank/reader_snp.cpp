@@ -762,6 +762,7 @@ void CSeq_annot_SNP_Info_Reader::x_Read(CNcbiIstream& stream,
                        "Cannot read SNP table simple SNPs");
         }
     }
+    snp_info.x_UpdatePositions();
     size_t comments_size = snp_info.m_Comments.GetSize();
     size_t alleles_size = snp_info.m_Alleles.GetSize();
     size_t extra_size = snp_info.m_Extra.GetSize();
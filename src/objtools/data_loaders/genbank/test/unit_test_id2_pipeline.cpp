@@ -0,0 +1,190 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Unit tests for several ID2 request packets in flight on one connection.
+*
+* ===========================================================================
+*/
+
+#include <ncbi_pch.hpp>
+
+#include <corelib/ncbiapp.hpp>
+#include <objects/id2/ID2_Request_Packet.hpp>
+#include <objects/id2/ID2_Request.hpp>
+#include <objects/id2/ID2_Reply.hpp>
+#include <objects/id2/ID2_Error.hpp>
+#include <objects/seqloc/Seq_id.hpp>
+#include <objmgr/object_manager.hpp>
+#include <objmgr/scope.hpp>
+#include <objmgr/bioseq_handle.hpp>
+#include <objtools/data_loaders/genbank/gbnative.hpp>
+#include <objtools/data_loaders/genbank/impl/reader_id2_base.hpp>
+
+// This header must be included before all Boost.Test headers if there are any
+#include <corelib/test_boost.hpp>
+
+#include <common/test_assert.h> // This header must go last
+
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+static const int kPacketSize = 10;
+static const size_t kPacketsInFlight = 4;
+
+
+NCBITEST_AUTO_INIT()
+{
+    CNcbiRegistry& reg = CNcbiApplication::Instance()->GetConfig();
+    reg.Set("GENBANK", "ID2_MAX_CHUNKS_REQUEST_SIZE",
+            NStr::IntToString(kPacketSize));
+    reg.Set("GENBANK", "ID2_MAX_PACKETS_IN_FLIGHT",
+            NStr::SizetToString(kPacketsInFlight));
+}
+
+
+// ID2 reader over an in-memory server that has no data for any Seq-id.
+// Replies to the packet sent last come first, so replies to the other
+// packets in flight have to be kept until their packet is processed.
+class CTestId2Reader : public CId2ReaderBase
+{
+public:
+    CTestId2Reader(void)
+        : m_RequestCount(0),
+          m_MaxPacketsInFlight(0),
+          m_EndOfPacketCount(0)
+        {
+            SetMaximumConnections(1, 1);
+        }
+
+    int GetMaximumConnectionsLimit(void) const
+        {
+            return 1;
+        }
+
+    size_t m_RequestCount;
+    size_t m_MaxPacketsInFlight;
+    size_t m_EndOfPacketCount;
+
+protected:
+    typedef deque< CRef<CID2_Reply> > TReplies;
+
+    virtual void x_AddConnectionSlot(TConn /*conn*/)
+        {
+        }
+    virtual void x_RemoveConnectionSlot(TConn /*conn*/)
+        {
+        }
+    virtual void x_ConnectAtSlot(TConn /*conn*/)
+        {
+        }
+    virtual void x_DisconnectAtSlot(TConn /*conn*/, bool /*failed*/)
+        {
+            m_Packets.clear();
+        }
+    virtual string x_ConnDescription(TConn /*conn*/) const
+        {
+            return "test connection";
+        }
+    virtual bool x_CanPipelinePackets(void) const
+        {
+            return true;
+        }
+
+    virtual void x_SendPacket(TConn /*conn*/,
+                              const CID2_Request_Packet& packet)
+        {
+            TReplies replies;
+            ITERATE ( CID2_Request_Packet::Tdata, it, packet.Get() ) {
+                ++m_RequestCount;
+                CRef<CID2_Reply> reply(new CID2_Reply);
+                reply->SetSerial_number((*it)->GetSerial_number());
+                CRef<CID2_Error> error(new CID2_Error);
+                error->SetSeverity(CID2_Error::eSeverity_no_data);
+                reply->SetError().push_back(error);
+                reply->SetEnd_of_reply();
+                reply->SetReply().SetEmpty();
+                replies.push_back(reply);
+            }
+            m_Packets.push_back(replies);
+            m_MaxPacketsInFlight = max(m_MaxPacketsInFlight,
+                                       m_Packets.size());
+        }
+    virtual void x_ReceiveReply(TConn /*conn*/, CID2_Reply& reply)
+        {
+            BOOST_REQUIRE(!m_Packets.empty());
+            TReplies& replies = m_Packets.back();
+            reply.Assign(*replies.front());
+            replies.pop_front();
+            if ( replies.empty() ) {
+                m_Packets.pop_back();
+            }
+        }
+    virtual void x_EndOfPacket(TConn /*conn*/)
+        {
+            // no replies may be left unread on the connection
+            BOOST_CHECK(m_Packets.empty());
+            ++m_EndOfPacketCount;
+        }
+
+private:
+    deque<TReplies> m_Packets;
+};
+
+
+BOOST_AUTO_TEST_CASE(TestID2PacketsInFlight)
+{
+    // one batch of the scope, sent as several packets
+    const int kIdCount = 15 * kPacketSize + 3;
+    CRef<CTestId2Reader> reader(new CTestId2Reader);
+    CRef<CObjectManager> om = CObjectManager::GetInstance();
+    string loader_name = CGBDataLoader_Native::RegisterInObjectManager
+        (*om, reader.GetPointer(), CObjectManager::eNonDefault)
+        .GetLoader()->GetName();
+
+    CScope::TIds ids;
+    for ( int i = 0; i < kIdCount; ++i ) {
+        CSeq_id id("NC_" + NStr::IntToString(900000 + i) + ".1");
+        ids.push_back(CSeq_id_Handle::GetHandle(id));
+    }
+    {{
+        CScope scope(*om);
+        scope.AddDataLoader(loader_name);
+        CScope::TBioseqHandles handles = scope.GetBioseqHandles(ids);
+        BOOST_REQUIRE_EQUAL(handles.size(), ids.size());
+        ITERATE ( CScope::TBioseqHandles, it, handles ) {
+            BOOST_CHECK(!*it);
+        }
+    }}
+
+    // every Seq-id is requested once over the pipelined connection
+    BOOST_CHECK_EQUAL(reader->m_RequestCount, size_t(kIdCount));
+    BOOST_CHECK_EQUAL(reader->m_MaxPacketsInFlight, kPacketsInFlight);
+    BOOST_CHECK_EQUAL(reader->m_EndOfPacketCount, 1u);
+
+    om->RevokeDataLoader(loader_name);
+}
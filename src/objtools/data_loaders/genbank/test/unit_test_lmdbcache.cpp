@@ -0,0 +1,201 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Unit tests for the blob store of the shared LMDB cache.
+*
+* ===========================================================================
+*/
+
+#include <ncbi_pch.hpp>
+
+#include <corelib/ncbifile.hpp>
+#include <objtools/data_loaders/genbank/gbnative.hpp>
+#include <objtools/data_loaders/genbank/lmdbcache/reader_lmdbcache.hpp>
+#include <util/cache/icache.hpp>
+
+// This header must be included before all Boost.Test headers if there are any
+#include <corelib/test_boost.hpp>
+
+#include <common/test_assert.h> // This header must go last
+
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+static string s_CachePath;
+
+
+NCBITEST_AUTO_INIT()
+{
+    s_CachePath = CDirEntry::GetTmpName();
+}
+
+
+NCBITEST_AUTO_FINI()
+{
+    CDir(s_CachePath).Remove();
+}
+
+
+// Blob cache over the test environment
+class CTestLMDBCache : public CCacheHolder
+{
+public:
+    CTestLMDBCache(void)
+    {
+        SLMDBCacheInfo info;
+        info.m_Path = s_CachePath;
+        info.m_MapSize = 16<<20;
+        info.m_MaxReaders = 16;
+        info.m_IdTimeout = info.m_BlobTimeout = 3600;
+        info.InitializeCache(*this, m_Manager);
+        BOOST_REQUIRE(GetBlobCache());
+    }
+
+    // write the data and either close or abort the writer
+    void Write(const string& key, int version, const string& data,
+               bool close)
+    {
+        unique_ptr<IWriter> writer
+            (GetBlobCache()->GetWriteStream(key, version, "blob"));
+        BOOST_REQUIRE(writer.get());
+        ICacheBlobWriter* stream =
+            dynamic_cast<ICacheBlobWriter*>(writer.get());
+        BOOST_REQUIRE(stream);
+        // the writer collects data in several pieces
+        size_t half = data.size()/2;
+        BOOST_CHECK_EQUAL(writer->Write(data.data(), half), eRW_Success);
+        BOOST_CHECK_EQUAL(writer->Write(data.data()+half, data.size()-half),
+                          eRW_Success);
+        if ( close ) {
+            stream->Close();
+        }
+        else {
+            stream->Abort();
+        }
+    }
+
+    bool Read(const string& key, int version, string& data)
+    {
+        ICache* cache = GetBlobCache();
+        if ( !cache->HasBlobs(key, "blob") ) {
+            return false;
+        }
+        data.resize(cache->GetSize(key, version, "blob"));
+        return cache->Read(key, version, "blob", &data[0], data.size());
+    }
+
+private:
+    CGBReaderCacheManager m_Manager;
+};
+
+
+BOOST_AUTO_TEST_CASE(TestLMDBCacheStoreRead)
+{
+    CTestLMDBCache cache;
+    string data;
+    BOOST_CHECK(!cache.Read("store", 1, data));
+    cache.Write("store", 1, "blob data", true);
+    BOOST_REQUIRE(cache.Read("store", 1, data));
+    BOOST_CHECK_EQUAL(data, "blob data");
+
+    // other versions are not found
+    BOOST_CHECK_EQUAL(cache.GetBlobCache()->GetSize("store", 2, "blob"), 0u);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestLMDBCacheAbort)
+{
+    CTestLMDBCache cache;
+    string data;
+    cache.Write("abort", 1, "aborted data", false);
+    BOOST_CHECK(!cache.Read("abort", 1, data));
+
+    // a writer destroyed without Close() doesn't store the data
+    {{
+        unique_ptr<IWriter> writer
+            (cache.GetBlobCache()->GetWriteStream("abort", 1, "blob"));
+        writer->Write("lost", 4);
+    }}
+    BOOST_CHECK(!cache.Read("abort", 1, data));
+
+    // an aborted write doesn't replace the stored blob
+    cache.Write("abort", 2, "stored data", true);
+    cache.Write("abort", 2, "aborted", false);
+    BOOST_REQUIRE(cache.Read("abort", 2, data));
+    BOOST_CHECK_EQUAL(data, "stored data");
+}
+
+
+BOOST_AUTO_TEST_CASE(TestLMDBCacheCurrentVersion)
+{
+    CTestLMDBCache cache;
+    ICache* blob_cache = cache.GetBlobCache();
+    blob_cache->SetVersionRetention(ICache::eKeepAll);
+    cache.Write("version", 2, "version 2", true);
+    cache.Write("version", 1, "version 1", true);
+
+    // storing an older version keeps the current one
+    ICache::TBlobVersion version = 0;
+    ICache::EBlobVersionValidity validity;
+    unique_ptr<IReader> reader
+        (blob_cache->GetReadStream("version", "blob", &version, &validity));
+    BOOST_CHECK(reader.get());
+    BOOST_CHECK_EQUAL(version, 2);
+    BOOST_CHECK_EQUAL(validity, ICache::eCurrent);
+    reader.reset();
+
+    blob_cache->SetBlobVersionAsCurrent("version", "blob", 1);
+    reader.reset
+        (blob_cache->GetReadStream("version", "blob", &version, &validity));
+    BOOST_CHECK(reader.get());
+    BOOST_CHECK_EQUAL(version, 1);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestLMDBCacheEviction)
+{
+    CTestLMDBCache cache;
+    // fill the 16MB map several times over with 1MB blobs
+    const int kBlobCount = 64;
+    string blob(1<<20, 'e');
+    for ( int i = 0; i < kBlobCount; ++i ) {
+        cache.Write("evict"+NStr::IntToString(i), 1, blob, true);
+    }
+    // the oldest blobs were evicted to make room for the new ones
+    string data;
+    BOOST_CHECK(!cache.Read("evict0", 1, data));
+    BOOST_REQUIRE(cache.Read("evict"+NStr::IntToString(kBlobCount-1), 1,
+                             data));
+    BOOST_CHECK(data == blob);
+    BOOST_CHECK(cache.Read("evict"+NStr::IntToString(kBlobCount-2), 1, data));
+
+    // a blob bigger than the map is skipped without evicting anything
+    cache.Write("evict_big", 1, string(32<<20, 'b'), true);
+    BOOST_CHECK(!cache.Read("evict_big", 1, data));
+    BOOST_CHECK(cache.Read("evict"+NStr::IntToString(kBlobCount-1), 1, data));
+}
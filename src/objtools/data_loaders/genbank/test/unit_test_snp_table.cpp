@@ -0,0 +1,235 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Unit tests for parsing, storing and loading of packed SNP tables.
+*
+* ===========================================================================
+*/
+
+#include <ncbi_pch.hpp>
+
+#include <serial/serial.hpp>
+#include <serial/objistrasnb.hpp>
+#include <objects/seq/Seq_annot.hpp>
+#include <objects/seqfeat/Seq_feat.hpp>
+#include <objects/seqfeat/Imp_feat.hpp>
+#include <objects/seqfeat/Gb_qual.hpp>
+#include <objects/general/Dbtag.hpp>
+#include <objects/general/Object_id.hpp>
+#include <objects/seqloc/Seq_id.hpp>
+#include <objects/seqloc/Seq_loc.hpp>
+#include <objects/seqloc/Seq_point.hpp>
+#include <objects/seqloc/Seq_interval.hpp>
+#include <objmgr/impl/snp_annot_info.hpp>
+#include <objtools/data_loaders/genbank/reader_snp.hpp>
+
+#include <algorithm>
+
+// This header must be included before all Boost.Test headers if there are any
+#include <corelib/test_boost.hpp>
+
+#include <common/test_assert.h> // This header must go last
+
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+static const TIntId kGi = 123456;
+static const TSeqPos kMaxPosition = 200;
+static const char* const kAlleles[] = { "A", "C", "G", "T", "-", "AT" };
+static const size_t kAllelesCount = sizeof(kAlleles)/sizeof(kAlleles[0]);
+
+
+static CRef<CSeq_feat> s_GetSNP(int index, size_t alleles)
+{
+    CRef<CSeq_feat> feat(new CSeq_feat);
+    feat->SetData().SetImp().SetKey("variation");
+    for ( size_t i = 0; i < alleles; ++i ) {
+        CRef<CGb_qual> qual(new CGb_qual("allele",
+                                         kAlleles[(index + i) %
+                                                  kAllelesCount]));
+        feat->SetQual().push_back(qual);
+    }
+    CRef<CDbtag> dbtag(new CDbtag);
+    dbtag->SetDb("dbSNP");
+    dbtag->SetTag().SetId(1000 + index);
+    feat->SetDbxref().push_back(dbtag);
+
+    // unsorted positions with repeats, points and short intervals
+    // on both strands
+    TSeqPos to = TSeqPos(index * 7919 % kMaxPosition + 10);
+    CSeq_loc& loc = feat->SetLocation();
+    if ( index % 3 ) {
+        loc.SetPnt().SetId().SetGi(GI_FROM(TIntId, kGi));
+        loc.SetPnt().SetPoint(to);
+    }
+    else {
+        loc.SetInt().SetId().SetGi(GI_FROM(TIntId, kGi));
+        loc.SetInt().SetFrom(to - index % 5 - 1);
+        loc.SetInt().SetTo(to);
+    }
+    if ( index % 4 == 1 ) {
+        loc.SetStrand(eNa_strand_plus);
+    }
+    else if ( index % 4 == 2 ) {
+        loc.SetStrand(eNa_strand_minus);
+    }
+    return feat;
+}
+
+
+static CRef<CSeq_annot> s_GetAnnot(int count)
+{
+    CRef<CSeq_annot> annot(new CSeq_annot);
+    for ( int i = 0; i < count; ++i ) {
+        annot->SetData().SetFtable().push_back(s_GetSNP(i, 2));
+    }
+    // too many alleles to be packed into the table
+    annot->SetData().SetFtable().push_back(s_GetSNP(count, 5));
+    return annot;
+}
+
+
+static CRef<CSeq_annot_SNP_Info> s_Parse(const CSeq_annot& annot)
+{
+    CNcbiOstrstream ostr;
+    ostr << MSerial_AsnBinary << annot;
+    string data = CNcbiOstrstreamToString(ostr);
+    CNcbiIstrstream istr(data);
+    CObjectIStreamAsnBinary in(istr);
+    return CSeq_annot_SNP_Info_Reader::ParseAnnot(in);
+}
+
+
+static void s_CheckFirstIn(const CSeq_annot_SNP_Info& snp_info)
+{
+    for ( TSeqPos pos = 0; pos <= kMaxPosition + 20; ++pos ) {
+        CSeq_annot_SNP_Info::const_iterator expected =
+            lower_bound(snp_info.begin(), snp_info.end(), pos);
+        CSeq_annot_SNP_Info::TRange range(pos, pos + 10);
+        BOOST_CHECK(snp_info.FirstIn(range) == expected);
+    }
+}
+
+
+static void s_CheckSame(const CSeq_annot_SNP_Info& snp_info1,
+                        const CSeq_annot_SNP_Info& snp_info2)
+{
+    BOOST_CHECK(snp_info1.GetSeq_id().Equals(snp_info2.GetSeq_id()));
+    BOOST_REQUIRE_EQUAL(snp_info1.size(), snp_info2.size());
+    for ( size_t i = 0; i < snp_info1.size(); ++i ) {
+        const SSNP_Info& info1 = snp_info1.GetInfo(i);
+        const SSNP_Info& info2 = snp_info2.GetInfo(i);
+        BOOST_CHECK_EQUAL(info1.GetFrom(), info2.GetFrom());
+        BOOST_CHECK_EQUAL(info1.GetTo(), info2.GetTo());
+        BOOST_CHECK_EQUAL(info1.m_SNP_Id, info2.m_SNP_Id);
+        BOOST_CHECK_EQUAL(info1.PlusStrand(), info2.PlusStrand());
+        BOOST_CHECK_EQUAL(info1.MinusStrand(), info2.MinusStrand());
+        BOOST_REQUIRE_EQUAL(info1.GetAllelesCount(), info2.GetAllelesCount());
+        for ( size_t j = 0; j < info1.GetAllelesCount(); ++j ) {
+            BOOST_CHECK_EQUAL
+                (snp_info1.x_GetAllele(info1.GetAlleleStrIndex(j)),
+                 snp_info2.x_GetAllele(info2.GetAlleleStrIndex(j)));
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(TestSNPTableParse)
+{
+    const int kCount = 300;
+    CRef<CSeq_annot> annot = s_GetAnnot(kCount);
+    CRef<CSeq_annot_SNP_Info> snp_info = s_Parse(*annot);
+    BOOST_REQUIRE(snp_info);
+    BOOST_REQUIRE_EQUAL(snp_info->size(), size_t(kCount));
+    BOOST_CHECK(snp_info->GetSeq_id().IsGi());
+    BOOST_CHECK_EQUAL(snp_info->GetSeq_id().GetGi(), GI_FROM(TIntId, kGi));
+
+    // only the complex SNP stays in the Seq-annot
+    BOOST_CHECK_EQUAL
+        (snp_info->GetRemainingSeq_annot().GetData().GetFtable().size(), 1u);
+
+    // the table is sorted and has every parsed SNP
+    vector<bool> seen(kCount);
+    for ( size_t i = 0; i < snp_info->size(); ++i ) {
+        const SSNP_Info& info = snp_info->GetInfo(i);
+        if ( i ) {
+            BOOST_CHECK(snp_info->GetInfo(i-1).GetTo() <= info.GetTo());
+        }
+        int index = info.m_SNP_Id - 1000;
+        BOOST_REQUIRE(index >= 0 && index < kCount);
+        BOOST_CHECK(!seen[index]);
+        seen[index] = true;
+
+        CRef<CSeq_feat> feat = s_GetSNP(index, 2);
+        const CSeq_loc& loc = feat->GetLocation();
+        BOOST_CHECK_EQUAL(info.GetFrom(), loc.GetStart(eExtreme_Positional));
+        BOOST_CHECK_EQUAL(info.GetTo(), loc.GetStop(eExtreme_Positional));
+        BOOST_CHECK_EQUAL(info.PlusStrand(), index % 4 == 1);
+        BOOST_CHECK_EQUAL(info.MinusStrand(), index % 4 == 2);
+        BOOST_REQUIRE_EQUAL(info.GetAllelesCount(), 2u);
+        for ( size_t j = 0; j < 2; ++j ) {
+            BOOST_CHECK_EQUAL(snp_info->x_GetAllele(info.GetAlleleStrIndex(j)),
+                              kAlleles[(index + j) % kAllelesCount]);
+        }
+    }
+
+    // repeated alleles are stored once
+    BOOST_CHECK_EQUAL(snp_info->x_GetAlleles().GetSize(), kAllelesCount);
+
+    s_CheckFirstIn(*snp_info);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestSNPTableStoreLoad)
+{
+    CRef<CSeq_annot_SNP_Info> snp_info = s_Parse(*s_GetAnnot(1000));
+    BOOST_REQUIRE(snp_info);
+
+    CNcbiOstrstream ostr;
+    CSeq_annot_SNP_Info_Reader::Write(ostr, *snp_info);
+    string data = CNcbiOstrstreamToString(ostr);
+    CNcbiIstrstream istr(data);
+    CRef<CSeq_annot_SNP_Info> loaded(new CSeq_annot_SNP_Info);
+    CSeq_annot_SNP_Info_Reader::Read(istr, *loaded);
+
+    s_CheckSame(*snp_info, *loaded);
+    BOOST_CHECK_EQUAL(loaded->x_GetAlleles().GetSize(), kAllelesCount);
+    BOOST_CHECK(loaded->GetRemainingSeq_annot()
+                .Equals(snp_info->GetRemainingSeq_annot()));
+
+    // the loaded table rebuilds its positions for the range search
+    s_CheckFirstIn(*loaded);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestSNPTableEmpty)
+{
+    CSeq_annot_SNP_Info snp_info;
+    CSeq_annot_SNP_Info::TRange range(0, 100);
+    BOOST_CHECK(snp_info.FirstIn(range) == snp_info.end());
+}
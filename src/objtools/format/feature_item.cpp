@@ -1802,6 +1802,7 @@ void CFeatureItem::x_AddQualsIdx(
                         CRef<CBioseqIndex> bsx = idx->GetBioseqIndex (hdl);
                         const CRef<CSeqMasterIndex>& midx = idx->GetMasterIndex();
                         CRef<feature::CFeatTree> ftree = midx->GetFeatTree();
+                        CFastMutexGuard guard(midx->GetFeatTreeMutex());
                         ftree->AddGenesForFeat(m_Feat, ctx.GetAnnotSelector());
                         try {
                             const CMappedFeat mf = ftree->GetBestGene(m_Feat);
@@ -321,6 +321,7 @@ CFlatFileConfig::CFlatFileConfig(
     m_RefSeqConventions = false;
     m_FeatDepth = 0;
     m_GapDepth = 0;
+    m_BioseqThreads = 0;
     SetGenbankBlocks(fGenbankBlocks_All);
     SetGenbankBlockCallback(nullptr);
     SetCanceledCallback(nullptr);
@@ -637,6 +638,9 @@ void CFlatFileConfig::AddArgumentDescriptions(CArgDescriptions& args)
          arg_desc->AddOptionalKey("gap-depth", "GapDepth",
                                   "Gap exploration depth", CArgDescriptions::eInteger);
 
+         arg_desc->AddOptionalKey("bioseq-threads", "BioseqThreads",
+                                  "Number of threads gathering independent Bioseqs of one record", CArgDescriptions::eInteger);
+
          arg_desc->AddOptionalKey("max_search_segments", "MaxSearchSegments",
                                   "Max number of empty segments to search", CArgDescriptions::eInteger);
 
@@ -1085,6 +1089,10 @@ void CFlatFileConfig::FromArguments(const CArgs& args)
         int gapDepth = args["gap-depth"].AsInteger();
         SetGapDepth(gapDepth);
     }
+    if( args["bioseq-threads"] ) {
+        int threads = args["bioseq-threads"].AsInteger();
+        SetBioseqThreads(threads);
+    }
     if (args["accn"]) {
         string singleAccn = args["accn"].AsString();
         SetSingleAccession(singleAccn);
@@ -59,11 +59,299 @@
 
 #include <objects/misc/sequence_macros.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
 BEGIN_NCBI_SCOPE
 BEGIN_SCOPE(objects)
 USING_SCOPE(sequence);
 
 
+//////////////////////////////////////////////////////////////////////////////
+//
+// Parallel gathering of independent Bioseqs
+
+// Bioseq waiting to be gathered by a worker thread
+struct SFlatBioseqJob
+{
+    CSeq_entry_Handle      m_Entry;
+    CBioseq_Handle         m_Bioseq;
+    // where the gathered items finally go, with the formatter already set
+    CRef<CFlatItemOStream> m_ItemOS;
+};
+
+// Holds the items of one Bioseq until all preceding records are written
+class CFlatItemBuffer : public CFlatItemOStream
+{
+public:
+    typedef vector< CConstRef<IFlatItem> > TItems;
+
+    virtual void AddItem(CConstRef<IFlatItem> item) { m_Items.push_back(item); }
+
+    const TItems& GetItems(void) const { return m_Items; }
+
+private:
+    TItems m_Items;
+};
+
+typedef vector<SFlatBioseqJob>         TFlatBioseqJobs;
+typedef vector< CRef<CFlatItemBuffer> > TFlatItemBuffers;
+
+
+// Only the children of a collection set (pop-set, genbank set, ...) are
+// independent: within a nuc-prot, gen-prod or segmented set the gatherer
+// and the Bioseq indexes of one member lazily fill in state of the others.
+static bool s_IsCollectionSet(const CSeq_entry_Handle& entry)
+{
+    if ( ! entry.IsSet()  ||  ! entry.GetSet().IsSetClass() ) {
+        return false;
+    }
+    switch ( entry.GetSet().GetClass() ) {
+    case CBioseq_set::eClass_nuc_prot:
+    case CBioseq_set::eClass_segset:
+    case CBioseq_set::eClass_conset:
+    case CBioseq_set::eClass_parts:
+    case CBioseq_set::eClass_gen_prod_set:
+    case CBioseq_set::eClass_small_genome_set:
+        return false;
+    default:
+        return true;
+    }
+}
+
+
+// child of the generated entry that contains the Bioseq
+static CSeq_entry_Handle s_GetIndependentEntry(const CSeq_entry_Handle& entry,
+                                               const CBioseq_Handle& bsh)
+{
+    CSeq_entry_Handle seh = bsh.GetSeq_entry_Handle();
+    CSeq_entry_Handle parent = seh.GetParentEntry();
+    while ( parent  &&  parent != entry ) {
+        seh = parent;
+        parent = seh.GetParentEntry();
+    }
+    return seh;
+}
+
+
+static TFlatItemBuffers s_GatherBioseqs(CFlatFileContext& ctx,
+                                        const TFlatBioseqJobs& jobs,
+                                        size_t from, size_t to,
+                                        bool useSeqEntryIndexing,
+                                        bool doNuc, bool doProt, bool doFastSets,
+                                        const std::atomic<bool>& stop)
+{
+    TFlatItemBuffers buffers;
+    for ( size_t i = from;  i < to  &&  ! stop;  ++i ) {
+        CRef<CFlatGatherer> gatherer(CFlatGatherer::New(ctx.GetConfig().GetFormat()));
+        if ( !gatherer ) {
+            NCBI_THROW(CFlatException, eInternal, "Unable to initialize gatherer");
+        }
+        CRef<CFlatItemBuffer> buffer(new CFlatItemBuffer);
+        gatherer->Gather(ctx, *buffer, jobs[i].m_Entry, jobs[i].m_Bioseq,
+                         useSeqEntryIndexing, doNuc, doProt, doFastSets);
+        buffers.push_back(buffer);
+    }
+    return buffers;
+}
+
+
+// Context for gathering one group on a worker thread. The gatherer changes
+// its context (RefSeq conventions in the config, feature exclusions of the
+// annot selector), so every group gets its own copy of the snapshot made
+// before the workers start; the snapshot itself is only read.
+static CRef<CFlatFileContext> s_CopyContext(const CFlatFileContext& ctx)
+{
+    CRef<CFlatFileContext> copy(new CFlatFileContext(ctx.GetConfig()));
+    copy->SetEntry(ctx.GetEntry());
+    if ( ctx.GetSubmitBlock() ) {
+        copy->SetSubmit(*ctx.GetSubmitBlock());
+    }
+    if ( ctx.GetAnnotSelector() ) {
+        copy->SetAnnotSelector(*ctx.GetAnnotSelector());
+    }
+    copy->SetLocation(ctx.GetLocation());
+    _ASSERT(!ctx.GetFeatTree());
+    copy->SetSeqEntryIndex(ctx.GetSeqEntryIndex());
+    copy->SetSGS(ctx.GetSGS());
+    return copy;
+}
+
+
+static bool s_IsRefSeq(const CBioseq_Handle& bsh)
+{
+    ITERATE ( CBioseq::TId, it, bsh.GetBioseqCore()->GetId() ) {
+        if ( (*it)->IsOther() ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// In serial mode the context changes only when a Bioseq is gathered that
+// first turns on RefSeq conventions or first excludes nucleotide-only
+// features. When the first group already did it (or no later Bioseq does),
+// all later groups see the same context as in serial mode.
+static bool s_CanGatherInParallel(const TFlatBioseqJobs& jobs,
+                                  size_t first_group_size)
+{
+    bool refseq = false, nuc = false;
+    for ( size_t i = 0;  i < first_group_size;  ++i ) {
+        refseq = refseq  ||  s_IsRefSeq(jobs[i].m_Bioseq);
+        nuc = nuc  ||  jobs[i].m_Bioseq.IsNa();
+    }
+    for ( size_t i = first_group_size;  i < jobs.size();  ++i ) {
+        if ( (!refseq  &&  s_IsRefSeq(jobs[i].m_Bioseq))  ||
+             (!nuc  &&  jobs[i].m_Bioseq.IsNa()) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// Gathers groups of Bioseqs on a fixed pool of 'threads' worker threads
+// while the calling thread formats the finished groups in their original
+// order, so the output (and every formatter call) is the same as in serial
+// mode. The first group is gathered on the calling thread with the shared
+// context, the others on private copies of it (see s_CopyContext()).
+// The workers take the groups by index and store the results in the
+// slot of that index; they run at most two groups per thread ahead of the
+// formatting, which bounds the memory held by the gathered items.
+static void s_GatherBioseqsInParallel(CFlatFileContext& ctx,
+                                      const TFlatBioseqJobs& jobs,
+                                      const vector<size_t>& group_starts,
+                                      size_t threads,
+                                      bool useSeqEntryIndexing,
+                                      bool doNuc, bool doProt, bool doFastSets)
+{
+    struct SGroupResult
+    {
+        bool                   m_Done = false;
+        TFlatItemBuffers       m_Buffers;
+        std::exception_ptr     m_Error;
+        // referenced by the gathered items until they are formatted
+        CRef<CFlatFileContext> m_Context;
+    };
+
+    const size_t group_count = group_starts.size();
+    const size_t max_ahead = threads * 2;
+    vector<SGroupResult> results(group_count);
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::atomic<bool> stop(false);
+    size_t next_group = 1;
+    size_t formatted_groups = 0;
+    CRef<CFlatFileContext> snapshot;
+
+    auto group_end = [&](size_t group)
+    {
+        return group + 1 < group_count ? group_starts[group + 1] : jobs.size();
+    };
+
+    auto worker = [&]()
+    {
+        for ( ;; ) {
+            size_t group;
+            {{
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [&]() {
+                        return stop  ||  next_group >= group_count  ||
+                            next_group < formatted_groups + max_ahead;
+                    });
+                if ( stop  ||  next_group >= group_count ) {
+                    return;
+                }
+                group = next_group++;
+            }}
+            CRef<CFlatFileContext> group_ctx;
+            TFlatItemBuffers buffers;
+            std::exception_ptr error;
+            try {
+                group_ctx = s_CopyContext(*snapshot);
+                buffers = s_GatherBioseqs(*group_ctx, jobs,
+                                          group_starts[group],
+                                          group_end(group),
+                                          useSeqEntryIndexing,
+                                          doNuc, doProt, doFastSets, stop);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+            {{
+                std::lock_guard<std::mutex> lock(mutex);
+                results[group].m_Buffers.swap(buffers);
+                results[group].m_Error = error;
+                results[group].m_Context = group_ctx;
+                results[group].m_Done = true;
+            }}
+            cond.notify_all();
+        }
+    };
+
+    vector<std::thread> pool;
+    try {
+        size_t next_job = 0;
+        for ( size_t group = 0;  group < group_count;  ++group ) {
+            TFlatItemBuffers buffers;
+            if ( group == 0  ||  pool.empty() ) {
+                buffers = s_GatherBioseqs(ctx, jobs,
+                                          group_starts[group],
+                                          group_end(group),
+                                          useSeqEntryIndexing,
+                                          doNuc, doProt, doFastSets, stop);
+                if ( group == 0  &&
+                     s_CanGatherInParallel(jobs, group_end(0)) ) {
+                    snapshot = s_CopyContext(ctx);
+                    threads = min(threads, group_count - 1);
+                    for ( size_t i = 0;  i < threads;  ++i ) {
+                        pool.push_back(std::thread(worker));
+                    }
+                }
+            }
+            else {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [&]() { return results[group].m_Done; });
+                if ( results[group].m_Error ) {
+                    std::rethrow_exception(results[group].m_Error);
+                }
+                buffers.swap(results[group].m_Buffers);
+            }
+            {{
+                std::lock_guard<std::mutex> lock(mutex);
+                formatted_groups = group + 1;
+            }}
+            cond.notify_all();
+            ITERATE ( TFlatItemBuffers, buf, buffers ) {
+                CFlatItemOStream& item_os = jobs[next_job++].m_ItemOS.GetNCObject();
+                ITERATE ( CFlatItemBuffer::TItems, item, (*buf)->GetItems() ) {
+                    item_os.AddItem(*item);
+                }
+            }
+        }
+    }
+    catch (...) {
+        // let the workers finish their current groups early
+        {{
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }}
+        cond.notify_all();
+        NON_CONST_ITERATE ( vector<std::thread>, thr, pool ) {
+            thr->join();
+        }
+        throw;
+    }
+    NON_CONST_ITERATE ( vector<std::thread>, thr, pool ) {
+        thr->join();
+    }
+}
+
+
 //////////////////////////////////////////////////////////////////////////////
 //
 // PUBLIC
@@ -637,6 +925,11 @@ void CFlatFileGenerator::Generate
 
     if (useSeqEntryIndexing) {
         m_Ctx->SetConfig().SetUseSeqEntryIndexer(true);
+    } else if (entry == entry.GetTopLevelEntry()) {
+        // feature items add genes to the tree, so they get a private copy
+        // of the tree shared by all users of the TSE
+        SetFeatTree(feature::CFeatTree::GetTSEFeatTree(entry.GetTSE_Handle())
+                    ->Clone().GetPointer());
     } else {
         SetFeatTree(new feature::CFeatTree(entry));
     }
@@ -819,6 +1112,20 @@ void CFlatFileGenerator::Generate
 
     const string accn_filt = cfg.GetSingleAccession();
 
+    // Bioseqs of different members of a collection set can be gathered
+    // concurrently; formatting stays on this thread, in the original order.
+    // Only the indexed path is safe: without the index, feature items add
+    // genes to the context feature tree while they are being gathered.
+    size_t bioseqThreads = 0;
+    if ( cfg.GetBioseqThreads() > 1  &&  s_IsCollectionSet(entry)  &&
+         m_Ctx->UsingSeqEntryIndex()  &&  ! m_Ctx->GetFeatTree()  &&
+         ! showDebugTiming ) {
+        bioseqThreads = cfg.GetBioseqThreads();
+    }
+    TFlatBioseqJobs parallel_jobs;
+    vector<size_t> group_starts;
+    CSeq_entry_Handle last_group;
+
     // internal Bioseq iterator loop moved up from x_GatherSeqEntry
     for (CBioseq_CI bioseq_it(entry);  bioseq_it;  ++bioseq_it) {
 
@@ -970,6 +1277,16 @@ void CFlatFileGenerator::Generate
 
         pItemOS->SetFormatter(formatter);
 
+        if ( bioseqThreads > 1 ) {
+            CSeq_entry_Handle group = s_GetIndependentEntry(entry, bsh);
+            if ( parallel_jobs.empty()  ||  group != last_group ) {
+                group_starts.push_back(parallel_jobs.size());
+                last_group = group;
+            }
+            parallel_jobs.push_back(SFlatBioseqJob{ent, bsh, pItemOS});
+            continue;
+        }
+
         CRef<CFlatGatherer> gatherer(CFlatGatherer::New(format));
         if ( !gatherer ) {
             NCBI_THROW(CFlatException, eInternal, "Unable to initialize gatherer");
@@ -983,6 +1300,11 @@ void CFlatFileGenerator::Generate
         }
     }
 
+    if ( ! parallel_jobs.empty() ) {
+        s_GatherBioseqsInParallel(*m_Ctx, parallel_jobs, group_starts, bioseqThreads,
+                                  useSeqEntryIndexing, doNuc, doProt, doFastSets);
+    }
+
     /*
     if ( m_Ctx->GetConfig().UseSeqEntryIndexer() ) {
         m_Ctx->ResetSeqEntryIndex();
@@ -1176,9 +1498,8 @@ string CFlatFileGenerator::GetSeqFeatText
     CBioseqContext bctx(seq, *ctx);
 
     if (ftree.Empty()) {
-        CSeq_entry_Handle tseh = seq.GetTopLevelEntry();
-        CFeat_CI iter (tseh);
-        ftree.Reset (new feature::CFeatTree (iter));
+        ftree = feature::CFeatTree::GetTSEFeatTree(seq.GetTSE_Handle())
+            ->Clone();
     }
 
     CConstRef<IFlatItem> item;
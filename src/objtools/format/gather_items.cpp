@@ -259,6 +259,19 @@ CFlatGatherer::~CFlatGatherer(void)
 }
 
 
+static CRef<feature::CFeatTree> s_GetFeatTree(const CSeq_entry_Handle& entry)
+{
+    // tree of the whole TSE is shared with other users of the TSE;
+    // feature items add genes to the tree, so they get a private copy
+    if (entry == entry.GetTopLevelEntry()) {
+        return feature::CFeatTree::GetTSEFeatTree(entry.GetTSE_Handle())
+            ->Clone();
+    }
+    CFeat_CI iter (entry);
+    return Ref(new feature::CFeatTree (iter));
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Protected:
@@ -273,8 +286,7 @@ void CFlatGatherer::x_GatherSeqEntry(CFlatFileContext& ctx,
     m_TopSEH = ctx.GetEntry();
     m_Feat_Tree.Reset(ctx.GetFeatTree());
     if (m_Feat_Tree.Empty() && ! useSeqEntryIndexing) {
-        CFeat_CI iter (m_TopSEH);
-        m_Feat_Tree.Reset (new feature::CFeatTree (iter));
+        m_Feat_Tree = s_GetFeatTree(m_TopSEH);
     }
 
     if (( bsh.IsNa() && doNuc ) || ( bsh.IsAa() && doProt )) {
@@ -326,8 +338,7 @@ void CFlatGatherer::x_GatherSeqEntry(CFlatFileContext& ctx,
     m_TopSEH = ctx.GetEntry();
     m_Feat_Tree.Reset(ctx.GetFeatTree());
     if (m_Feat_Tree.Empty()) {
-        CFeat_CI iter (m_TopSEH);
-        m_Feat_Tree.Reset (new feature::CFeatTree (iter));
+        m_Feat_Tree = s_GetFeatTree(m_TopSEH);
     }
 
 
@@ -0,0 +1,245 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Unit tests comparing the flat file generated with and without
+*   gathering the Bioseqs of a set on worker threads.
+*
+* ===========================================================================
+*/
+
+#include <ncbi_pch.hpp>
+
+#include <objects/seqset/Seq_entry.hpp>
+#include <objects/seqset/Bioseq_set.hpp>
+#include <objects/seq/Bioseq.hpp>
+#include <objects/seq/Seq_annot.hpp>
+#include <objects/seq/Seq_inst.hpp>
+#include <objects/seq/Seq_data.hpp>
+#include <objects/seq/IUPACna.hpp>
+#include <objects/seq/IUPACaa.hpp>
+#include <objects/seq/Seq_descr.hpp>
+#include <objects/seq/Seqdesc.hpp>
+#include <objects/seq/MolInfo.hpp>
+#include <objects/seqblock/GB_block.hpp>
+#include <objects/seqfeat/Seq_feat.hpp>
+#include <objects/seqfeat/Gene_ref.hpp>
+#include <objects/seqfeat/Prot_ref.hpp>
+#include <objects/seqfeat/Cdregion.hpp>
+#include <objects/seqfeat/BioSource.hpp>
+#include <objects/seqfeat/Org_ref.hpp>
+#include <objects/seqloc/Seq_id.hpp>
+#include <objects/seqloc/Seq_loc.hpp>
+#include <objmgr/object_manager.hpp>
+#include <objmgr/scope.hpp>
+#include <objmgr/seq_entry_handle.hpp>
+#include <objtools/format/flat_file_config.hpp>
+#include <objtools/format/flat_file_generator.hpp>
+
+// This header must be included before all Boost.Test headers if there are any
+#include <corelib/test_boost.hpp>
+
+#include <common/test_assert.h> // This header must go last
+
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+static CRef<CSeq_loc> s_GetLoc(const string& id, TSeqPos from, TSeqPos to)
+{
+    CRef<CSeq_loc> loc(new CSeq_loc);
+    loc->SetInt().SetId().Set(id);
+    loc->SetInt().SetFrom(from);
+    loc->SetInt().SetTo(to);
+    return loc;
+}
+
+
+// Nuc-prot set with a gene and a coding region translated into the protein
+static CRef<CSeq_entry> s_GetNucProt(int index, bool refseq)
+{
+    string suffix = NStr::IntToString(index);
+    string nuc_id = refseq ?
+        "ref|NC_" + NStr::IntToString(900000 + index) + ".1" :
+        "lcl|nuc" + suffix;
+    string prot_id = "lcl|prot" + suffix;
+    TSeqPos codons = 30 + index * 7;
+
+    static const char* const kCodons[] = { "GCT", "AAA", "GGC" };
+    static const char kAminoAcids[] = "AKG";
+    string nuc_data = "ATG";
+    string prot_data = "M";
+    for ( TSeqPos i = 1;  i < codons;  ++i ) {
+        nuc_data += kCodons[(i + index) % 3];
+        prot_data += kAminoAcids[(i + index) % 3];
+    }
+    nuc_data += "TAA";
+
+    CRef<CSeq_entry> nuc_entry(new CSeq_entry);
+    CBioseq& nuc = nuc_entry->SetSeq();
+    nuc.SetId().push_back(Ref(new CSeq_id(nuc_id)));
+    nuc.SetInst().SetRepr(CSeq_inst::eRepr_raw);
+    nuc.SetInst().SetMol(CSeq_inst::eMol_dna);
+    nuc.SetInst().SetLength(TSeqPos(nuc_data.size()));
+    nuc.SetInst().SetSeq_data().SetIupacna().Set(nuc_data);
+    CRef<CSeqdesc> title(new CSeqdesc);
+    title->SetTitle("Test organism gene" + suffix + " gene, complete cds");
+    nuc.SetDescr().Set().push_back(title);
+    CRef<CSeqdesc> nuc_molinfo(new CSeqdesc);
+    nuc_molinfo->SetMolinfo().SetBiomol(CMolInfo::eBiomol_genomic);
+    nuc.SetDescr().Set().push_back(nuc_molinfo);
+
+    CRef<CSeq_entry> prot_entry(new CSeq_entry);
+    CBioseq& prot = prot_entry->SetSeq();
+    prot.SetId().push_back(Ref(new CSeq_id(prot_id)));
+    prot.SetInst().SetRepr(CSeq_inst::eRepr_raw);
+    prot.SetInst().SetMol(CSeq_inst::eMol_aa);
+    prot.SetInst().SetLength(TSeqPos(prot_data.size()));
+    prot.SetInst().SetSeq_data().SetIupacaa().Set(prot_data);
+    CRef<CSeqdesc> prot_molinfo(new CSeqdesc);
+    prot_molinfo->SetMolinfo().SetBiomol(CMolInfo::eBiomol_peptide);
+    prot.SetDescr().Set().push_back(prot_molinfo);
+    CRef<CSeq_feat> prot_feat(new CSeq_feat);
+    prot_feat->SetData().SetProt().SetName().push_back("protein " + suffix);
+    prot_feat->SetLocation(*s_GetLoc(prot_id, 0, TSeqPos(prot_data.size()-1)));
+    CRef<CSeq_annot> prot_annot(new CSeq_annot);
+    prot_annot->SetData().SetFtable().push_back(prot_feat);
+    prot.SetAnnot().push_back(prot_annot);
+
+    CRef<CSeq_feat> gene(new CSeq_feat);
+    gene->SetData().SetGene().SetLocus("gene" + suffix);
+    gene->SetLocation(*s_GetLoc(nuc_id, 0, TSeqPos(nuc_data.size()-1)));
+    CRef<CSeq_feat> cds(new CSeq_feat);
+    cds->SetData().SetCdregion();
+    cds->SetLocation(*s_GetLoc(nuc_id, 0, TSeqPos(nuc_data.size()-1)));
+    cds->SetProduct(*s_GetLoc(prot_id, 0, TSeqPos(prot_data.size()-1)));
+    CRef<CSeq_annot> annot(new CSeq_annot);
+    annot->SetData().SetFtable().push_back(gene);
+    annot->SetData().SetFtable().push_back(cds);
+
+    CRef<CSeq_entry> entry(new CSeq_entry);
+    CBioseq_set& set = entry->SetSet();
+    set.SetClass(CBioseq_set::eClass_nuc_prot);
+    set.SetSeq_set().push_back(nuc_entry);
+    set.SetSeq_set().push_back(prot_entry);
+    set.SetAnnot().push_back(annot);
+    CRef<CSeqdesc> source(new CSeqdesc);
+    source->SetSource().SetOrg().SetTaxname("Test organism");
+    set.SetDescr().Set().push_back(source);
+    return entry;
+}
+
+
+// Population set of nuc-prot sets, each one is an independent record;
+// the record with index 'refseq_index' has a RefSeq nucleotide
+static CRef<CSeq_entry> s_GetPopSet(int count, int refseq_index)
+{
+    CRef<CSeq_entry> entry(new CSeq_entry);
+    entry->SetSet().SetClass(CBioseq_set::eClass_pop_set);
+    for ( int i = 0;  i < count;  ++i ) {
+        entry->SetSet().SetSeq_set().push_back
+            (s_GetNucProt(i, i == refseq_index));
+    }
+    return entry;
+}
+
+
+static string s_Generate(const CSeq_entry& entry,
+                         CFlatFileConfig::TFormat format,
+                         CFlatFileConfig::TView view,
+                         int threads)
+{
+    CScope scope(*CObjectManager::GetInstance());
+    CSeq_entry_Handle seh = scope.AddTopLevelSeqEntry(entry);
+
+    CFlatFileConfig cfg(format, CFlatFileConfig::eMode_Entrez,
+                        CFlatFileConfig::eStyle_Normal,
+                        CFlatFileConfig::fUseSeqEntryIndexer, view);
+    cfg.SetBioseqThreads(threads);
+    CFlatFileGenerator generator(cfg);
+    CNcbiOstrstream out;
+    generator.Generate(seh, out);
+    return CNcbiOstrstreamToString(out);
+}
+
+
+static void s_CheckThreads(CFlatFileConfig::TFormat format,
+                           CFlatFileConfig::TView view,
+                           int refseq_index = -1)
+{
+    // more records than the worker threads may gather ahead of formatting
+    const int kRecords = 25;
+    CRef<CSeq_entry> entry = s_GetPopSet(kRecords, refseq_index);
+
+    string serial = s_Generate(*entry, format, view, 0);
+    BOOST_REQUIRE(!serial.empty());
+    BOOST_CHECK(serial.find("gene" + NStr::IntToString(kRecords-1)) != NPOS);
+
+    for ( int threads = 2;  threads <= 8;  threads *= 2 ) {
+        string parallel = s_Generate(*entry, format, view, threads);
+        BOOST_CHECK_MESSAGE(parallel == serial,
+                            "Output with " << threads << " threads differs");
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(TestGenBankThreads)
+{
+    s_CheckThreads(CFlatFileConfig::eFormat_GenBank,
+                   CFlatFileConfig::fViewNucleotides);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestGenBankAllThreads)
+{
+    s_CheckThreads(CFlatFileConfig::eFormat_GenBank,
+                   CFlatFileConfig::fViewAll);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestFTableThreads)
+{
+    s_CheckThreads(CFlatFileConfig::eFormat_FTable,
+                   CFlatFileConfig::fViewNucleotides);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestRefSeqFirstThreads)
+{
+    // RefSeq conventions are turned on by the first record,
+    // so the others are still gathered on the worker threads
+    s_CheckThreads(CFlatFileConfig::eFormat_GenBank,
+                   CFlatFileConfig::fViewAll, 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestRefSeqLaterThreads)
+{
+    // a later record changes the config for the records after it,
+    // so all records are gathered serially
+    s_CheckThreads(CFlatFileConfig::eFormat_GenBank,
+                   CFlatFileConfig::fViewAll, 10);
+}
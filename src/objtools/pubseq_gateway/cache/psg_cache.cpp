@@ -103,6 +103,7 @@ CPubseqGatewayCache::CPubseqGatewayCache(
     : m_BioseqInfoPath(bioseq_info_file_name)
     , m_Si2CsiPath(si2csi_file_name)
     , m_BlobPropPath(blob_prop_file_name)
+    , m_BioseqInfoLruSize(0)
 {
 }
 
@@ -114,6 +115,7 @@ void CPubseqGatewayCache::Open(const set<int>& sat_ids)
 {
     if (!m_BioseqInfoPath.empty()) {
         m_BioseqInfoCache.reset(new CPubseqGatewayCacheBioseqInfo(m_BioseqInfoPath));
+        m_BioseqInfoCache->SetLruCapacity(m_BioseqInfoLruSize);
         try {
             m_BioseqInfoCache->Open();
         } catch (const lmdb::error& e) {
@@ -224,6 +226,39 @@ CPubseqGatewayCache::TSi2CsiResponse CPubseqGatewayCache::FetchSi2CsiLast(void)
     return TSi2CsiResponse();
 }
 
+vector<CPubseqGatewayCache::TBioseqInfoResponse> CPubseqGatewayCache::FetchBioseqInfo(
+    vector<TBioseqInfoRequest> const& requests)
+{
+    if (m_BioseqInfoCache) {
+        vector<TBioseqInfoResponse> responses = m_BioseqInfoCache->Fetch(requests);
+        for (auto & response : responses) {
+            for (auto & record : response) {
+                ApplyInheritedSeqIds(m_BioseqInfoCache.get(), record);
+            }
+        }
+        return responses;
+    }
+    return vector<TBioseqInfoResponse>(requests.size());
+}
+
+vector<CPubseqGatewayCache::TBlobPropResponse> CPubseqGatewayCache::FetchBlobProp(
+    vector<TBlobPropRequest> const& requests)
+{
+    if (m_BlobPropCache) {
+        return m_BlobPropCache->Fetch(requests);
+    }
+    return vector<TBlobPropResponse>(requests.size());
+}
+
+vector<CPubseqGatewayCache::TSi2CsiResponse> CPubseqGatewayCache::FetchSi2Csi(
+    vector<TSi2CsiRequest> const& requests)
+{
+    if (m_Si2CsiCache) {
+        return m_Si2CsiCache->Fetch(requests);
+    }
+    return vector<TSi2CsiResponse>(requests.size());
+}
+
 string CPubseqGatewayCache::PackBioseqInfoKey(const string& accession, int version)
 {
     return CPubseqGatewayCacheBioseqInfo::PackKey(accession, version);
@@ -41,6 +41,9 @@ BEGIN_SCOPE()
     static const size_t kMapSizeInit = 256UL * 1024 * 1024 * 1024;
     static const size_t kMapSizeDelta = 16UL * 1024 * 1024 * 1024;
     static const size_t kMaxReaders = 1024UL;
+    // Reset transactions keep their reader slot, so only part of the slots
+    // may be parked in the pool
+    static const size_t kMaxPooledTxns = kMaxReaders / 4;
 END_SCOPE()
 
 BEGIN_IDBLOB_SCOPE
@@ -51,15 +54,57 @@ CPubseqGatewayCacheBase::CPubseqGatewayCacheBase(const string& file_name)
     m_Env.reset(new lmdb::env(lmdb::env::create()));
 }
 
+CLMDBReadOnlyTxn::~CLMDBReadOnlyTxn()
+{
+    if (m_Txn.handle()) {
+        if (m_Pool) {
+            m_Pool->x_ReleaseReadTxn(move(m_Txn));
+        } else {
+            m_Txn.commit();
+        }
+    }
+}
+
 CPubseqGatewayCacheBase::~CPubseqGatewayCacheBase()
 {
+    // Pooled transactions have to be gone before the environment is closed
+    lock_guard<mutex> lock(m_TxnPoolMutex);
+    m_TxnPool.clear();
 }
 
 CLMDBReadOnlyTxn CPubseqGatewayCacheBase::BeginReadTxn()
+{
+    lmdb::txn txn(nullptr);
+    {
+        lock_guard<mutex> lock(m_TxnPoolMutex);
+        if (!m_TxnPool.empty()) {
+            txn = move(m_TxnPool.back());
+            m_TxnPool.pop_back();
+        }
+    }
+    if (txn.handle()) {
+        txn.renew();
+    } else {
+        txn = lmdb::txn::begin(*m_Env, nullptr, MDB_RDONLY);
+    }
+    return CLMDBReadOnlyTxn(move(txn), this);
+}
+
+CLMDBReadOnlyTxn CPubseqGatewayCacheBase::BeginOpenTxn()
 {
     return CLMDBReadOnlyTxn(lmdb::txn::begin(*m_Env, nullptr, MDB_RDONLY));
 }
 
+void CPubseqGatewayCacheBase::x_ReleaseReadTxn(lmdb::txn&& txn)
+{
+    lmdb::txn released(move(txn));
+    released.reset();
+    lock_guard<mutex> lock(m_TxnPoolMutex);
+    if (m_TxnPool.size() < kMaxPooledTxns) {
+        m_TxnPool.push_back(move(released));
+    }
+}
+
 void CPubseqGatewayCacheBase::Open()
 {
     struct stat st;
@@ -76,7 +121,9 @@ void CPubseqGatewayCacheBase::Open()
     m_Env->set_max_dbs(kLmdbMaxDbCount);
     m_Env->set_max_readers(kMaxReaders);
     m_Env->set_mapsize(mapsize);
-    m_Env->open(m_FileName.c_str(), MDB_RDONLY | MDB_NOSUBDIR | MDB_NOSYNC | MDB_NOMETASYNC, 0664);
+    // MDB_NOTLS: pooled read transactions are renewed by whichever thread
+    // needs one, so they must not be bound to the thread that created them
+    m_Env->open(m_FileName.c_str(), MDB_RDONLY | MDB_NOSUBDIR | MDB_NOSYNC | MDB_NOMETASYNC | MDB_NOTLS, 0664);
 }
 
 END_IDBLOB_SCOPE
@@ -33,8 +33,10 @@
  */
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <util/lmdbxx/lmdb++.h>
 
@@ -45,23 +47,26 @@
 BEGIN_IDBLOB_SCOPE
 USING_NCBI_SCOPE;
 
+class CPubseqGatewayCacheBase;
+
 class CLMDBReadOnlyTxn
 {
  public:
     CLMDBReadOnlyTxn()
         : m_Txn(nullptr)
+        , m_Pool(nullptr)
     {
     }
 
-    explicit CLMDBReadOnlyTxn(lmdb::txn&& txn)
+    // @param pool - cache the transaction is returned to (reset) instead of
+    //               being committed; nullptr commits it
+    explicit CLMDBReadOnlyTxn(lmdb::txn&& txn, CPubseqGatewayCacheBase* pool = nullptr)
         : m_Txn(move(txn))
+        , m_Pool(pool)
     {
     }
 
-    ~CLMDBReadOnlyTxn()
-    {
-        m_Txn.commit();
-    }
+    ~CLMDBReadOnlyTxn();
 
     CLMDBReadOnlyTxn(CLMDBReadOnlyTxn&&) = default;
     CLMDBReadOnlyTxn(const CLMDBReadOnlyTxn&) = delete;
@@ -73,8 +78,15 @@ class CLMDBReadOnlyTxn
         return m_Txn.handle();
     }
 
+    // Id of the database snapshot the transaction reads
+    size_t GetSnapshotId() const
+    {
+        return mdb_txn_id(m_Txn.handle());
+    }
+
  private:
     lmdb::txn m_Txn;
+    CPubseqGatewayCacheBase* m_Pool;
 };
 
 class CPubseqGatewayCacheBase
@@ -86,9 +98,24 @@ class CPubseqGatewayCacheBase
     void Open();
 
  protected:
+    // Read transaction for lookups. Transactions are reused: a finished one
+    // is reset and parked in a pool, the next lookup on any thread renews it
+    // instead of allocating a new one and a reader slot
     CLMDBReadOnlyTxn BeginReadTxn();
+
+    // New read transaction committed on destruction, so that dbi handles
+    // opened in it stay valid for the life of the environment
+    CLMDBReadOnlyTxn BeginOpenTxn();
+
     string m_FileName;
     unique_ptr<lmdb::env> m_Env;
+
+ private:
+    friend class CLMDBReadOnlyTxn;
+    void x_ReleaseReadTxn(lmdb::txn&& txn);
+
+    mutex m_TxnPoolMutex;
+    vector<lmdb::txn> m_TxnPool;
 };
 
 END_IDBLOB_SCOPE
@@ -33,6 +33,7 @@
 
 #include "psg_cache_bioseq_info.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -90,7 +91,7 @@ void CPubseqGatewayCacheBioseqInfo::Open()
 {
     CPubseqGatewayCacheBase::Open();
     {
-        auto rdtxn = BeginReadTxn();
+        auto rdtxn = BeginOpenTxn();
         m_Dbi = unique_ptr<lmdb::dbi, function<void(lmdb::dbi*)>>(
             new lmdb::dbi({lmdb::dbi::open(rdtxn, "#DATA", 0)}),
             [this](lmdb::dbi* dbi){
@@ -164,6 +165,82 @@ bool CPubseqGatewayCacheBioseqInfo::x_ExtractRecord(CBioseqInfoRecord& record, l
     return true;
 }
 
+string CPubseqGatewayCacheBioseqInfo::x_MakeLruKey(CBioseqInfoFetchRequest const& request) const
+{
+    // Accession cannot contain zero bytes; the rest tells which fields are set
+    string key = request.GetAccession();
+    key.append(1, 0);
+    if (request.HasField(TField::eVersion)) {
+        key += "v" + to_string(request.GetVersion());
+    }
+    if (request.HasField(TField::eSeqIdType)) {
+        key += "t" + to_string(request.GetSeqIdType());
+    }
+    if (request.HasField(TField::eGI)) {
+        key += "g" + to_string(request.GetGI());
+    }
+    return key;
+}
+
+void CPubseqGatewayCacheBioseqInfo::SetLruCapacity(size_t capacity)
+{
+    if (capacity > 0) {
+        m_Lru.reset(new CPubseqGatewayCacheLru<string, vector<CBioseqInfoRecord>>(capacity));
+    } else {
+        m_Lru.reset();
+    }
+}
+
+void CPubseqGatewayCacheBioseqInfo::x_Fetch(
+    CLMDBReadOnlyTxn const& rdtxn, lmdb::cursor& cursor, string const& filter,
+    CBioseqInfoFetchRequest const& request, vector<CBioseqInfoRecord>& response)
+{
+    string lru_key;
+    if (m_Lru) {
+        lru_key = x_MakeLruKey(request);
+        if (m_Lru->Get(lru_key, rdtxn.GetSnapshotId(), response)) {
+            return;
+        }
+    }
+
+    lmdb::val val;
+    if (cursor.get(lmdb::val(filter), val, MDB_SET_RANGE)) {
+        lmdb::val key;
+        string accession = request.GetAccession();
+        bool has_current = cursor.get(key, val, MDB_GET_CURRENT);
+        while (has_current) {
+            int seq_id_type{-1}, version{-1};
+            int64_t gi{-1};
+            if (
+                key.size() != PackedKeySize(accession.size())
+                || accession.compare(key.data<const char>()) != 0
+            ) {
+                break;
+            }
+
+            has_current = UnpackKey(key.data<const char>(), key.size(), version, seq_id_type, gi);
+            if (has_current && x_IsMatchingRecord(request, version, seq_id_type, gi)) {
+                response.resize(response.size() + 1);
+                auto& last_record = response[response.size() - 1];
+                last_record
+                    .SetAccession(accession)
+                    .SetVersion(version)
+                    .SetSeqIdType(seq_id_type)
+                    .SetGI(gi);
+                // Skip record if we cannot parse protobuf data
+                if (!x_ExtractRecord(last_record, val)) {
+                    response.resize(response.size() - 1);
+                }
+            }
+            has_current = cursor.get(key, val, MDB_NEXT);
+        }
+    }
+
+    if (m_Lru) {
+        m_Lru->Put(lru_key, rdtxn.GetSnapshotId(), response);
+    }
+}
+
 vector<CBioseqInfoRecord> CPubseqGatewayCacheBioseqInfo::Fetch(CBioseqInfoFetchRequest const& request)
 {
     vector<CBioseqInfoRecord> response;
@@ -174,42 +251,40 @@ vector<CBioseqInfoRecord> CPubseqGatewayCacheBioseqInfo::Fetch(CBioseqInfoFetchR
     string filter = x_MakeLookupKey(request);
     {
         auto rdtxn = BeginReadTxn();
-        lmdb::val val;
         auto cursor = lmdb::cursor::open(rdtxn, *m_Dbi);
-        if (cursor.get(lmdb::val(filter), val, MDB_SET_RANGE)) {
-            lmdb::val key;
-            string accession = request.GetAccession();
-            bool has_current = cursor.get(key, val, MDB_GET_CURRENT);
-            while (has_current) {
-                int seq_id_type{-1}, version{-1};
-                int64_t gi{-1};
-                if (
-                    key.size() != PackedKeySize(accession.size())
-                    || accession.compare(key.data<const char>()) != 0
-                ) {
-                    break;
-                }
+        x_Fetch(rdtxn, cursor, filter, request, response);
+    }
 
-                has_current = UnpackKey(key.data<const char>(), key.size(), version, seq_id_type, gi);
-                if (has_current && x_IsMatchingRecord(request, version, seq_id_type, gi)) {
-                    response.resize(response.size() + 1);
-                    auto& last_record = response[response.size() - 1];
-                    last_record
-                        .SetAccession(accession)
-                        .SetVersion(version)
-                        .SetSeqIdType(seq_id_type)
-                        .SetGI(gi);
-                    // Skip record if we cannot parse protobuf data
-                    if (!x_ExtractRecord(last_record, val)) {
-                        response.resize(response.size() - 1);
-                    }
-                }
-                has_current = cursor.get(key, val, MDB_NEXT);
-            }
+    return response;
+}
+
+vector<vector<CBioseqInfoRecord>> CPubseqGatewayCacheBioseqInfo::Fetch(
+    vector<CBioseqInfoFetchRequest> const& requests)
+{
+    vector<vector<CBioseqInfoRecord>> responses(requests.size());
+    vector<pair<string, size_t>> lookups;
+    lookups.reserve(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (requests[i].HasField(CBioseqInfoFetchRequest::EFields::eAccession)) {
+            lookups.emplace_back(x_MakeLookupKey(requests[i]), i);
+        }
+    }
+    if (lookups.empty()) {
+        return responses;
+    }
+
+    // Ascending keys make every seek land near the previous one, so the
+    // cursor walks mostly through pages it has just touched
+    sort(lookups.begin(), lookups.end());
+    {
+        auto rdtxn = BeginReadTxn();
+        auto cursor = lmdb::cursor::open(rdtxn, *m_Dbi);
+        for (auto const & lookup : lookups) {
+            x_Fetch(rdtxn, cursor, lookup.first, requests[lookup.second], responses[lookup.second]);
         }
     }
 
-    return response;
+    return responses;
 }
 
 vector<CBioseqInfoRecord> CPubseqGatewayCacheBioseqInfo::FetchLast(void)
@@ -37,6 +37,7 @@
 #include <vector>
 
 #include "psg_cache_base.hpp"
+#include "psg_cache_lru.hpp"
 
 #include <objtools/pubseq_gateway/impl/cassandra/IdCassScope.hpp>
 #include <objtools/pubseq_gateway/impl/cassandra/request.hpp>
@@ -52,7 +53,13 @@ class CPubseqGatewayCacheBioseqInfo
     virtual ~CPubseqGatewayCacheBioseqInfo() override;
     void Open();
 
+    // Keep up to capacity decoded lookup results in memory; 0 disables it
+    void SetLruCapacity(size_t capacity);
+
     vector<CBioseqInfoRecord> Fetch(CBioseqInfoFetchRequest const& request);
+    // Results are in the order of requests. Lookups run in key order on
+    // a single cursor within one read transaction
+    vector<vector<CBioseqInfoRecord>> Fetch(vector<CBioseqInfoFetchRequest> const& requests);
     vector<CBioseqInfoRecord> FetchLast(void);
 
     static string PackKey(const string& accession, int version);
@@ -65,9 +72,14 @@ class CPubseqGatewayCacheBioseqInfo
  private:
     bool x_ExtractRecord(CBioseqInfoRecord& record, lmdb::val const& value) const;
     string x_MakeLookupKey(CBioseqInfoFetchRequest const& request) const;
+    string x_MakeLruKey(CBioseqInfoFetchRequest const& request) const;
+    void x_Fetch(
+        CLMDBReadOnlyTxn const& rdtxn, lmdb::cursor& cursor, string const& filter,
+        CBioseqInfoFetchRequest const& request, vector<CBioseqInfoRecord>& response);
     bool x_IsMatchingRecord(CBioseqInfoFetchRequest const& request, int version, int seq_id_type, int64_t gi) const;
     void ResetDbi();
     unique_ptr<lmdb::dbi, function<void(lmdb::dbi*)>> m_Dbi;
+    unique_ptr<CPubseqGatewayCacheLru<string, vector<CBioseqInfoRecord>>> m_Lru;
 };
 
 END_IDBLOB_SCOPE
@@ -32,9 +32,11 @@
 
 #include "psg_cache_blob_prop.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <set>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -71,7 +73,7 @@ void CPubseqGatewayCacheBlobProp::Open(const set<int>& sat_ids)
     }
 
     CPubseqGatewayCacheBase::Open();
-    auto rdtxn = BeginReadTxn();
+    auto rdtxn = BeginOpenTxn();
     for (const auto & sat_id : sat_ids) {
         unique_ptr<lmdb::dbi, function<void(lmdb::dbi*)>> pdbi;
         string sat_dbi = string("#DATA[") + to_string(sat_id) + "]";
@@ -119,56 +121,108 @@ bool CPubseqGatewayCacheBlobProp::x_ExtractRecord(CBlobRecord& record, lmdb::val
     return true;
 }
 
-vector<CBlobRecord> CPubseqGatewayCacheBlobProp::Fetch(CBlobFetchRequest const& request)
+bool CPubseqGatewayCacheBlobProp::x_IsValidRequest(CBlobFetchRequest const& request) const
 {
-    vector<CBlobRecord> response;
     if (
         !request.HasField(CBlobFetchRequest::EFields::eSat)
         || !request.HasField(CBlobFetchRequest::EFields::eSatKey)
     ) {
-        return response;
+        return false;
     }
     auto sat = request.GetSat();
-    if (!m_Env || sat < 0 || static_cast<size_t>(sat) >= m_Dbis.size() || !m_Dbis[sat]) {
-        return response;
+    return m_Env && sat >= 0 && static_cast<size_t>(sat) < m_Dbis.size() && m_Dbis[sat];
+}
+
+string CPubseqGatewayCacheBlobProp::x_MakeLookupKey(CBlobFetchRequest const& request) const
+{
+    if (request.HasField(CBlobFetchRequest::EFields::eLastModified)) {
+        return PackKey(request.GetSatKey(), request.GetLastModified());
     }
+    return PackKey(request.GetSatKey());
+}
+
+void CPubseqGatewayCacheBlobProp::x_Fetch(
+    lmdb::cursor& cursor, string const& filter,
+    CBlobFetchRequest const& request, vector<CBlobRecord>& response) const
+{
     auto sat_key = request.GetSatKey();
     bool with_modified = request.HasField(CBlobFetchRequest::EFields::eLastModified);
-    string filter = with_modified ? PackKey(sat_key, request.GetLastModified()) : PackKey(sat_key);
-    {
-        auto rdtxn = BeginReadTxn();
-        lmdb::val val;
-        auto cursor = lmdb::cursor::open(rdtxn, *m_Dbis[sat]);
-        if (cursor.get(lmdb::val(filter), val, MDB_SET_RANGE)) {
-            lmdb::val key;
-            bool has_current = cursor.get(key, val, MDB_GET_CURRENT);
-            while (has_current) {
-                int64_t last_modified{-1};
-                if (
-                    key.size() != kPackedKeySize
-                    || memcmp(key.data<const char>(), filter.c_str(), filter.size()) != 0
-                ) {
-                    break;
-                }
+    lmdb::val val;
+    if (cursor.get(lmdb::val(filter), val, MDB_SET_RANGE)) {
+        lmdb::val key;
+        bool has_current = cursor.get(key, val, MDB_GET_CURRENT);
+        while (has_current) {
+            int64_t last_modified{-1};
+            if (
+                key.size() != kPackedKeySize
+                || memcmp(key.data<const char>(), filter.c_str(), filter.size()) != 0
+            ) {
+                break;
+            }
 
-                has_current = UnpackKey(key.data<const char>(), key.size(), last_modified);
-                if (has_current && (!with_modified || last_modified == request.GetLastModified())) {
-                    response.resize(response.size() + 1);
-                    auto& last_record = response[response.size() - 1];
-                    last_record.SetKey(sat_key);
-                    last_record.SetModified(last_modified);
-                    // Skip record if we cannot parse protobuf data
-                    if (!x_ExtractRecord(last_record, val)) {
-                        response.resize(response.size() - 1);
-                    }
+            has_current = UnpackKey(key.data<const char>(), key.size(), last_modified);
+            if (has_current && (!with_modified || last_modified == request.GetLastModified())) {
+                response.resize(response.size() + 1);
+                auto& last_record = response[response.size() - 1];
+                last_record.SetKey(sat_key);
+                last_record.SetModified(last_modified);
+                // Skip record if we cannot parse protobuf data
+                if (!x_ExtractRecord(last_record, val)) {
+                    response.resize(response.size() - 1);
                 }
-                has_current = cursor.get(key, val, MDB_NEXT);
             }
+            has_current = cursor.get(key, val, MDB_NEXT);
         }
     }
+}
+
+vector<CBlobRecord> CPubseqGatewayCacheBlobProp::Fetch(CBlobFetchRequest const& request)
+{
+    vector<CBlobRecord> response;
+    if (!x_IsValidRequest(request)) {
+        return response;
+    }
+    string filter = x_MakeLookupKey(request);
+    {
+        auto rdtxn = BeginReadTxn();
+        auto cursor = lmdb::cursor::open(rdtxn, *m_Dbis[request.GetSat()]);
+        x_Fetch(cursor, filter, request, response);
+    }
     return response;
 }
 
+vector<vector<CBlobRecord>> CPubseqGatewayCacheBlobProp::Fetch(vector<CBlobFetchRequest> const& requests)
+{
+    using TLookup = tuple<int32_t, string, size_t>;
+
+    vector<vector<CBlobRecord>> responses(requests.size());
+    vector<TLookup> lookups;
+    lookups.reserve(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (x_IsValidRequest(requests[i])) {
+            lookups.emplace_back(requests[i].GetSat(), x_MakeLookupKey(requests[i]), i);
+        }
+    }
+    if (lookups.empty()) {
+        return responses;
+    }
+    sort(lookups.begin(), lookups.end());
+    {
+        auto rdtxn = BeginReadTxn();
+        lmdb::cursor cursor(nullptr);
+        int32_t cursor_sat = -1;
+        for (auto const & lookup : lookups) {
+            if (get<0>(lookup) != cursor_sat) {
+                // The replaced cursor is closed along with the temporary
+                cursor_sat = get<0>(lookup);
+                cursor = lmdb::cursor::open(rdtxn, *m_Dbis[cursor_sat]);
+            }
+            x_Fetch(cursor, get<1>(lookup), requests[get<2>(lookup)], responses[get<2>(lookup)]);
+        }
+    }
+    return responses;
+}
+
 vector<CBlobRecord> CPubseqGatewayCacheBlobProp::FetchLast(CBlobFetchRequest const& request)
 {
     vector<CBlobRecord> response;
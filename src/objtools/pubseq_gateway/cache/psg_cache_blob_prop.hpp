@@ -58,6 +58,9 @@ class CPubseqGatewayCacheBlobProp
     void Open(const set<int>& sat_ids);
 
     vector<CBlobRecord> Fetch(CBlobFetchRequest const& request);
+    // Results are in the order of requests. Lookups run in (sat, key) order
+    // within one read transaction, one cursor per satellite
+    vector<vector<CBlobRecord>> Fetch(vector<CBlobFetchRequest> const& requests);
     vector<CBlobRecord> FetchLast(CBlobFetchRequest const& request);
     void EnumerateBlobProp(int32_t sat, TBlobPropEnumerateFn fn);
 
@@ -68,6 +71,11 @@ class CPubseqGatewayCacheBlobProp
 
  private:
     bool x_ExtractRecord(CBlobRecord& record, lmdb::val const& value) const;
+    bool x_IsValidRequest(CBlobFetchRequest const& request) const;
+    string x_MakeLookupKey(CBlobFetchRequest const& request) const;
+    void x_Fetch(
+        lmdb::cursor& cursor, string const& filter,
+        CBlobFetchRequest const& request, vector<CBlobRecord>& response) const;
     vector<unique_ptr<lmdb::dbi, function<void(lmdb::dbi*)>>> m_Dbis;
 };
 
@@ -0,0 +1,132 @@
+#ifndef PSG_CACHE_LRU__HPP_
+#define PSG_CACHE_LRU__HPP_
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: LRU of decoded records kept in front of LMDB lookups
+ *
+ */
+
+#include <corelib/ncbistl.hpp>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include <objtools/pubseq_gateway/impl/cassandra/IdCassScope.hpp>
+
+BEGIN_IDBLOB_SCOPE
+
+// Values are tagged with the id of the LMDB snapshot they were read from.
+// When a newer snapshot shows up the whole content is dropped, so a lookup
+// never returns records older than the data a fresh read transaction sees.
+template<typename TKey, typename TValue>
+class CPubseqGatewayCacheLru
+{
+ public:
+    explicit CPubseqGatewayCacheLru(size_t capacity)
+        : m_Capacity(capacity)
+        , m_SnapshotId(0)
+    {
+    }
+
+    CPubseqGatewayCacheLru(const CPubseqGatewayCacheLru&) = delete;
+    CPubseqGatewayCacheLru& operator=(const CPubseqGatewayCacheLru&) = delete;
+
+    size_t GetCapacity() const
+    {
+        return m_Capacity;
+    }
+
+    bool Get(const TKey& key, size_t snapshot_id, TValue& value)
+    {
+        lock_guard<mutex> lock(m_Mutex);
+        x_CheckSnapshot(snapshot_id);
+        if (snapshot_id != m_SnapshotId) {
+            return false;
+        }
+        auto it = m_Index.find(key);
+        if (it == m_Index.end()) {
+            return false;
+        }
+        m_Items.splice(m_Items.begin(), m_Items, it->second);
+        value = it->second->second;
+        return true;
+    }
+
+    void Put(const TKey& key, size_t snapshot_id, const TValue& value)
+    {
+        lock_guard<mutex> lock(m_Mutex);
+        x_CheckSnapshot(snapshot_id);
+        if (m_Capacity == 0 || snapshot_id != m_SnapshotId) {
+            return;
+        }
+        auto it = m_Index.find(key);
+        if (it != m_Index.end()) {
+            it->second->second = value;
+            m_Items.splice(m_Items.begin(), m_Items, it->second);
+            return;
+        }
+        if (m_Items.size() >= m_Capacity) {
+            m_Index.erase(m_Items.back().first);
+            m_Items.pop_back();
+        }
+        m_Items.emplace_front(key, value);
+        m_Index.emplace(key, m_Items.begin());
+    }
+
+    void Clear()
+    {
+        lock_guard<mutex> lock(m_Mutex);
+        m_Index.clear();
+        m_Items.clear();
+    }
+
+ private:
+    using TItems = list<pair<TKey, TValue>>;
+
+    void x_CheckSnapshot(size_t snapshot_id)
+    {
+        // Transactions started before the switch still read the old
+        // snapshot; they just bypass the LRU
+        if (snapshot_id > m_SnapshotId) {
+            m_Index.clear();
+            m_Items.clear();
+            m_SnapshotId = snapshot_id;
+        }
+    }
+
+    size_t m_Capacity;
+    size_t m_SnapshotId;
+    mutex m_Mutex;
+    TItems m_Items;
+    unordered_map<TKey, typename TItems::iterator> m_Index;
+};
+
+END_IDBLOB_SCOPE
+
+#endif  // PSG_CACHE_LRU__HPP_
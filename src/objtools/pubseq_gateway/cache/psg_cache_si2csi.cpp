@@ -33,6 +33,7 @@
 
 #include "psg_cache_si2csi.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -72,7 +73,7 @@ void CPubseqGatewayCacheSi2Csi::Open()
 {
     CPubseqGatewayCacheBase::Open();
     {
-        auto rdtxn = BeginReadTxn();
+        auto rdtxn = BeginOpenTxn();
         m_Dbi = unique_ptr<lmdb::dbi, function<void(lmdb::dbi*)>>(
             new lmdb::dbi({lmdb::dbi::open(rdtxn, "#DATA", 0)}),
             [this](lmdb::dbi* dbi){
@@ -99,49 +100,91 @@ bool CPubseqGatewayCacheSi2Csi::x_ExtractRecord(CSI2CSIRecord& record, lmdb::val
     return true;
 }
 
+string CPubseqGatewayCacheSi2Csi::x_MakeLookupKey(CSi2CsiFetchRequest const& request) const
+{
+    if (request.HasField(CSi2CsiFetchRequest::EFields::eSecSeqIdType)) {
+        return PackKey(request.GetSecSeqId(), request.GetSecSeqIdType());
+    }
+    return request.GetSecSeqId();
+}
+
+void CPubseqGatewayCacheSi2Csi::x_Fetch(
+    lmdb::cursor& cursor, string const& filter,
+    CSi2CsiFetchRequest const& request, vector<CSI2CSIRecord>& response) const
+{
+    string sec_seqid = request.GetSecSeqId();
+    bool with_type = request.HasField(CSi2CsiFetchRequest::EFields::eSecSeqIdType);
+    lmdb::val val;
+    if (cursor.get(lmdb::val(filter), val, MDB_SET_RANGE)) {
+        lmdb::val key;
+        bool has_current = cursor.get(key, val, MDB_GET_CURRENT);
+        while (has_current) {
+            int sec_seq_it_type{-1};
+            if (
+                key.size() != PackedKeySize(sec_seqid.size())
+                || sec_seqid.compare(key.data<const char>()) != 0
+            ) {
+                break;
+            }
+            has_current = UnpackKey(key.data<const char>(), key.size(), sec_seq_it_type);
+            if (has_current && (!with_type || sec_seq_it_type == request.GetSecSeqIdType())) {
+                response.resize(response.size() + 1);
+                auto& last_record = response[response.size() - 1];
+                last_record
+                    .SetSecSeqId(sec_seqid)
+                    .SetSecSeqIdType(sec_seq_it_type);
+                // Skip record if we cannot parse protobuf data
+                if (!x_ExtractRecord(last_record, val)) {
+                    response.resize(response.size() - 1);
+                }
+            }
+            has_current = cursor.get(key, val, MDB_NEXT);
+        }
+    }
+}
+
 vector<CSI2CSIRecord> CPubseqGatewayCacheSi2Csi::Fetch(CSi2CsiFetchRequest const& request)
 {
     vector<CSI2CSIRecord> response;
     if (!m_Env || !request.HasField(CSi2CsiFetchRequest::EFields::eSecSeqId)) {
         return response;
     }
-    string sec_seqid = request.GetSecSeqId();
-    bool with_type = request.HasField(CSi2CsiFetchRequest::EFields::eSecSeqIdType);
-    string filter = with_type ? PackKey(sec_seqid, request.GetSecSeqIdType()) : sec_seqid;
+    string filter = x_MakeLookupKey(request);
     {
         auto rdtxn = BeginReadTxn();
-        lmdb::val val;
         auto cursor = lmdb::cursor::open(rdtxn, *m_Dbi);
-        if (cursor.get(lmdb::val(filter), val, MDB_SET_RANGE)) {
-            lmdb::val key;
-            bool has_current = cursor.get(key, val, MDB_GET_CURRENT);
-            while (has_current) {
-                int sec_seq_it_type{-1};
-                if (
-                    key.size() != PackedKeySize(sec_seqid.size())
-                    || sec_seqid.compare(key.data<const char>()) != 0
-                ) {
-                    break;
-                }
-                has_current = UnpackKey(key.data<const char>(), key.size(), sec_seq_it_type);
-                if (has_current && (!with_type || sec_seq_it_type == request.GetSecSeqIdType())) {
-                    response.resize(response.size() + 1);
-                    auto& last_record = response[response.size() - 1];
-                    last_record
-                        .SetSecSeqId(sec_seqid)
-                        .SetSecSeqIdType(sec_seq_it_type);
-                    // Skip record if we cannot parse protobuf data
-                    if (!x_ExtractRecord(last_record, val)) {
-                        response.resize(response.size() - 1);
-                    }
-                }
-                has_current = cursor.get(key, val, MDB_NEXT);
-            }
-        }
+        x_Fetch(cursor, filter, request, response);
     }
     return response;
 }
 
+vector<vector<CSI2CSIRecord>> CPubseqGatewayCacheSi2Csi::Fetch(vector<CSi2CsiFetchRequest> const& requests)
+{
+    vector<vector<CSI2CSIRecord>> responses(requests.size());
+    if (!m_Env) {
+        return responses;
+    }
+    vector<pair<string, size_t>> lookups;
+    lookups.reserve(requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (requests[i].HasField(CSi2CsiFetchRequest::EFields::eSecSeqId)) {
+            lookups.emplace_back(x_MakeLookupKey(requests[i]), i);
+        }
+    }
+    if (lookups.empty()) {
+        return responses;
+    }
+    sort(lookups.begin(), lookups.end());
+    {
+        auto rdtxn = BeginReadTxn();
+        auto cursor = lmdb::cursor::open(rdtxn, *m_Dbi);
+        for (auto const & lookup : lookups) {
+            x_Fetch(cursor, lookup.first, requests[lookup.second], responses[lookup.second]);
+        }
+    }
+    return responses;
+}
+
 vector<CSI2CSIRecord> CPubseqGatewayCacheSi2Csi::FetchLast(void)
 {
     vector<CSI2CSIRecord> response;
@@ -54,6 +54,9 @@ class CPubseqGatewayCacheSi2Csi
     void Open();
 
     vector<CSI2CSIRecord> Fetch(CSi2CsiFetchRequest const& request);
+    // Results are in the order of requests. Lookups run in key order on
+    // a single cursor within one read transaction
+    vector<vector<CSI2CSIRecord>> Fetch(vector<CSi2CsiFetchRequest> const& requests);
     vector<CSI2CSIRecord> FetchLast();
 
     static string PackKey(const string& sec_seqid, int sec_seq_id_type);
@@ -62,6 +65,10 @@ class CPubseqGatewayCacheSi2Csi
 
  private:
     bool x_ExtractRecord(CSI2CSIRecord& record, lmdb::val const& value) const;
+    string x_MakeLookupKey(CSi2CsiFetchRequest const& request) const;
+    void x_Fetch(
+        lmdb::cursor& cursor, string const& filter,
+        CSi2CsiFetchRequest const& request, vector<CSI2CSIRecord>& response) const;
     unique_ptr<lmdb::dbi, function<void(lmdb::dbi*)>> m_Dbi;
 };
 
@@ -31,16 +31,19 @@
 
 #include <ncbi_pch.hpp>
 
+#include <atomic>
 #include <climits>
 #include <list>
 #include <map>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <corelib/ncbiapp.hpp>
 #include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
 
 #include <objects/seqloc/Seq_id.hpp>
 #include <objects/general/Dbtag.hpp>
@@ -62,6 +65,7 @@ using TJob = enum class EJob {
     jb_unpack_bp_key,
     jb_last_si,
     jb_last_bi,
+    jb_bench_bi,
 };
 
 bool IsHex(char ch)
@@ -118,6 +122,10 @@ class CTestPsgCache
         : m_job(TJob::jb_lookup_bi_primary)
         , m_force_version{}
         , m_force_seq_id_type{}
+        , m_threads{1}
+        , m_batch{0}
+        , m_iterations{1}
+        , m_lru_size{0}
     {}
     virtual ~CTestPsgCache() = default;
     virtual void Init();
@@ -141,6 +149,7 @@ class CTestPsgCache
     void LookupBioseqInfoBySecondary(const string& fasta_seqid, int force_seq_id_type);
     void LookupPrimaryBySecondary(const string& fasta_seqid, int force_seq_id_type);
     void LookupBlobProp(int sat, int sat_key, int64_t last_modified = -1);
+    void BenchmarkBioseqInfo(const string& file_name);
 
     string m_BioseqInfoDbFile;
     string m_Si2csiDbFile;
@@ -150,6 +159,10 @@ class CTestPsgCache
     string m_query;
     int m_force_version;
     int m_force_seq_id_type;
+    int m_threads;
+    int m_batch;
+    int m_iterations;
+    int m_lru_size;
 };
 
 void CTestPsgCache::Init()
@@ -161,12 +174,19 @@ void CTestPsgCache::Init()
        "File with configuration information", CArgDescriptions::eString, "test_psg_cache.ini");
     argdesc->AddKey("j", "job", "Job type", CArgDescriptions::eString);
     argdesc->SetConstraint("j",
-        &(*new CArgAllow_Strings, "bi_pri", "bi_sec", "si2csi", "blob_prop", "unp_bi", "unp_si", "unp_bp", "last_si", "last_bi"),
+        &(*new CArgAllow_Strings, "bi_pri", "bi_sec", "si2csi", "blob_prop", "unp_bi", "unp_si", "unp_bp", "last_si", "last_bi",
+            "bench_bi"),
         CArgDescriptions::eConstraint
     );
     argdesc->AddOptionalKey("q", "query", "Query string (depends on job type)", CArgDescriptions::eString);
     argdesc->AddDefaultKey("v", "ver", "Force version", CArgDescriptions::eInteger, to_string(INT_MIN));
     argdesc->AddDefaultKey("t", "seqidtype", "Force seq_id_type", CArgDescriptions::eInteger, to_string(INT_MIN));
+    argdesc->AddDefaultKey("threads", "threads", "Benchmark: number of threads", CArgDescriptions::eInteger, "1");
+    argdesc->AddDefaultKey("batch", "batch",
+        "Benchmark: requests per batch lookup, 0 - single lookups", CArgDescriptions::eInteger, "0");
+    argdesc->AddDefaultKey("n", "iterations",
+        "Benchmark: number of passes over the list of seq_ids", CArgDescriptions::eInteger, "1");
+    argdesc->AddDefaultKey("lru", "size", "Size of bioseq_info LRU, 0 - disabled", CArgDescriptions::eInteger, "0");
     SetupArgDescriptions(argdesc.release());
 }
 
@@ -182,6 +202,7 @@ void CTestPsgCache::ParseArgs()
         { "unp_bp", TJob::jb_unpack_bp_key    },
         { "last_si", TJob::jb_last_si },
         { "last_bi", TJob::jb_last_bi },
+        { "bench_bi", TJob::jb_bench_bi },
     });
 
     const CArgs & args = GetArgs();
@@ -203,12 +224,17 @@ void CTestPsgCache::ParseArgs()
     }
     m_force_version = args["v"].AsInteger();
     m_force_seq_id_type = args["t"].AsInteger();
+    m_threads = max(args["threads"].AsInteger(), 1);
+    m_batch = max(args["batch"].AsInteger(), 0);
+    m_iterations = max(args["n"].AsInteger(), 1);
+    m_lru_size = max(args["lru"].AsInteger(), 0);
 }
 
 int CTestPsgCache::Run()
 {
     ParseArgs();
     m_LookupCache.reset(new CPubseqGatewayCache(m_BioseqInfoDbFile, m_Si2csiDbFile, m_BlobPropDbFile));
+    m_LookupCache->SetBioseqInfoLruSize(m_lru_size);
     m_LookupCache->Open({50});
 
     switch (m_job) {
@@ -228,6 +254,10 @@ int CTestPsgCache::Run()
             LookupBioseqInfoBySecondary(m_query, m_force_seq_id_type);
             break;
         }
+        case TJob::jb_bench_bi: {
+            BenchmarkBioseqInfo(m_query);
+            break;
+        }
         case TJob::jb_lookup_primary_secondary: {
             LookupPrimaryBySecondary(m_query, m_force_seq_id_type);
             break;
@@ -541,6 +571,78 @@ void CTestPsgCache::LookupBlobProp(int sat, int sat_key, int64_t last_modified)
     }
 }
 
+void CTestPsgCache::BenchmarkBioseqInfo(const string& file_name)
+{
+    vector<CPubseqGatewayCache::TBioseqInfoRequest> requests;
+    CNcbiIfstream input(file_name.c_str());
+    string line;
+    while (getline(input, line)) {
+        NStr::TruncateSpacesInPlace(line);
+        int version = -1;
+        int seq_id_type = -1;
+        string accession;
+        if (line.empty() || !ParsePrimarySeqId(line, accession, version, seq_id_type)) {
+            continue;
+        }
+        CPubseqGatewayCache::TBioseqInfoRequest request;
+        request.SetAccession(accession);
+        if (version >= 0) {
+            request.SetVersion(version);
+        }
+        requests.push_back(request);
+    }
+    if (requests.empty()) {
+        ERR_POST(Error << "Query parameter expected: file with primary seq_ids, one per line");
+        return;
+    }
+
+    // Every thread makes the same number of passes, each starting at its
+    // own offset so that threads do not march over the same keys in step
+    atomic<size_t> lookups{0};
+    atomic<size_t> hits{0};
+    CStopWatch sw(CStopWatch::eStart);
+    vector<thread> threads;
+    for (int t = 0; t < m_threads; ++t) {
+        threads.emplace_back([this, t, &requests, &lookups, &hits] {
+            size_t count = requests.size();
+            size_t pos = count * t / m_threads;
+            size_t thread_lookups = 0;
+            size_t thread_hits = 0;
+            vector<CPubseqGatewayCache::TBioseqInfoRequest> batch;
+            for (size_t i = 0; i < count * m_iterations; ++i) {
+                auto const& request = requests[pos];
+                pos = (pos + 1) % count;
+                ++thread_lookups;
+                if (m_batch == 0) {
+                    thread_hits += m_LookupCache->FetchBioseqInfo(request).empty() ? 0 : 1;
+                    continue;
+                }
+                batch.push_back(request);
+                if (batch.size() == static_cast<size_t>(m_batch) || i + 1 == count * m_iterations) {
+                    for (auto const& response : m_LookupCache->FetchBioseqInfo(batch)) {
+                        thread_hits += response.empty() ? 0 : 1;
+                    }
+                    batch.clear();
+                }
+            }
+            lookups += thread_lookups;
+            hits += thread_hits;
+        });
+    }
+    for (auto& item : threads) {
+        item.join();
+    }
+    double elapsed = sw.Elapsed();
+
+    cout << "threads: " << m_threads << endl
+         << "batch: " << m_batch << endl
+         << "lru: " << m_lru_size << endl
+         << "lookups: " << lookups << endl
+         << "hits: " << hits << endl
+         << "elapsed: " << NStr::DoubleToString(elapsed, 3) << " s" << endl
+         << "rate: " << NStr::DoubleToString(elapsed > 0 ? lookups / elapsed : 0, 0) << " lookups/s" << endl;
+}
+
 int main(int argc, const char* argv[])
 {
     return CTestPsgCache().AppMain(argc, argv);
@@ -72,8 +72,8 @@ class CPsgCacheBioseqInfoTest
 
         CNcbiIfstream i(config_path, ifstream::in | ifstream::binary);
         CNcbiRegistry r(i);
-        string file_name = r.GetString("LMDB_CACHE", "bioseq_info", "");
-        m_Cache = make_unique<CPubseqGatewayCache>(file_name, "", "");
+        m_FileName = r.GetString("LMDB_CACHE", "bioseq_info", "");
+        m_Cache = make_unique<CPubseqGatewayCache>(m_FileName, "", "");
         m_Cache->Open({});
     }
 
@@ -83,9 +83,11 @@ class CPsgCacheBioseqInfoTest
     }
 
     static unique_ptr<CPubseqGatewayCache> m_Cache;
+    static string m_FileName;
 };
 
 unique_ptr<CPubseqGatewayCache> CPsgCacheBioseqInfoTest::m_Cache(nullptr);
+string CPsgCacheBioseqInfoTest::m_FileName;
 
 TEST_F(CPsgCacheBioseqInfoTest, LookupUninitialized)
 {
@@ -259,5 +261,57 @@ TEST_F(CPsgCacheBioseqInfoTest, LookupBioseqInfoForLastRecord)
     EXPECT_EQ(last.GetGI(), response[0].GetGI());
 }
 
+TEST_F(CPsgCacheBioseqInfoTest, BatchLookup)
+{
+    vector<CPubseqGatewayCache::TBioseqInfoRequest> requests(5);
+    requests[0].SetAccession("NC_000001").SetVersion(5);
+    requests[1].SetAccession("FAKE");
+    requests[2].SetAccession("AC005299").SetVersion(0);
+    requests[3].SetVersion(0);
+    requests[4].SetAccession("AC005299").SetGI(3643631);
+
+    auto responses = m_Cache->FetchBioseqInfo(requests);
+    ASSERT_EQ(requests.size(), responses.size());
+    EXPECT_TRUE(responses[1].empty());
+    EXPECT_TRUE(responses[3].empty());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        auto response = m_Cache->FetchBioseqInfo(requests[i]);
+        ASSERT_EQ(response.size(), responses[i].size());
+        for (size_t j = 0; j < response.size(); ++j) {
+            EXPECT_EQ(response[j].GetAccession(), responses[i][j].GetAccession());
+            EXPECT_EQ(response[j].GetVersion(), responses[i][j].GetVersion());
+            EXPECT_EQ(response[j].GetGI(), responses[i][j].GetGI());
+            EXPECT_EQ(response[j].GetSeqIds(), responses[i][j].GetSeqIds());
+        }
+    }
+}
+
+TEST_F(CPsgCacheBioseqInfoTest, LookupWithLru)
+{
+    unique_ptr<CPubseqGatewayCache> cache = make_unique<CPubseqGatewayCache>(m_FileName, "", "");
+    cache->SetBioseqInfoLruSize(2);
+    cache->Open({});
+
+    CPubseqGatewayCache::TBioseqInfoRequest request;
+    request.SetAccession("AC005299").SetVersion(0);
+    // Second round is served from the LRU, third one after eviction
+    for (int round = 0; round < 3; ++round) {
+        auto response = cache->FetchBioseqInfo(request);
+        ASSERT_EQ(response.size(), 5UL);
+        EXPECT_EQ("AC005299", response[0].GetAccession());
+        EXPECT_EQ(3746100, response[0].GetGI());
+        if (round == 1) {
+            CPubseqGatewayCache::TBioseqInfoRequest other;
+            cache->FetchBioseqInfo(other.SetAccession("AC005299").SetGI(3643631));
+            cache->FetchBioseqInfo(other.Reset().SetAccession("NC_000001").SetVersion(5));
+        }
+    }
+
+    request.Reset().SetAccession("AC005299").SetGI(3643631);
+    auto response = cache->FetchBioseqInfo(request);
+    ASSERT_EQ(response.size(), 1UL);
+    EXPECT_EQ(3643631, response[0].GetGI());
+}
+
 END_SCOPE()
 
@@ -200,5 +200,25 @@ TEST_F(CPsgCacheBlobPropTest, EnumerateBlobProp)
     EXPECT_EQ(1020, rows);
 }
 
+TEST_F(CPsgCacheBlobPropTest, BatchLookup)
+{
+    vector<CPubseqGatewayCache::TBlobPropRequest> requests(5);
+    requests[0].SetSat(4).SetSatKey(9965740);
+    requests[1].SetSat(-10).SetSatKey(2054006);
+    requests[2].SetSat(0).SetSatKey(2054006).SetLastModified(823387172086);
+    requests[3].SetSat(0).SetSatKey(-500);
+    requests[4].SetSat(0).SetSatKey(2054006);
+
+    auto responses = m_Cache->FetchBlobProp(requests);
+    ASSERT_EQ(requests.size(), responses.size());
+    EXPECT_TRUE(responses[1].empty());
+    EXPECT_TRUE(responses[3].empty());
+    ASSERT_EQ(1UL, responses[0].size());
+    EXPECT_EQ(1114019083516, responses[0][0].GetModified());
+    ASSERT_EQ(1UL, responses[2].size());
+    EXPECT_EQ(823387172086, responses[2][0].GetModified());
+    EXPECT_EQ(m_Cache->FetchBlobProp(requests[4]).size(), responses[4].size());
+}
+
 END_SCOPE()
 
@@ -157,5 +157,24 @@ TEST_F(CPsgCacheSi2CsiTest, LookupCsiForLastRecord)
     EXPECT_EQ(last.GetGI(), response[0].GetGI());
 }
 
+TEST_F(CPsgCacheSi2CsiTest, BatchLookup)
+{
+    vector<CPubseqGatewayCache::TSi2CsiRequest> requests(4);
+    requests[0].SetSecSeqId("3643631").SetSecSeqIdType(12);
+    requests[1].SetSecSeqId("FAKE");
+    requests[2].SetSecSeqId("3643631");
+    requests[3].SetSecSeqId("3643631").SetSecSeqIdType(0);
+
+    auto responses = m_Cache->FetchSi2Csi(requests);
+    ASSERT_EQ(requests.size(), responses.size());
+    EXPECT_TRUE(responses[1].empty());
+    EXPECT_TRUE(responses[3].empty());
+    ASSERT_EQ(1UL, responses[0].size());
+    ASSERT_EQ(1UL, responses[2].size());
+    EXPECT_EQ(12, responses[0][0].GetSecSeqIdType());
+    EXPECT_EQ(responses[0][0].GetAccession(), responses[2][0].GetAccession());
+    EXPECT_EQ(responses[0][0].GetGI(), responses[2][0].GetGI());
+}
+
 END_SCOPE()
 
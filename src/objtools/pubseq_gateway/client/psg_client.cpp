@@ -101,13 +101,53 @@ ERW_Result SPSG_BlobReader::x_Read(void* buf, size_t count, size_t* bytes_read)
 
         if (!count) return eRW_Success;
 
-        m_Index = 0;
+        x_ReleaseChunk();
     }
 
+    return x_GetEndResult();
+}
+
+ERW_Result SPSG_BlobReader::x_ReadInPlace(const char** data, size_t* bytes_read)
+{
+    assert(data);
+    assert(bytes_read);
+
+    *bytes_read = 0;
+
+    CheckForNewChunks();
+
+    for (; m_Chunk < m_Data.size(); ++m_Chunk) {
+        auto& chunk = m_Data[m_Chunk];
+
+        // Chunk has not been received yet
+        if (chunk.empty()) return eRW_Success;
+
+        if (m_Index < chunk.size()) {
+            *data = chunk.data() + m_Index;
+            *bytes_read = chunk.size() - m_Index;
+            m_Index = chunk.size();
+            return eRW_Success;
+        }
+
+        x_ReleaseChunk();
+    }
+
+    return x_GetEndResult();
+}
+
+ERW_Result SPSG_BlobReader::x_GetEndResult()
+{
     auto src_locked = m_Src.GetLock();
     return src_locked->expected.Cmp<equal_to>(src_locked->received) ? eRW_Eof : eRW_Success;
 }
 
+void SPSG_BlobReader::x_ReleaseChunk()
+{
+    // Chunks are read only once, no need to keep the whole blob in memory
+    SPSG_Chunk().swap(m_Data[m_Chunk]);
+    m_Index = 0;
+}
+
 ERW_Result SPSG_BlobReader::Read(void* buf, size_t count, size_t* bytes_read)
 {
     size_t read;
@@ -128,6 +168,24 @@ ERW_Result SPSG_BlobReader::Read(void* buf, size_t count, size_t* bytes_read)
     return eRW_Error;
 }
 
+ERW_Result SPSG_BlobReader::ReadInPlace(const char** data, size_t* bytes_read)
+{
+    assert(bytes_read);
+
+    const auto kSeconds = TPSG_ReaderTimeout::GetDefault();
+    CDeadline deadline(kSeconds);
+
+    do {
+        auto rv = x_ReadInPlace(data, bytes_read);
+
+        if ((rv != eRW_Success) || (*bytes_read != 0)) return rv;
+    }
+    while (m_Src.WaitUntil(deadline));
+
+    NCBI_THROW_FMT(CPSG_Exception, eTimeout, "Timeout on reading (after " << kSeconds << " seconds)");
+    return eRW_Error;
+}
+
 ERW_Result SPSG_BlobReader::PendingCount(size_t* count)
 {
     assert(count);
@@ -168,6 +226,35 @@ void SPSG_BlobReader::CheckForNewChunks()
 }
 
 
+SPSG_BlobStreambuf::int_type SPSG_BlobStreambuf::underflow()
+{
+    if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+    const char* data = nullptr;
+    size_t read = 0;
+
+    try {
+        if (m_Reader.ReadInPlace(&data, &read) != eRW_Success) return traits_type::eof();
+    }
+    catch (CPSG_Exception& ex) {
+        // The stream reports the failure to the consumer instead
+        ERR_POST("Failed to read blob data: " << ex.GetMsg());
+        OnReadError();
+        return traits_type::eof();
+    }
+
+    // The get area is never written to, the chunk is only consumed from
+    auto begin = const_cast<char*>(data);
+    setg(begin, begin, begin + read);
+    return traits_type::to_int_type(*begin);
+}
+
+streamsize SPSG_BlobStreambuf::showmanyc()
+{
+    size_t count;
+    return m_Reader.PendingCount(&count) == eRW_Success ? static_cast<streamsize>(count) : -1;
+}
+
 const char* s_GetRequestTypeName(CPSG_Request::EType type)
 {
     switch (type) {
@@ -933,7 +1020,7 @@ shared_ptr<CPSG_Reply> CPSG_Queue::SImpl::SendRequestAndGetReply(shared_ptr<CPSG
 
     auto request = make_shared<SPSG_Request>(move(abs_path_ref), reply, request_context->Clone(), params);
 
-    if (ioc.AddRequest(request, queue->Stopped(), deadline)) {
+    if (ioc.AddRequest(request, queue->Stopped(), deadline, user_request->GetType())) {
         if (stats) stats->IncCounter(SPSG_Stats::eRequest, user_request->GetType());
         shared_ptr<CPSG_Reply> user_reply(new CPSG_Reply);
         user_reply->m_Impl->reply = move(reply);
@@ -38,15 +38,14 @@
 #include "psg_client_transport.hpp"
 
 #include <corelib/reader_writer.hpp>
-#include <corelib/rwstream.hpp>
 
+#include <deque>
 #include <unordered_map>
 #include <mutex>
 
 BEGIN_NCBI_SCOPE
 
-// ICC does not like this array to be a direct base of SPSG_RStream
-struct SPSG_BlobReader : IReader, protected array<char, 64 * 1024>
+struct SPSG_BlobReader : IReader
 {
     using TStats = pair<bool, weak_ptr<SPSG_Stats>>;
     SPSG_BlobReader(SPSG_Reply::SItem::TTS& src, TStats stats = TStats());
@@ -54,24 +53,55 @@ struct SPSG_BlobReader : IReader, protected array<char, 64 * 1024>
     ERW_Result Read(void* buf, size_t count, size_t* bytes_read = 0);
     ERW_Result PendingCount(size_t* count);
 
+    // Provides the next received part of the data in place (without copying),
+    // it stays valid until the next call.
+    ERW_Result ReadInPlace(const char** data, size_t* bytes_read);
+
 private:
     void CheckForNewChunks();
     ERW_Result x_Read(void* buf, size_t count, size_t* bytes_read);
+    ERW_Result x_ReadInPlace(const char** data, size_t* bytes_read);
+    ERW_Result x_GetEndResult();
+    void x_ReleaseChunk();
 
     SPSG_Reply::SItem::TTS& m_Src;
     TStats m_Stats;
-    vector<SPSG_Chunk> m_Data;
+
+    // Chunks must not move when more of them arrive,
+    // ReadInPlace() and SPSG_BlobStreambuf point into them
+    deque<SPSG_Chunk> m_Data;
     size_t m_Chunk = 0;
     size_t m_Index = 0;
 };
 
-struct SPSG_RStream : private SPSG_BlobReader, public CRStream
+// Uses received chunks as its get area, so data is not copied
+// until the consumer (e.g. decompressor or CObjectIStream) reads it
+struct SPSG_BlobStreambuf : streambuf
+{
+    template <class... TArgs>
+    SPSG_BlobStreambuf(TArgs&&... args) : m_Reader(forward<TArgs>(args)...) {}
+
+protected:
+    int_type underflow() override;
+    streamsize showmanyc() override;
+
+    // Called when the data cannot be read (e.g. on timeout)
+    virtual void OnReadError() {}
+
+private:
+    SPSG_BlobReader m_Reader;
+};
+
+struct SPSG_RStream : private SPSG_BlobStreambuf, public istream
 {
     template <class... TArgs>
     SPSG_RStream(TArgs&&... args) :
-        SPSG_BlobReader(forward<TArgs>(args)...),
-        CRStream(this, size(), data())
+        SPSG_BlobStreambuf(forward<TArgs>(args)...),
+        istream(this)
     {}
+
+private:
+    void OnReadError() override { setstate(badbit); }
 };
 
 struct CPSG_ReplyItem::SImpl
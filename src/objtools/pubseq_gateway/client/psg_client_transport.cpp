@@ -80,6 +80,8 @@ NCBI_PARAM_DEF(bool,     PSG, https,                  false);
 NCBI_PARAM_DEF(double,   PSG, no_servers_retry_delay, 1.0);
 NCBI_PARAM_DEF(bool,     PSG, stats,                  false);
 NCBI_PARAM_DEF(double,   PSG, stats_period,           0.0);
+NCBI_PARAM_DEF(bool,     PSG, coalesce_requests,      false);
+NCBI_PARAM_DEF(double,   PSG, resolve_cache_ttl,      0.0);
 
 NCBI_PARAM_DEF(double,   PSG, throttle_relaxation_period,                  0.0);
 NCBI_PARAM_DEF(unsigned, PSG, throttle_by_consecutive_connection_failures, 0);
@@ -424,6 +426,36 @@ struct SPSG_StatsCounters::SGroup<SPSG_StatsCounters::eRetries>
     }
 };
 
+enum EPSG_StatsCountersCoalescing {
+    ePSG_StatsCountersCoalescing_Coalesced,
+    ePSG_StatsCountersCoalescing_ResolveCacheHit,
+};
+
+template <>
+struct SPSG_StatsCounters::SGroup<SPSG_StatsCounters::eCoalescing>
+{
+    using type = EPSG_StatsCountersCoalescing;
+    static constexpr size_t size = ePSG_StatsCountersCoalescing_ResolveCacheHit + 1;
+    static constexpr auto prefix = "\tcoalescing\tevent=";
+
+    static constexpr array<type, size> values = {
+        ePSG_StatsCountersCoalescing_Coalesced,
+        ePSG_StatsCountersCoalescing_ResolveCacheHit,
+    };
+
+    static const char* ValueName(type value)
+    {
+        switch (value) {
+            case ePSG_StatsCountersCoalescing_Coalesced:        return "coalesced";
+            case ePSG_StatsCountersCoalescing_ResolveCacheHit:  return "resolve_cache_hit";
+        }
+
+        // Should not happen
+        _TROUBLE;
+        return "unknown";
+    }
+};
+
 template <SPSG_Stats::EGroup group>
 void SPSG_StatsCounters::SInit::Func(TData& data)
 {
@@ -466,6 +498,7 @@ void SPSG_StatsCounters::Apply(EGroup start_with, TArgs&&... args)
         case eReplyItemStatus:  TWhat::template Func<eReplyItemStatus>  (forward<TArgs>(args)...);
         case eMessage:          TWhat::template Func<eMessage>          (forward<TArgs>(args)...);
         case eRetries:          TWhat::template Func<eRetries>          (forward<TArgs>(args)...);
+        case eCoalescing:       TWhat::template Func<eCoalescing>       (forward<TArgs>(args)...);
     }
 }
 
@@ -725,6 +758,122 @@ void SPSG_Request::Reset()
     processed_by.Reset();
     m_Buffer = SBuffer{};
     m_ItemsByID.clear();
+
+    if (m_Coalescing) {
+        auto shared_locked = m_Shared.GetLock();
+        shared_locked->data.clear();
+
+        for (auto& follower : shared_locked->followers) {
+            follower->Reset();
+        }
+    }
+}
+
+void SPSG_Request::SetShared(shared_ptr<SPSG_Coalescing> coalescing, bool cache_reply)
+{
+    _ASSERT(coalescing);
+
+    m_Coalescing = move(coalescing);
+    m_Shared.GetLock()->cache_reply = cache_reply;
+}
+
+bool SPSG_Request::AddFollower(shared_ptr<SPSG_Request> follower)
+{
+    _ASSERT(follower);
+
+    auto shared_locked = m_Shared.GetLock();
+
+    // Too late, some reply data has already been parsed
+    if (!shared_locked->accepts_followers) {
+        return false;
+    }
+
+    // Followers parse only data the leader has accepted, so they never retry on their own
+    follower->m_Retries.Zero();
+    shared_locked->followers.emplace_back(move(follower));
+    return true;
+}
+
+SPSG_Request::EStateResult SPSG_Request::OnSharedReplyData(SPSG_Processor::TId processor_id, const char* data, size_t len)
+{
+    auto shared_locked = m_Shared.GetLock();
+    shared_locked->accepts_followers = false;
+
+    const auto rv = Parse(data, len);
+
+    // Followers are reset along with this request, no need to feed them
+    if (rv == eRetry) {
+        return rv;
+    }
+
+    for (auto& follower : shared_locked->followers) {
+        follower->OnReplyData(processor_id, data, len);
+    }
+
+    if (shared_locked->cache_reply) {
+        shared_locked->data.append(data, len);
+    }
+
+    return rv;
+}
+
+static bool s_CanCache(SPSG_Reply& reply)
+{
+    if (reply.reply_item->state.GetStatus() != EPSG_Status::eSuccess) {
+        return false;
+    }
+
+    auto items_locked = reply.items.GetLock();
+    auto failed = [](auto& item) { return item->state.GetStatus() == EPSG_Status::eError; };
+    return none_of(items_locked->begin(), items_locked->end(), failed);
+}
+
+void SPSG_Request::SReplies::SetComplete()
+{
+    request.reply->SetComplete();
+
+    if (!request.m_Coalescing) return;
+
+    vector<shared_ptr<SPSG_Request>> followers;
+    string data;
+
+    // The coalescing locks must not be acquired while holding this one
+    if (auto shared_locked = request.m_Shared.GetLock()) {
+        shared_locked->accepts_followers = false;
+        followers.swap(shared_locked->followers);
+        if (shared_locked->cache_reply) data.swap(shared_locked->data);
+    }
+
+    for (auto& follower : followers) {
+        follower->reply->SetComplete();
+    }
+
+    request.m_Coalescing->OnReplyDone(request);
+
+    if (!data.empty() && s_CanCache(*request.reply)) {
+        request.m_Coalescing->Store(request.full_path, move(data));
+    }
+}
+
+void SPSG_Request::SReplies::SetFailed(string message, EPSG_Status status)
+{
+    request.reply->SetFailed(message, status);
+
+    if (!request.m_Coalescing) return;
+
+    vector<shared_ptr<SPSG_Request>> followers;
+
+    if (auto shared_locked = request.m_Shared.GetLock()) {
+        shared_locked->accepts_followers = false;
+        followers.swap(shared_locked->followers);
+        shared_locked->data.clear();
+    }
+
+    for (auto& follower : followers) {
+        follower->reply->SetFailed(message, status);
+    }
+
+    request.m_Coalescing->OnReplyDone(request);
 }
 
 SPSG_Request::EStateResult SPSG_Request::StatePrefix(const char*& data, size_t& len)
@@ -1047,7 +1196,7 @@ int SPSG_IoSession::OnData(nghttp2_session*, uint8_t, int32_t stream_id, const u
                 m_Queue.Emplace(req);
 
             } else {
-                req->reply->SetComplete();
+                req->OnReplyDone(processor_id).SetComplete();
             }
         }
 
@@ -1078,7 +1227,7 @@ bool SPSG_Request::Fail(SPSG_Processor::TId processor_id, const SUvNgHttp2_Error
     auto context_guard = context.Set();
 
     reply->debug_printout << error << endl;
-    OnReplyDone(processor_id)->SetFailed(error);
+    OnReplyDone(processor_id).SetFailed(error);
     return true;
 }
 
@@ -1115,7 +1264,7 @@ int SPSG_IoSession::OnStreamClose(nghttp2_session*, int32_t stream_id, uint32_t
                     ERR_POST("Request for " << GetId() << " failed with " << error);
                 }
             } else {
-                req->OnReplyDone(processor_id)->SetComplete();
+                req->OnReplyDone(processor_id).SetComplete();
                 server.throttling.AddSuccess();
                 PSG_THROTTLING_TRACE("Server '" << GetId() << "' processed request '" <<
                         debug_printout.id << "' successfully");
@@ -1146,7 +1295,7 @@ int SPSG_IoSession::OnHeader(nghttp2_session*, const nghttp2_frame* frame, const
             if (status != EPSG_Status::eSuccess) {
                 if (auto [processor_id, req] = it->second.Get(); req) {
                     const auto error = to_string(request_status) + ' ' + CRequestStatus::GetStdStatusMessage(request_status);
-                    req->OnReplyDone(processor_id)->SetFailed(error, status);
+                    req->OnReplyDone(processor_id).SetFailed(error, status);
                 } else {
                     m_Requests.erase(it);
                 }
@@ -1773,7 +1922,7 @@ void SPSG_IoImpl::FailRequests()
             auto context_guard = req->context.Set();
             auto& debug_printout = req->reply->debug_printout;
             debug_printout << error << endl;
-            req->OnReplyDone(processor_id)->SetFailed(error);
+            req->OnReplyDone(processor_id).SetFailed(error);
             PSG_IO_TRACE("No servers to process request '" << debug_printout.id << '\'');
         }
     }
@@ -1857,19 +2006,134 @@ SPSG_IoCoordinator::SPSG_IoCoordinator(CServiceDiscovery service) :
     }
 
     m_Barrier.Wait();
+
+    const auto coalesce = TPSG_CoalesceRequests::GetDefault();
+    const auto cache_ttl = TPSG_ResolveCacheTtl::GetDefault();
+
+    if (coalesce || (cache_ttl > 0.0)) {
+        m_Coalescing = make_shared<SPSG_Coalescing>(coalesce, max(cache_ttl, 0.0), stats);
+    }
 }
 
-bool SPSG_IoCoordinator::AddRequest(shared_ptr<SPSG_Request> req, const atomic_bool&, const CDeadline&)
+bool SPSG_IoCoordinator::AddRequest(shared_ptr<SPSG_Request> req, const atomic_bool&, const CDeadline&, CPSG_Request::EType type)
 {
     if (m_Io.size() == 0) {
         ERR_POST(Fatal << "IO is not open");
     }
 
+    if (m_Coalescing && m_Coalescing->Join(req, type)) {
+        return true;
+    }
+
     const auto idx = (m_RequestCounter++ / params.requests_per_io) % m_Io.size();
     m_Io[idx]->queue.Emplace(move(req));
     return true;
 }
 
+bool SPSG_Coalescing::Join(const shared_ptr<SPSG_Request>& req, CPSG_Request::EType type)
+{
+    _ASSERT(req);
+
+    const auto is_resolve = type == CPSG_Request::eResolve;
+
+    if (!is_resolve && (type != CPSG_Request::eBiodata)) {
+        return false;
+    }
+
+    const auto cache_reply = is_resolve && (m_CacheTtl > TClock::duration::zero());
+
+    if (cache_reply && Replay(req)) {
+        if (auto stats = m_Stats.lock()) stats->IncCounter(SPSG_Stats::eCoalescing, ePSG_StatsCountersCoalescing_ResolveCacheHit);
+        return true;
+    }
+
+    if (m_Coalesce) {
+        auto in_flight_locked = m_InFlight.GetLock();
+        auto& leader = (*in_flight_locked)[req->full_path];
+
+        if (auto existing = leader.lock(); existing && existing->AddFollower(req)) {
+            if (auto stats = m_Stats.lock()) stats->IncCounter(SPSG_Stats::eCoalescing, ePSG_StatsCountersCoalescing_Coalesced);
+            return true;
+        }
+
+        req->SetShared(shared_from_this(), cache_reply);
+        leader = req;
+
+    } else if (cache_reply) {
+        req->SetShared(shared_from_this(), cache_reply);
+    }
+
+    return false;
+}
+
+void SPSG_Coalescing::OnReplyDone(const SPSG_Request& req)
+{
+    if (!m_Coalesce) return;
+
+    auto in_flight_locked = m_InFlight.GetLock();
+    auto it = in_flight_locked->find(req.full_path);
+
+    if (it == in_flight_locked->end()) return;
+
+    // The path may already be led by a newer request
+    auto leader = it->second.lock();
+
+    if (!leader || (leader.get() == &req)) {
+        in_flight_locked->erase(it);
+    }
+}
+
+void SPSG_Coalescing::Store(const string& full_path, string data)
+{
+    // Expired replies are only removed on lookups, so drop them all once the cache gets large
+    constexpr size_t kMaxSize = 10000;
+
+    const auto now = TClock::now();
+    auto cache_locked = m_Cache.GetLock();
+
+    if (cache_locked->size() >= kMaxSize) {
+        for (auto it = cache_locked->begin(); it != cache_locked->end(); ) {
+            if (it->second.first <= now) {
+                it = cache_locked->erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (cache_locked->size() >= kMaxSize) return;
+    }
+
+    (*cache_locked)[full_path] = make_pair(now + m_CacheTtl, move(data));
+}
+
+bool SPSG_Coalescing::Replay(const shared_ptr<SPSG_Request>& req)
+{
+    string data;
+
+    if (auto cache_locked = m_Cache.GetLock()) {
+        auto it = cache_locked->find(req->full_path);
+
+        if (it == cache_locked->end()) return false;
+
+        if (it->second.first <= TClock::now()) {
+            cache_locked->erase(it);
+            return false;
+        }
+
+        data = it->second.second;
+    }
+
+    // Parsing sets (and then clears) the request context of the calling thread
+    CRef<CRequestContext> user_context(&CDiagContext::GetRequestContext());
+
+    const auto processor_id = SPSG_Processor::GetNextId();
+    req->OnReplyData(processor_id, data.data(), data.size());
+    req->OnReplyDone(processor_id).SetComplete();
+
+    CDiagContext::SetRequestContext(user_context);
+    return true;
+}
+
 
 END_NCBI_SCOPE
 
@@ -468,6 +468,8 @@ private:
     inline static atomic<TId> sm_NextId;
 };
 
+struct SPSG_Coalescing;
+
 struct SPSG_Request
 {
     struct SContext
@@ -488,26 +490,31 @@ struct SPSG_Request
 
     SPSG_Request(string p, shared_ptr<SPSG_Reply> r, CRef<CRequestContext> c, const SPSG_Params& params);
 
+    // Completes the reply of the request and the replies of its followers (if any)
+    struct SReplies
+    {
+        SPSG_Request& request;
+
+        void SetComplete();
+        void SetFailed(string message, EPSG_Status status = EPSG_Status::eError);
+    };
+
     enum EStateResult { eContinue, eStop, eRetry };
     EStateResult OnReplyData(SPSG_Processor::TId processor_id, const char* data, size_t len)
     {
         processed_by.Set(processor_id);
-
-        while (len) {
-            if (auto rv = (this->*m_State)(data, len); rv != eContinue) {
-                return rv;
-            }
-        }
-
-        return eContinue;
+        return m_Coalescing ? OnSharedReplyData(processor_id, data, len) : Parse(data, len);
     }
 
-    auto& OnReplyDone(SPSG_Processor::TId processor_id)
+    SReplies OnReplyDone(SPSG_Processor::TId processor_id)
     {
         processed_by.Set(processor_id);
-        return reply;
+        return { *this };
     }
 
+    void SetShared(shared_ptr<SPSG_Coalescing> coalescing, bool cache_reply);
+    bool AddFollower(shared_ptr<SPSG_Request> follower);
+
     unsigned GetRetries(SPSG_Retries::EType type, bool refused_stream)
     {
         return m_Retries.Get(type, refused_stream);
@@ -518,6 +525,19 @@ struct SPSG_Request
     void Reset();
 
 private:
+    EStateResult Parse(const char* data, size_t len)
+    {
+        while (len) {
+            if (auto rv = (this->*m_State)(data, len); rv != eContinue) {
+                return rv;
+            }
+        }
+
+        return eContinue;
+    }
+
+    EStateResult OnSharedReplyData(SPSG_Processor::TId processor_id, const char* data, size_t len);
+
     EStateResult StatePrefix(const char*& data, size_t& len);
     EStateResult StateArgs  (const char*& data, size_t& len);
     EStateResult StateData  (const char*& data, size_t& len);
@@ -538,9 +558,48 @@ private:
         size_t data_to_read = 0;
     };
 
+    // Requests receiving the same reply data as this one
+    struct SShared
+    {
+        bool accepts_followers = true;
+        bool cache_reply = false;
+        vector<shared_ptr<SPSG_Request>> followers;
+        string data;
+    };
+
     SBuffer m_Buffer;
     unordered_map<string, SPSG_Reply::SItem::TTS*> m_ItemsByID;
     SPSG_Retries m_Retries;
+    shared_ptr<SPSG_Coalescing> m_Coalescing;
+    SThreadSafe<SShared> m_Shared;
+};
+
+// Lets identical biodata/resolve requests share one stream and
+// serves recently received resolve replies without sending requests
+struct SPSG_Coalescing : enable_shared_from_this<SPSG_Coalescing>
+{
+    SPSG_Coalescing(bool coalesce, double cache_ttl, weak_ptr<SPSG_Stats> stats) :
+        m_Coalesce(coalesce),
+        m_CacheTtl(chrono::duration_cast<TClock::duration>(chrono::duration<double>(cache_ttl))),
+        m_Stats(move(stats))
+    {}
+
+    // Returns true if the request does not need to be sent
+    bool Join(const shared_ptr<SPSG_Request>& req, CPSG_Request::EType type);
+
+    void OnReplyDone(const SPSG_Request& req);
+    void Store(const string& full_path, string data);
+
+private:
+    using TClock = chrono::steady_clock;
+
+    bool Replay(const shared_ptr<SPSG_Request>& req);
+
+    const bool m_Coalesce;
+    const TClock::duration m_CacheTtl;
+    weak_ptr<SPSG_Stats> m_Stats;
+    SThreadSafe<unordered_map<string, weak_ptr<SPSG_Request>>> m_InFlight;
+    SThreadSafe<unordered_map<string, pair<TClock::time_point, string>>> m_Cache;
 };
 
 struct SPSG_TimedRequest
@@ -821,7 +880,7 @@ private:
 
 struct SPSG_StatsCounters
 {
-    enum EGroup : size_t { eRequest, eReplyItem, eSkippedBlob, eReplyItemStatus, eMessage, eRetries };
+    enum EGroup : size_t { eRequest, eReplyItem, eSkippedBlob, eReplyItemStatus, eMessage, eRetries, eCoalescing };
 
     void IncCounter(EGroup group, unsigned counter)
     {
@@ -1049,7 +1108,7 @@ public:
     shared_ptr<SPSG_Stats> stats;
 
     SPSG_IoCoordinator(CServiceDiscovery service);
-    bool AddRequest(shared_ptr<SPSG_Request> req, const atomic_bool& stopped, const CDeadline& deadline);
+    bool AddRequest(shared_ptr<SPSG_Request> req, const atomic_bool& stopped, const CDeadline& deadline, CPSG_Request::EType type);
     string GetNewRequestId() { return to_string(m_RequestId++); }
     bool RejectsRequests() const { return m_Servers->fail_requests; }
 
@@ -1061,6 +1120,7 @@ private:
     SPSG_Thread<SPSG_DiscoveryImpl> m_Discovery;
     atomic<size_t> m_RequestCounter;
     atomic<size_t> m_RequestId;
+    shared_ptr<SPSG_Coalescing> m_Coalescing;
 };
 
 END_NCBI_SCOPE
@@ -144,6 +144,7 @@ struct SFixture
     template <class TReadImpl>
     void MtReading();
     void Receive(const SPSG_Params& params, shared_ptr<SPSG_Reply>& reply, bool sleep);
+    void CheckItems(SPSG_Reply& reply);
 };
 
 thread_local SRandom SFixture::r;
@@ -243,7 +244,7 @@ bool SFixture::SReceiver::Process()
 void SFixture::SReceiver::Complete()
 {
     if (auto [processor_id, req] = m_Request.Get(); req) {
-        req->OnReplyDone(processor_id)->SetComplete();
+        req->OnReplyDone(processor_id).SetComplete();
     }
 }
 
@@ -487,23 +488,9 @@ void SFixture::Receive(const SPSG_Params& params, shared_ptr<SPSG_Reply>& reply,
     }
 }
 
-BOOST_FIXTURE_TEST_SUITE(PSG, SFixture)
-
-BOOST_AUTO_TEST_CASE(Request)
+void SFixture::CheckItems(SPSG_Reply& reply)
 {
-    const SPSG_Params params;
-    auto queue = make_shared<TPSG_Queue>();
-    auto reply = make_shared<SPSG_Reply>("", params, queue);
-
-
-    // Reading
-
-    Receive(params, reply, false);
-
-
-    // Checking
-
-    auto items_locked = reply->items.GetLock();
+    auto items_locked = reply.items.GetLock();
     auto& items = *items_locked;
 
     for (auto& item_ts : items) {
@@ -544,6 +531,74 @@ BOOST_AUTO_TEST_CASE(Request)
     }
 }
 
+BOOST_FIXTURE_TEST_SUITE(PSG, SFixture)
+
+BOOST_AUTO_TEST_CASE(Request)
+{
+    const SPSG_Params params;
+    auto queue = make_shared<TPSG_Queue>();
+    auto reply = make_shared<SPSG_Reply>("", params, queue);
+
+
+    // Reading
+
+    Receive(params, reply, false);
+
+
+    // Checking
+
+    CheckItems(*reply);
+}
+
+BOOST_AUTO_TEST_CASE(Coalescing)
+{
+    const SPSG_Params params;
+    auto queue = make_shared<TPSG_Queue>();
+    auto context = CDiagContext::GetRequestContext().Clone();
+    auto coalescing = make_shared<SPSG_Coalescing>(true, 600.0, weak_ptr<SPSG_Stats>());
+
+    auto new_request = [&]() {
+        auto reply = make_shared<SPSG_Reply>("", params, queue);
+        return make_shared<SPSG_Request>("/ID/resolve?seq_id=coalescing", reply, context, params);
+    };
+
+    auto leader = new_request();
+    auto follower = new_request();
+    auto late = new_request();
+
+    BOOST_REQUIRE_MESSAGE(!coalescing->Join(leader, CPSG_Request::eResolve), "First request has been joined");
+    BOOST_REQUIRE_MESSAGE(coalescing->Join(follower, CPSG_Request::eResolve), "Identical request has not been joined");
+
+
+    // Reading
+
+    const auto processor_id = SPSG_Processor::GetNextId();
+
+    for (const auto& chunk : src_chunks) {
+        auto result = leader->OnReplyData(processor_id, chunk.data(), chunk.size());
+        BOOST_REQUIRE_MESSAGE(result == SPSG_Request::eContinue, "Failed to parse reply data");
+    }
+
+    BOOST_REQUIRE_MESSAGE(!leader->AddFollower(late), "Request has been joined after reply data");
+
+    leader->OnReplyDone(processor_id).SetComplete();
+
+    // Served from the resolve reply cache
+    BOOST_REQUIRE_MESSAGE(coalescing->Join(late, CPSG_Request::eResolve), "Resolve reply has not been cached");
+
+
+    // Checking
+
+    for (const auto& request : { follower, late }) {
+        auto& reply = *request->reply;
+
+        BOOST_REQUIRE_MESSAGE(!reply.reply_item->state.InProgress(), "Reply has not been completed");
+        BOOST_REQUIRE_MESSAGE(reply.items.GetLock()->size() == src_blobs.size(), "Unexpected number of items");
+
+        CheckItems(reply);
+    }
+}
+
 struct SBlobReader
 {
     SBlobReader(SPSG_Reply::SItem::TTS& dst) : reader(dst) {}
@@ -743,6 +798,98 @@ BOOST_AUTO_TEST_CASE(UserArgsBuilder)
     BOOST_CHECK_EQUAL(s_Build(builder, request_user_args), SPSG_UserArgs("&enable_processor=cdd&enable_processor=osg&enable_processor=snp&enable_processor=wgs&hops=3&use_cache=no"));
 }
 
+void s_SetBlobData(SPSG_Reply::SItem::TTS& item_ts, const vector<string>& chunks, size_t expected)
+{
+    auto item_locked = item_ts.GetLock();
+    auto& item = *item_locked;
+
+    for (const auto& chunk : chunks) {
+        item.chunks.emplace_back(chunk.data(), chunk.size());
+    }
+
+    item.expected = expected;
+    item.received = chunks.size();
+}
+
+BOOST_AUTO_TEST_CASE(BlobStream)
+{
+    const vector<string> chunks{ "first chunk;", "second chunk;", "third chunk" };
+    const auto data = chunks[0] + chunks[1] + chunks[2];
+
+    // Reading exactly the blob data
+    {
+        SPSG_Reply::SItem::TTS item;
+        s_SetBlobData(item, chunks, chunks.size());
+
+        SPSG_RStream is(item);
+        string received(data.size(), '\0');
+        BOOST_CHECK(is.read(&received[0], received.size()));
+        BOOST_CHECK_EQUAL(received, data);
+        BOOST_CHECK_EQUAL(is.get(), char_traits<char>::eof());
+        BOOST_CHECK(is.eof());
+        BOOST_CHECK(!is.bad());
+    }
+
+    // Reading more than the blob has
+    {
+        SPSG_Reply::SItem::TTS item;
+        s_SetBlobData(item, chunks, chunks.size());
+
+        SPSG_RStream is(item);
+        string received(data.size() * 2, '\0');
+        BOOST_CHECK(!is.read(&received[0], received.size()));
+        BOOST_CHECK_EQUAL(is.gcount(), streamsize(data.size()));
+        BOOST_CHECK_EQUAL(received.substr(0, data.size()), data);
+        BOOST_CHECK(is.eof());
+        BOOST_CHECK(!is.bad());
+    }
+
+    // The rest of the blob does not come in time
+    {
+        const auto timeout = TPSG_ReaderTimeout::GetDefault();
+        TPSG_ReaderTimeout::SetDefault(1);
+
+        SPSG_Reply::SItem::TTS item;
+        s_SetBlobData(item, { chunks[0] }, chunks.size());
+
+        SPSG_RStream is(item);
+        string received(data.size(), '\0');
+        BOOST_CHECK_NO_THROW(is.read(&received[0], received.size()));
+        BOOST_CHECK_EQUAL(is.gcount(), streamsize(chunks[0].size()));
+        BOOST_CHECK_EQUAL(received.substr(0, chunks[0].size()), chunks[0]);
+        BOOST_CHECK(is.bad());
+
+        TPSG_ReaderTimeout::SetDefault(timeout);
+    }
+
+    // More chunks arrive while the reader still points into a chunk
+    {
+        SPSG_Reply::SItem::TTS item;
+        s_SetBlobData(item, { chunks[0] }, 100);
+
+        SPSG_BlobReader reader(item);
+        const char* in_place = nullptr;
+        size_t read = 0;
+        BOOST_REQUIRE_EQUAL(reader.ReadInPlace(&in_place, &read), eRW_Success);
+        BOOST_REQUIRE_EQUAL(read, chunks[0].size());
+
+        {
+            auto item_locked = item.GetLock();
+
+            for (size_t i = 1; i < 100; ++i) {
+                item_locked->chunks.emplace_back(chunks[1].data(), chunks[1].size());
+            }
+
+            item_locked->received = 100;
+        }
+
+        size_t pending = 0;
+        BOOST_CHECK_EQUAL(reader.PendingCount(&pending), eRW_Success);
+        BOOST_CHECK_EQUAL(pending, 99 * chunks[1].size());
+        BOOST_CHECK_EQUAL(string(in_place, read), chunks[0]);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 #endif